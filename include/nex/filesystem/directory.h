@@ -47,6 +47,13 @@ public:
      * @return the list of files found in the directory.
      */
     static std::vector<FileInfo> getFiles(const std::string& dir);
+
+    /**
+     * @brief Get a list of all files in the directory, reusing the storage of a previous list.
+     * @param dir = The path to the directory.
+     * @param files = Receives the files found, its previous content is overwritten.
+     */
+    static void getFiles(const std::string& dir, std::vector<FileInfo>& files);
 };
 
 } // namespace nx
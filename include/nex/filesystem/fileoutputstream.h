@@ -11,7 +11,7 @@
 namespace nx
 {
 
-class FileOutputStream
+class FileOutputStream : public OutStream
 {
 public:
 
@@ -0,0 +1,81 @@
+#ifndef MAPPEDFILE_H_INCLUDE
+#define MAPPEDFILE_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/system/noncopyable.h>
+
+// Standard includes.
+#include <cstddef>
+#include <string>
+
+namespace nx
+{
+
+/**
+ * Read only view of a whole file mapped into memory.
+ *
+ * The operating system pages the file in on demand, nothing is copied into
+ * a buffer of ours: loading a large asset costs the pages that are actually
+ * read. The data stays valid until the file is closed.
+ */
+class MappedFile : public NonCopyable
+{
+public:
+
+    /**
+     * @brief Default constructor, no file is mapped.
+     */
+    MappedFile();
+
+    /**
+     * @brief Destructor, unmaps the file.
+     */
+    ~MappedFile();
+
+    /**
+     * @brief Map a file into memory, closing the previous one.
+     * @param filepath = The path to the file.
+     * @return true if successful, empty files cannot be mapped.
+     */
+    bool open(const std::string& filepath);
+
+    /**
+     * @brief Unmap the file.
+     */
+    void close();
+
+    /**
+     * @brief Get the content of the file.
+     * @return the first byte of the file, or 0 if no file is mapped.
+     */
+    const uint8* getData() const { return static_cast<const uint8*>(mData); }
+
+    /**
+     * @brief Get the size of the file.
+     * @return the size in bytes, or 0 if no file is mapped.
+     */
+    std::size_t getSize() const { return mSize; }
+
+    /**
+     * @brief Tells whether a file is mapped.
+     * @return true if a file is mapped.
+     */
+    bool isOpen() const { return mData != 0; }
+
+private:
+
+    /**
+     * @brief The mapped view of the file.
+     */
+    void* mData;
+
+    /**
+     * @brief The size of the view, in bytes.
+     */
+    std::size_t mSize;
+};
+
+} // namespace nx
+
+#endif // MAPPEDFILE_H_INCLUDE
@@ -6,11 +6,14 @@
 #include <nex/gfx/texture.h>
 #include <nex/gfx/image.h>
 #include <nex/system/string.h>
+#include <nex/system/flathashmap.h>
 #include <nex/math/vec2.h>
 #include <nex/math/rect.h>
 
 // Standard includes.
+#include <deque>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -18,6 +21,38 @@ namespace nx
 {
 
 class InStream;
+class OutStream;
+
+/**
+ * @brief What a Font has loaded so far.
+ */
+struct FontStats
+{
+    /**
+     * @brief Number of character sizes glyphs were asked for.
+     */
+    uint32 pageCount;
+
+    /**
+     * @brief Number of atlas textures holding the glyphs.
+     */
+    uint32 atlasCount;
+
+    /**
+     * @brief Number of bytes of the atlas textures, at 4 bytes per pixel.
+     */
+    std::size_t atlasBytes;
+
+    /**
+     * @brief Number of glyphs rendered by FreeType, distance fields count once.
+     */
+    uint32 glyphsRasterized;
+
+    /**
+     * @brief Number of getGlyph calls that did not find the glyph in the page of their size.
+     */
+    uint32 cacheMisses;
+};
 
 class Font
 {
@@ -31,6 +66,16 @@ public:
         std::string family;
     };
 
+    /**
+     * @brief Character size the glyphs of distance field fonts are rendered at.
+     */
+    static const uint32 DistanceFieldSize = 32;
+
+    /**
+     * @brief Distance, in pixels at DistanceFieldSize, covered by the fields on each side of an edge.
+     */
+    static const uint32 DistanceFieldSpread = 4;
+
     /**
      * @brief Default constructor defines an empty font.
      */
@@ -69,6 +114,46 @@ public:
      */
     bool loadFromStream(InStream& stream);
 
+    /**
+     * @brief Load the font from a file written by saveBaked.
+     * The file is mapped into memory, its glyphs, kerning and metrics fill
+     * the caches and its atlas is uploaded in one go, FreeType is never
+     * used. Glyphs and sizes that were not baked come out empty.
+     * @param filename = Path of the baked font file to load.
+     * @return true if loading succeeded, false if it failed.
+     */
+    bool loadFromBaked(const std::string& filename);
+
+    /**
+     * @brief Rasterize a set of characters at a set of sizes into a baked font file.
+     * Everything is rendered on the CPU into a single atlas, no OpenGL
+     * context is needed. The font must have been loaded with FreeType.
+     * Glyphs are baked as bitmaps, even in distance field mode.
+     * @param stream = Destination stream to write to.
+     * @param characterSizes = Character sizes to bake.
+     * @param charset = Characters to bake at every size.
+     * @param bold = Bake the bold version of the characters as well?
+     * @return true if saving succeeded, false if it failed.
+     */
+    bool saveBaked(OutStream& stream, const std::vector<uint32>& characterSizes, const String& charset, bool bold = false) const;
+
+    /**
+     * @brief Switch between bitmaps rendered for each size and distance fields scaled to any size.
+     * In distance field mode a glyph is rendered once at DistanceFieldSize into
+     * a single atlas shared by every character size, its alpha holding the
+     * distance to the outline instead of the coverage. Texts of such fonts
+     * need a TextShader in distance field mode. Switching drops the loaded
+     * glyphs, baked fonts cannot switch.
+     * @param distanceField = Use distance fields?
+     */
+    void setDistanceField(bool distanceField);
+
+    /**
+     * @brief Tells whether the glyphs are distance fields.
+     * @return true in distance field mode.
+     */
+    bool isDistanceField() const;
+
     /**
      * @brief Get the font information.
      * @return A structure that holds the font information.
@@ -121,6 +206,13 @@ public:
      */
     const Texture& getTexture(uint32 characterSize) const;
 
+    /**
+     * @brief Get the counters of the glyphs loaded so far.
+     * Copies of a font start from the counters of the original.
+     * @return the counters.
+     */
+    FontStats getStats() const;
+
     /**
      * @brief Overload of assignment operator.
      * @param right = right Instance to assign.
@@ -142,7 +234,10 @@ private:
         uint32 height;
     };
 
-    typedef std::map<uint32, Glyph> GlyphTable;
+    /**
+     * @brief Number of code points looked up directly instead of through the hash table (Latin-1).
+     */
+    static const uint32 LatinGlyphCount = 256;
 
     /**
      * @brief Structure defining a page of glyphs.
@@ -151,10 +246,31 @@ private:
     {
         Page();
 
-        GlyphTable glyphs;
+        /**
+         * @brief Create the texture the glyphs are rendered into, baked fonts share one atlas instead.
+         */
+        void createTexture();
+
+        // Loaded glyphs, a deque so references handed out stay valid
+        std::deque<Glyph> glyphs;
+
+        // Index + 1 in glyphs of Latin-1 code points, the bold ones after the regular ones, 0 if not loaded
+        uint32 latinGlyphs[LatinGlyphCount * 2];
+
+        // Index in glyphs of the other code points, keyed by code point with the bold flag in bit 31
+        FlatHashMap<uint32, uint32> glyphTable;
+
+        // Kerning of character pairs already asked for, keyed by first << 32 | second
+        FlatHashMap<uint64, float> kerning;
+
         nx::Texture texture;
         uint32 nextRow;
         std::vector<Row> rows;
+
+        // Metrics read from a baked font, FreeType answers otherwise
+        float lineSpacing;
+        float underlinePosition;
+        float underlineThickness;
     };
 
     typedef std::map<unsigned int, Page> PageTable;
@@ -164,6 +280,53 @@ private:
      */
     void cleanup();
 
+    /**
+     * @brief Get the page of a character size, remembering it for the next call.
+     * @param characterSize = Reference character size.
+     * @return the page, created if needed.
+     */
+    Page& getPage(uint32 characterSize) const;
+
+    /**
+     * @brief Look a glyph up in a page.
+     * @param page = The page.
+     * @param codePoint = Unicode code point of the character.
+     * @param bold = The bold version or the regular one?
+     * @return the glyph, or 0 if it is not loaded.
+     */
+    static const Glyph* findGlyph(const Page& page, uint32 codePoint, bool bold);
+
+    /**
+     * @brief Store a newly loaded glyph in a page.
+     * @param page = The page.
+     * @param codePoint = Unicode code point of the character.
+     * @param bold = The bold version or the regular one?
+     * @param glyph = The glyph.
+     * @return the stored glyph.
+     */
+    static const Glyph& insertGlyph(Page& page, uint32 codePoint, bool bold, const Glyph& glyph);
+
+    /**
+     * @brief Render a glyph into m_pixelBuffer, white with the coverage in the alpha channel.
+     * @param codePoint = Unicode code point of the character to render.
+     * @param characterSize = Reference character size.
+     * @param bold = Render the bold version or the regular one?
+     * @param glyph = Receives the advance and bounds of the glyph, its texture rectangle is left alone.
+     * @param size = Receives the size of the bitmap in pixels, 0 for blank glyphs.
+     * @param oversampling = Factor the bitmap is enlarged by, the metrics stay those of characterSize.
+     * @return false if FreeType failed to render the glyph.
+     */
+    bool rasterizeGlyph(uint32 codePoint, uint32 characterSize, bool bold, Glyph& glyph, vec2u& size, uint32 oversampling = 1) const;
+
+    /**
+     * @brief Ask FreeType for the kerning offset of two glyphs.
+     * @param first = Unicode code point of the first character.
+     * @param second = Unicode code point of the second character.
+     * @param characterSize = Reference character size.
+     * @return Kerning value for first and second, in pixels.
+     */
+    float computeKerning(uint32 first, uint32 second, uint32 characterSize) const;
+
     /**
      * @brief Load a new glyph and store it in the cache.
      * @param codePoint = Unicode code point of the character to load.
@@ -173,6 +336,28 @@ private:
      */
     Glyph loadGlyph(uint32 codePoint, uint32 characterSize, bool bold) const;
 
+    /**
+     * @brief Get the page of distance field glyphs.
+     * @return the page, created with its atlas if needed.
+     */
+    Page& getDistanceFieldPage() const;
+
+    /**
+     * @brief Get a glyph of the distance field page, rendering it into the atlas if needed.
+     * @param codePoint = Unicode code point of the character.
+     * @param bold = Retrieve the bold version or the regular one?
+     * @return The glyph at DistanceFieldSize.
+     */
+    const Glyph& getDistanceFieldGlyph(uint32 codePoint, bool bold) const;
+
+    /**
+     * @brief Render the distance field of a glyph and store it in the atlas.
+     * @param codePoint = Unicode code point of the character to load.
+     * @param bold = Retrieve the bold version or the regular one?
+     * @return The glyph at DistanceFieldSize, its bounds cover the spread around the outline.
+     */
+    Glyph loadDistanceFieldGlyph(uint32 codePoint, bool bold) const;
+
     /**
      * @brief Find a suitable rectangle within the texture for a glyph.
      * @param page = Page of glyphs to search in.
@@ -219,11 +404,42 @@ private:
      */
     mutable PageTable m_pages;
 
+    /**
+     * @brief The page of the last character size asked for, texts ask for one size many times in a row.
+     */
+    mutable Page* m_lastPage;
+
+    /**
+     * @brief The character size of m_lastPage.
+     */
+    mutable uint32 m_lastPageSize;
+
+    /**
+     * @brief The atlas of a baked font, holding the glyphs of every size, null for FreeType fonts.
+     * Every copy of the font uploads its own.
+     */
+    std::unique_ptr<Texture> m_atlas;
+
+    /**
+     * @brief Are the glyphs distance fields?
+     */
+    bool m_distanceField;
+
+    /**
+     * @brief Glyphs of distance field fonts at DistanceFieldSize and their atlas, the other pages scale them.
+     */
+    mutable std::shared_ptr<Page> m_distanceFieldPage;
+
     /**
      * @brief Pixel buffer holding a glyph's pixels before being written to the texture
      */
     mutable std::vector<uint8> m_pixelBuffer;
 
+    /**
+     * @brief Glyphs rasterized and cache misses, the other counters are computed by getStats.
+     */
+    mutable FontStats m_stats;
+
 };
 
 } // namespace nx
@@ -18,7 +18,18 @@
 
 namespace nx
 {
-
+class JobSystem;
+
+/**
+ * @brief The number of pixels a parallel image operation hands to a job at a time.
+ */
+const std::size_t ImageParallelPixels = 1 << 16;
+
+/**
+ * The pixel operations that visit every row have an overload taking a
+ * JobSystem, which splits the rows between its threads. They are opt in,
+ * small images are faster on the calling thread alone.
+ */
 class Image
 {
 public:
@@ -56,6 +67,14 @@ public:
      */
     void createMaskFromColor(const Color& color, uint8 alpha = 0);
 
+    /**
+     * @brief Create a transparency mask from a specified color-key, on the threads of a job system.
+     * @param color = Color to make transparent.
+     * @param alpha = Alpha value to assign to transparent pixels.
+     * @param jobs = The job system to run on.
+     */
+    void createMaskFromColor(const Color& color, uint8 alpha, JobSystem& jobs);
+
     /**
      * @brief Copy pixels from another image onto this one.
      * @param source = The source image to copy from.
@@ -67,6 +86,18 @@ public:
     void copy(const Image& source, uint32 destX, uint32 destY,
               const recti& sourceRect = recti(0, 0, 0, 0), bool applyAlpha = false);
 
+    /**
+     * @brief Copy pixels from another image onto this one, on the threads of a job system.
+     * @param source = The source image to copy from.
+     * @param destX = The X coordinate of the destination position.
+     * @param destY = The Y coordinate of the destination position.
+     * @param sourceRect = Sub-rectangle of the source image to copy.
+     * @param applyAlpha = Should the copy take into account the source transparency.
+     * @param jobs = The job system to run on.
+     */
+    void copy(const Image& source, uint32 destX, uint32 destY,
+              const recti& sourceRect, bool applyAlpha, JobSystem& jobs);
+
     /**
      * @brief Change the color of a pixel.
      * @param x = The X coordinate of pixel to change.
@@ -88,11 +119,23 @@ public:
      */
     void flipHorizontally();
 
+    /**
+     * @brief Flip the image horizontally (left <-> right), on the threads of a job system.
+     * @param jobs = The job system to run on.
+     */
+    void flipHorizontally(JobSystem& jobs);
+
     /**
      * @brief Flip the image vertically (top <-> bottom).
      */
     void flipVertically();
 
+    /**
+     * @brief Flip the image vertically (top <-> bottom), on the threads of a job system.
+     * @param jobs = The job system to run on.
+     */
+    void flipVertically(JobSystem& jobs);
+
     /**
      * @brief Load the image from a file on disk.
      * @param filename = Path of the image file to load.
@@ -135,6 +178,13 @@ public:
     const uint8* getPixelsPtr() const;
 
 private:
+
+    // The implementations of the pixel operations, jobs is 0 to stay on the calling thread.
+    void createMaskFromColorRows(const Color& color, uint8 alpha, JobSystem* jobs);
+    void copyRows(const Image& source, uint32 destX, uint32 destY, const recti& sourceRect, bool applyAlpha, JobSystem* jobs);
+    void flipRowsHorizontally(JobSystem* jobs);
+    void flipRowsVertically(JobSystem* jobs);
+
     vec2u m_size;
     std::vector<uint8> m_pixels;
 };
@@ -62,6 +62,13 @@ public:
 
     //FloatRect getGlobalBounds() const;
 
+    /**
+     * @brief Get the vertices of the text, six per glyph quad, laid out but not uploaded.
+     * Lets a TextBatch gather many texts without touching their vertex buffers.
+     * @return the vertices.
+     */
+    const VertexList2d& getVertices() const;
+
     void render() const;
 
 private:
@@ -76,6 +83,21 @@ private:
 
     Color m_color;
 
+    /**
+     * @brief Layout state before a character, lets an update resume in the middle of the string.
+     */
+    struct LayoutState
+    {
+        float x;
+        float y;
+        float minX;
+        float minY;
+        float maxX;
+        float maxY;
+        uint32 prevChar;
+        uint32 vertexCount;
+    };
+
     mutable VertexList2d m_vertices;
 
     mutable VertexBuffer m_vertexBuffer;
@@ -86,7 +108,24 @@ private:
 
     mutable bool m_geometryNeedUpdate;
 
+    mutable bool m_colorNeedUpdate;
+
+    // One state per character plus the end of the string, valid up to m_firstChangedChar.
+    mutable std::vector<LayoutState> m_layout;
+
+    mutable std::size_t m_firstChangedChar;
+
+    // Number of vertices the vertex buffer can hold without growing.
+    mutable uint32 m_bufferCapacity;
+
+    // First vertex the vertex buffer is missing, uploaded on the next render.
+    mutable uint32 m_uploadFrom;
+
+    void invalidateFrom(std::size_t index);
+
     void ensureGeometryUpdate() const;
+
+    void upload(uint32 first) const;
 };
 
 } // namespace nx
@@ -0,0 +1,132 @@
+#ifndef TEXTBATCH_H_INCLUDE
+#define TEXTBATCH_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/gfx/text.h>
+#include <nex/gfx/texture.h>
+#include <nex/gfx/vertex2d.h>
+#include <nex/gfx/vertexarray.h>
+#include <nex/gfx/vertexbuffer.h>
+#include <nex/gfx/elementbuffer.h>
+
+// Standard includes.
+#include <cstddef>
+#include <vector>
+
+namespace nx
+{
+
+/**
+ * @brief What a TextBatch sent to the GPU during the last flush.
+ */
+struct TextBatchStats
+{
+    /**
+     * @brief Number of draw calls, one per atlas texture.
+     */
+    uint32 drawCalls;
+
+    /**
+     * @brief Number of bytes of vertices and indices uploaded.
+     */
+    std::size_t bytesUploaded;
+
+    /**
+     * @brief Number of glyph quads drawn.
+     */
+    uint32 quadCount;
+
+    /**
+     * @brief Number of texts drawn.
+     */
+    uint32 textCount;
+};
+
+/**
+ * Draws many Text objects with one draw call per glyph atlas.
+ *
+ * Texts are gathered between begin and flush. flush sorts them by atlas
+ * texture, that is by font and character size, copies their glyph quads
+ * into one streaming vertex buffer and issues one indexed draw per atlas,
+ * so a HUD of hundreds of labels in a couple of fonts costs a couple of
+ * draws. Texts keep their own layout, only their vertices are read, their
+ * own vertex buffers are left alone.
+ *
+ * The shader must read Vertex2d data at the Vertex2dAttribute locations.
+ * Texture coordinates are in atlas pixels: given the location of a vec2
+ * uniform of the bound program, such as TextShader::getTextureSizeUniform,
+ * flush sets it to the size of the atlas of each draw.
+ */
+class TextBatch
+{
+public:
+
+    TextBatch();
+    ~TextBatch();
+
+    /**
+     * @brief Starts gathering texts for a new frame.
+     */
+    void begin();
+
+    /**
+     * @brief Queues a text, drawn on the next flush.
+     * The text must stay alive and unchanged until then.
+     * @param text = The text.
+     * @param position = Offset added to the vertices of the text.
+     */
+    void draw(const Text& text, const vec2f& position = vec2f());
+
+    /**
+     * @brief Uploads and draws every queued text, with the atlas bound to texture unit 0.
+     * @param textureSizeUniform = Location of the uniform of the bound program receiving the atlas size, -1 for none.
+     */
+    void flush(GLint textureSizeUniform = -1);
+
+    /**
+     * @brief Get the counters of the last flush.
+     * @return the counters.
+     */
+    const TextBatchStats& getStats() const { return m_stats; }
+
+private:
+
+    struct Item
+    {
+        const Text* text;
+        const Texture* texture;
+        vec2f position;
+        uint32 order;
+    };
+
+    // Quads of consecutive items sharing an atlas.
+    struct Range
+    {
+        const Texture* texture;
+        uint32 firstQuad;
+        uint32 quadCount;
+    };
+
+    static bool compareItems(const Item& left, const Item& right);
+
+    void ensureIndices(uint32 quadCount);
+
+    std::vector<Item> m_items;
+    std::vector<Range> m_ranges;
+    std::vector<Vertex2d> m_vertices;
+
+    VertexArray m_vertexArray;
+    VertexBuffer m_vertexBuffer;
+    ElementBuffer m_elementBuffer;
+
+    // Quads the vertex and element buffers can hold.
+    uint32 m_vertexCapacity;
+    uint32 m_indexCapacity;
+
+    TextBatchStats m_stats;
+};
+
+} // namespace nx
+
+#endif // TEXTBATCH_H_INCLUDE
@@ -0,0 +1,97 @@
+#ifndef TEXTSHADER_H_INCLUDE
+#define TEXTSHADER_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/noncopyable.h>
+#include <nex/math/matrix.h>
+#include <nex/gfx/color.h>
+#include <nex/gfx/shader.h>
+#include <nex/gfx/texture.h>
+
+namespace nx
+{
+
+/**
+ * Shader program drawing Text and TextBatch vertices.
+ *
+ * The bitmap mode multiplies the vertex color by the glyph coverage. The
+ * distance field mode draws fonts in Font::setDistanceField mode: it cuts
+ * the glyphs at the threshold, antialiased over one screen pixel whatever
+ * the character size, and can add an outline around them.
+ *
+ * Vertices are read at the Vertex2dAttribute locations, texture coordinates
+ * in atlas pixels, positions transformed by the projection.
+ */
+class TextShader : public NonCopyable
+{
+public:
+
+    /**
+     * @brief Alpha of the outline in distance field atlases.
+     */
+    static const float DistanceFieldThreshold;
+
+    TextShader();
+
+    /**
+     * @brief Compile and link the program.
+     * @param distanceField = Draw distance field fonts rather than bitmap ones?
+     * @return true if the program compiled.
+     */
+    bool create(bool distanceField);
+
+    /**
+     * @brief Tells whether the program draws distance field fonts.
+     * @return true in distance field mode.
+     */
+    bool isDistanceField() const { return m_distanceField; }
+
+    /**
+     * @brief Set where distance fields are cut, distance field mode only.
+     * @param threshold = Alpha of the cut, below DistanceFieldThreshold to embolden and above to thin.
+     */
+    void setThreshold(float threshold);
+
+    /**
+     * @brief Set the outline drawn around the glyphs, distance field mode only.
+     * @param thickness = Thickness in pixels at Font::DistanceFieldSize, up to Font::DistanceFieldSpread, 0 for none.
+     * @param color = Color of the outline.
+     */
+    void setOutline(float thickness, const Color& color);
+
+    /**
+     * @brief Bind the program and set its uniforms, the atlas is read from texture unit 0.
+     * @param projection = Transform of the vertex positions.
+     * @param atlas = The glyph atlas, for its size.
+     */
+    void bind(const mat4f& projection, const Texture& atlas);
+
+    /**
+     * @brief Unbind the program.
+     */
+    void unbind() const { m_shader.unbind(); }
+
+    /**
+     * @brief Get the location of the atlas size uniform, for TextBatch::flush.
+     * @return the location, -1 before create.
+     */
+    GLint getTextureSizeUniform() const { return m_textureSizeUniform; }
+
+private:
+
+    Shader m_shader;
+
+    GLint m_textureSizeUniform;
+
+    bool m_distanceField;
+
+    float m_threshold;
+
+    float m_outlineThickness;
+
+    Color m_outlineColor;
+};
+
+} // namespace nx
+
+#endif // TEXTSHADER_H_INCLUDE
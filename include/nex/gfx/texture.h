@@ -3,14 +3,12 @@
 
 // Nex includes.
 #include <nex/system/typedefs.h>
+#include <nex/system/objectpool.h>
 #include <nex/math/vec2.h>
 #include <nex/gfx/image.h>
 
 #include <GL/glew.h>
 
-// Standard includes.
-#include <memory>
-
 namespace nx
 {
 
@@ -138,7 +136,15 @@ private:
     static int m_texturesAlive;
 };
 
-typedef std::shared_ptr<Texture> TexturePtr;
+/**
+ * @brief Reference to a texture of a TexturePool, copied without any reference counting.
+ */
+typedef Handle<Texture> TextureHandle;
+
+/**
+ * @brief Owner of textures handed out as TextureHandle.
+ */
+typedef ObjectPool<Texture> TexturePool;
 
 } //namespace nx
 
@@ -10,6 +10,16 @@ using nx::vec3f;
 namespace nx
 {
 
+/**
+ * @brief Attribute locations shaders drawing Vertex2d data bind their inputs to.
+ */
+enum Vertex2dAttribute
+{
+    VERTEX2D_POSITION = 0,
+    VERTEX2D_COLOR = 1,
+    VERTEX2D_UV = 2
+};
+
 struct Vertex2d
 {
     /**
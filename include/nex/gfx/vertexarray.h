@@ -3,6 +3,9 @@
 
 #include <GL/glew.h>
 
+// Standard includes.
+#include <cstddef>
+
 namespace nx
 {
 
@@ -43,6 +46,16 @@ public:
      */
     inline void unbind() const { glBindVertexArray(0); }
 
+    /**
+     * @brief Point an attribute at float data of the currently bound vertex buffer and enable it.
+     * The vertex array must be bound.
+     * @param index = The attribute location.
+     * @param components = The number of floats of the attribute.
+     * @param stride = The distance in bytes between two vertices.
+     * @param offset = The offset in bytes of the attribute in a vertex.
+     */
+    void setAttribute(GLuint index, GLint components, GLsizei stride, std::size_t offset);
+
     /**
      * @brief Check if this vertex array has been created.
      * @return true if it has been created.
@@ -35,6 +35,14 @@ public:
         m_vertices.resize(vertexCount);
     }
 
+    /**
+     * @brief Make room for vertices without adding any, clear keeps the room.
+     * @param vertexCount = The number of vertices to make room for.
+     */
+    inline void reserve(std::size_t vertexCount) {
+        m_vertices.reserve(vertexCount);
+    }
+
     /**
      * @brief Get a read-write access to a vertex by its index.
      * @param index = Index Index of the vertex to get.
@@ -3,6 +3,8 @@
 
 // Nex includes.
 #include <nex/gfx/vertex3d.h>
+#include <nex/math/matrix.h>
+#include <nex/math/vec3array.h>
 
 // Standard includes.
 #include <vector>
@@ -55,6 +57,28 @@ public:
      */
     inline const float* getFloatPtr() { return reinterpret_cast<const float*>(&m_vertices[0]); }
 
+    /**
+     * @brief Get a view over the vertex positions, valid until the list is modified.
+     * @return A strided view over Vertex3d::position.
+     */
+    inline Vec3View getPositions() {
+        return m_vertices.empty() ? Vec3View() : Vec3View(&m_vertices[0].position, m_vertices.size(), sizeof(Vertex3d));
+    }
+
+    /**
+     * @brief Get a view over the vertex normals, valid until the list is modified.
+     * @return A strided view over Vertex3d::normal.
+     */
+    inline Vec3View getNormals() {
+        return m_vertices.empty() ? Vec3View() : Vec3View(&m_vertices[0].normal, m_vertices.size(), sizeof(Vertex3d));
+    }
+
+    /**
+     * @brief Transform the position and normal of every vertex in place.
+     * @param matrix = The affine transformation, normals are transformed by its inverse transpose.
+     */
+    void transform(const mat4f& matrix);
+
 private:
 
     std::vector<Vertex3d> m_vertices;
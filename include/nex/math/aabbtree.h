@@ -0,0 +1,155 @@
+#ifndef AABBTREE_H_INCLUDE
+#define AABBTREE_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/math/vec3.h>
+#include <nex/math/aabb.h>
+
+// Standard includes.
+#include <cstddef>
+#include <vector>
+
+namespace nx
+{
+
+/**
+ * @brief The default distance by which AABBTree grows the bounds of every proxy.
+ */
+const float AABBTreeMargin = 0.1f;
+
+/**
+ * @brief Two proxies whose fat bounds overlap, proxyA < proxyB.
+ */
+struct AABBTreePair
+{
+    int32 proxyA;
+    int32 proxyB;
+};
+
+/**
+ * Dynamic bounding volume tree for moving objects.
+ *
+ * Every proxy is stored with fat bounds, grown by a margin and by its last
+ * displacement, so small moves do not touch the tree. Insertions pick the
+ * sibling with the surface area heuristic and rotations keep the tree
+ * balanced. Nodes live in one array and removed nodes are reused.
+ */
+class AABBTree
+{
+public:
+
+    /**
+     * @brief The proxy value that never refers to a node.
+     */
+    static const int32 NullNode = -1;
+
+    /**
+     * @brief Constructs an empty tree.
+     * @param margin = The distance by which the bounds of every proxy are grown.
+     */
+    explicit AABBTree(float margin = AABBTreeMargin);
+
+    /**
+     * @brief Adds a proxy to the tree.
+     * @param box = The tight bounds of the object.
+     * @param userData = Value returned by getUserData.
+     * @return the proxy handle, valid until it is removed.
+     */
+    int32 insert(const AABB& box, void* userData = 0);
+
+    /**
+     * @brief Removes a proxy from the tree, its handle may be reused by a later insert.
+     * @param proxy = The proxy to remove.
+     */
+    void remove(int32 proxy);
+
+    /**
+     * @brief Updates the bounds of a proxy, the tree is only touched if the box left the fat bounds.
+     * @param proxy = The proxy to move.
+     * @param box = The new tight bounds of the object.
+     * @param displacement = The expected motion until the next move, used to grow the fat bounds.
+     * @return true if the proxy was reinserted.
+     */
+    bool move(int32 proxy, const AABB& box, const vec3f& displacement = vec3f());
+
+    /**
+     * @brief Get the fat bounds stored for a proxy.
+     * @param proxy = The proxy.
+     * @return the fat bounds.
+     */
+    const AABB& getFatBounds(int32 proxy) const { return mNodes[proxy].box; }
+
+    /**
+     * @brief Get the user data of a proxy.
+     * @param proxy = The proxy.
+     * @return the value passed to insert.
+     */
+    void* getUserData(int32 proxy) const { return mNodes[proxy].userData; }
+
+    /**
+     * @brief Collects every proxy whose fat bounds overlap a box.
+     * @param box = The box to test.
+     * @param results = The proxies are appended to it.
+     */
+    void query(const AABB& box, std::vector<int32>& results) const;
+
+    /**
+     * @brief Collects every pair of proxies whose fat bounds overlap, each pair once.
+     * @param pairs = The pairs are appended to it.
+     */
+    void queryPairs(std::vector<AABBTreePair>& pairs) const;
+
+    /**
+     * @brief Removes every proxy.
+     */
+    void clear();
+
+    /**
+     * @brief Get the height of the tree, 0 for a single leaf.
+     * @return the height.
+     */
+    int32 getHeight() const { return mRoot == NullNode ? 0 : mNodes[mRoot].height; }
+
+    /**
+     * @brief Get the number of proxies.
+     * @return the proxy count.
+     */
+    std::size_t size() const { return mProxyCount; }
+
+private:
+
+    struct Node
+    {
+        bool isLeaf() const { return child1 == NullNode; }
+
+        AABB box;
+        void* userData;
+
+        // Next free node while the node is in the free list.
+        int32 parent;
+
+        int32 child1;
+        int32 child2;
+
+        // Leaves are 0, free nodes -1.
+        int32 height;
+    };
+
+    int32 allocateNode();
+    void freeNode(int32 node);
+    void insertLeaf(int32 leaf);
+    void removeLeaf(int32 leaf);
+    int32 balance(int32 node);
+    void refit(int32 node);
+
+    std::vector<Node> mNodes;
+    int32 mRoot;
+    int32 mFreeList;
+    std::size_t mProxyCount;
+    float mMargin;
+};
+
+} // namespace nx
+
+#endif // AABBTREE_H_INCLUDE
@@ -0,0 +1,236 @@
+#ifndef BATCHTRANSFORM_H_INCLUDE
+#define BATCHTRANSFORM_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/math/vec3.h>
+#include <nex/math/vec4.h>
+#include <nex/math/matrix.h>
+#include <nex/math/obb.h>
+
+// Standard includes.
+#include <cstddef>
+
+/*
+ * Stream versions of Matrix::transform, Matrix::transformNormal and OBB::transform.
+ *
+ * Every function accepts input == output to transform in place. The packed
+ * and SoA kernels run 4 points per iteration with SSE and 8 with AVX. The
+ * interleaved kernels gather 8 positions per iteration with AVX2 and are
+ * scalar otherwise. The overloads taking a JobSystem split batches larger
+ * than BatchTransformParallelSize between its threads, the others run on
+ * the calling thread.
+ */
+
+namespace nx
+{
+class JobSystem;
+
+/**
+ * @brief The number of elements above which the JobSystem overloads split a batch across threads.
+ */
+const std::size_t BatchTransformParallelSize = 32768;
+
+/**
+ * @brief Transforms an array of positions by a matrix (w = 1).
+ * @param matrix = The transformation matrix.
+ * @param input = The source positions.
+ * @param output = The destination positions, may be the same as input.
+ * @param count = The number of positions.
+ */
+void transformPositions(const mat4f& matrix, const vec3f* input, vec3f* output, std::size_t count);
+
+/**
+ * @brief Transforms an array of positions by a matrix (w = 1), on the threads of a job system.
+ * @param matrix = The transformation matrix.
+ * @param input = The source positions.
+ * @param output = The destination positions, may be the same as input.
+ * @param count = The number of positions.
+ * @param jobs = The job system to run on.
+ */
+void transformPositions(const mat4f& matrix, const vec3f* input, vec3f* output, std::size_t count, JobSystem& jobs);
+
+/**
+ * @brief Transforms an array of normals by a matrix, the translation is ignored (w = 0).
+ * @param matrix = The transformation matrix, use the inverse transpose for non uniform scales.
+ * @param input = The source normals.
+ * @param output = The destination normals, may be the same as input.
+ * @param count = The number of normals.
+ */
+void transformNormals(const mat4f& matrix, const vec3f* input, vec3f* output, std::size_t count);
+
+/**
+ * @brief Transforms an array of normals by a matrix, the translation is ignored (w = 0), on the threads of a job system.
+ * @param matrix = The transformation matrix, use the inverse transpose for non uniform scales.
+ * @param input = The source normals.
+ * @param output = The destination normals, may be the same as input.
+ * @param count = The number of normals.
+ * @param jobs = The job system to run on.
+ */
+void transformNormals(const mat4f& matrix, const vec3f* input, vec3f* output, std::size_t count, JobSystem& jobs);
+
+/**
+ * @brief Transforms an array of 4d vectors by a matrix.
+ * @param matrix = The transformation matrix.
+ * @param input = The source vectors.
+ * @param output = The destination vectors, may be the same as input.
+ * @param count = The number of vectors.
+ */
+void transformVectors(const mat4f& matrix, const vec4f* input, vec4f* output, std::size_t count);
+
+/**
+ * @brief Transforms an array of 4d vectors by a matrix, on the threads of a job system.
+ * @param matrix = The transformation matrix.
+ * @param input = The source vectors.
+ * @param output = The destination vectors, may be the same as input.
+ * @param count = The number of vectors.
+ * @param jobs = The job system to run on.
+ */
+void transformVectors(const mat4f& matrix, const vec4f* input, vec4f* output, std::size_t count, JobSystem& jobs);
+
+/**
+ * @brief Transforms positions stored as separate x, y and z arrays (w = 1).
+ * @param matrix = The transformation matrix.
+ * @param inputX = The source x coordinates.
+ * @param inputY = The source y coordinates.
+ * @param inputZ = The source z coordinates.
+ * @param outputX = The destination x coordinates.
+ * @param outputY = The destination y coordinates.
+ * @param outputZ = The destination z coordinates.
+ * @param count = The number of positions.
+ */
+void transformPositions(const mat4f& matrix,
+                        const float* inputX, const float* inputY, const float* inputZ,
+                        float* outputX, float* outputY, float* outputZ,
+                        std::size_t count);
+
+/**
+ * @brief Transforms positions stored as separate x, y and z arrays (w = 1), on the threads of a job system.
+ * @param matrix = The transformation matrix.
+ * @param inputX = The source x coordinates.
+ * @param inputY = The source y coordinates.
+ * @param inputZ = The source z coordinates.
+ * @param outputX = The destination x coordinates.
+ * @param outputY = The destination y coordinates.
+ * @param outputZ = The destination z coordinates.
+ * @param count = The number of positions.
+ * @param jobs = The job system to run on.
+ */
+void transformPositions(const mat4f& matrix,
+                        const float* inputX, const float* inputY, const float* inputZ,
+                        float* outputX, float* outputY, float* outputZ,
+                        std::size_t count, JobSystem& jobs);
+
+/**
+ * @brief Transforms normals stored as separate x, y and z arrays (w = 0).
+ * @param matrix = The transformation matrix.
+ * @param inputX = The source x coordinates.
+ * @param inputY = The source y coordinates.
+ * @param inputZ = The source z coordinates.
+ * @param outputX = The destination x coordinates.
+ * @param outputY = The destination y coordinates.
+ * @param outputZ = The destination z coordinates.
+ * @param count = The number of normals.
+ */
+void transformNormals(const mat4f& matrix,
+                      const float* inputX, const float* inputY, const float* inputZ,
+                      float* outputX, float* outputY, float* outputZ,
+                      std::size_t count);
+
+/**
+ * @brief Transforms normals stored as separate x, y and z arrays (w = 0), on the threads of a job system.
+ * @param matrix = The transformation matrix.
+ * @param inputX = The source x coordinates.
+ * @param inputY = The source y coordinates.
+ * @param inputZ = The source z coordinates.
+ * @param outputX = The destination x coordinates.
+ * @param outputY = The destination y coordinates.
+ * @param outputZ = The destination z coordinates.
+ * @param count = The number of normals.
+ * @param jobs = The job system to run on.
+ */
+void transformNormals(const mat4f& matrix,
+                      const float* inputX, const float* inputY, const float* inputZ,
+                      float* outputX, float* outputY, float* outputZ,
+                      std::size_t count, JobSystem& jobs);
+
+/**
+ * @brief Transforms positions embedded in interleaved structures, like Vertex3d::position.
+ * @param matrix = The transformation matrix.
+ * @param input = Pointer to the first source position.
+ * @param inputStride = The distance in bytes between two source positions.
+ * @param output = Pointer to the first destination position.
+ * @param outputStride = The distance in bytes between two destination positions.
+ * @param count = The number of positions.
+ */
+void transformPositions(const mat4f& matrix,
+                        const void* input, std::size_t inputStride,
+                        void* output, std::size_t outputStride,
+                        std::size_t count);
+
+/**
+ * @brief Transforms positions embedded in interleaved structures, like Vertex3d::position, on the threads of a job system.
+ * @param matrix = The transformation matrix.
+ * @param input = Pointer to the first source position.
+ * @param inputStride = The distance in bytes between two source positions.
+ * @param output = Pointer to the first destination position.
+ * @param outputStride = The distance in bytes between two destination positions.
+ * @param count = The number of positions.
+ * @param jobs = The job system to run on.
+ */
+void transformPositions(const mat4f& matrix,
+                        const void* input, std::size_t inputStride,
+                        void* output, std::size_t outputStride,
+                        std::size_t count, JobSystem& jobs);
+
+/**
+ * @brief Transforms normals embedded in interleaved structures, like Vertex3d::normal.
+ * @param matrix = The transformation matrix.
+ * @param input = Pointer to the first source normal.
+ * @param inputStride = The distance in bytes between two source normals.
+ * @param output = Pointer to the first destination normal.
+ * @param outputStride = The distance in bytes between two destination normals.
+ * @param count = The number of normals.
+ */
+void transformNormals(const mat4f& matrix,
+                      const void* input, std::size_t inputStride,
+                      void* output, std::size_t outputStride,
+                      std::size_t count);
+
+/**
+ * @brief Transforms normals embedded in interleaved structures, like Vertex3d::normal, on the threads of a job system.
+ * @param matrix = The transformation matrix.
+ * @param input = Pointer to the first source normal.
+ * @param inputStride = The distance in bytes between two source normals.
+ * @param output = Pointer to the first destination normal.
+ * @param outputStride = The distance in bytes between two destination normals.
+ * @param count = The number of normals.
+ * @param jobs = The job system to run on.
+ */
+void transformNormals(const mat4f& matrix,
+                      const void* input, std::size_t inputStride,
+                      void* output, std::size_t outputStride,
+                      std::size_t count, JobSystem& jobs);
+
+/**
+ * @brief Transforms an array of oriented boxes, as OBB::transform.
+ * @param matrix = The transformation matrix, made of rotations, translations and scales.
+ * @param input = The source boxes.
+ * @param output = The destination boxes, may be the same as input.
+ * @param count = The number of boxes.
+ */
+void transformBoxes(const mat4f& matrix, const OBB* input, OBB* output, std::size_t count);
+
+/**
+ * @brief Transforms an array of oriented boxes, as OBB::transform, on the threads of a job system.
+ * @param matrix = The transformation matrix, made of rotations, translations and scales.
+ * @param input = The source boxes.
+ * @param output = The destination boxes, may be the same as input.
+ * @param count = The number of boxes.
+ * @param jobs = The job system to run on.
+ */
+void transformBoxes(const mat4f& matrix, const OBB* input, OBB* output, std::size_t count, JobSystem& jobs);
+
+} // namespace nx
+
+#endif // BATCHTRANSFORM_H_INCLUDE
@@ -0,0 +1,210 @@
+#ifndef BVH_H_INCLUDE
+#define BVH_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/math/vec3.h>
+#include <nex/math/aabb.h>
+#include <nex/math/ray.h>
+
+// Standard includes.
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace nx
+{
+class Frustum;
+class Sphere;
+class JobSystem;
+
+/**
+ * @brief The number of primitives above which a BVH build given a JobSystem splits subtrees across threads.
+ */
+const std::size_t BVHParallelBuildSize = 16384;
+
+/**
+ * @brief The deepest a BVH can be, traversal stacks are sized on it.
+ */
+const std::size_t BVHMaxDepth = 64;
+
+/**
+ * @brief A node of a BVH, 32 bytes so two siblings share a cache line.
+ */
+struct BVHNode
+{
+    /**
+     * @brief The minimum corner of the node bounds.
+     */
+    float min[3];
+
+    /**
+     * @brief Inner nodes: index of the left child, the right child follows it.
+     * Leaves: index of the first primitive in BVH::getIndices.
+     */
+    uint32 first;
+
+    /**
+     * @brief The maximum corner of the node bounds.
+     */
+    float max[3];
+
+    /**
+     * @brief The number of primitives in a leaf, 0 for inner nodes.
+     */
+    uint32 count;
+
+    bool isLeaf() const { return count != 0; }
+};
+
+/**
+ * @brief The result of a BVH ray cast.
+ */
+struct BVHHit
+{
+    /**
+     * @brief The index of the primitive that was hit, as passed to BVH::build.
+     */
+    uint32 index;
+
+    /**
+     * @brief The distance along the ray, in units of the ray direction.
+     */
+    float distance;
+};
+
+/**
+ * Static bounding volume hierarchy over axis aligned boxes, built with a
+ * binned surface area heuristic. Nodes live in one cache line aligned array,
+ * the root is node 0 and every pair of siblings starts on a cache line.
+ */
+class BVH
+{
+public:
+
+    /**
+     * @brief Constructs an empty hierarchy.
+     */
+    BVH();
+
+    BVH(const BVH& other);
+    BVH& operator=(const BVH& other);
+    ~BVH();
+
+    /**
+     * @brief Rebuilds the hierarchy over a set of boxes.
+     * @param boxes = The primitive bounds, queries report indices into this array.
+     * @param count = The number of boxes.
+     * @param maxLeafSize = The largest number of primitives a leaf may hold.
+     */
+    void build(const AABB* boxes, std::size_t count, uint32 maxLeafSize = 4);
+
+    /**
+     * @brief Rebuilds the hierarchy over a set of boxes, on the threads of a job system.
+     * @param boxes = The primitive bounds, queries report indices into this array.
+     * @param count = The number of boxes.
+     * @param maxLeafSize = The largest number of primitives a leaf may hold.
+     * @param jobs = The job system to run on.
+     */
+    void build(const AABB* boxes, std::size_t count, uint32 maxLeafSize, JobSystem& jobs);
+
+    /**
+     * @brief Rebuilds the hierarchy over a set of boxes.
+     * @param boxes = The primitive bounds, queries report indices into this vector.
+     * @param maxLeafSize = The largest number of primitives a leaf may hold.
+     */
+    void build(const std::vector<AABB>& boxes, uint32 maxLeafSize = 4);
+
+    /**
+     * @brief Rebuilds the hierarchy over a set of boxes, on the threads of a job system.
+     * @param boxes = The primitive bounds, queries report indices into this vector.
+     * @param maxLeafSize = The largest number of primitives a leaf may hold.
+     * @param jobs = The job system to run on.
+     */
+    void build(const std::vector<AABB>& boxes, uint32 maxLeafSize, JobSystem& jobs);
+
+    /**
+     * @brief Removes every node and primitive.
+     */
+    void clear();
+
+    /**
+     * @brief Finds the closest primitive box hit by a ray.
+     * @param ray = The ray to cast.
+     * @param hit = Receives the closest hit, untouched if nothing is hit.
+     * @param maxDistance = Hits farther than this are ignored.
+     * @return true if a box was hit.
+     */
+    bool raycast(const Ray& ray, BVHHit& hit, float maxDistance = std::numeric_limits<float>::max()) const;
+
+    /**
+     * @brief Finds the closest primitive hit by a ray, using a custom primitive test.
+     * @param ray = The ray to cast.
+     * @param intersector = Callable bool(uint32 index, float& distance), returns true and the distance
+     * along the ray when the primitive is hit.
+     * @param hit = Receives the closest hit, untouched if nothing is hit.
+     * @param maxDistance = Hits farther than this are ignored.
+     * @return true if a primitive was hit.
+     */
+    template <typename Intersector>
+    bool raycast(const Ray& ray, Intersector intersector, BVHHit& hit, float maxDistance = std::numeric_limits<float>::max()) const;
+
+    /**
+     * @brief Collects every primitive whose box intersects a frustum.
+     * @param frustum = The frustum to test.
+     * @param results = The primitive indices are appended to it.
+     */
+    void query(const Frustum& frustum, std::vector<uint32>& results) const;
+
+    /**
+     * @brief Collects every primitive whose box overlaps a sphere.
+     * @param sphere = The sphere to test.
+     * @param results = The primitive indices are appended to it.
+     */
+    void query(const Sphere& sphere, std::vector<uint32>& results) const;
+
+    /**
+     * @brief Collects every primitive whose box overlaps another box.
+     * @param box = The box to test.
+     * @param results = The primitive indices are appended to it.
+     */
+    void query(const AABB& box, std::vector<uint32>& results) const;
+
+    /**
+     * @brief Get the bounds of the whole hierarchy.
+     * @return the root bounds, an empty box if the hierarchy is empty.
+     */
+    AABB getBounds() const;
+
+    const BVHNode* getNodes() const { return mNodes; }
+    std::size_t getNodeCount() const { return mNodeCount; }
+    const uint32* getIndices() const { return mIndices.empty() ? 0 : &mIndices[0]; }
+    std::size_t size() const { return mIndices.size(); }
+    bool empty() const { return mIndices.empty(); }
+
+private:
+
+    void reserveNodes(std::size_t capacity);
+
+    // Runs on the calling thread when jobs is 0.
+    void buildTree(const AABB* boxes, std::size_t count, uint32 maxLeafSize, JobSystem* jobs);
+
+    BVHNode* mNodes;
+    std::size_t mNodeCount;
+    std::size_t mNodeCapacity;
+
+    // Leaves reference ranges of this array, it maps back to the build order.
+    std::vector<uint32> mIndices;
+
+    // Primitive bounds in build order.
+    std::vector<vec3f> mMin;
+    std::vector<vec3f> mMax;
+};
+
+#include <nex/math/bvh.inl>
+
+} // namespace nx
+
+#endif // BVH_H_INCLUDE
@@ -0,0 +1,150 @@
+namespace priv
+{
+
+/**
+ * @brief A ray prepared for repeated slab tests.
+ */
+struct BVHRay
+{
+    explicit BVHRay(const Ray& ray)
+    {
+        const float directions[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+
+        origin[0] = ray.position.x;
+        origin[1] = ray.position.y;
+        origin[2] = ray.position.z;
+
+        // Tiny directions keep a huge but finite inverse so an origin lying on
+        // a slab gives 0 instead of 0 * infinity.
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float direction = std::fabs(directions[axis]) < 1e-20f ? (directions[axis] < 0.0f ? -1e-20f : 1e-20f) : directions[axis];
+            inverseDirection[axis] = 1.0f / direction;
+        }
+    }
+
+    /**
+     * @brief Slab test against a box.
+     * @param min = The minimum corner.
+     * @param max = The maximum corner.
+     * @param maxDistance = The far end of the ray.
+     * @param entry = Receives the entry distance, 0 when the origin is inside.
+     * @return true if the ray hits the box before maxDistance.
+     */
+    bool intersects(const float* min, const float* max, float maxDistance, float& entry) const
+    {
+        float near = 0.0f;
+        float far = maxDistance;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float t0 = (min[axis] - origin[axis]) * inverseDirection[axis];
+            float t1 = (max[axis] - origin[axis]) * inverseDirection[axis];
+
+            if (t0 > t1)
+                std::swap(t0, t1);
+
+            near = t0 > near ? t0 : near;
+            far = t1 < far ? t1 : far;
+        }
+
+        entry = near;
+        return near <= far;
+    }
+
+    float origin[3];
+    float inverseDirection[3];
+};
+
+} // namespace priv
+
+template <typename Intersector>
+bool BVH::raycast(const Ray& ray, Intersector intersector, BVHHit& hit, float maxDistance) const
+{
+    if (mNodeCount == 0)
+        return false;
+
+    struct Entry
+    {
+        uint32 node;
+        float distance;
+    };
+
+    const priv::BVHRay prepared(ray);
+
+    float closest = maxDistance;
+    bool found = false;
+
+    float entry;
+    if (!prepared.intersects(mNodes[0].min, mNodes[0].max, closest, entry))
+        return false;
+
+    Entry stack[BVHMaxDepth];
+    std::size_t top = 0;
+    stack[top].node = 0;
+    stack[top].distance = entry;
+    ++top;
+
+    while (top > 0)
+    {
+        const Entry current = stack[--top];
+
+        // A closer hit was found since this node was pushed.
+        if (current.distance > closest)
+            continue;
+
+        const BVHNode& node = mNodes[current.node];
+
+        if (node.isLeaf())
+        {
+            for (uint32 i = node.first; i < node.first + node.count; ++i)
+            {
+                float distance;
+                if (intersector(mIndices[i], distance) && distance >= 0.0f && distance <= closest)
+                {
+                    closest = distance;
+                    hit.index = mIndices[i];
+                    hit.distance = distance;
+                    found = true;
+                }
+            }
+            continue;
+        }
+
+        const BVHNode& left = mNodes[node.first];
+        const BVHNode& right = mNodes[node.first + 1];
+
+        float leftDistance;
+        float rightDistance;
+        const bool hitLeft = prepared.intersects(left.min, left.max, closest, leftDistance);
+        const bool hitRight = prepared.intersects(right.min, right.max, closest, rightDistance);
+
+        // Push the far child first so the near one is visited next.
+        if (hitLeft && hitRight)
+        {
+            const bool leftFirst = leftDistance <= rightDistance;
+
+            stack[top].node = leftFirst ? node.first + 1 : node.first;
+            stack[top].distance = leftFirst ? rightDistance : leftDistance;
+            ++top;
+
+            stack[top].node = leftFirst ? node.first : node.first + 1;
+            stack[top].distance = leftFirst ? leftDistance : rightDistance;
+            ++top;
+        }
+        else if (hitLeft)
+        {
+            stack[top].node = node.first;
+            stack[top].distance = leftDistance;
+            ++top;
+        }
+        else if (hitRight)
+        {
+            stack[top].node = node.first + 1;
+            stack[top].distance = rightDistance;
+            ++top;
+        }
+    }
+
+    return found;
+}
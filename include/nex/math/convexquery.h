@@ -0,0 +1,285 @@
+#ifndef CONVEXQUERY_H_INCLUDE
+#define CONVEXQUERY_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/math/vec3.h>
+#include <nex/math/aabb.h>
+#include <nex/math/obb.h>
+#include <nex/math/sphere.h>
+#include <nex/math/frustum.h>
+
+// Standard includes.
+#include <cstddef>
+
+namespace nx
+{
+
+/**
+ * @brief The most GJK iterations a ConvexQuery runs before settling for its current answer.
+ */
+const int32 ConvexQueryMaxIterations = 64;
+
+/**
+ * @brief Support function of a sphere.
+ */
+struct SphereSupport
+{
+    explicit SphereSupport(const Sphere& sphere) : center(sphere.center), radius(sphere.radius) { }
+
+    /**
+     * @brief Get the point of the shape furthest along a direction.
+     * @param direction = The direction, does not need to be normalized.
+     * @return the support point.
+     */
+    vec3f support(const vec3f& direction) const;
+
+    vec3f center;
+    float radius;
+};
+
+/**
+ * @brief Support function of an axis aligned box.
+ */
+struct AABBSupport
+{
+    explicit AABBSupport(const AABB& box) : min(box.min), max(box.max) { }
+
+    /**
+     * @brief Get the point of the shape furthest along a direction.
+     * @param direction = The direction, does not need to be normalized.
+     * @return the support point.
+     */
+    vec3f support(const vec3f& direction) const
+    {
+        return vec3f(direction.x < 0.0f ? min.x : max.x,
+                     direction.y < 0.0f ? min.y : max.y,
+                     direction.z < 0.0f ? min.z : max.z);
+    }
+
+    vec3f min;
+    vec3f max;
+};
+
+/**
+ * @brief Support function of an oriented box.
+ */
+struct OBBSupport
+{
+    explicit OBBSupport(const OBB& box) : box(box) { }
+
+    /**
+     * @brief Get the point of the shape furthest along a direction.
+     * @param direction = The direction, does not need to be normalized.
+     * @return the support point.
+     */
+    vec3f support(const vec3f& direction) const
+    {
+        return box.center +
+               box.axes[0] * (vec3f::dot(direction, box.axes[0]) < 0.0f ? -box.halfExtents.x : box.halfExtents.x) +
+               box.axes[1] * (vec3f::dot(direction, box.axes[1]) < 0.0f ? -box.halfExtents.y : box.halfExtents.y) +
+               box.axes[2] * (vec3f::dot(direction, box.axes[2]) < 0.0f ? -box.halfExtents.z : box.halfExtents.z);
+    }
+
+    OBB box;
+};
+
+/**
+ * @brief Support function of a frustum, the frustum must outlive it.
+ */
+struct FrustumSupport
+{
+    explicit FrustumSupport(const Frustum& frustum) : frustum(&frustum) { }
+
+    /**
+     * @brief Get the point of the shape furthest along a direction.
+     * @param direction = The direction, does not need to be normalized.
+     * @return the support point.
+     */
+    vec3f support(const vec3f& direction) const { return frustum->supportMapping(direction); }
+
+    const Frustum* frustum;
+};
+
+/**
+ * @brief Support function of a capsule, a segment grown by a radius.
+ */
+struct CapsuleSupport
+{
+    CapsuleSupport(const vec3f& start, const vec3f& end, float radius) : start(start), end(end), radius(radius) { }
+
+    /**
+     * @brief Get the point of the shape furthest along a direction.
+     * @param direction = The direction, does not need to be normalized.
+     * @return the support point.
+     */
+    vec3f support(const vec3f& direction) const;
+
+    vec3f start;
+    vec3f end;
+    float radius;
+};
+
+/**
+ * @brief Support function of the convex hull of a point cloud, the points must outlive it.
+ */
+struct HullSupport
+{
+    HullSupport(const vec3f* points, std::size_t count) : points(points), count(count) { }
+
+    /**
+     * @brief Get the point of the shape furthest along a direction.
+     * @param direction = The direction, does not need to be normalized.
+     * @return the support point.
+     */
+    vec3f support(const vec3f& direction) const;
+
+    const vec3f* points;
+    std::size_t count;
+};
+
+/**
+ * @brief The simplex a query ended with, kept per pair of shapes between frames.
+ *
+ * The search directions that produced the simplex are stored rather than the
+ * points, so the next query rebuilds the simplex from the moved shapes and
+ * usually converges in one or two iterations.
+ */
+struct ConvexCache
+{
+    ConvexCache() : count(0) { }
+
+    /**
+     * @brief Forgets the simplex, the next query starts from scratch.
+     */
+    void reset() { count = 0; }
+
+    /**
+     * @brief The search directions of the simplex vertices.
+     */
+    vec3f directions[4];
+
+    /**
+     * @brief The number of vertices, 0 for an empty cache.
+     */
+    int32 count;
+};
+
+/**
+ * @brief The result of a ConvexQuery.
+ */
+struct ConvexResult
+{
+    /**
+     * @brief true if the shapes overlap.
+     */
+    bool intersecting;
+
+    /**
+     * @brief The distance between the shapes, 0 when they overlap.
+     */
+    float distance;
+
+    /**
+     * @brief The penetration depth found by EPA, 0 when the shapes are apart.
+     */
+    float depth;
+
+    /**
+     * @brief Unit vector from the first shape towards the second one. When
+     * they overlap, moving the second shape by normal * depth separates them.
+     */
+    vec3f normal;
+
+    /**
+     * @brief The point of the first shape closest to the second one, or
+     * deepest inside it when they overlap.
+     */
+    vec3f pointA;
+
+    /**
+     * @brief The point of the second shape closest to the first one, or
+     * deepest inside it when they overlap.
+     */
+    vec3f pointB;
+
+    /**
+     * @brief The number of GJK iterations that were run.
+     */
+    int32 iterations;
+};
+
+namespace priv
+{
+
+/**
+ * @brief Type erased support function, lets the GJK and EPA code live in one translation unit.
+ */
+struct SupportFunction
+{
+    template <typename Shape>
+    explicit SupportFunction(const Shape& shape) :
+        shape(&shape),
+        function(&call<Shape>)
+    { }
+
+    vec3f operator()(const vec3f& direction) const { return function(shape, direction); }
+
+    template <typename Shape>
+    static vec3f call(const void* shape, const vec3f& direction)
+    {
+        return static_cast<const Shape*>(shape)->support(direction);
+    }
+
+    const void* shape;
+    vec3f (*function)(const void*, const vec3f&);
+};
+
+bool gjkIntersects(const SupportFunction& shapeA, const SupportFunction& shapeB, ConvexCache* cache);
+ConvexResult gjkQuery(const SupportFunction& shapeA, const SupportFunction& shapeB, ConvexCache* cache);
+
+} // namespace priv
+
+/**
+ * Narrowphase between any two convex shapes given by support functions.
+ *
+ * A shape is any type with a const support(direction) member returning the
+ * point furthest along the direction, such as SphereSupport, AABBSupport,
+ * OBBSupport, FrustumSupport, CapsuleSupport and HullSupport. GJK finds
+ * the distance and closest points of shapes that are apart, and EPA the
+ * penetration depth and normal of shapes that overlap.
+ */
+class ConvexQuery
+{
+public:
+
+    /**
+     * @brief Checks whether two shapes overlap, stops as soon as a separating direction is found.
+     * @param shapeA = The first shape.
+     * @param shapeB = The second shape.
+     * @param cache = Optional simplex of the previous query between the same shapes, updated on return.
+     * @return true if the shapes overlap.
+     */
+    template <typename ShapeA, typename ShapeB>
+    static bool intersects(const ShapeA& shapeA, const ShapeB& shapeB, ConvexCache* cache = 0)
+    {
+        return priv::gjkIntersects(priv::SupportFunction(shapeA), priv::SupportFunction(shapeB), cache);
+    }
+
+    /**
+     * @brief Computes the distance and closest points of two shapes, or their penetration when they overlap.
+     * @param shapeA = The first shape.
+     * @param shapeB = The second shape.
+     * @param cache = Optional simplex of the previous query between the same shapes, updated on return.
+     * @return the result.
+     */
+    template <typename ShapeA, typename ShapeB>
+    static ConvexResult query(const ShapeA& shapeA, const ShapeB& shapeB, ConvexCache* cache = 0)
+    {
+        return priv::gjkQuery(priv::SupportFunction(shapeA), priv::SupportFunction(shapeB), cache);
+    }
+};
+
+} // namespace nx
+
+#endif // CONVEXQUERY_H_INCLUDE
@@ -1,150 +1,294 @@
-#ifndef BOUNDINGFRUSTUM_H_INCLUDE
-#define BOUNDINGFRUSTUM_H_INCLUDE
-
-#include <nex/system/typedefs.h>
-#include <nex/math/vec3.h>
-#include <nex/math/matrix.h>
-#include <nex/math/gjk.h>
-#include <nex/math/plane.h>
-#include <nex/math/aabb.h>
-
-namespace nx
-{
-class Sphere;
-
-class Frustum
-{
-public:
-
-    Frustum();
-
-    /**
-     * @brief Specifies the total number of corners (8) in the BoundingFrustum.
-     */
-    const int CornerCount = 8;
-
-    /**
-     * @brief Bounding Frustum Plane Index
-     */
-    enum BFPlaneIndex {
-        NearPlaneIndex = 0,
-        FarPlaneIndex = 1,
-        LeftPlaneIndex = 2,
-        RightPlaneIndex = 3,
-        TopPlaneIndex = 4,
-        BottomPlaneIndex = 5
-    };
-
-    /**
-     * @brief Get the specified plane
-     * @param index = index of the plane to get.
-     * @return the specified plane.
-     */
-    const Plane getPlane(BFPlaneIndex index) const {
-        return mPlanes[index];
-    }
-
-    /**
-     * @brief Get a pointer to the current corner array.
-     * @return const pointer.
-     */
-    const vec3f* getCorners() const { return mCornerArray; }
-
-    /**
-     * @brief Get the current matrix.
-     * @return the matrix.
-     */
-    mat4f getMatrix() const { return mMatrix; }
-
-    /**
-     * @brief Checks whether the current BoundingFrustum intersects a BoundingBox.
-     * @param box = The BoundingBox to check for intersection with.
-     * @return true if the BoundingFrustum and BoundingBox intersect; false otherwise.
-     */
-    bool intersects(const AABB& box) const;
-
-    /**
-     * @brief Checks whether the current BoundingFrustum intersects the specified BoundingFrustum.
-     * @param frustum = The BoundingFrustum to check for intersection.
-     * @return the intersection result.
-     */
-    bool intersects(const Frustum& frustum) const;
-
-    /**
-     * @brief Checks whether the current BoundingFrustum intersects the specified BoundingSphere.
-     * @param sphere = The BoundingSphere to check for intersection with.
-     * @return true if the BoundingFrustum and BoundingSphere intersect; false otherwise.
-     */
-    bool intersects(const Sphere& sphere) const;
-
-    /**
-     * @brief Checks whether the current BoundingFrustum intersects a Ray.
-     * @param ray = The Ray to check for intersection with.
-     * @return Distance at which the ray intersects the BoundingFrustum or 0 if there is no intersection.
-     */
-    float intersects(const Ray& ray) const;
-
-    /**
-     * @brief Checks whether the current BoundingFrustum intersects the specified Plane.
-     * @param plane = The Plane to check for intersection.
-     * @return the itnersection type.
-     */
-    PlaneIntersectionType intersects(const Plane& plane) const;
-
-    /**
-     * @brief Checks whether the current BoundingFrustum contains the specified point.
-     * @param point = The point to check against the current BoundingFrustum.
-     * @return the containment type.
-     */
-    ContainmentType contains(const vec3f& point) const;
-
-    /**
-     * @brief Checks whether the current BoundingFrustum contains the specified BoundingBox.
-     * @param box = The BoundingBox to check against the current BoundingFrustum.
-     * @return the containment type.
-     */
-    ContainmentType contains(const AABB& box) const;
-
-    /**
-     * @brief Checks whether the current BoundingFrustum contains the specified BoundingFrustum.
-     * @param frustum = The BoundingFrustum to check against the current BoundingFrustum.
-     * @return the containment type.
-     */
-    ContainmentType contains(const Frustum& frustum) const;
-
-    /**
-     * @brief Checks whether the current BoundingFrustum contains the specified BoundingSphere.
-     * @param sphere = The BoundingSphere to check against the current BoundingFrustum.
-     * @return the containment type.
-     */
-    ContainmentType contains(const Sphere& sphere) const;
-
-    /**
-     * @brief Compute the bounding frustum from the given matrix.
-     * @param matrix = matrix to compute from.
-     */
-    void setMatrix(const mat4f& matrix);
-
-    /**
-     * @brief supportMapping
-     * @param vector
-     * @return
-     */
-    vec3f supportMapping(const vec3f vector) const;
-
-private:
-
-    const int NumPlanes = 6;
-
-    vec3f mCornerArray[8];
-
-    Plane mPlanes[6];
-
-    mat4f mMatrix;
-
-    mutable GJK mGJK;
-
-}; //class BoundingFrustum
-} //namespace nx
-
-#endif // BOUNDINGFRUSTUM_H_INCLUDE
+#ifndef BOUNDINGFRUSTUM_H_INCLUDE
+#define BOUNDINGFRUSTUM_H_INCLUDE
+
+#include <nex/system/typedefs.h>
+#include <nex/math/vec3.h>
+#include <nex/math/matrix.h>
+#include <nex/math/gjk.h>
+#include <nex/math/plane.h>
+#include <nex/math/aabb.h>
+#include <nex/math/vec3array.h>
+
+// Standard includes.
+#include <cstddef>
+
+namespace nx
+{
+class Sphere;
+class OBB;
+class JobSystem;
+
+/**
+ * @brief The number of objects above which the JobSystem overloads of Frustum::cullBoxes and cullSpheres
+ * split the work across threads.
+ */
+const std::size_t FrustumCullParallelSize = 16384;
+
+/**
+ * Every const query is reentrant, one Frustum can be shared by any number
+ * of threads as long as none of them calls setMatrix. The batch culls have an
+ * overload taking a JobSystem, which splits large batches between its threads.
+ */
+class Frustum
+{
+public:
+
+    Frustum();
+
+    /**
+     * @brief Specifies the total number of corners (8) in the BoundingFrustum.
+     */
+    const int CornerCount = 8;
+
+    /**
+     * @brief Bounding Frustum Plane Index
+     */
+    enum BFPlaneIndex {
+        NearPlaneIndex = 0,
+        FarPlaneIndex = 1,
+        LeftPlaneIndex = 2,
+        RightPlaneIndex = 3,
+        TopPlaneIndex = 4,
+        BottomPlaneIndex = 5
+    };
+
+    /**
+     * @brief Get the specified plane
+     * @param index = index of the plane to get.
+     * @return the specified plane.
+     */
+    const Plane getPlane(BFPlaneIndex index) const {
+        return mPlanes[index];
+    }
+
+    /**
+     * @brief Get a pointer to the current corner array.
+     * @return const pointer.
+     */
+    const vec3f* getCorners() const { return mCornerArray; }
+
+    /**
+     * @brief Get the current matrix.
+     * @return the matrix.
+     */
+    mat4f getMatrix() const { return mMatrix; }
+
+    /**
+     * @brief Checks whether the current BoundingFrustum intersects a BoundingBox.
+     * Plane test, a box near a corner of the frustum may be reported as intersecting.
+     * @param box = The BoundingBox to check for intersection with.
+     * @return true if the BoundingFrustum and BoundingBox intersect; false otherwise.
+     */
+    bool intersects(const AABB& box) const;
+
+    /**
+     * @brief Checks whether the current BoundingFrustum intersects an OBB.
+     * Plane test, a box near a corner of the frustum may be reported as intersecting.
+     * @param box = The OBB to check for intersection with.
+     * @return true if the BoundingFrustum and OBB intersect; false otherwise.
+     */
+    bool intersects(const OBB& box) const;
+
+    /**
+     * @brief Checks whether the current BoundingFrustum intersects the specified BoundingFrustum.
+     * @param frustum = The BoundingFrustum to check for intersection.
+     * @return the intersection result.
+     */
+    bool intersects(const Frustum& frustum) const;
+
+    /**
+     * @brief Checks whether the current BoundingFrustum intersects the specified BoundingFrustum.
+     * @param frustum = The BoundingFrustum to check for intersection.
+     * @param gjk = Caller owned working set for the GJK iterations.
+     * @return the intersection result.
+     */
+    bool intersects(const Frustum& frustum, GJK& gjk) const;
+
+    /**
+     * @brief Checks whether the current BoundingFrustum intersects the specified BoundingSphere.
+     * Plane test, a sphere near a corner of the frustum may be reported as intersecting.
+     * @param sphere = The BoundingSphere to check for intersection with.
+     * @return true if the BoundingFrustum and BoundingSphere intersect; false otherwise.
+     */
+    bool intersects(const Sphere& sphere) const;
+
+    /**
+     * @brief Checks whether the current BoundingFrustum intersects a Ray.
+     * @param ray = The Ray to check for intersection with.
+     * @return Distance at which the ray intersects the BoundingFrustum or 0 if there is no intersection.
+     */
+    float intersects(const Ray& ray) const;
+
+    /**
+     * @brief Checks whether the current BoundingFrustum intersects the specified Plane.
+     * @param plane = The Plane to check for intersection.
+     * @return the itnersection type.
+     */
+    PlaneIntersectionType intersects(const Plane& plane) const;
+
+    /**
+     * @brief Checks whether the current BoundingFrustum contains the specified point.
+     * @param point = The point to check against the current BoundingFrustum.
+     * @return the containment type.
+     */
+    ContainmentType contains(const vec3f& point) const;
+
+    /**
+     * @brief Checks whether the current BoundingFrustum contains the specified BoundingBox.
+     * @param box = The BoundingBox to check against the current BoundingFrustum.
+     * @return the containment type.
+     */
+    ContainmentType contains(const AABB& box) const;
+
+    /**
+     * @brief Checks whether the current BoundingFrustum contains the specified OBB.
+     * @param box = The OBB to check against the current BoundingFrustum.
+     * @return the containment type.
+     */
+    ContainmentType contains(const OBB& box) const;
+
+    /**
+     * @brief Checks whether the current BoundingFrustum contains the specified BoundingFrustum.
+     * @param frustum = The BoundingFrustum to check against the current BoundingFrustum.
+     * @return the containment type.
+     */
+    ContainmentType contains(const Frustum& frustum) const;
+
+    /**
+     * @brief Checks whether the current BoundingFrustum contains the specified BoundingSphere.
+     * @param sphere = The BoundingSphere to check against the current BoundingFrustum.
+     * @return the containment type.
+     */
+    ContainmentType contains(const Sphere& sphere) const;
+
+    /**
+     * @brief Culls a batch of boxes stored as separate arrays, several boxes are tested per instruction.
+     * @param minX = The minimum x of every box.
+     * @param minY = The minimum y of every box.
+     * @param minZ = The minimum z of every box.
+     * @param maxX = The maximum x of every box.
+     * @param maxY = The maximum y of every box.
+     * @param maxZ = The maximum z of every box.
+     * @param count = The number of boxes.
+     * @param visibility = Receives one bit per box, bit (i % 32) of visibility[i / 32] is set when box i
+     * is at least partially inside. Must hold (count + 31) / 32 words.
+     * @param lastPlane = Optional per box cache of the plane that rejected it in the previous call, tested
+     * first so boxes that stay outside are rejected by a single plane. Values above 5 mean no plane, may be 0.
+     */
+    void cullBoxes(const float* minX, const float* minY, const float* minZ,
+                   const float* maxX, const float* maxY, const float* maxZ,
+                   std::size_t count, uint32* visibility, uint8* lastPlane = 0) const;
+
+    /**
+     * @brief Culls a batch of boxes stored as separate arrays, on the threads of a job system.
+     * @param minX = The minimum x of every box.
+     * @param minY = The minimum y of every box.
+     * @param minZ = The minimum z of every box.
+     * @param maxX = The maximum x of every box.
+     * @param maxY = The maximum y of every box.
+     * @param maxZ = The maximum z of every box.
+     * @param count = The number of boxes.
+     * @param visibility = Receives one bit per box, see the serial overload.
+     * @param lastPlane = Optional plane coherency cache, see the serial overload.
+     * @param jobs = The job system to run on.
+     */
+    void cullBoxes(const float* minX, const float* minY, const float* minZ,
+                   const float* maxX, const float* maxY, const float* maxZ,
+                   std::size_t count, uint32* visibility, uint8* lastPlane, JobSystem& jobs) const;
+
+    /**
+     * @brief Culls a batch of boxes stored as two arrays of corners.
+     * @param min = The minimum corner of every box.
+     * @param max = The maximum corner of every box, same size as min.
+     * @param visibility = Receives one bit per box, see the float array overload.
+     * @param lastPlane = Optional plane coherency cache, see the float array overload.
+     */
+    void cullBoxes(const Vec3Array& min, const Vec3Array& max, uint32* visibility, uint8* lastPlane = 0) const;
+
+    /**
+     * @brief Culls a batch of boxes stored as two arrays of corners, on the threads of a job system.
+     * @param min = The minimum corner of every box.
+     * @param max = The maximum corner of every box, same size as min.
+     * @param visibility = Receives one bit per box, see the float array overload.
+     * @param lastPlane = Optional plane coherency cache, see the float array overload.
+     * @param jobs = The job system to run on.
+     */
+    void cullBoxes(const Vec3Array& min, const Vec3Array& max, uint32* visibility, uint8* lastPlane, JobSystem& jobs) const;
+
+    /**
+     * @brief Culls a batch of spheres stored as separate arrays, several spheres are tested per instruction.
+     * @param centerX = The center x of every sphere.
+     * @param centerY = The center y of every sphere.
+     * @param centerZ = The center z of every sphere.
+     * @param radius = The radius of every sphere.
+     * @param count = The number of spheres.
+     * @param visibility = Receives one bit per sphere, see cullBoxes.
+     * @param lastPlane = Optional plane coherency cache, see cullBoxes.
+     */
+    void cullSpheres(const float* centerX, const float* centerY, const float* centerZ, const float* radius,
+                     std::size_t count, uint32* visibility, uint8* lastPlane = 0) const;
+
+    /**
+     * @brief Culls a batch of spheres stored as separate arrays, on the threads of a job system.
+     * @param centerX = The center x of every sphere.
+     * @param centerY = The center y of every sphere.
+     * @param centerZ = The center z of every sphere.
+     * @param radius = The radius of every sphere.
+     * @param count = The number of spheres.
+     * @param visibility = Receives one bit per sphere, see cullBoxes.
+     * @param lastPlane = Optional plane coherency cache, see cullBoxes.
+     * @param jobs = The job system to run on.
+     */
+    void cullSpheres(const float* centerX, const float* centerY, const float* centerZ, const float* radius,
+                     std::size_t count, uint32* visibility, uint8* lastPlane, JobSystem& jobs) const;
+
+    /**
+     * @brief Culls a batch of spheres.
+     * @param centers = The center of every sphere.
+     * @param radius = The radius of every sphere, must hold centers.size() floats.
+     * @param visibility = Receives one bit per sphere, see cullBoxes.
+     * @param lastPlane = Optional plane coherency cache, see cullBoxes.
+     */
+    void cullSpheres(const Vec3Array& centers, const float* radius, uint32* visibility, uint8* lastPlane = 0) const;
+
+    /**
+     * @brief Culls a batch of spheres, on the threads of a job system.
+     * @param centers = The center of every sphere.
+     * @param radius = The radius of every sphere, must hold centers.size() floats.
+     * @param visibility = Receives one bit per sphere, see cullBoxes.
+     * @param lastPlane = Optional plane coherency cache, see cullBoxes.
+     * @param jobs = The job system to run on.
+     */
+    void cullSpheres(const Vec3Array& centers, const float* radius, uint32* visibility, uint8* lastPlane, JobSystem& jobs) const;
+
+    /**
+     * @brief Compute the bounding frustum from the given matrix.
+     * @param matrix = matrix to compute from.
+     */
+    void setMatrix(const mat4f& matrix);
+
+    /**
+     * @brief supportMapping
+     * @param vector
+     * @return
+     */
+    vec3f supportMapping(const vec3f vector) const;
+
+private:
+
+    const int NumPlanes = 6;
+
+    vec3f mCornerArray[8];
+
+    Plane mPlanes[6];
+
+    // The planes as separate x, y, z and distance rows, padded to 8 with
+    // planes that contain everything so one AVX register holds all of them.
+    float mPlaneLanes[4][8];
+
+    mat4f mMatrix;
+
+}; //class BoundingFrustum
+} //namespace nx
+
+#endif // BOUNDINGFRUSTUM_H_INCLUDE
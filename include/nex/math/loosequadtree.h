@@ -0,0 +1,183 @@
+#ifndef LOOSEQUADTREE_H_INCLUDE
+#define LOOSEQUADTREE_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/math/vec2.h>
+#include <nex/math/rect.h>
+#include <nex/math/circle.h>
+
+// Standard includes.
+#include <cstddef>
+#include <vector>
+
+namespace nx
+{
+
+/**
+ * @brief The default depth of a LooseQuadtree.
+ */
+const int32 LooseQuadtreeDepth = 6;
+
+/**
+ * @brief The deepest level a LooseQuadtree allocates, 4^8 leaves.
+ */
+const int32 LooseQuadtreeMaxDepth = 8;
+
+/**
+ * Loose quadtree for 2D items of mixed sizes.
+ *
+ * Every node is allowed to hold items that stick out of it by half its size,
+ * so an item goes straight to the level that matches its size and to the
+ * node under its center, without walking the tree. Moving an item only
+ * touches the tree when its center changes node. All levels are allocated
+ * up front as flat grids, queries visit the nodes whose loose bounds overlap
+ * and skip the subtrees that are empty.
+ *
+ * Items whose center lies outside of the world are kept in the root.
+ *
+ * Queries write the matching handles into a caller buffer and return the
+ * number of matches, which may be larger than the buffer.
+ */
+class LooseQuadtree
+{
+public:
+
+    /**
+     * @brief The handle value that never refers to an item.
+     */
+    static const uint32 NullHandle = 0xFFFFFFFF;
+
+    /**
+     * @brief Constructs an empty tree.
+     * @param world = The area covered by the root node.
+     * @param depth = The number of levels under the root, clamped to LooseQuadtreeMaxDepth.
+     */
+    explicit LooseQuadtree(const rectf& world, int32 depth = LooseQuadtreeDepth);
+
+    /**
+     * @brief Adds an item.
+     * @param bounds = The bounds of the item.
+     * @param userData = Value returned by getUserData.
+     * @return the item handle, valid until it is removed.
+     */
+    uint32 insert(const rectf& bounds, void* userData = 0);
+
+    /**
+     * @brief Removes an item, its handle may be reused by a later insert.
+     * @param handle = The item to remove.
+     */
+    void remove(uint32 handle);
+
+    /**
+     * @brief Changes the bounds of an item, the tree is only touched if it changed node.
+     * @param handle = The item to update.
+     * @param bounds = The new bounds.
+     */
+    void update(uint32 handle, const rectf& bounds);
+
+    /**
+     * @brief Get the bounds of an item.
+     * @param handle = The item.
+     * @return the bounds.
+     */
+    const rectf& getBounds(uint32 handle) const { return mItems[handle].bounds; }
+
+    /**
+     * @brief Get the user data of an item.
+     * @param handle = The item.
+     * @return the value passed to insert.
+     */
+    void* getUserData(uint32 handle) const { return mItems[handle].userData; }
+
+    /**
+     * @brief Finds the items overlapping a region, with the rules of Rect::intersects.
+     * @param region = The region to test.
+     * @param results = Receives up to capacity handles.
+     * @param capacity = The size of results.
+     * @return the number of matching items, results holds the first capacity of them.
+     */
+    std::size_t query(const rectf& region, uint32* results, std::size_t capacity) const;
+
+    /**
+     * @brief Finds the items containing a point, with the rules of Rect::contains.
+     * @param point = The point to test.
+     * @param results = Receives up to capacity handles.
+     * @param capacity = The size of results.
+     * @return the number of matching items, results holds the first capacity of them.
+     */
+    std::size_t query(const vec2f& point, uint32* results, std::size_t capacity) const;
+
+    /**
+     * @brief Finds the items overlapping a circle, with the rules of Circle::intersects.
+     * @param circle = The circle to test.
+     * @param results = Receives up to capacity handles.
+     * @param capacity = The size of results.
+     * @return the number of matching items, results holds the first capacity of them.
+     */
+    std::size_t query(const Circle& circle, uint32* results, std::size_t capacity) const;
+
+    /**
+     * @brief Removes every item.
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of items.
+     * @return the item count.
+     */
+    std::size_t size() const { return mItemCount; }
+
+private:
+
+    struct Item
+    {
+        rectf bounds;
+        void* userData;
+
+        // Node holding the item and its position in the node's list.
+        uint32 node;
+        uint32 slot;
+
+        // Next free item while the item is in the free list.
+        uint32 next;
+    };
+
+    struct Node
+    {
+        std::vector<uint32> items;
+
+        // Items in this node and every node under it.
+        uint32 count;
+    };
+
+    uint32 locate(float minX, float minY, float maxX, float maxY) const;
+    uint32 store(uint32 handle, const rectf& bounds);
+    void link(uint32 handle, uint32 node);
+    void unlink(uint32 handle);
+    void addCount(uint32 node, int32 delta);
+
+    template <typename Test>
+    std::size_t gather(float minX, float minY, float maxX, float maxY, const Test& test, uint32* results, std::size_t capacity) const;
+
+    float mWorldX;
+    float mWorldY;
+    float mWorldWidth;
+    float mWorldHeight;
+    int32 mDepth;
+
+    // Every level as a row major grid of 2^level by 2^level nodes, root first.
+    std::vector<Node> mNodes;
+
+    std::vector<Item> mItems;
+
+    // Resolved min and max corners of every item, what the queries read.
+    std::vector<float> mBoxes;
+
+    uint32 mFreeList;
+    std::size_t mItemCount;
+};
+
+} // namespace nx
+
+#endif // LOOSEQUADTREE_H_INCLUDE
@@ -7,6 +7,7 @@
 #include <nex/math/vec2.h>
 #include <nex/math/vec3.h>
 #include <nex/math/vec4.h>
+#include <nex/math/simd.h>
 
 /*
  * TODO (Tyler): Implement the following.
@@ -14,11 +15,8 @@
  * - static Vector2 TransformNormal(Vector2 normal, Matrix matrix)
  * - static Vector2 Transform(Vector2 value, Quaternion rotation)
  *
- * - static Vector3 Transform(Vector3 position, Matrix matrix)
- * - static Vector3 TransformNormal(Vector3 normal, Matrix matrix)
  * - static Vector3 Transform(Vector3 value, Quaternion rotation)
  *
- * - static Vector4 Transform(Vector4 vector, Matrix matrix)
  * - static Vector4 Transform(Vector4 value, Quaternion rotation)
  *
  * - frustum
@@ -55,8 +53,8 @@ namespace nx
 //| 0 0 1 z |
 //| 0 0 0 1 |
 
-//friend Vector3 operator*(const Vector3& vec, const Matrix4& m);
-//friend Vector4 operator*(const Vector4& vec, const Matrix4& m);
+//Matrices are concatenated right to left, a vector is transformed as (m * v):
+//   mvp = projection * view * model;
 template <typename T>
 class Matrix
 {
@@ -246,6 +244,64 @@ public:
      */
     static Matrix<T> lookAt(const Vec3<T>& eye, const Vec3<T>& center, const Vec3<T>& up);
 
+    /**
+     * @brief Swap the rows and columns of a matrix.
+     * @param matrix = The matrix to transpose.
+     * @return the transposed matrix.
+     */
+    static Matrix<T> transpose(const Matrix<T>& matrix);
+
+    /**
+     * @brief Calculates the determinant of a matrix.
+     * @param matrix = The source matrix.
+     * @return the determinant.
+     */
+    static T determinant(const Matrix<T>& matrix);
+
+    /**
+     * @brief Calculates the inverse of a general matrix.
+     * @param matrix = The matrix to invert, it must not be singular.
+     * @return the inverted matrix.
+     */
+    static Matrix<T> inverse(const Matrix<T>& matrix);
+
+    /**
+     * @brief Calculates the inverse of an affine matrix (the last row must be 0 0 0 1).
+     *
+     * This is a lot cheaper than inverse() and should be used for model and view matrices.
+     *
+     * @param matrix = The affine matrix to invert, its 3x3 part must not be singular.
+     * @return the inverted matrix.
+     */
+    static Matrix<T> affineInverse(const Matrix<T>& matrix);
+
+    /**
+     * @brief Transforms a position by a matrix, the translation is applied (w = 1).
+     * @param position = The source position.
+     * @param matrix = The transformation matrix.
+     * @return the transformed position.
+     */
+    static Vec3<T> transform(const Vec3<T>& position, const Matrix<T>& matrix);
+
+    /**
+     * @brief Transforms a normal by a matrix, the translation is ignored (w = 0).
+     *
+     * To transform normals by a non uniformly scaled matrix pass the inverse transpose of that matrix.
+     *
+     * @param normal = The source normal.
+     * @param matrix = The transformation matrix.
+     * @return the transformed normal.
+     */
+    static Vec3<T> transformNormal(const Vec3<T>& normal, const Matrix<T>& matrix);
+
+    /**
+     * @brief Transforms a 4d vector by a matrix.
+     * @param vector = The source vector.
+     * @param matrix = The transformation matrix.
+     * @return the transformed vector.
+     */
+    static Vec4<T> transform(const Vec4<T>& vector, const Matrix<T>& matrix);
+
     //Our matrix data.
     col_type m[4];
 
@@ -389,6 +389,164 @@ inline Matrix<T> Matrix<T>::lookAt(const Vec3<T>& eye, const Vec3<T>& center, co
     return result;
 }
 
+template <typename T>
+inline Matrix<T> Matrix<T>::transpose(const Matrix<T>& matrix)
+{
+    Matrix<T> result;
+
+    for (uint32 column = 0; column < 4; ++column)
+    {
+        result[column][0] = matrix[0][column];
+        result[column][1] = matrix[1][column];
+        result[column][2] = matrix[2][column];
+        result[column][3] = matrix[3][column];
+    }
+
+    return result;
+}
+
+template <typename T>
+inline T Matrix<T>::determinant(const Matrix<T>& matrix)
+{
+    const col_type* a = matrix.m;
+
+    // 2x2 sub determinants of the first two and the last two columns.
+    const T s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+    const T s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+    const T s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+    const T s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+    const T s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+    const T s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+
+    const T c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+    const T c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+    const T c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+    const T c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+    const T c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+    const T c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+
+template <typename T>
+inline Matrix<T> Matrix<T>::inverse(const Matrix<T>& matrix)
+{
+    // Laplace expansion by 2x2 sub determinants. The inverse of the transpose is the
+    // transpose of the inverse, so this works on the column major storage as is.
+    const col_type* a = matrix.m;
+
+    const T s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+    const T s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+    const T s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+    const T s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+    const T s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+    const T s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+
+    const T c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+    const T c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+    const T c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+    const T c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+    const T c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+    const T c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+
+    const T oneOverDet = static_cast<T>(1.0) / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+    Matrix<T> result;
+
+    result[0][0] = ( a[1][1] * c5 - a[1][2] * c4 + a[1][3] * c3) * oneOverDet;
+    result[0][1] = (-a[0][1] * c5 + a[0][2] * c4 - a[0][3] * c3) * oneOverDet;
+    result[0][2] = ( a[3][1] * s5 - a[3][2] * s4 + a[3][3] * s3) * oneOverDet;
+    result[0][3] = (-a[2][1] * s5 + a[2][2] * s4 - a[2][3] * s3) * oneOverDet;
+
+    result[1][0] = (-a[1][0] * c5 + a[1][2] * c2 - a[1][3] * c1) * oneOverDet;
+    result[1][1] = ( a[0][0] * c5 - a[0][2] * c2 + a[0][3] * c1) * oneOverDet;
+    result[1][2] = (-a[3][0] * s5 + a[3][2] * s2 - a[3][3] * s1) * oneOverDet;
+    result[1][3] = ( a[2][0] * s5 - a[2][2] * s2 + a[2][3] * s1) * oneOverDet;
+
+    result[2][0] = ( a[1][0] * c4 - a[1][1] * c2 + a[1][3] * c0) * oneOverDet;
+    result[2][1] = (-a[0][0] * c4 + a[0][1] * c2 - a[0][3] * c0) * oneOverDet;
+    result[2][2] = ( a[3][0] * s4 - a[3][1] * s2 + a[3][3] * s0) * oneOverDet;
+    result[2][3] = (-a[2][0] * s4 + a[2][1] * s2 - a[2][3] * s0) * oneOverDet;
+
+    result[3][0] = (-a[1][0] * c3 + a[1][1] * c1 - a[1][2] * c0) * oneOverDet;
+    result[3][1] = ( a[0][0] * c3 - a[0][1] * c1 + a[0][2] * c0) * oneOverDet;
+    result[3][2] = (-a[3][0] * s3 + a[3][1] * s1 - a[3][2] * s0) * oneOverDet;
+    result[3][3] = ( a[2][0] * s3 - a[2][1] * s1 + a[2][2] * s0) * oneOverDet;
+
+    return result;
+}
+
+template <typename T>
+inline Matrix<T> Matrix<T>::affineInverse(const Matrix<T>& matrix)
+{
+    const Vec3<T> column0(matrix[0][0], matrix[0][1], matrix[0][2]);
+    const Vec3<T> column1(matrix[1][0], matrix[1][1], matrix[1][2]);
+    const Vec3<T> column2(matrix[2][0], matrix[2][1], matrix[2][2]);
+    const Vec3<T> translation(matrix[3][0], matrix[3][1], matrix[3][2]);
+
+    // The rows of the inverted 3x3 part are the cross products of its columns.
+    const Vec3<T> row0 = Vec3<T>::cross(column1, column2);
+    const Vec3<T> row1 = Vec3<T>::cross(column2, column0);
+    const Vec3<T> row2 = Vec3<T>::cross(column0, column1);
+
+    const T oneOverDet = static_cast<T>(1.0) / Vec3<T>::dot(column0, row0);
+
+    const T zero = static_cast<T>(0.0);
+    const T one = static_cast<T>(1.0);
+
+    Matrix<T> result;
+
+    result[0][0] = row0.x * oneOverDet;
+    result[0][1] = row1.x * oneOverDet;
+    result[0][2] = row2.x * oneOverDet;
+    result[0][3] = zero;
+
+    result[1][0] = row0.y * oneOverDet;
+    result[1][1] = row1.y * oneOverDet;
+    result[1][2] = row2.y * oneOverDet;
+    result[1][3] = zero;
+
+    result[2][0] = row0.z * oneOverDet;
+    result[2][1] = row1.z * oneOverDet;
+    result[2][2] = row2.z * oneOverDet;
+    result[2][3] = zero;
+
+    result[3][0] = -Vec3<T>::dot(row0, translation) * oneOverDet;
+    result[3][1] = -Vec3<T>::dot(row1, translation) * oneOverDet;
+    result[3][2] = -Vec3<T>::dot(row2, translation) * oneOverDet;
+    result[3][3] = one;
+
+    return result;
+}
+
+template <typename T>
+inline Vec3<T> Matrix<T>::transform(const Vec3<T>& position, const Matrix<T>& matrix)
+{
+    return Vec3<T>(
+            matrix[0][0] * position.x + matrix[1][0] * position.y + matrix[2][0] * position.z + matrix[3][0],
+            matrix[0][1] * position.x + matrix[1][1] * position.y + matrix[2][1] * position.z + matrix[3][1],
+            matrix[0][2] * position.x + matrix[1][2] * position.y + matrix[2][2] * position.z + matrix[3][2]);
+}
+
+template <typename T>
+inline Vec3<T> Matrix<T>::transformNormal(const Vec3<T>& normal, const Matrix<T>& matrix)
+{
+    return Vec3<T>(
+            matrix[0][0] * normal.x + matrix[1][0] * normal.y + matrix[2][0] * normal.z,
+            matrix[0][1] * normal.x + matrix[1][1] * normal.y + matrix[2][1] * normal.z,
+            matrix[0][2] * normal.x + matrix[1][2] * normal.y + matrix[2][2] * normal.z);
+}
+
+template <typename T>
+inline Vec4<T> Matrix<T>::transform(const Vec4<T>& vector, const Matrix<T>& matrix)
+{
+    return Vec4<T>(
+            matrix[0][0] * vector.x + matrix[1][0] * vector.y + matrix[2][0] * vector.z + matrix[3][0] * vector.w,
+            matrix[0][1] * vector.x + matrix[1][1] * vector.y + matrix[2][1] * vector.z + matrix[3][1] * vector.w,
+            matrix[0][2] * vector.x + matrix[1][2] * vector.y + matrix[2][2] * vector.z + matrix[3][2] * vector.w,
+            matrix[0][3] * vector.x + matrix[1][3] * vector.y + matrix[2][3] * vector.z + matrix[3][3] * vector.w);
+}
+
 template <typename T>
 inline Matrix<T> operator -(Matrix<T>& right)
 {
@@ -485,11 +643,23 @@ inline Matrix<T> operator *(const Matrix<T>& left, const T right)
 template <typename T>
 inline Matrix<T> operator *(const Matrix<T>& left, const Matrix<T>& right)
 {
-    return Matrix<T>(
-            left[0][0] * right[0][0], left[1][0] * right[1][0], left[2][0] * right[2][0], left[3][0] * right[3][0],
-            left[0][1] * right[0][1], left[1][1] * right[1][1], left[2][1] * right[2][1], left[3][1] * right[3][1],
-            left[0][2] * right[0][2], left[1][2] * right[1][2], left[2][2] * right[2][2], left[3][2] * right[3][2],
-            left[0][3] * right[0][3], left[1][3] * right[1][3], left[2][3] * right[2][3], left[3][3] * right[3][3]);
+    // Every column of the result is the left matrix applied to the matching right column.
+    Matrix<T> result;
+
+    for (uint32 column = 0; column < 4; ++column)
+    {
+        const T x = right[column][0];
+        const T y = right[column][1];
+        const T z = right[column][2];
+        const T w = right[column][3];
+
+        result[column][0] = left[0][0] * x + left[1][0] * y + left[2][0] * z + left[3][0] * w;
+        result[column][1] = left[0][1] * x + left[1][1] * y + left[2][1] * z + left[3][1] * w;
+        result[column][2] = left[0][2] * x + left[1][2] * y + left[2][2] * z + left[3][2] * w;
+        result[column][3] = left[0][3] * x + left[1][3] * y + left[2][3] * z + left[3][3] * w;
+    }
+
+    return result;
 }
 
 template <typename T>
@@ -502,49 +672,40 @@ inline Matrix<T> operator *(const T left, const Matrix<T>& right)
             left * right[0][3], left * right[1][3], left * right[2][3], left * right[3][3]);
 }
 
-// | 0 2 |    | 0 3 6 |    |  0  4  8 12 |
-// | 1 3 |    | 1 4 7 |    |  1  5  9 13 |
-//            | 2 5 8 |    |  2  6 10 14 |
-//                         |  3  7 11 15 |
-/*template <typename T>
-inline Vector4 Matrix4::operator*(const Vector4& rhs) const
+template <typename T>
+inline Vec4<T> operator *(const Matrix<T>& left, const Vec4<T>& right)
 {
-    return Vector4(m[0]*rhs.x + m[4]*rhs.y + m[8]*rhs.z  + m[12]*rhs.w,
-                   m[1]*rhs.x + m[5]*rhs.y + m[9]*rhs.z  + m[13]*rhs.w,
-                   m[2]*rhs.x + m[6]*rhs.y + m[10]*rhs.z + m[14]*rhs.w,
-                   m[3]*rhs.x + m[7]*rhs.y + m[11]*rhs.z + m[15]*rhs.w);
+    return Matrix<T>::transform(right, left);
 }
 
 template <typename T>
-inline Vector3 Matrix4::operator*(const Vector3& rhs) const
+inline Vec3<T> operator *(const Matrix<T>& left, const Vec3<T>& right)
 {
-    return Vector3(m[0]*rhs.x + m[4]*rhs.y + m[8]*rhs.z,
-                   m[1]*rhs.x + m[5]*rhs.y + m[9]*rhs.z,
-                   m[2]*rhs.x + m[6]*rhs.y + m[10]*rhs.z);
+    return Matrix<T>::transform(right, left);
 }
-*/
+
 template <typename T>
 inline Matrix<T>& operator *=(Matrix<T>& left, const T right)
 {
-    left[0][0] += right;
-    left[0][1] += right;
-    left[0][2] += right;
-    left[0][3] += right;
-
-    left[1][0] += right;
-    left[1][1] += right;
-    left[1][2] += right;
-    left[1][3] += right;
-
-    left[2][0] += right;
-    left[2][1] += right;
-    left[2][2] += right;
-    left[2][3] += right;
-
-    left[3][0] += right;
-    left[3][1] += right;
-    left[3][2] += right;
-    left[3][3] += right;
+    left[0][0] *= right;
+    left[0][1] *= right;
+    left[0][2] *= right;
+    left[0][3] *= right;
+
+    left[1][0] *= right;
+    left[1][1] *= right;
+    left[1][2] *= right;
+    left[1][3] *= right;
+
+    left[2][0] *= right;
+    left[2][1] *= right;
+    left[2][2] *= right;
+    left[2][3] *= right;
+
+    left[3][0] *= right;
+    left[3][1] *= right;
+    left[3][2] *= right;
+    left[3][3] *= right;
 
     return left;
 }
@@ -552,26 +713,7 @@ inline Matrix<T>& operator *=(Matrix<T>& left, const T right)
 template <typename T>
 inline Matrix<T>& operator *=(Matrix<T>& left, const Matrix<T>& right)
 {
-    left[0][0] *= right[0][0];
-    left[0][1] *= right[0][1];
-    left[0][2] *= right[0][2];
-    left[0][3] *= right[0][3];
-
-    left[1][0] *= right[1][0];
-    left[1][1] *= right[1][1];
-    left[1][2] *= right[1][2];
-    left[1][3] *= right[1][3];
-
-    left[2][0] *= right[2][0];
-    left[2][1] *= right[2][1];
-    left[2][2] *= right[2][2];
-    left[2][3] *= right[2][3];
-
-    left[3][0] *= right[3][0];
-    left[3][1] *= right[3][1];
-    left[3][2] *= right[3][2];
-    left[3][3] *= right[3][3];
-
+    left = left * right;
     return left;
 }
 
@@ -667,3 +809,255 @@ inline bool operator !=(const Matrix<T>& left, const Matrix<T>& right)
            (left[0][2] != right[0][2]) || (left[1][2] != right[1][2]) || left[2][2] != right[2][2] || left[3][2] != right[3][2] ||
            (left[0][3] != right[0][3]) || (left[1][3] != right[1][3]) || left[2][3] != right[2][3] || left[3][3] != right[3][3];
 }
+
+/*
+    Vectorized mat4f kernels.
+
+    Each column of the matrix is one __m128, so a product or a transform is a
+    sum of columns scaled by broadcast components. The generic templates above
+    stay the reference implementation for every other type.
+*/
+#if defined(NEX_SIMD_SSE)
+
+#define NEX_MATRIX_SHUFFLE(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define NEX_MATRIX_SWIZZLE(vec, x, y, z, w) \
+    _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(vec), NEX_MATRIX_SHUFFLE(x, y, z, w)))
+
+namespace priv
+{
+
+// Multiplies the 2x2 matrices packed as (a0 a1 a2 a3) = | a0 a1 |
+//                                                        | a2 a3 |
+inline __m128 matrix2Mul(__m128 left, __m128 right)
+{
+    return _mm_add_ps(_mm_mul_ps(left, NEX_MATRIX_SWIZZLE(right, 0, 3, 0, 3)),
+                      _mm_mul_ps(NEX_MATRIX_SWIZZLE(left, 1, 0, 3, 2), NEX_MATRIX_SWIZZLE(right, 2, 1, 2, 1)));
+}
+
+// Multiplies the adjugate of a packed 2x2 matrix with another one.
+inline __m128 matrix2AdjMul(__m128 left, __m128 right)
+{
+    return _mm_sub_ps(_mm_mul_ps(NEX_MATRIX_SWIZZLE(left, 3, 3, 0, 0), right),
+                      _mm_mul_ps(NEX_MATRIX_SWIZZLE(left, 1, 1, 2, 2), NEX_MATRIX_SWIZZLE(right, 2, 3, 0, 1)));
+}
+
+// Multiplies a packed 2x2 matrix with the adjugate of another one.
+inline __m128 matrix2MulAdj(__m128 left, __m128 right)
+{
+    return _mm_sub_ps(_mm_mul_ps(left, NEX_MATRIX_SWIZZLE(right, 3, 0, 3, 0)),
+                      _mm_mul_ps(NEX_MATRIX_SWIZZLE(left, 1, 0, 3, 2), NEX_MATRIX_SWIZZLE(right, 2, 1, 2, 1)));
+}
+
+} // namespace priv
+
+template <>
+inline Matrix<float> operator *(const Matrix<float>& left, const Matrix<float>& right)
+{
+    Matrix<float> result;
+
+#if defined(NEX_SIMD_AVX)
+    // Two result columns per iteration, both halves share the left columns.
+    const __m256 column0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left[0]));
+    const __m256 column1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left[1]));
+    const __m256 column2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left[2]));
+    const __m256 column3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left[3]));
+
+    for (uint32 column = 0; column < 4; column += 2)
+    {
+        const __m256 pair = _mm256_loadu_ps(right[column]);
+
+#if defined(NEX_SIMD_AVX2)
+        __m256 sum = _mm256_mul_ps(column0, _mm256_shuffle_ps(pair, pair, 0x00));
+        sum = _mm256_fmadd_ps(column1, _mm256_shuffle_ps(pair, pair, 0x55), sum);
+        sum = _mm256_fmadd_ps(column2, _mm256_shuffle_ps(pair, pair, 0xAA), sum);
+        sum = _mm256_fmadd_ps(column3, _mm256_shuffle_ps(pair, pair, 0xFF), sum);
+#else
+        __m256 sum = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(column0, _mm256_shuffle_ps(pair, pair, 0x00)),
+                              _mm256_mul_ps(column1, _mm256_shuffle_ps(pair, pair, 0x55))),
+                _mm256_add_ps(_mm256_mul_ps(column2, _mm256_shuffle_ps(pair, pair, 0xAA)),
+                              _mm256_mul_ps(column3, _mm256_shuffle_ps(pair, pair, 0xFF))));
+#endif
+        _mm256_storeu_ps(result[column], sum);
+    }
+#else
+    const __m128 column0 = _mm_loadu_ps(left[0]);
+    const __m128 column1 = _mm_loadu_ps(left[1]);
+    const __m128 column2 = _mm_loadu_ps(left[2]);
+    const __m128 column3 = _mm_loadu_ps(left[3]);
+
+    for (uint32 column = 0; column < 4; ++column)
+    {
+        const __m128 source = _mm_loadu_ps(right[column]);
+
+        const __m128 sum = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(column0, _mm_shuffle_ps(source, source, 0x00)),
+                           _mm_mul_ps(column1, _mm_shuffle_ps(source, source, 0x55))),
+                _mm_add_ps(_mm_mul_ps(column2, _mm_shuffle_ps(source, source, 0xAA)),
+                           _mm_mul_ps(column3, _mm_shuffle_ps(source, source, 0xFF))));
+
+        _mm_storeu_ps(result[column], sum);
+    }
+#endif
+
+    return result;
+}
+
+template <>
+inline Vec4<float> Matrix<float>::transform(const Vec4<float>& vector, const Matrix<float>& matrix)
+{
+    const __m128 sum = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(matrix[0]), _mm_set1_ps(vector.x)),
+                       _mm_mul_ps(_mm_loadu_ps(matrix[1]), _mm_set1_ps(vector.y))),
+            _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(matrix[2]), _mm_set1_ps(vector.z)),
+                       _mm_mul_ps(_mm_loadu_ps(matrix[3]), _mm_set1_ps(vector.w))));
+
+    Vec4<float> result;
+    _mm_storeu_ps(&result.x, sum);
+    return result;
+}
+
+template <>
+inline Vec3<float> Matrix<float>::transform(const Vec3<float>& position, const Matrix<float>& matrix)
+{
+    const __m128 sum = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(matrix[0]), _mm_set1_ps(position.x)),
+                       _mm_mul_ps(_mm_loadu_ps(matrix[1]), _mm_set1_ps(position.y))),
+            _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(matrix[2]), _mm_set1_ps(position.z)),
+                       _mm_loadu_ps(matrix[3])));
+
+    float result[4];
+    _mm_storeu_ps(result, sum);
+    return Vec3<float>(result[0], result[1], result[2]);
+}
+
+template <>
+inline Matrix<float> Matrix<float>::transpose(const Matrix<float>& matrix)
+{
+    __m128 column0 = _mm_loadu_ps(matrix[0]);
+    __m128 column1 = _mm_loadu_ps(matrix[1]);
+    __m128 column2 = _mm_loadu_ps(matrix[2]);
+    __m128 column3 = _mm_loadu_ps(matrix[3]);
+
+    _MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+
+    Matrix<float> result;
+    _mm_storeu_ps(result[0], column0);
+    _mm_storeu_ps(result[1], column1);
+    _mm_storeu_ps(result[2], column2);
+    _mm_storeu_ps(result[3], column3);
+    return result;
+}
+
+template <>
+inline Matrix<float> Matrix<float>::inverse(const Matrix<float>& matrix)
+{
+    // Block inverse of | A B | using the 2x2 adjugates, see the scalar version for the layout note.
+    //                  | C D |
+    const __m128 column0 = _mm_loadu_ps(matrix[0]);
+    const __m128 column1 = _mm_loadu_ps(matrix[1]);
+    const __m128 column2 = _mm_loadu_ps(matrix[2]);
+    const __m128 column3 = _mm_loadu_ps(matrix[3]);
+
+    const __m128 a = _mm_movelh_ps(column0, column1);
+    const __m128 b = _mm_movehl_ps(column1, column0);
+    const __m128 c = _mm_movelh_ps(column2, column3);
+    const __m128 d = _mm_movehl_ps(column3, column2);
+
+    // Determinants of the sub matrices as (|A| |B| |C| |D|).
+    const __m128 subDet = _mm_sub_ps(
+            _mm_mul_ps(_mm_shuffle_ps(column0, column2, NEX_MATRIX_SHUFFLE(0, 2, 0, 2)),
+                       _mm_shuffle_ps(column1, column3, NEX_MATRIX_SHUFFLE(1, 3, 1, 3))),
+            _mm_mul_ps(_mm_shuffle_ps(column0, column2, NEX_MATRIX_SHUFFLE(1, 3, 1, 3)),
+                       _mm_shuffle_ps(column1, column3, NEX_MATRIX_SHUFFLE(0, 2, 0, 2))));
+
+    const __m128 detA = NEX_MATRIX_SWIZZLE(subDet, 0, 0, 0, 0);
+    const __m128 detB = NEX_MATRIX_SWIZZLE(subDet, 1, 1, 1, 1);
+    const __m128 detC = NEX_MATRIX_SWIZZLE(subDet, 2, 2, 2, 2);
+    const __m128 detD = NEX_MATRIX_SWIZZLE(subDet, 3, 3, 3, 3);
+
+    const __m128 adjDC = priv::matrix2AdjMul(d, c);
+    const __m128 adjAB = priv::matrix2AdjMul(a, b);
+
+    __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), priv::matrix2Mul(b, adjDC));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), priv::matrix2Mul(c, adjAB));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), priv::matrix2MulAdj(d, adjAB));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), priv::matrix2MulAdj(a, adjDC));
+
+    // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+    __m128 trace = _mm_mul_ps(adjAB, NEX_MATRIX_SWIZZLE(adjDC, 0, 2, 1, 3));
+    trace = _mm_add_ps(trace, _mm_movehl_ps(trace, trace));
+    trace = _mm_add_ps(trace, NEX_MATRIX_SWIZZLE(trace, 1, 0, 0, 0));
+    trace = NEX_MATRIX_SWIZZLE(trace, 0, 0, 0, 0);
+
+    const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+    const __m128 oneOverDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+
+    x = _mm_mul_ps(x, oneOverDet);
+    y = _mm_mul_ps(y, oneOverDet);
+    z = _mm_mul_ps(z, oneOverDet);
+    w = _mm_mul_ps(w, oneOverDet);
+
+    // Apply the adjugate shuffle while storing.
+    Matrix<float> result;
+    _mm_storeu_ps(result[0], _mm_shuffle_ps(x, y, NEX_MATRIX_SHUFFLE(3, 1, 3, 1)));
+    _mm_storeu_ps(result[1], _mm_shuffle_ps(x, y, NEX_MATRIX_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(result[2], _mm_shuffle_ps(z, w, NEX_MATRIX_SHUFFLE(3, 1, 3, 1)));
+    _mm_storeu_ps(result[3], _mm_shuffle_ps(z, w, NEX_MATRIX_SHUFFLE(2, 0, 2, 0)));
+    return result;
+}
+
+template <>
+inline Matrix<float> Matrix<float>::affineInverse(const Matrix<float>& matrix)
+{
+    const __m128 zero = _mm_setzero_ps();
+
+    // Clear the w lanes so the cross products and the transpose stay clean.
+    const __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    const __m128 column0 = _mm_and_ps(_mm_loadu_ps(matrix[0]), mask);
+    const __m128 column1 = _mm_and_ps(_mm_loadu_ps(matrix[1]), mask);
+    const __m128 column2 = _mm_and_ps(_mm_loadu_ps(matrix[2]), mask);
+
+    // cross(a, b) = a.yzx * b.zxy - a.zxy * b.yzx
+    #define NEX_MATRIX_CROSS(left, right) _mm_sub_ps( \
+        _mm_mul_ps(NEX_MATRIX_SWIZZLE(left, 1, 2, 0, 3), NEX_MATRIX_SWIZZLE(right, 2, 0, 1, 3)), \
+        _mm_mul_ps(NEX_MATRIX_SWIZZLE(left, 2, 0, 1, 3), NEX_MATRIX_SWIZZLE(right, 1, 2, 0, 3)))
+
+    __m128 row0 = NEX_MATRIX_CROSS(column1, column2);
+    __m128 row1 = NEX_MATRIX_CROSS(column2, column0);
+    __m128 row2 = NEX_MATRIX_CROSS(column0, column1);
+
+    #undef NEX_MATRIX_CROSS
+
+    __m128 det = _mm_mul_ps(column0, row0);
+    det = _mm_add_ps(det, _mm_movehl_ps(det, det));
+    det = _mm_add_ps(det, NEX_MATRIX_SWIZZLE(det, 1, 0, 0, 0));
+    const __m128 oneOverDet = _mm_div_ps(_mm_set1_ps(1.0f), NEX_MATRIX_SWIZZLE(det, 0, 0, 0, 0));
+
+    row0 = _mm_mul_ps(row0, oneOverDet);
+    row1 = _mm_mul_ps(row1, oneOverDet);
+    row2 = _mm_mul_ps(row2, oneOverDet);
+    __m128 row3 = zero;
+
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+    // The translation is -(R^-1 * t), finally put 1 into its w lane.
+    const __m128 translation = _mm_loadu_ps(matrix[3]);
+    __m128 column3 = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(row0, NEX_MATRIX_SWIZZLE(translation, 0, 0, 0, 0)),
+                       _mm_mul_ps(row1, NEX_MATRIX_SWIZZLE(translation, 1, 1, 1, 1))),
+            _mm_mul_ps(row2, NEX_MATRIX_SWIZZLE(translation, 2, 2, 2, 2)));
+    column3 = _mm_add_ps(_mm_sub_ps(zero, column3), _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+
+    Matrix<float> result;
+    _mm_storeu_ps(result[0], row0);
+    _mm_storeu_ps(result[1], row1);
+    _mm_storeu_ps(result[2], row2);
+    _mm_storeu_ps(result[3], column3);
+    return result;
+}
+
+#undef NEX_MATRIX_SWIZZLE
+#undef NEX_MATRIX_SHUFFLE
+
+#endif // NEX_SIMD_SSE
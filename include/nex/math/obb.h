@@ -0,0 +1,178 @@
+#ifndef OBB_H_INCLUDE
+#define OBB_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/math/vec3.h>
+#include <nex/math/matrix.h>
+#include <nex/math/quaternion.h>
+#include <nex/math/aabb.h>
+#include <nex/math/containmenttype.h>
+
+// Standard includes.
+#include <cstddef>
+#include <vector>
+
+namespace nx
+{
+class Sphere;
+class JobSystem;
+
+/**
+ * Defines an oriented box-shaped 3D volume.
+ *
+ * The box is a center, three orthonormal axes and the half size of the box
+ * along each axis. Rotated and elongated objects get a much tighter volume
+ * than from an AABB, at the cost of a separating axis test that checks up
+ * to 15 axes. Planes, frustums and rays are tested through Plane::intersects,
+ * Frustum::contains and Ray::intersects, and ConvexQuery reads a box through
+ * OBBSupport.
+ */
+class OBB
+{
+public:
+
+    /**
+     * @brief Specifies the total number of corners (8) in the OBB.
+     */
+    static const int32 CornerCount = 8;
+
+    /**
+     * @brief Creates an empty box at the origin, aligned with the world axes.
+     */
+    OBB();
+
+    /**
+     * @brief Creates an instance of OBB.
+     * @param center = The center of the box.
+     * @param halfExtents = Half the size of the box along each of its axes.
+     * @param rotation = The unit quaternion that turns the world axes into the box axes.
+     */
+    OBB(const vec3f& center, const vec3f& halfExtents, const quatf& rotation);
+
+    /**
+     * @brief Creates an instance of OBB.
+     * @param center = The center of the box.
+     * @param halfExtents = Half the size of the box along each of its axes.
+     * @param axisX = The first axis of the box, a unit vector.
+     * @param axisY = The second axis of the box, a unit vector orthogonal to axisX.
+     * @param axisZ = The third axis of the box, a unit vector orthogonal to the other two.
+     */
+    OBB(const vec3f& center, const vec3f& halfExtents, const vec3f& axisX, const vec3f& axisY, const vec3f& axisZ);
+
+    /**
+     * @brief Creates an OBB that covers exactly an axis aligned box.
+     * @param box = The box.
+     */
+    explicit OBB(const AABB& box);
+
+    /**
+     * @brief Gets the corners of the box.
+     * @param corners = Receives CornerCount points.
+     */
+    void getCorners(vec3f* corners) const;
+
+    /**
+     * @brief Gets the smallest axis aligned box that contains this box.
+     * @return the bounding box.
+     */
+    AABB getBounds() const;
+
+    /**
+     * @brief Finds the point of the box closest to a point.
+     * @param point = The point.
+     * @return the point itself when it is inside the box.
+     */
+    vec3f closestPoint(const vec3f& point) const;
+
+    /**
+     * @brief Checks whether the current OBB intersects another OBB, with the 15 axis separating axis test.
+     * @param box = The OBB to check for intersection with.
+     * @return the intersection result.
+     */
+    bool intersects(const OBB& box) const;
+
+    /**
+     * @brief Checks whether the current OBB intersects an axis aligned box.
+     * @param box = The box to check for intersection with.
+     * @return the intersection result.
+     */
+    bool intersects(const AABB& box) const;
+
+    /**
+     * @brief Checks whether the current OBB intersects a sphere.
+     * @param sphere = The sphere to check for intersection with.
+     * @return the intersection result.
+     */
+    bool intersects(const Sphere& sphere) const;
+
+    /**
+     * @brief Tests whether the OBB contains a point.
+     * @param point = The point to test for overlap.
+     * @return The ContainmentType.
+     */
+    ContainmentType contains(const vec3f& point) const;
+
+    /**
+     * @brief Transforms a box by a matrix made of rotations, translations and scales.
+     * Scales stretch the half extents, they must be uniform or along the axes
+     * of the box for the result to stay a box.
+     * @param box = The box to transform.
+     * @param matrix = The transformation matrix.
+     * @return the transformed box.
+     */
+    static OBB transform(const OBB& box, const mat4f& matrix);
+
+    /**
+     * @brief Creates the OBB covering an axis aligned box placed in the world by a matrix.
+     * @param box = The box in its local space.
+     * @param matrix = The local to world matrix, as for transform.
+     * @return the world space box.
+     */
+    static OBB createFromAABB(const AABB& box, const mat4f& matrix);
+
+    /**
+     * @brief Fits a box to a group of points along the principal axes of their covariance.
+     * @param points = A list of points the OBB should contain.
+     * @return the box containing the points.
+     */
+    static OBB createFromPoints(const std::vector<vec3f>& points);
+
+    /**
+     * @brief Fits a box to a group of points along the principal axes of their covariance, reading them in place.
+     * @param points = The first point.
+     * @param count = The number of points.
+     * @param stride = The distance in bytes between two points, larger than a vec3f for points inside vertices.
+     * @return the box containing the points.
+     */
+    static OBB createFromPoints(const vec3f* points, std::size_t count, std::size_t stride = sizeof(vec3f));
+
+    /**
+     * @brief Fits a box to a group of points along the principal axes of their covariance, on the threads of a job system.
+     * @param points = The first point.
+     * @param count = The number of points.
+     * @param stride = The distance in bytes between two points, larger than a vec3f for points inside vertices.
+     * @param jobs = The job system to run on.
+     * @return the box containing the points.
+     */
+    static OBB createFromPoints(const vec3f* points, std::size_t count, std::size_t stride, JobSystem& jobs);
+
+    /**
+     * @brief The center of the box.
+     */
+    vec3f center;
+
+    /**
+     * @brief The axes of the box, orthonormal.
+     */
+    vec3f axes[3];
+
+    /**
+     * @brief Half the size of the box along each of its axes.
+     */
+    vec3f halfExtents;
+};
+
+} // namespace nx
+
+#endif // OBB_H_INCLUDE
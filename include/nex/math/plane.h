@@ -13,6 +13,7 @@ namespace nx
 {
 
 class Ray;
+class OBB;
 
 class Plane
 {
@@ -78,6 +79,13 @@ public:
      */
     PlaneIntersectionType intersects(const Sphere& sphere) const;
 
+    /**
+     * @brief Checks whether the current Plane intersects a specified OBB.
+     * @param box = The OBB to check for intersection with.
+     * @return the intersection results.
+     */
+    PlaneIntersectionType intersects(const OBB& box) const;
+
     /**
      * @brief Changes the coefficients of the Normal vector of this Plane to make it of unit length.
      * @param plane = plane to  normalize.
@@ -5,6 +5,7 @@
 #include <nex/math/plane.h>
 
 #include <nex/math/aabb.h>
+#include <nex/math/obb.h>
 #include <nex/math/sphere.h>
 #include <nex/math/frustum.h>
 
@@ -51,6 +52,13 @@ public:
      */
     float intersects(const AABB& boundingBox) const;
 
+    /**
+     * @brief Checks whether the Ray intersects a specified OBB.
+     * @param box = The OBB to check for intersection with the Ray.
+     * @return intersection result.
+     */
+    float intersects(const OBB& box) const;
+
     /**
      * @brief Computes the intersections between the ray an plane.
      * @param plane = plane to compute the intersection on.
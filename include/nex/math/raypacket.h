@@ -0,0 +1,174 @@
+#ifndef RAYPACKET_H_INCLUDE
+#define RAYPACKET_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/math/vec3.h>
+#include <nex/math/ray.h>
+#include <nex/math/plane.h>
+#include <nex/math/aabb.h>
+#include <nex/math/sphere.h>
+
+// Standard includes.
+#include <cstddef>
+#include <limits>
+
+namespace nx
+{
+
+/**
+ * A bundle of 4 or 8 rays tested together, one ray per SIMD lane.
+ *
+ * The rays are stored as separate x, y and z arrays with their inverse
+ * directions precomputed, so the slab tests run without branches. Every
+ * test returns a bit mask with bit i set when ray i hits, and writes the
+ * hit distance of every lane, infinity for the lanes that miss.
+ *
+ * Triangles go through the Moller-Trumbore test and also return the
+ * barycentric coordinates of the hits.
+ *
+ * Each lane carries a maximum distance, hits further away are misses.
+ * Lanes that were never set are inactive and never hit. Traversals shrink
+ * the maximum distance of a lane as closer hits are found.
+ *
+ * Directions are expected to be unit vectors, as for Ray.
+ */
+template <std::size_t Size>
+class RayPacket
+{
+public:
+
+    /**
+     * @brief The number of rays in the packet.
+     */
+    static const std::size_t Width = Size;
+
+    /**
+     * @brief The mask with a bit set for every lane.
+     */
+    static const uint32 FullMask = (1u << Size) - 1;
+
+    /**
+     * @brief Constructs a packet with every lane inactive.
+     */
+    RayPacket();
+
+    /**
+     * @brief Constructs a packet from consecutive rays.
+     * @param rays = The rays.
+     * @param count = The number of rays, at most Width. The other lanes stay inactive.
+     * @param maxDistance = The maximum distance of every ray.
+     */
+    RayPacket(const Ray* rays, std::size_t count, float maxDistance = std::numeric_limits<float>::max());
+
+    /**
+     * @brief Sets the ray of a lane and makes the lane active.
+     * @param lane = The lane, less than Width.
+     * @param ray = The ray.
+     * @param maxDistance = The maximum distance of the ray.
+     */
+    void set(std::size_t lane, const Ray& ray, float maxDistance = std::numeric_limits<float>::max());
+
+    /**
+     * @brief Get the ray of a lane.
+     * @param lane = The lane, less than Width.
+     * @return the ray.
+     */
+    Ray get(std::size_t lane) const;
+
+    /**
+     * @brief Changes the maximum distance of a lane, a negative distance makes it inactive.
+     * @param lane = The lane, less than Width.
+     * @param maxDistance = The new maximum distance.
+     */
+    void setMaxDistance(std::size_t lane, float maxDistance) { mMaxDistance[lane] = maxDistance; }
+
+    /**
+     * @brief Get the maximum distance of a lane.
+     * @param lane = The lane, less than Width.
+     * @return the maximum distance, negative for inactive lanes.
+     */
+    float getMaxDistance(std::size_t lane) const { return mMaxDistance[lane]; }
+
+    /**
+     * @brief Get the lanes that can still hit something.
+     * @return the mask of lanes with a maximum distance of 0 or more.
+     */
+    uint32 getActiveMask() const;
+
+    /**
+     * @brief Slab test of every ray against a box.
+     * @param min = The minimum corner of the box, 3 floats.
+     * @param max = The maximum corner of the box, 3 floats.
+     * @param distances = Receives Width entry distances, 0 for rays starting inside.
+     * @return the mask of rays that hit the box.
+     */
+    uint32 intersects(const float* min, const float* max, float* distances) const;
+
+    /**
+     * @brief Slab test of every ray against a box.
+     * @param box = The box.
+     * @param distances = Receives Width entry distances, 0 for rays starting inside.
+     * @return the mask of rays that hit the box.
+     */
+    uint32 intersects(const AABB& box, float* distances) const;
+
+    /**
+     * @brief Finds the closest box hit by every ray.
+     * @param boxes = The boxes.
+     * @param count = The number of boxes.
+     * @param distances = Receives Width distances to the closest box.
+     * @param indices = Receives Width indices of the closest box, left untouched for rays that hit nothing.
+     * @return the mask of rays that hit at least one box.
+     */
+    uint32 intersects(const AABB* boxes, std::size_t count, float* distances, uint32* indices) const;
+
+    /**
+     * @brief Tests every ray against a sphere.
+     * @param sphere = The sphere.
+     * @param distances = Receives Width distances to the sphere surface, 0 for rays starting inside.
+     * @return the mask of rays that hit the sphere.
+     */
+    uint32 intersects(const Sphere& sphere, float* distances) const;
+
+    /**
+     * @brief Tests every ray against a plane, rays parallel to the plane miss.
+     * @param plane = The plane.
+     * @param distances = Receives Width distances to the plane.
+     * @return the mask of rays that hit the plane.
+     */
+    uint32 intersects(const Plane& plane, float* distances) const;
+
+    /**
+     * @brief Tests every ray against a triangle, both faces are hit.
+     * @param vertexA = The first vertex.
+     * @param vertexB = The second vertex.
+     * @param vertexC = The third vertex.
+     * @param distances = Receives Width distances to the triangle.
+     * @param u = Receives Width weights of vertexB, as for Vec3::barycentric.
+     * @param v = Receives Width weights of vertexC.
+     * @return the mask of rays that hit the triangle.
+     */
+    uint32 intersects(const vec3f& vertexA, const vec3f& vertexB, const vec3f& vertexC, float* distances, float* u, float* v) const;
+
+private:
+
+    float mOrigin[3][Size];
+    float mDirection[3][Size];
+    float mInverseDirection[3][Size];
+    float mMaxDistance[Size];
+};
+
+/**
+ * @brief A packet of 4 rays, one SSE register per component.
+ */
+typedef RayPacket<4> RayPacket4;
+
+/**
+ * @brief A packet of 8 rays, one AVX register per component.
+ */
+typedef RayPacket<8> RayPacket8;
+
+} // namespace nx
+
+#endif // RAYPACKET_H_INCLUDE
@@ -45,11 +45,11 @@ public:
 
     /**
      * @brief Check if a rectangle contains the specified point.
-     * @param x = The x coordinate.
-     * @param y = The y coordinate.
+     * @param pointX = The x coordinate.
+     * @param pointY = The y coordinate.
      * @return true if the rectangle contains the point.
      */
-    bool contains(T x, T y) const;
+    bool contains(T pointX, T pointY) const;
 
     /**
      * @brief Check if a rectangle conatins the specified vector point.
@@ -24,7 +24,7 @@ Rect<T>::Rect(const Rect<U>& rectangle) :
 { }
 
 template <typename T>
-bool Rect<T>::contains(T x, T y) const
+bool Rect<T>::contains(T pointX, T pointY) const
 {
     // Rectangles with negative dimensions are allowed, so we must handle them correctly
 
@@ -34,7 +34,7 @@ bool Rect<T>::contains(T x, T y) const
     T minY = std::min(y, static_cast<T>(y + height));
     T maxY = std::max(y, static_cast<T>(y + height));
 
-    return (x >= minX) && (x < maxX) && (y >= minY) && (y < maxY);
+    return (pointX >= minX) && (pointX < maxX) && (pointY >= minY) && (pointY < maxY);
 }
 
 template <typename T>
@@ -0,0 +1,42 @@
+#ifndef SIMD_H_INCLUDE
+#define SIMD_H_INCLUDE
+
+/*
+ * Detects the vector instruction sets the compiler is allowed to emit.
+ *
+ * Every vectorized kernel in nex keeps a scalar fallback, so building with
+ * NEX_NO_SIMD defined (or for a target without SSE) still produces a working
+ * library. SSE2 is part of the x86-64 baseline; AVX2 and FMA are opt-in
+ * through the NEX_ENABLE_AVX2 cmake option.
+ */
+
+#if !defined(NEX_NO_SIMD)
+
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define NEX_SIMD_SSE
+    #endif
+
+    #if defined(__AVX__)
+        #define NEX_SIMD_AVX
+    #endif
+
+    #if defined(__AVX2__) && defined(__FMA__)
+        #define NEX_SIMD_AVX2
+    #endif
+
+#endif
+
+#if defined(NEX_SIMD_SSE) || defined(NEX_SIMD_AVX)
+    #include <immintrin.h>
+#endif
+
+/**
+ * @brief The widest vector register, in bytes, the kernels were built for.
+ */
+#if defined(NEX_SIMD_AVX)
+    #define NEX_SIMD_WIDTH 32
+#else
+    #define NEX_SIMD_WIDTH 16
+#endif
+
+#endif // SIMD_H_INCLUDE
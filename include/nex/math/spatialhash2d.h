@@ -0,0 +1,169 @@
+#ifndef SPATIALHASH2D_H_INCLUDE
+#define SPATIALHASH2D_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/math/vec2.h>
+#include <nex/math/rect.h>
+#include <nex/math/circle.h>
+
+// Standard includes.
+#include <cstddef>
+#include <vector>
+
+namespace nx
+{
+
+/**
+ * @brief The default number of buckets of a SpatialHash2d.
+ */
+const std::size_t SpatialHashBucketCount = 4096;
+
+/**
+ * Uniform grid for many 2D items of similar size.
+ *
+ * Space is cut into square cells and every item is listed in each cell its
+ * bounds touch. Cells are hashed into a fixed number of buckets, so the grid
+ * is unbounded and only costs memory where items are. Works best when the
+ * cell size is close to the size of the items, use LooseQuadtree when sizes
+ * vary a lot.
+ *
+ * Queries write the matching handles into a caller buffer and return the
+ * number of matches, which may be larger than the buffer.
+ */
+class SpatialHash2d
+{
+public:
+
+    /**
+     * @brief The handle value that never refers to an item.
+     */
+    static const uint32 NullHandle = 0xFFFFFFFF;
+
+    /**
+     * @brief Constructs an empty grid.
+     * @param cellSize = The width and height of a cell.
+     * @param bucketCount = The number of buckets, rounded up to a power of two.
+     */
+    explicit SpatialHash2d(float cellSize, std::size_t bucketCount = SpatialHashBucketCount);
+
+    /**
+     * @brief Adds an item.
+     * @param bounds = The bounds of the item.
+     * @param userData = Value returned by getUserData.
+     * @return the item handle, valid until it is removed.
+     */
+    uint32 insert(const rectf& bounds, void* userData = 0);
+
+    /**
+     * @brief Removes an item, its handle may be reused by a later insert.
+     * @param handle = The item to remove.
+     */
+    void remove(uint32 handle);
+
+    /**
+     * @brief Changes the bounds of an item, the buckets are only touched if it crossed a cell border.
+     * @param handle = The item to update.
+     * @param bounds = The new bounds.
+     */
+    void update(uint32 handle, const rectf& bounds);
+
+    /**
+     * @brief Get the bounds of an item.
+     * @param handle = The item.
+     * @return the bounds.
+     */
+    const rectf& getBounds(uint32 handle) const { return mItems[handle].bounds; }
+
+    /**
+     * @brief Get the user data of an item.
+     * @param handle = The item.
+     * @return the value passed to insert.
+     */
+    void* getUserData(uint32 handle) const { return mItems[handle].userData; }
+
+    /**
+     * @brief Finds the items overlapping a region, with the rules of Rect::intersects.
+     * @param region = The region to test.
+     * @param results = Receives up to capacity handles.
+     * @param capacity = The size of results.
+     * @return the number of matching items, results holds the first capacity of them.
+     */
+    std::size_t query(const rectf& region, uint32* results, std::size_t capacity) const;
+
+    /**
+     * @brief Finds the items containing a point, with the rules of Rect::contains.
+     * @param point = The point to test.
+     * @param results = Receives up to capacity handles.
+     * @param capacity = The size of results.
+     * @return the number of matching items, results holds the first capacity of them.
+     */
+    std::size_t query(const vec2f& point, uint32* results, std::size_t capacity) const;
+
+    /**
+     * @brief Finds the items overlapping a circle, with the rules of Circle::intersects.
+     * @param circle = The circle to test.
+     * @param results = Receives up to capacity handles.
+     * @param capacity = The size of results.
+     * @return the number of matching items, results holds the first capacity of them.
+     */
+    std::size_t query(const Circle& circle, uint32* results, std::size_t capacity) const;
+
+    /**
+     * @brief Removes every item.
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of items.
+     * @return the item count.
+     */
+    std::size_t size() const { return mItemCount; }
+
+private:
+
+    struct CellRange
+    {
+        int32 minX;
+        int32 minY;
+        int32 maxX;
+        int32 maxY;
+    };
+
+    struct Item
+    {
+        rectf bounds;
+        void* userData;
+        CellRange cells;
+
+        // Next free item while the item is in the free list.
+        uint32 next;
+    };
+
+    CellRange toCells(float minX, float minY, float maxX, float maxY) const;
+    std::size_t bucket(int32 x, int32 y) const;
+    CellRange store(uint32 handle, const rectf& bounds);
+    void link(uint32 handle);
+    void unlink(uint32 handle);
+
+    template <typename Test>
+    std::size_t gather(const CellRange& range, const Test& test, uint32* results, std::size_t capacity) const;
+
+    float mInvCellSize;
+    std::vector<std::vector<uint32> > mBuckets;
+
+    std::vector<Item> mItems;
+
+    // Resolved min and max corners of every item, what the queries read.
+    std::vector<float> mBoxes;
+
+    uint32 mFreeList;
+    std::size_t mItemCount;
+
+    // Cells touched by any item since the last clear, bounds the query loops.
+    CellRange mUsed;
+};
+
+} // namespace nx
+
+#endif // SPATIALHASH2D_H_INCLUDE
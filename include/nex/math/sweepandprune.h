@@ -0,0 +1,131 @@
+#ifndef SWEEPANDPRUNE_H_INCLUDE
+#define SWEEPANDPRUNE_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/math/aabb.h>
+
+// Standard includes.
+#include <cstddef>
+#include <vector>
+
+namespace nx
+{
+
+/**
+ * @brief Two proxies whose boxes overlap, proxyA < proxyB.
+ */
+struct SweepAndPrunePair
+{
+    uint32 proxyA;
+    uint32 proxyB;
+};
+
+/**
+ * Sweep and prune broadphase for many bodies of similar size.
+ *
+ * The boxes are kept sorted on the sweep axis by their minimum. Bodies move
+ * little between frames, so an insertion sort restores the order in close to
+ * linear time. The sweep then tests every box against the following boxes
+ * that start before it ends, 8 (AVX) or 4 (SSE) at a time on the other axes.
+ */
+class SweepAndPrune
+{
+public:
+
+    /**
+     * @brief Constructs an empty broadphase.
+     * @param axis = The sweep axis, 0 for x, 1 for y and 2 for z. Pick the axis the bodies spread the most along.
+     */
+    explicit SweepAndPrune(int axis = 0);
+
+    /**
+     * @brief Adds a proxy.
+     * @param box = The bounds of the body.
+     * @param userData = Value returned by getUserData.
+     * @return the proxy handle, valid until it is removed.
+     */
+    uint32 insert(const AABB& box, void* userData = 0);
+
+    /**
+     * @brief Removes a proxy, its handle may be reused by a later insert.
+     * @param proxy = The proxy to remove.
+     */
+    void remove(uint32 proxy);
+
+    /**
+     * @brief Changes the bounds of a proxy, the order is restored by the next call to findPairs.
+     * @param proxy = The proxy to update.
+     * @param box = The new bounds.
+     */
+    void update(uint32 proxy, const AABB& box) { mProxies[proxy].box = box; }
+
+    /**
+     * @brief Get the bounds of a proxy.
+     * @param proxy = The proxy.
+     * @return the bounds.
+     */
+    const AABB& getBounds(uint32 proxy) const { return mProxies[proxy].box; }
+
+    /**
+     * @brief Get the user data of a proxy.
+     * @param proxy = The proxy.
+     * @return the value passed to insert.
+     */
+    void* getUserData(uint32 proxy) const { return mProxies[proxy].userData; }
+
+    /**
+     * @brief Sorts the proxies and finds every overlapping pair.
+     * @return the pairs sorted by proxyA then proxyB, the storage is reused by the next call.
+     */
+    const std::vector<SweepAndPrunePair>& findPairs();
+
+    /**
+     * @brief Get the pairs found by the last call to findPairs.
+     * @return the pairs.
+     */
+    const std::vector<SweepAndPrunePair>& getPairs() const { return mPairs; }
+
+    /**
+     * @brief Get the number of proxies.
+     * @return the proxy count.
+     */
+    std::size_t size() const { return mSorted.size(); }
+
+private:
+
+    struct Proxy
+    {
+        AABB box;
+        void* userData;
+
+        // Next free proxy while the proxy is in the free list.
+        uint32 next;
+    };
+
+    struct Endpoint
+    {
+        float min;
+        uint32 proxy;
+    };
+
+    void sort();
+    void gather();
+
+    int mAxis;
+    std::vector<Proxy> mProxies;
+    uint32 mFreeList;
+
+    // Proxies in sweep order, nearly sorted between frames.
+    std::vector<Endpoint> mSorted;
+
+    // Proxies and bounds in sweep order as separate arrays, padded for full width loads.
+    std::vector<uint32> mOrder;
+    std::vector<float> mBounds[6];
+
+    std::vector<SweepAndPrunePair> mPairs;
+};
+
+} // namespace nx
+
+#endif // SWEEPANDPRUNE_H_INCLUDE
@@ -0,0 +1,218 @@
+#ifndef SWEPTQUERY_H_INCLUDE
+#define SWEPTQUERY_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/math/vec3.h>
+#include <nex/math/aabb.h>
+#include <nex/math/sphere.h>
+#include <nex/math/convexquery.h>
+
+// Standard includes.
+#include <cstddef>
+
+namespace nx
+{
+class JobSystem;
+
+/**
+ * @brief The most conservative advancement steps a SweptQuery takes before reporting a contact.
+ */
+const int32 SweptQueryMaxIterations = 32;
+
+/**
+ * @brief The distance at which conservative advancement considers two shapes touching.
+ */
+const float SweptQueryTolerance = 1e-3f;
+
+/**
+ * @brief The number of pairs above which a batch given a JobSystem is split across threads.
+ */
+const std::size_t SweptQueryParallelSize = 1024;
+
+/**
+ * @brief The result of a SweptQuery.
+ */
+struct SweptResult
+{
+    /**
+     * @brief true if the shapes touch during the motion.
+     */
+    bool hit;
+
+    /**
+     * @brief The fraction of the motions, between 0 and 1, at the first contact.
+     * 0 when the shapes overlap from the start, 1 when they never touch.
+     */
+    float time;
+
+    /**
+     * @brief Unit vector from the first shape towards the second one at the first contact.
+     * May be zero for boxes that overlap from the start.
+     */
+    vec3f normal;
+
+    /**
+     * @brief The contact point at the first contact.
+     */
+    vec3f point;
+};
+
+namespace priv
+{
+
+bool conservativeAdvancement(const SupportFunction& shapeA, const vec3f& motionA,
+                             const SupportFunction& shapeB, const vec3f& motionB,
+                             SweptResult& result, ConvexCache* cache);
+
+} // namespace priv
+
+/**
+ * Continuous collision detection between moving shapes.
+ *
+ * Each shape translates by its motion over the step. The queries return the
+ * earliest fraction of the step at which the shapes touch, so fast bodies
+ * cannot tunnel through thin geometry between two static tests. Spheres and
+ * boxes are solved in closed form. Any two convex shapes go through
+ * conservative advancement, which steps the shapes forward by the distance
+ * GJK reports divided by their closing speed.
+ *
+ * The batch versions run pairs of arrays side by side without allocating, the
+ * overloads taking a JobSystem split them across its threads. A null motion
+ * array stands for shapes at rest.
+ */
+class SweptQuery
+{
+public:
+
+    /**
+     * @brief Finds the first contact of two moving spheres.
+     * @param sphereA = The first sphere at the start of the step.
+     * @param motionA = The translation of the first sphere over the step.
+     * @param sphereB = The second sphere at the start of the step.
+     * @param motionB = The translation of the second sphere over the step.
+     * @param result = Receives the contact.
+     * @return true if the spheres touch during the step.
+     */
+    static bool sweep(const Sphere& sphereA, const vec3f& motionA, const Sphere& sphereB, const vec3f& motionB, SweptResult& result);
+
+    /**
+     * @brief Finds the first contact of a moving sphere and a moving box.
+     * @param sphere = The sphere at the start of the step.
+     * @param sphereMotion = The translation of the sphere over the step.
+     * @param box = The box at the start of the step.
+     * @param boxMotion = The translation of the box over the step.
+     * @param result = Receives the contact, the normal points from the sphere to the box.
+     * @return true if the shapes touch during the step.
+     */
+    static bool sweep(const Sphere& sphere, const vec3f& sphereMotion, const AABB& box, const vec3f& boxMotion, SweptResult& result);
+
+    /**
+     * @brief Finds the first contact of two moving boxes.
+     * @param boxA = The first box at the start of the step.
+     * @param motionA = The translation of the first box over the step.
+     * @param boxB = The second box at the start of the step.
+     * @param motionB = The translation of the second box over the step.
+     * @param result = Receives the contact.
+     * @return true if the boxes touch during the step.
+     */
+    static bool sweep(const AABB& boxA, const vec3f& motionA, const AABB& boxB, const vec3f& motionB, SweptResult& result);
+
+    /**
+     * @brief Sweeps pairs of spheres.
+     * @param spheresA = The first sphere of every pair.
+     * @param motionsA = The motions of spheresA, or 0 if they are at rest.
+     * @param spheresB = The second sphere of every pair.
+     * @param motionsB = The motions of spheresB, or 0 if they are at rest.
+     * @param count = The number of pairs.
+     * @param results = Receives count results.
+     */
+    static void sweep(const Sphere* spheresA, const vec3f* motionsA, const Sphere* spheresB, const vec3f* motionsB,
+                      std::size_t count, SweptResult* results);
+
+    /**
+     * @brief Sweeps pairs of spheres, on the threads of a job system.
+     * @param spheresA = The first sphere of every pair.
+     * @param motionsA = The motions of spheresA, or 0 if they are at rest.
+     * @param spheresB = The second sphere of every pair.
+     * @param motionsB = The motions of spheresB, or 0 if they are at rest.
+     * @param count = The number of pairs.
+     * @param results = Receives count results.
+     * @param jobs = The job system to run on.
+     */
+    static void sweep(const Sphere* spheresA, const vec3f* motionsA, const Sphere* spheresB, const vec3f* motionsB,
+                      std::size_t count, SweptResult* results, JobSystem& jobs);
+
+    /**
+     * @brief Sweeps pairs of a sphere and a box.
+     * @param spheres = The sphere of every pair.
+     * @param sphereMotions = The motions of the spheres, or 0 if they are at rest.
+     * @param boxes = The box of every pair.
+     * @param boxMotions = The motions of the boxes, or 0 if they are at rest.
+     * @param count = The number of pairs.
+     * @param results = Receives count results.
+     */
+    static void sweep(const Sphere* spheres, const vec3f* sphereMotions, const AABB* boxes, const vec3f* boxMotions,
+                      std::size_t count, SweptResult* results);
+
+    /**
+     * @brief Sweeps pairs of a sphere and a box, on the threads of a job system.
+     * @param spheres = The sphere of every pair.
+     * @param sphereMotions = The motions of the spheres, or 0 if they are at rest.
+     * @param boxes = The box of every pair.
+     * @param boxMotions = The motions of the boxes, or 0 if they are at rest.
+     * @param count = The number of pairs.
+     * @param results = Receives count results.
+     * @param jobs = The job system to run on.
+     */
+    static void sweep(const Sphere* spheres, const vec3f* sphereMotions, const AABB* boxes, const vec3f* boxMotions,
+                      std::size_t count, SweptResult* results, JobSystem& jobs);
+
+    /**
+     * @brief Sweeps pairs of boxes.
+     * @param boxesA = The first box of every pair.
+     * @param motionsA = The motions of boxesA, or 0 if they are at rest.
+     * @param boxesB = The second box of every pair.
+     * @param motionsB = The motions of boxesB, or 0 if they are at rest.
+     * @param count = The number of pairs.
+     * @param results = Receives count results.
+     */
+    static void sweep(const AABB* boxesA, const vec3f* motionsA, const AABB* boxesB, const vec3f* motionsB,
+                      std::size_t count, SweptResult* results);
+
+    /**
+     * @brief Sweeps pairs of boxes, on the threads of a job system.
+     * @param boxesA = The first box of every pair.
+     * @param motionsA = The motions of boxesA, or 0 if they are at rest.
+     * @param boxesB = The second box of every pair.
+     * @param motionsB = The motions of boxesB, or 0 if they are at rest.
+     * @param count = The number of pairs.
+     * @param results = Receives count results.
+     * @param jobs = The job system to run on.
+     */
+    static void sweep(const AABB* boxesA, const vec3f* motionsA, const AABB* boxesB, const vec3f* motionsB,
+                      std::size_t count, SweptResult* results, JobSystem& jobs);
+
+    /**
+     * @brief Finds the first contact of any two moving convex shapes by conservative advancement.
+     * The shapes are given as for ConvexQuery and only translate, the contact
+     * is reported once they come within SweptQueryTolerance.
+     * @param shapeA = The first shape at the start of the step.
+     * @param motionA = The translation of the first shape over the step.
+     * @param shapeB = The second shape at the start of the step.
+     * @param motionB = The translation of the second shape over the step.
+     * @param result = Receives the contact.
+     * @param cache = Optional simplex shared by the GJK queries of every step, updated on return.
+     * @return true if the shapes touch during the step.
+     */
+    template <typename ShapeA, typename ShapeB>
+    static bool advance(const ShapeA& shapeA, const vec3f& motionA, const ShapeB& shapeB, const vec3f& motionB,
+                        SweptResult& result, ConvexCache* cache = 0)
+    {
+        return priv::conservativeAdvancement(priv::SupportFunction(shapeA), motionA, priv::SupportFunction(shapeB), motionB, result, cache);
+    }
+};
+
+} // namespace nx
+
+#endif // SWEPTQUERY_H_INCLUDE
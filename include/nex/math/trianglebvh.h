@@ -0,0 +1,188 @@
+#ifndef TRIANGLEBVH_H_INCLUDE
+#define TRIANGLEBVH_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/system/instream.h>
+#include <nex/system/outstream.h>
+#include <nex/math/vec3.h>
+#include <nex/math/vec3array.h>
+#include <nex/math/aabb.h>
+#include <nex/math/ray.h>
+#include <nex/math/raypacket.h>
+#include <nex/math/bvh.h>
+
+// Standard includes.
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace nx
+{
+
+/**
+ * @brief The result of a TriangleBVH ray cast.
+ */
+struct TriangleHit
+{
+    /**
+     * @brief The index of the triangle that was hit, as numbered by TriangleBVH::build.
+     */
+    uint32 triangle;
+
+    /**
+     * @brief The distance along the ray, in units of the ray direction.
+     */
+    float distance;
+
+    /**
+     * @brief The weight of the second vertex at the hit point.
+     */
+    float u;
+
+    /**
+     * @brief The weight of the third vertex at the hit point.
+     */
+    float v;
+};
+
+/**
+ * Bounding volume hierarchy over the triangles of one mesh, for picking and
+ * ray casts.
+ *
+ * It is built once with the binned SAH builder of BVH and keeps only the
+ * nodes and the triangles, reordered so every leaf is a run of consecutive
+ * triangles. The vertices of those runs are stored as nine float arrays, a
+ * leaf is tested against a ray 8 (AVX) or 4 (SSE) triangles at a time.
+ * Packets test 4 or 8 rays against each triangle of the leaves they reach.
+ *
+ * The u and v of a hit interpolate vertex attributes with
+ * Vec3::barycentric(a, b, c, u, v), where a, b and c are the attributes of
+ * the three vertices of the triangle. Both faces of a triangle are hit.
+ *
+ * The hierarchy can be written to a stream and read back instead of being
+ * rebuilt, the format is the memory layout of the host.
+ */
+class TriangleBVH
+{
+public:
+
+    /**
+     * @brief Constructs an empty hierarchy.
+     */
+    TriangleBVH();
+
+    /**
+     * @brief Rebuilds the hierarchy over a triangle list, every three positions make a triangle.
+     * @param positions = The positions, for instance VertexList3d::getPositions.
+     * @param maxLeafSize = The largest number of triangles a leaf may hold.
+     */
+    void build(const Vec3View& positions, uint32 maxLeafSize = 8);
+
+    /**
+     * @brief Rebuilds the hierarchy over a triangle list, on the threads of a job system.
+     * @param positions = The positions, for instance VertexList3d::getPositions.
+     * @param maxLeafSize = The largest number of triangles a leaf may hold.
+     * @param jobs = The job system to run on.
+     */
+    void build(const Vec3View& positions, uint32 maxLeafSize, JobSystem& jobs);
+
+    /**
+     * @brief Rebuilds the hierarchy over an indexed triangle list.
+     * @param positions = The positions.
+     * @param indices = Three position indices per triangle.
+     * @param triangleCount = The number of triangles.
+     * @param maxLeafSize = The largest number of triangles a leaf may hold.
+     */
+    void build(const Vec3View& positions, const uint32* indices, std::size_t triangleCount, uint32 maxLeafSize = 8);
+
+    /**
+     * @brief Rebuilds the hierarchy over an indexed triangle list, on the threads of a job system.
+     * @param positions = The positions.
+     * @param indices = Three position indices per triangle.
+     * @param triangleCount = The number of triangles.
+     * @param maxLeafSize = The largest number of triangles a leaf may hold.
+     * @param jobs = The job system to run on.
+     */
+    void build(const Vec3View& positions, const uint32* indices, std::size_t triangleCount, uint32 maxLeafSize, JobSystem& jobs);
+
+    /**
+     * @brief Removes every node and triangle.
+     */
+    void clear();
+
+    /**
+     * @brief Finds the closest triangle hit by a ray.
+     * @param ray = The ray to cast.
+     * @param hit = Receives the closest hit, untouched if nothing is hit.
+     * @param maxDistance = Hits farther than this are ignored.
+     * @return true if a triangle was hit.
+     */
+    bool raycast(const Ray& ray, TriangleHit& hit, float maxDistance = std::numeric_limits<float>::max()) const;
+
+    /**
+     * @brief Finds the closest triangle hit by every ray of a packet.
+     * @param packet = The rays, each one limited by its maximum distance.
+     * @param hits = Receives 4 hits, left untouched for the rays that hit nothing.
+     * @return the mask of the rays that hit a triangle.
+     */
+    uint32 raycast(const RayPacket4& packet, TriangleHit* hits) const;
+
+    /**
+     * @brief Finds the closest triangle hit by every ray of a packet.
+     * @param packet = The rays, each one limited by its maximum distance.
+     * @param hits = Receives 8 hits, left untouched for the rays that hit nothing.
+     * @return the mask of the rays that hit a triangle.
+     */
+    uint32 raycast(const RayPacket8& packet, TriangleHit* hits) const;
+
+    /**
+     * @brief Writes the hierarchy to a stream.
+     * @param stream = The stream to write to.
+     * @return true if every byte was written.
+     */
+    bool write(OutStream& stream) const;
+
+    /**
+     * @brief Replaces the hierarchy by one written with write.
+     * @param stream = The stream to read from.
+     * @return true on success, the hierarchy is left empty otherwise.
+     */
+    bool read(InStream& stream);
+
+    /**
+     * @brief Get the bounds of the whole mesh.
+     * @return the root bounds, an empty box if the hierarchy is empty.
+     */
+    AABB getBounds() const;
+
+    const BVHNode* getNodes() const { return mNodes.empty() ? 0 : &mNodes[0]; }
+    std::size_t getNodeCount() const { return mNodes.size(); }
+    std::size_t size() const { return mTriangleCount; }
+    bool empty() const { return mTriangleCount == 0; }
+
+private:
+
+    template <std::size_t Size>
+    uint32 raycastPacket(const RayPacket<Size>& packet, TriangleHit* hits) const;
+
+    // A null indices array stands for a triangle list, a null jobs for the calling thread.
+    void rebuild(const Vec3View& positions, const uint32* indices, std::size_t triangleCount, uint32 maxLeafSize, JobSystem* jobs);
+    const float* getStream(int vertex, int axis) const { return &mVertices[(vertex * 3 + axis) * mStride]; }
+
+    std::vector<BVHNode> mNodes;
+
+    // The x, y and z of the first, second and third vertices in leaf order,
+    // nine arrays of mStride floats padded with empty triangles.
+    std::vector<float> mVertices;
+
+    // The build numbering of the triangles in leaf order.
+    std::vector<uint32> mTriangles;
+
+    std::size_t mTriangleCount;
+    std::size_t mStride;
+};
+
+} // namespace nx
+
+#endif // TRIANGLEBVH_H_INCLUDE
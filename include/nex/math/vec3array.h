@@ -0,0 +1,245 @@
+#ifndef VEC3ARRAY_H_INCLUDE
+#define VEC3ARRAY_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/math/vec3.h>
+
+// Standard includes.
+#include <cstddef>
+#include <vector>
+
+namespace nx
+{
+
+/**
+ * Non owning view over vec3f stored in any interleaved layout, like
+ * std::vector<vec3f> or the positions of a VertexList3d.
+ */
+class Vec3View
+{
+public:
+
+    /**
+     * @brief Constructs an empty view.
+     */
+    Vec3View() : mData(0), mSize(0), mStride(sizeof(vec3f)) { }
+
+    /**
+     * @brief Constructs a view over a strided sequence of vectors.
+     * @param data = Pointer to the first vector.
+     * @param size = The number of vectors.
+     * @param stride = The distance in bytes between two vectors.
+     */
+    Vec3View(vec3f* data, std::size_t size, std::size_t stride = sizeof(vec3f))
+        : mData(reinterpret_cast<uint8*>(data)), mSize(size), mStride(stride) { }
+
+    /**
+     * @brief Constructs a view over the contents of a vector, valid until it reallocates.
+     * @param vector = The vector to view.
+     */
+    Vec3View(std::vector<vec3f>& vector)
+        : mData(vector.empty() ? 0 : reinterpret_cast<uint8*>(&vector[0])), mSize(vector.size()), mStride(sizeof(vec3f)) { }
+
+    vec3f& operator[](std::size_t index) const { return *reinterpret_cast<vec3f*>(mData + index * mStride); }
+
+    std::size_t size() const { return mSize; }
+    std::size_t getStride() const { return mStride; }
+    bool empty() const { return mSize == 0; }
+
+private:
+
+    uint8* mData;
+    std::size_t mSize;
+    std::size_t mStride;
+};
+
+/**
+ * Structure of arrays storage for vec3f. The x, y and z coordinates live in
+ * separate 32 byte aligned float arrays so the bulk operations below process
+ * 8 (AVX) or 4 (SSE) vectors per instruction.
+ */
+class Vec3Array
+{
+public:
+
+    /**
+     * @brief Constructs an empty array.
+     */
+    Vec3Array();
+
+    /**
+     * @brief Constructs an array of zero vectors.
+     * @param size = The number of vectors.
+     */
+    explicit Vec3Array(std::size_t size);
+
+    /**
+     * @brief Constructs an array holding a copy of the viewed vectors.
+     * @param view = The vectors to copy.
+     */
+    explicit Vec3Array(const Vec3View& view);
+
+    Vec3Array(const Vec3Array& other);
+    Vec3Array& operator=(const Vec3Array& other);
+    ~Vec3Array();
+
+    /**
+     * @brief Changes the number of vectors, new vectors are zero.
+     * @param size = The new number of vectors.
+     */
+    void resize(std::size_t size);
+
+    /**
+     * @brief Makes room for at least capacity vectors without changing the size.
+     * @param capacity = The number of vectors to make room for.
+     */
+    void reserve(std::size_t capacity);
+
+    /**
+     * @brief Removes all the vectors, the memory is kept.
+     */
+    void clear() { mSize = 0; }
+
+    /**
+     * @brief Adds a vector at the end of the array.
+     * @param vector = The vector to add.
+     */
+    void append(const vec3f& vector);
+
+    std::size_t size() const { return mSize; }
+    std::size_t capacity() const { return mCapacity; }
+    bool empty() const { return mSize == 0; }
+
+    vec3f get(std::size_t index) const { return vec3f(mX[index], mY[index], mZ[index]); }
+    void set(std::size_t index, const vec3f& vector) { mX[index] = vector.x; mY[index] = vector.y; mZ[index] = vector.z; }
+
+    float* getX() { return mX; }
+    float* getY() { return mY; }
+    float* getZ() { return mZ; }
+    const float* getX() const { return mX; }
+    const float* getY() const { return mY; }
+    const float* getZ() const { return mZ; }
+
+    /**
+     * @brief Replaces the contents with a copy of the viewed vectors.
+     * @param view = The vectors to copy.
+     */
+    void assign(const Vec3View& view);
+
+    /**
+     * @brief Writes the vectors back to interleaved storage.
+     * @param view = The destination, must hold at least size() vectors.
+     */
+    void store(const Vec3View& view) const;
+
+    /**
+     * @brief Replaces the contents of a std::vector with the vectors of this array.
+     * @param vector = The destination vector, resized to size().
+     */
+    void store(std::vector<vec3f>& vector) const;
+
+    /**
+     * @brief Normalizes every vector in place.
+     */
+    void normalize();
+
+    /**
+     * @brief Calculates the length of every vector.
+     * @param result = The destination, must hold at least size() floats.
+     */
+    void length(float* result) const;
+
+    /**
+     * @brief Calculates the squared length of every vector.
+     * @param result = The destination, must hold at least size() floats.
+     */
+    void lengthSquared(float* result) const;
+
+    /**
+     * @brief Get the component wise minimum of all the vectors.
+     * @return the smallest coordinates, FLT_MAX for an empty array.
+     */
+    vec3f reduceMin() const;
+
+    /**
+     * @brief Get the component wise maximum of all the vectors.
+     * @return the largest coordinates, -FLT_MAX for an empty array.
+     */
+    vec3f reduceMax() const;
+
+    /**
+     * @brief Get the bounds of all the vectors in one call.
+     * @param min = Receives the result of reduceMin.
+     * @param max = Receives the result of reduceMax.
+     */
+    void bounds(vec3f& min, vec3f& max) const;
+
+    /**
+     * @brief Get the sum of all the vectors.
+     * @return the sum.
+     */
+    vec3f sum() const;
+
+    /**
+     * @brief Get the average of all the vectors.
+     * @return the centroid, a zero vector for an empty array.
+     */
+    vec3f centroid() const;
+
+    /**
+     * @brief Calculates the dot product of every pair of vectors.
+     * @param a = The first array.
+     * @param b = The second array, same size as a.
+     * @param result = The destination, must hold at least a.size() floats.
+     */
+    static void dot(const Vec3Array& a, const Vec3Array& b, float* result);
+
+    /**
+     * @brief Calculates the cross product of every pair of vectors.
+     * @param a = The first array.
+     * @param b = The second array, same size as a.
+     * @param result = The destination, resized to a.size(), may be a or b.
+     */
+    static void cross(const Vec3Array& a, const Vec3Array& b, Vec3Array& result);
+
+    /**
+     * @brief Linear interpolation of every pair of vectors.
+     * @param a = The start vectors.
+     * @param b = The end vectors, same size as a.
+     * @param amount = The interpolation factor.
+     * @param result = The destination, resized to a.size(), may be a or b.
+     */
+    static void lerp(const Vec3Array& a, const Vec3Array& b, float amount, Vec3Array& result);
+
+    /**
+     * @brief Component wise minimum of every pair of vectors.
+     * @param a = The first array.
+     * @param b = The second array, same size as a.
+     * @param result = The destination, resized to a.size(), may be a or b.
+     */
+    static void min(const Vec3Array& a, const Vec3Array& b, Vec3Array& result);
+
+    /**
+     * @brief Component wise maximum of every pair of vectors.
+     * @param a = The first array.
+     * @param b = The second array, same size as a.
+     * @param result = The destination, resized to a.size(), may be a or b.
+     */
+    static void max(const Vec3Array& a, const Vec3Array& b, Vec3Array& result);
+
+private:
+
+    void reallocate(std::size_t capacity);
+
+    float* mData;
+    float* mX;
+    float* mY;
+    float* mZ;
+    std::size_t mSize;
+    std::size_t mCapacity;
+};
+
+} // namespace nx
+
+#endif // VEC3ARRAY_H_INCLUDE
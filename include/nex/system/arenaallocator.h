@@ -0,0 +1,85 @@
+#ifndef ARENAALLOCATOR_H_INCLUDE
+#define ARENAALLOCATOR_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/framearena.h>
+
+// Standard includes.
+#include <cstddef>
+#include <new>
+
+namespace nx
+{
+
+/**
+ * Standard allocator drawing from an arena, so standard containers can hold
+ * temporary data without touching the heap:
+ *
+ *     std::vector<vec3f, ArenaAllocator<vec3f> > points(ArenaAllocator<vec3f>(frameArena));
+ *
+ * Arena is a FrameArena or a ScratchArena. Freed memory is only reused when
+ * it is the last allocation of the arena. A growing vector allocates its new
+ * block before it frees the old one, so the old block is not reclaimed and
+ * every growth costs arena space: reserve up front. The rest comes back when
+ * the arena is reset or rewound. The container must not outlive that.
+ */
+template <typename T, typename Arena = FrameArena>
+class ArenaAllocator
+{
+public:
+
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef ArenaAllocator<U, Arena> other;
+    };
+
+    explicit ArenaAllocator(Arena& arena) : mArena(&arena) { }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U, Arena>& other) : mArena(&other.getArena()) { }
+
+    T* allocate(std::size_t count)
+    {
+        T* memory = mArena->template allocate<T>(count);
+        if (!memory && count > 0)
+            throw std::bad_alloc();
+
+        return memory;
+    }
+
+    void deallocate(T* memory, std::size_t count)
+    {
+        mArena->deallocate(memory, count * sizeof(T));
+    }
+
+    Arena& getArena() const { return *mArena; }
+
+private:
+
+    Arena* mArena;
+};
+
+template <typename T, typename U, typename Arena>
+inline bool operator ==(const ArenaAllocator<T, Arena>& left, const ArenaAllocator<U, Arena>& right)
+{
+    return &left.getArena() == &right.getArena();
+}
+
+template <typename T, typename U, typename Arena>
+inline bool operator !=(const ArenaAllocator<T, Arena>& left, const ArenaAllocator<U, Arena>& right)
+{
+    return !(left == right);
+}
+
+} // namespace nx
+
+#endif // ARENAALLOCATOR_H_INCLUDE
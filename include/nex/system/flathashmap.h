@@ -0,0 +1,147 @@
+#ifndef FLATHASHMAP_H_INCLUDE
+#define FLATHASHMAP_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+
+// Standard includes.
+#include <cstddef>
+#include <vector>
+
+namespace nx
+{
+
+/**
+ * Hash map from integer keys to small values, stored in flat arrays.
+ *
+ * Open addressing with linear probing: a lookup hashes the key once and
+ * scans neighbouring slots of one array, with no node to chase. The table
+ * doubles before it is half full. Entries cannot be erased, the map suits
+ * caches that only grow until cleared.
+ *
+ * The key with every bit set marks empty slots and cannot be stored.
+ */
+template <typename Key, typename Value>
+class FlatHashMap
+{
+public:
+
+    FlatHashMap() :
+        mSize(0),
+        mShift(64)
+    { }
+
+    /**
+     * @brief Looks a key up.
+     * @param key = The key.
+     * @return the value of the key, or 0 if it is not in the map.
+     */
+    Value* find(Key key)
+    {
+        if (mKeys.empty())
+            return 0;
+
+        const std::size_t mask = mKeys.size() - 1;
+        for (std::size_t slot = getSlot(key); ; slot = (slot + 1) & mask)
+        {
+            if (mKeys[slot] == key)
+                return &mValues[slot];
+
+            if (mKeys[slot] == EmptyKey)
+                return 0;
+        }
+    }
+
+    const Value* find(Key key) const
+    {
+        return const_cast<FlatHashMap*>(this)->find(key);
+    }
+
+    /**
+     * @brief Sets the value of a key, adding the key if needed.
+     * References returned earlier may be invalidated.
+     * @param key = The key, not EmptyKey.
+     * @param value = The value.
+     * @return the stored value.
+     */
+    Value& insert(Key key, const Value& value)
+    {
+        if ((mSize + 1) * 2 > mKeys.size())
+            rehash(mKeys.empty() ? MinimumCapacity : mKeys.size() * 2);
+
+        const std::size_t mask = mKeys.size() - 1;
+        std::size_t slot = getSlot(key);
+        while (mKeys[slot] != EmptyKey && mKeys[slot] != key)
+            slot = (slot + 1) & mask;
+
+        if (mKeys[slot] == EmptyKey)
+        {
+            mKeys[slot] = key;
+            ++mSize;
+        }
+
+        mValues[slot] = value;
+        return mValues[slot];
+    }
+
+    /**
+     * @brief Removes every entry, the memory is kept.
+     */
+    void clear()
+    {
+        mKeys.assign(mKeys.size(), EmptyKey);
+        mSize = 0;
+    }
+
+    std::size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+
+    /**
+     * @brief The reserved key marking empty slots.
+     */
+    static const Key EmptyKey = static_cast<Key>(~static_cast<Key>(0));
+
+private:
+
+    static const std::size_t MinimumCapacity = 16;
+
+    // Fibonacci hashing, the high bits of the product are well mixed.
+    std::size_t getSlot(Key key) const
+    {
+        return static_cast<std::size_t>((static_cast<uint64>(key) * 0x9E3779B97F4A7C15ull) >> mShift);
+    }
+
+    void rehash(std::size_t capacity)
+    {
+        std::vector<Key> keys(capacity, EmptyKey);
+        std::vector<Value> values(capacity);
+        keys.swap(mKeys);
+        values.swap(mValues);
+
+        mShift = 64;
+        for (std::size_t size = capacity; size > 1; size >>= 1)
+            --mShift;
+
+        mSize = 0;
+        for (std::size_t slot = 0; slot < keys.size(); ++slot)
+        {
+            if (keys[slot] != EmptyKey)
+                insert(keys[slot], values[slot]);
+        }
+    }
+
+    std::vector<Key> mKeys;
+    std::vector<Value> mValues;
+    std::size_t mSize;
+    uint32 mShift;
+};
+
+template <typename Key, typename Value>
+const Key FlatHashMap<Key, Value>::EmptyKey;
+
+template <typename Key, typename Value>
+const std::size_t FlatHashMap<Key, Value>::MinimumCapacity;
+
+} // namespace nx
+
+#endif // FLATHASHMAP_H_INCLUDE
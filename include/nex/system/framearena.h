@@ -0,0 +1,82 @@
+#ifndef FRAMEARENA_H_INCLUDE
+#define FRAMEARENA_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/noncopyable.h>
+
+// Standard includes.
+#include <cstddef>
+#include <vector>
+
+namespace nx
+{
+
+/**
+ * Bump pointer allocator for data that lives until the end of a frame.
+ *
+ * Allocations come out of one block and are all released by reset, called
+ * once per frame. Unlike a ScratchArena the frame arena never fails: when the
+ * block is full the allocation goes to the heap, and the next reset grows
+ * the block to the peak of the frame, so after a few frames the arena stops
+ * touching the heap entirely. No destructor is run.
+ */
+class FrameArena : public NonCopyable
+{
+public:
+
+    /**
+     * @brief Allocates the first block of the arena.
+     * @param capacity = The size of the block in bytes, it grows on demand.
+     */
+    explicit FrameArena(std::size_t capacity);
+
+    ~FrameArena();
+
+    /**
+     * @brief Reserves memory until the next reset.
+     * @param size = The number of bytes.
+     * @param alignment = The alignment of the memory, a power of two.
+     * @return the memory, 0 only if the heap is exhausted.
+     */
+    void* allocate(std::size_t size, std::size_t alignment = 16);
+
+    /**
+     * @brief Reserves an uninitialized array until the next reset.
+     * @param count = The number of elements.
+     * @return the array.
+     */
+    template <typename T>
+    T* allocate(std::size_t count)
+    {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * @brief Gives back the last allocation of the block, anything else waits for reset.
+     * @param memory = The memory from allocate.
+     * @param size = The size given to allocate.
+     */
+    void deallocate(void* memory, std::size_t size);
+
+    /**
+     * @brief Releases every allocation, grows the block if the frame did not fit in it.
+     */
+    void reset();
+
+    std::size_t getCapacity() const { return mCapacity; }
+    std::size_t getUsed() const { return mOffset + mOverflowSize; }
+
+private:
+
+    char* mData;
+    std::size_t mCapacity;
+    std::size_t mOffset;
+
+    // Heap blocks taken once the block was full, freed by reset.
+    std::vector<void*> mOverflow;
+    std::size_t mOverflowSize;
+};
+
+} // namespace nx
+
+#endif // FRAMEARENA_H_INCLUDE
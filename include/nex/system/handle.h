@@ -0,0 +1,51 @@
+#ifndef HANDLE_H_INCLUDE
+#define HANDLE_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+
+namespace nx
+{
+
+/**
+ * Reference to an object of an ObjectPool.
+ *
+ * A handle is a slot index and the generation of the object that lived in
+ * the slot when the handle was made. Destroying the object bumps the
+ * generation of the slot, so every handle to it goes stale at once instead
+ * of dangling, and the pool answers 0 for it. Copying a handle is copying
+ * two integers, there is no reference count.
+ */
+template <typename T>
+struct Handle
+{
+    /**
+     * @brief Constructs a handle that refers to nothing.
+     */
+    Handle() : index(0), generation(0) { }
+
+    Handle(uint32 index, uint32 generation) : index(index), generation(generation) { }
+
+    /**
+     * @brief Tells whether the handle was ever given by a pool, it may be stale since.
+     * @return false for a default constructed handle.
+     */
+    bool isNull() const { return generation == 0; }
+
+    bool operator ==(const Handle& other) const { return index == other.index && generation == other.generation; }
+    bool operator !=(const Handle& other) const { return !(*this == other); }
+
+    /**
+     * @brief The slot of the object in the pool.
+     */
+    uint32 index;
+
+    /**
+     * @brief The generation of the slot when the object was created, odd for live objects.
+     */
+    uint32 generation;
+};
+
+} // namespace nx
+
+#endif // HANDLE_H_INCLUDE
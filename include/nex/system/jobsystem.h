@@ -0,0 +1,259 @@
+#ifndef JOBSYSTEM_H_INCLUDE
+#define JOBSYSTEM_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/system/noncopyable.h>
+#include <nex/system/scratcharena.h>
+
+// Standard includes.
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace nx
+{
+
+/**
+ * @brief The number of jobs a worker queues before running new ones inline.
+ */
+const std::size_t JobSystemQueueCapacity = 4096;
+
+/**
+ * @brief The default size in bytes of the scratch arena of every thread.
+ */
+const std::size_t JobSystemScratchSize = 1 << 20;
+
+/**
+ * @brief Counts the jobs submitted against it that have not finished yet.
+ */
+class JobCounter : public NonCopyable
+{
+public:
+
+    JobCounter() : mPending(0) { }
+
+    /**
+     * @brief Tells whether every job submitted against the counter has finished.
+     * @return true when nothing is pending.
+     */
+    bool isDone() const { return mPending.load(std::memory_order_acquire) == 0; }
+
+private:
+
+    friend class JobSystem;
+
+    std::atomic<int32> mPending;
+};
+
+/**
+ * @brief A function to run on the JobSystem, owned by the caller until its counter is waited on.
+ */
+struct Job
+{
+    Job() : function(0), data(0), counter(0) { }
+
+    Job(void (*function)(void*), void* data) : function(function), data(data), counter(0) { }
+
+    /**
+     * @brief The function to run, it receives data.
+     */
+    void (*function)(void* data);
+
+    /**
+     * @brief The argument of the function.
+     */
+    void* data;
+
+    /**
+     * @brief The counter given to JobSystem::submit, set by the job system.
+     */
+    JobCounter* counter;
+};
+
+namespace priv
+{
+
+/**
+ * @brief A loop shared by the threads of a parallelFor or parallelReduce.
+ * Every thread that picks it up claims chunks of grain indices until none are
+ * left, so fast threads take more chunks than slow ones.
+ */
+struct ParallelLoop
+{
+    ParallelLoop(std::size_t count, std::size_t grain) : count(count), grain(grain), next(0) { }
+
+    // Claims the next chunk, returns false once the loop is exhausted.
+    bool claim(std::size_t& begin, std::size_t& end)
+    {
+        begin = next.fetch_add(grain, std::memory_order_relaxed);
+        if (begin >= count)
+            return false;
+
+        end = count - begin < grain ? count : begin + grain;
+        return true;
+    }
+
+    // Runs chunks on the calling thread until none are left.
+    void (*run)(ParallelLoop& loop);
+
+    std::size_t count;
+    std::size_t grain;
+    std::atomic<std::size_t> next;
+};
+
+} // namespace priv
+
+/**
+ * Work stealing thread pool.
+ *
+ * Every worker owns a Chase-Lev deque. A worker pushes and pops its own jobs
+ * at one end while idle workers steal from the other end of the others, so
+ * the load balances itself without a shared queue. Threads outside the pool
+ * submit through a small locked queue. Waiting on a counter never blocks:
+ * the waiting thread runs queued jobs until the counter drops to zero, which
+ * also lets jobs start and wait for nested jobs.
+ *
+ * parallelFor and parallelReduce split a range in chunks of a grain size
+ * that the calling thread and the workers claim until the range is done.
+ * Small grains balance better, large grains cost less per chunk. Nothing is
+ * allocated per call.
+ *
+ * Each thread also gets a ScratchArena for temporary buffers.
+ *
+ * The pool starts with one thread per hardware thread, the calling thread
+ * counting as one. setThreadCount pins another count, 1 runs everything on
+ * the calling thread, which makes timings and reductions reproducible.
+ */
+class JobSystem : public NonCopyable
+{
+public:
+
+    /**
+     * @brief Get the unique instance of the class, the workers start on the first call.
+     * @return Reference to the JobSystem instance.
+     */
+    static JobSystem& getInstance();
+
+    ~JobSystem();
+
+    /**
+     * @brief Restarts the pool with another number of threads, no job may be running.
+     * @param count = The number of threads working on jobs, the calling thread included.
+     * 0 picks the number of hardware threads.
+     */
+    void setThreadCount(std::size_t count);
+
+    /**
+     * @brief Get the number of threads working on jobs, the calling thread included.
+     * @return the thread count, at least 1.
+     */
+    std::size_t getThreadCount() const { return mThreadCount; }
+
+    /**
+     * @brief Get the index of the calling thread in the pool.
+     * @return 1 to getThreadCount() - 1 on workers, 0 on any other thread.
+     */
+    static std::size_t getThreadIndex();
+
+    /**
+     * @brief Changes the capacity of the scratch arenas created from now on.
+     * @param size = The capacity in bytes.
+     */
+    void setScratchSize(std::size_t size) { mScratchSize = size; }
+
+    /**
+     * @brief Get the scratch arena of the calling thread.
+     * The arena is created on first use and lives as long as the thread, jobs
+     * should rewind it before they return, for instance with a ScratchScope.
+     * @return the arena.
+     */
+    ScratchArena& getScratch();
+
+    /**
+     * @brief Queues a job.
+     * @param job = The job, it must stay alive until the counter is done.
+     * @param counter = Incremented now and decremented when the job has run.
+     */
+    void submit(Job& job, JobCounter& counter);
+
+    /**
+     * @brief Runs queued jobs until every job submitted against a counter has finished.
+     * @param counter = The counter to wait for.
+     */
+    void wait(JobCounter& counter);
+
+    /**
+     * @brief Calls function(begin, end) on chunks covering [0, count), on every thread of the pool.
+     * @param count = The number of indices.
+     * @param grainSize = The number of indices per chunk, 0 picks about four chunks per thread.
+     * @param function = The callable, it must be safe to call from several threads at once.
+     */
+    template <typename Function>
+    void parallelFor(std::size_t count, std::size_t grainSize, Function function);
+
+    /**
+     * @brief Maps chunks of [0, count) to values and combines them.
+     * Each thread combines the chunks it ran before merging with the others,
+     * the order is not fixed so reduce must be associative and commutative.
+     * @param count = The number of indices.
+     * @param grainSize = The number of indices per chunk, 0 picks about four chunks per thread.
+     * @param identity = The value that reduce leaves unchanged, returned when count is 0.
+     * @param map = Callable T(std::size_t begin, std::size_t end).
+     * @param reduce = Callable T(const T&, const T&).
+     * @return the combined value.
+     */
+    template <typename T, typename Map, typename Reduce>
+    T parallelReduce(std::size_t count, std::size_t grainSize, const T& identity, Map map, Reduce reduce);
+
+    /**
+     * @brief Runs two callables, possibly in parallel, and waits for both.
+     * @param first = Runs on the calling thread.
+     * @param second = Queued for another thread, or run after first if nobody took it.
+     */
+    template <typename FunctionA, typename FunctionB>
+    void parallelInvoke(FunctionA first, FunctionB second);
+
+private:
+
+    struct Worker;
+
+    JobSystem();
+
+    void start(std::size_t count);
+    void stop();
+    void workerMain(std::size_t index);
+
+    Job* findJob(std::size_t index);
+    void execute(Job& job);
+    void runLoop(priv::ParallelLoop& loop);
+
+    std::size_t getGrainSize(std::size_t count, std::size_t grainSize) const;
+
+    std::size_t mThreadCount;
+    std::size_t mScratchSize;
+
+    // Index 0 stands for the threads outside the pool and has no deque.
+    Worker** mWorkers;
+
+    // Jobs submitted from outside the pool, a ring buffer under mLock.
+    std::mutex mLock;
+    Job** mInjected;
+    std::size_t mInjectedCapacity;
+    std::size_t mInjectedHead;
+    std::size_t mInjectedCount;
+
+    // Queued jobs, idle workers sleep on mWake while it is 0.
+    std::atomic<int32> mQueued;
+    std::atomic<int32> mSleeping;
+    std::atomic<bool> mRunning;
+    std::mutex mSleepLock;
+    std::condition_variable mWake;
+};
+
+#include <nex/system/jobsystem.inl>
+
+} // namespace nx
+
+#endif // JOBSYSTEM_H_INCLUDE
@@ -0,0 +1,126 @@
+namespace priv
+{
+
+template <typename Function>
+struct ForLoop : ParallelLoop
+{
+    ForLoop(std::size_t count, std::size_t grain, Function& function) :
+        ParallelLoop(count, grain),
+        function(function)
+    {
+        run = &ForLoop::runChunks;
+    }
+
+    static void runChunks(ParallelLoop& base)
+    {
+        ForLoop& loop = static_cast<ForLoop&>(base);
+
+        std::size_t begin;
+        std::size_t end;
+        while (loop.claim(begin, end))
+            loop.function(begin, end);
+    }
+
+    Function& function;
+};
+
+template <typename T, typename Map, typename Reduce>
+struct ReduceLoop : ParallelLoop
+{
+    ReduceLoop(std::size_t count, std::size_t grain, const T& identity, Map& map, Reduce& reduce) :
+        ParallelLoop(count, grain),
+        map(map),
+        reduce(reduce),
+        result(identity)
+    {
+        run = &ReduceLoop::runChunks;
+    }
+
+    static void runChunks(ParallelLoop& base)
+    {
+        ReduceLoop& loop = static_cast<ReduceLoop&>(base);
+
+        std::size_t begin;
+        std::size_t end;
+        if (!loop.claim(begin, end))
+            return;
+
+        // Combine locally first, the lock is taken once per thread.
+        T value = loop.map(begin, end);
+        while (loop.claim(begin, end))
+            value = loop.reduce(value, loop.map(begin, end));
+
+        std::lock_guard<std::mutex> guard(loop.lock);
+        loop.result = loop.reduce(loop.result, value);
+    }
+
+    Map& map;
+    Reduce& reduce;
+    T result;
+    std::mutex lock;
+};
+
+template <typename Function>
+void invokeFunction(void* data)
+{
+    (*static_cast<Function*>(data))();
+}
+
+} // namespace priv
+
+template <typename Function>
+void JobSystem::parallelFor(std::size_t count, std::size_t grainSize, Function function)
+{
+    const std::size_t grain = getGrainSize(count, grainSize);
+
+    if (count <= grain || mThreadCount <= 1)
+    {
+        // The same chunks as the parallel version, run in order.
+        for (std::size_t begin = 0; begin < count; begin += grain)
+            function(begin, count - begin < grain ? count : begin + grain);
+        return;
+    }
+
+    priv::ForLoop<Function> loop(count, grain, function);
+    runLoop(loop);
+}
+
+template <typename T, typename Map, typename Reduce>
+T JobSystem::parallelReduce(std::size_t count, std::size_t grainSize, const T& identity, Map map, Reduce reduce)
+{
+    const std::size_t grain = getGrainSize(count, grainSize);
+
+    if (count == 0)
+        return identity;
+
+    if (count <= grain || mThreadCount <= 1)
+    {
+        // The same chunks as the parallel version, folded in order.
+        T result = identity;
+        for (std::size_t begin = 0; begin < count; begin += grain)
+            result = reduce(result, map(begin, count - begin < grain ? count : begin + grain));
+        return result;
+    }
+
+    priv::ReduceLoop<T, Map, Reduce> loop(count, grain, identity, map, reduce);
+    runLoop(loop);
+    return loop.result;
+}
+
+template <typename FunctionA, typename FunctionB>
+void JobSystem::parallelInvoke(FunctionA first, FunctionB second)
+{
+    if (mThreadCount <= 1)
+    {
+        first();
+        second();
+        return;
+    }
+
+    Job job(&priv::invokeFunction<FunctionB>, &second);
+    JobCounter counter;
+    submit(job, counter);
+
+    first();
+    wait(counter);
+}
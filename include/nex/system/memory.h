@@ -0,0 +1,53 @@
+#ifndef MEMORY_H_INCLUDE
+#define MEMORY_H_INCLUDE
+
+// Standard includes.
+#include <cstddef>
+#include <cstdlib>
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+#include <malloc.h>
+#endif
+
+namespace nx
+{
+
+/**
+ * @brief The size in bytes of a cache line on the platforms we target.
+ */
+const std::size_t CacheLineSize = 64;
+
+/**
+ * @brief Allocate a block of memory aligned to the given boundary.
+ * @param size = The number of bytes to allocate.
+ * @param alignment = The alignment in bytes, must be a power of two and a multiple of sizeof(void*).
+ * @return the memory block or 0 if the allocation failed, release it with alignedFree.
+ */
+inline void* alignedMalloc(std::size_t size, std::size_t alignment)
+{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+    return _aligned_malloc(size, alignment);
+#else
+    void* memory = 0;
+    if (posix_memalign(&memory, alignment, size) != 0)
+        return 0;
+    return memory;
+#endif
+}
+
+/**
+ * @brief Release a block of memory allocated with alignedMalloc.
+ * @param memory = The memory block, may be 0.
+ */
+inline void alignedFree(void* memory)
+{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+    _aligned_free(memory);
+#else
+    free(memory);
+#endif
+}
+
+} // namespace nx
+
+#endif // MEMORY_H_INCLUDE
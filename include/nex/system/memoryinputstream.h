@@ -10,7 +10,7 @@
 namespace nx
 {
 
-class MemoryInputStream
+class MemoryInputStream : public InStream
 {
 public:
 
@@ -7,7 +7,7 @@
 namespace nx
 {
 
-class MemoryOutputStream
+class MemoryOutputStream : public OutStream
 {
 
 public:
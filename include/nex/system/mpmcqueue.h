@@ -0,0 +1,177 @@
+#ifndef MPMCQUEUE_H_INCLUDE
+#define MPMCQUEUE_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/memory.h>
+#include <nex/system/noncopyable.h>
+
+// Standard includes.
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace nx
+{
+
+/**
+ * Bounded lock free queue for any number of producers and consumers.
+ *
+ * Dmitry Vyukov's design: every slot carries a sequence number telling
+ * whether it is ready to be written or read for a given lap around the
+ * ring. A producer claims a position with a compare and swap on the tail,
+ * writes the item and publishes it by bumping the sequence of the slot, a
+ * consumer does the same on the head. Producers and consumers only meet on
+ * a slot, never on a shared lock or count.
+ *
+ * T must be default constructible and copy assignable.
+ */
+template <typename T>
+class MpmcQueue : public NonCopyable
+{
+public:
+
+    /**
+     * @brief Creates an empty queue.
+     * @param capacity = The largest number of items, rounded up to a power of two, at least 2.
+     */
+    explicit MpmcQueue(std::size_t capacity = 1024) :
+        mTail(0),
+        mHead(0)
+    {
+        std::size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        mMask = size - 1;
+        mCells = new Cell[size];
+        for (std::size_t index = 0; index < size; ++index)
+            mCells[index].sequence.store(index, std::memory_order_relaxed);
+    }
+
+    ~MpmcQueue()
+    {
+        delete[] mCells;
+    }
+
+    /**
+     * @brief Adds an item, any thread may call it.
+     * @param item = The item.
+     * @return false if the queue is full.
+     */
+    bool push(const T& item)
+    {
+        Cell* cell;
+        std::size_t position = mTail.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &mCells[position & mMask];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+            if (difference == 0)
+            {
+                if (mTail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+            {
+                // The slot still holds the item of the previous lap.
+                return false;
+            }
+            else
+            {
+                position = mTail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->item = item;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Takes the oldest item, any thread may call it.
+     * @param item = Receives the item.
+     * @return false if the queue is empty.
+     */
+    bool pop(T& item)
+    {
+        Cell* cell;
+        std::size_t position = mHead.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &mCells[position & mMask];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+
+            if (difference == 0)
+            {
+                if (mHead.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+            {
+                // Nothing written to the slot for this lap yet.
+                return false;
+            }
+            else
+            {
+                position = mHead.load(std::memory_order_relaxed);
+            }
+        }
+
+        item = cell->item;
+        cell->sequence.store(position + mMask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Get an estimate of the number of items, only exact while no other thread uses the queue.
+     * @return the number of items.
+     */
+    std::size_t size() const
+    {
+        const std::size_t head = mHead.load(std::memory_order_acquire);
+        const std::size_t tail = mTail.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+    std::size_t capacity() const { return mMask + 1; }
+
+    // operator new only honours the default alignment before C++17, the
+    // indices must keep their cache lines to themselves on the heap too
+    static void* operator new(std::size_t size)
+    {
+        void* memory = alignedMalloc(size, CacheLineSize);
+        if (!memory)
+            throw std::bad_alloc();
+
+        return memory;
+    }
+
+    static void operator delete(void* memory)
+    {
+        alignedFree(memory);
+    }
+
+private:
+
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T item;
+    };
+
+    // Producers and consumers each race on their own cache line.
+    alignas(CacheLineSize) std::atomic<std::size_t> mTail;
+    alignas(CacheLineSize) std::atomic<std::size_t> mHead;
+    alignas(CacheLineSize) Cell* mCells;
+    std::size_t mMask;
+};
+
+} // namespace nx
+
+#endif // MPMCQUEUE_H_INCLUDE
@@ -0,0 +1,242 @@
+#ifndef OBJECTPOOL_H_INCLUDE
+#define OBJECTPOOL_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/system/memory.h>
+#include <nex/system/noncopyable.h>
+#include <nex/system/handle.h>
+
+// Standard includes.
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nx
+{
+
+/**
+ * @brief Byte written over the storage of destroyed objects in debug builds.
+ */
+const uint8 ObjectPoolPoison = 0xDD;
+
+/**
+ * @brief Occupancy of an ObjectPool.
+ */
+struct ObjectPoolStats
+{
+    /**
+     * @brief The number of slots, live or free.
+     */
+    std::size_t capacity;
+
+    /**
+     * @brief The number of live objects.
+     */
+    std::size_t used;
+
+    /**
+     * @brief The largest number of live objects so far.
+     */
+    std::size_t peak;
+
+    /**
+     * @brief The number of chunks of slots.
+     */
+    std::size_t chunkCount;
+};
+
+/**
+ * Pool of objects of one type, addressed through generational handles.
+ *
+ * Objects live in chunks of ChunkSize slots that are never moved or given
+ * back before the pool dies, so creating and destroying objects at a high
+ * rate reuses the same memory instead of fragmenting the heap. Free slots
+ * form a list threaded through the slots themselves, both create and
+ * destroy are a handful of instructions.
+ *
+ * Handles survive the object they refer to: get returns 0 once the object
+ * is destroyed, even after its slot was reused. A pointer from get stays
+ * valid until the object is destroyed.
+ *
+ * In debug builds the storage of destroyed objects is filled with
+ * ObjectPoolPoison so reads through stale pointers stand out.
+ */
+template <typename T, std::size_t ChunkSize = 64>
+class ObjectPool : public NonCopyable
+{
+public:
+
+    ObjectPool() :
+        mFreeHead(NoSlot),
+        mUsed(0),
+        mPeak(0)
+    { }
+
+    ~ObjectPool()
+    {
+        clear();
+
+        for (std::size_t index = 0; index < mChunks.size(); ++index)
+            alignedFree(mChunks[index]);
+    }
+
+    /**
+     * @brief Constructs an object in a free slot.
+     * @param args = The arguments of the constructor of T.
+     * @return the handle of the object.
+     */
+    template <typename... Args>
+    Handle<T> create(Args&&... args)
+    {
+        if (mFreeHead == NoSlot)
+            grow();
+
+        const uint32 index = mFreeHead;
+        Slot& slot = getSlot(index);
+
+        new (&slot.storage) T(std::forward<Args>(args)...);
+        mFreeHead = slot.nextFree;
+        ++slot.generation;
+
+        if (++mUsed > mPeak)
+            mPeak = mUsed;
+
+        return Handle<T>(index, slot.generation);
+    }
+
+    /**
+     * @brief Destroys an object, every handle to it goes stale.
+     * @param handle = The handle of the object.
+     * @return false if the handle was already stale.
+     */
+    bool destroy(Handle<T> handle)
+    {
+        T* object = get(handle);
+        if (!object)
+            return false;
+
+        release(handle.index);
+        return true;
+    }
+
+    /**
+     * @brief Get the object of a handle.
+     * @param handle = The handle.
+     * @return the object, or 0 if it was destroyed or the handle is null.
+     */
+    T* get(Handle<T> handle)
+    {
+        if (handle.index >= capacity())
+            return 0;
+
+        Slot& slot = getSlot(handle.index);
+        return slot.generation == handle.generation && (handle.generation & 1) ? reinterpret_cast<T*>(&slot.storage) : 0;
+    }
+
+    const T* get(Handle<T> handle) const
+    {
+        return const_cast<ObjectPool*>(this)->get(handle);
+    }
+
+    /**
+     * @brief Tells whether the object of a handle is still alive.
+     * @param handle = The handle.
+     * @return true if get would return the object.
+     */
+    bool isAlive(Handle<T> handle) const { return get(handle) != 0; }
+
+    /**
+     * @brief Destroys every object, the chunks are kept for reuse.
+     */
+    void clear()
+    {
+        // Backwards, so the free list hands out the lowest slots first again.
+        for (uint32 index = capacity(); index-- > 0;)
+        {
+            if (getSlot(index).generation & 1)
+                release(index);
+        }
+    }
+
+    /**
+     * @brief Get the occupancy of the pool.
+     * @return the statistics.
+     */
+    ObjectPoolStats getStats() const
+    {
+        ObjectPoolStats stats;
+        stats.capacity = capacity();
+        stats.used = mUsed;
+        stats.peak = mPeak;
+        stats.chunkCount = mChunks.size();
+        return stats;
+    }
+
+    std::size_t size() const { return mUsed; }
+    bool empty() const { return mUsed == 0; }
+    uint32 capacity() const { return static_cast<uint32>(mChunks.size() * ChunkSize); }
+
+private:
+
+    static const uint32 NoSlot = 0xFFFFFFFF;
+
+    struct Slot
+    {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        // Odd while an object lives in the slot.
+        uint32 generation;
+        uint32 nextFree;
+    };
+
+    Slot& getSlot(uint32 index) { return mChunks[index / ChunkSize][index % ChunkSize]; }
+    const Slot& getSlot(uint32 index) const { return mChunks[index / ChunkSize][index % ChunkSize]; }
+
+    void grow()
+    {
+        const std::size_t alignment = alignof(Slot) > sizeof(void*) ? alignof(Slot) : sizeof(void*);
+        Slot* chunk = static_cast<Slot*>(alignedMalloc(ChunkSize * sizeof(Slot), alignment));
+        if (!chunk)
+            throw std::bad_alloc();
+
+        const uint32 first = capacity();
+        mChunks.push_back(chunk);
+
+        // The lowest slots come first, live objects stay packed at the front.
+        for (std::size_t index = 0; index < ChunkSize; ++index)
+        {
+            chunk[index].generation = 0;
+            chunk[index].nextFree = index + 1 < ChunkSize ? first + static_cast<uint32>(index) + 1 : mFreeHead;
+        }
+
+        mFreeHead = first;
+    }
+
+    void release(uint32 index)
+    {
+        Slot& slot = getSlot(index);
+        reinterpret_cast<T*>(&slot.storage)->~T();
+
+#ifndef NDEBUG
+        std::memset(&slot.storage, ObjectPoolPoison, sizeof(slot.storage));
+#endif
+
+        ++slot.generation;
+        slot.nextFree = mFreeHead;
+        mFreeHead = index;
+        --mUsed;
+    }
+
+    std::vector<Slot*> mChunks;
+    uint32 mFreeHead;
+    std::size_t mUsed;
+    std::size_t mPeak;
+};
+
+} // namespace nx
+
+#endif // OBJECTPOOL_H_INCLUDE
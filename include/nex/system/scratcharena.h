@@ -0,0 +1,113 @@
+#ifndef SCRATCHARENA_H_INCLUDE
+#define SCRATCHARENA_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/noncopyable.h>
+
+// Standard includes.
+#include <cstddef>
+
+namespace nx
+{
+
+/**
+ * Fixed size block of temporary memory handed out by bumping an offset.
+ *
+ * Allocations are released all at once by rewinding to a marker taken
+ * earlier, there is no per allocation free and no destructor is run. The
+ * JobSystem keeps one arena per thread so jobs get temporary buffers
+ * without touching the heap or sharing anything with other threads.
+ *
+ * Used with a ScratchScope it is a stack allocator: a function takes what
+ * it needs and the scope gives it back on return, nested calls included.
+ */
+class ScratchArena : public NonCopyable
+{
+public:
+
+    /**
+     * @brief Allocates the block of the arena.
+     * @param capacity = The size of the block in bytes.
+     */
+    explicit ScratchArena(std::size_t capacity);
+
+    ~ScratchArena();
+
+    /**
+     * @brief Reserves memory from the arena.
+     * @param size = The number of bytes.
+     * @param alignment = The alignment of the memory, a power of two.
+     * @return the memory, or 0 if the arena is full.
+     */
+    void* allocate(std::size_t size, std::size_t alignment = 16);
+
+    /**
+     * @brief Reserves an uninitialized array from the arena.
+     * @param count = The number of elements.
+     * @return the array, or 0 if the arena is full.
+     */
+    template <typename T>
+    T* allocate(std::size_t count)
+    {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * @brief Gives back the last allocation, anything else waits for a rewind.
+     * Only a free at the top of the stack is reclaimed, a block freed after a
+     * newer one was taken, as a growing vector does, stays used.
+     * @param memory = The memory from allocate.
+     * @param size = The size given to allocate.
+     */
+    void deallocate(void* memory, std::size_t size);
+
+    /**
+     * @brief Get a marker to rewind to, everything allocated after it is released together.
+     * @return the marker.
+     */
+    std::size_t getMarker() const { return mOffset; }
+
+    /**
+     * @brief Releases everything allocated since a marker.
+     * @param marker = A marker from getMarker.
+     */
+    void rewind(std::size_t marker) { mOffset = marker; }
+
+    /**
+     * @brief Releases every allocation.
+     */
+    void reset() { mOffset = 0; }
+
+    std::size_t getCapacity() const { return mCapacity; }
+    std::size_t getUsed() const { return mOffset; }
+
+private:
+
+    char* mData;
+    std::size_t mCapacity;
+    std::size_t mOffset;
+};
+
+/**
+ * @brief Rewinds an arena to where it was at construction when going out of scope.
+ */
+class ScratchScope : public NonCopyable
+{
+public:
+
+    explicit ScratchScope(ScratchArena& arena) :
+        mArena(arena),
+        mMarker(arena.getMarker())
+    { }
+
+    ~ScratchScope() { mArena.rewind(mMarker); }
+
+private:
+
+    ScratchArena& mArena;
+    std::size_t mMarker;
+};
+
+} // namespace nx
+
+#endif // SCRATCHARENA_H_INCLUDE
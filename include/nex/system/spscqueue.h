@@ -0,0 +1,172 @@
+#ifndef SPSCQUEUE_H_INCLUDE
+#define SPSCQUEUE_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/memory.h>
+#include <nex/system/noncopyable.h>
+
+// Standard includes.
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace nx
+{
+
+/**
+ * Bounded lock free ring buffer for one producer thread and one consumer thread.
+ *
+ * The producer only writes the tail and the consumer only writes the head,
+ * each keeps a copy of the other index and reloads it only when the ring
+ * looks full or empty, so most operations touch no shared cache line at
+ * all. The batch versions move many items for a single index update, which
+ * suits streams such as log lines or input events.
+ *
+ * T must be default constructible and copy assignable, popped slots keep
+ * their value until they are overwritten.
+ */
+template <typename T>
+class SpscQueue : public NonCopyable
+{
+public:
+
+    /**
+     * @brief Creates an empty queue.
+     * @param capacity = The largest number of items, rounded up to a power of two.
+     */
+    explicit SpscQueue(std::size_t capacity = 1024) :
+        mHead(0),
+        mCachedTail(0),
+        mTail(0),
+        mCachedHead(0)
+    {
+        std::size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+
+        mMask = size - 1;
+        mItems = new T[size];
+    }
+
+    ~SpscQueue()
+    {
+        delete[] mItems;
+    }
+
+    /**
+     * @brief Adds an item, only the producer may call it.
+     * @param item = The item.
+     * @return false if the queue is full.
+     */
+    bool push(const T& item)
+    {
+        return push(&item, 1) == 1;
+    }
+
+    /**
+     * @brief Adds as many items as fit, only the producer may call it.
+     * @param items = The items, in order.
+     * @param count = The number of items.
+     * @return the number of items added, the first ones of the array.
+     */
+    std::size_t push(const T* items, std::size_t count)
+    {
+        const std::size_t tail = mTail.load(std::memory_order_relaxed);
+
+        std::size_t space = mMask + 1 - (tail - mCachedHead);
+        if (space < count)
+        {
+            mCachedHead = mHead.load(std::memory_order_acquire);
+            space = mMask + 1 - (tail - mCachedHead);
+        }
+
+        if (count > space)
+            count = space;
+
+        for (std::size_t i = 0; i < count; ++i)
+            mItems[(tail + i) & mMask] = items[i];
+
+        mTail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Takes the oldest item, only the consumer may call it.
+     * @param item = Receives the item.
+     * @return false if the queue is empty.
+     */
+    bool pop(T& item)
+    {
+        return pop(&item, 1) == 1;
+    }
+
+    /**
+     * @brief Takes the oldest items, only the consumer may call it.
+     * @param items = Receives the items, in order.
+     * @param maxCount = The largest number of items to take.
+     * @return the number of items taken.
+     */
+    std::size_t pop(T* items, std::size_t maxCount)
+    {
+        const std::size_t head = mHead.load(std::memory_order_relaxed);
+
+        std::size_t available = mCachedTail - head;
+        if (available < maxCount)
+        {
+            mCachedTail = mTail.load(std::memory_order_acquire);
+            available = mCachedTail - head;
+        }
+
+        const std::size_t count = available < maxCount ? available : maxCount;
+        for (std::size_t i = 0; i < count; ++i)
+            items[i] = mItems[(head + i) & mMask];
+
+        mHead.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Get an estimate of the number of items, exact when called from the producer or the consumer while the other is idle.
+     * @return the number of items.
+     */
+    std::size_t size() const
+    {
+        return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+    std::size_t capacity() const { return mMask + 1; }
+
+    // operator new only honours the default alignment before C++17, the
+    // indices must keep their cache lines to themselves on the heap too
+    static void* operator new(std::size_t size)
+    {
+        void* memory = alignedMalloc(size, CacheLineSize);
+        if (!memory)
+            throw std::bad_alloc();
+
+        return memory;
+    }
+
+    static void operator delete(void* memory)
+    {
+        alignedFree(memory);
+    }
+
+private:
+
+    // Written by the consumer, with its copy of the tail.
+    alignas(CacheLineSize) std::atomic<std::size_t> mHead;
+    std::size_t mCachedTail;
+
+    // Written by the producer, with its copy of the head.
+    alignas(CacheLineSize) std::atomic<std::size_t> mTail;
+    std::size_t mCachedHead;
+
+    alignas(CacheLineSize) T* mItems;
+    std::size_t mMask;
+};
+
+} // namespace nx
+
+#endif // SPSCQUEUE_H_INCLUDE
@@ -0,0 +1,144 @@
+#ifndef TASKGRAPH_H_INCLUDE
+#define TASKGRAPH_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/system/noncopyable.h>
+#include <nex/system/jobsystem.h>
+
+// Standard includes.
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nx
+{
+
+/**
+ * @brief When and where a task of a TaskGraph ran during the last run.
+ */
+struct TaskTiming
+{
+    /**
+     * @brief Nanoseconds between the start of the run and the start of the task.
+     */
+    int64 start;
+
+    /**
+     * @brief Nanoseconds the task took.
+     */
+    int64 duration;
+
+    /**
+     * @brief The JobSystem thread index of the thread that ran the task.
+     */
+    std::size_t thread;
+};
+
+/**
+ * A set of tasks and the order constraints between them, run on the JobSystem.
+ *
+ * The graph is declared once, for instance the stages of a frame:
+ *
+ *     const uint32 transforms = graph.addTask("transforms", updateTransforms);
+ *     const uint32 bounds = graph.addTask("bounds", updateBounds);
+ *     const uint32 culling = graph.addTask("culling", cull);
+ *     const uint32 text = graph.addTask("text", updateText);
+ *     graph.addDependency(bounds, transforms);
+ *     graph.addDependency(culling, bounds);
+ *
+ * and run every frame. A task starts as soon as every task it depends on
+ * has finished, independent tasks such as text above overlap with the
+ * chain. Running allocates nothing, the counters and jobs of the tasks live
+ * in the graph and are reset at the start of each run. A task may itself
+ * use parallelFor, the thread running it helps until the loop is done.
+ *
+ * Each run records the start, duration and thread of every task.
+ */
+class TaskGraph : public NonCopyable
+{
+public:
+
+    /**
+     * @brief Constructs an empty graph.
+     */
+    TaskGraph();
+
+    ~TaskGraph();
+
+    /**
+     * @brief Adds a task, it runs once per run of the graph.
+     * @param name = The name of the task, for profiling.
+     * @param function = The work of the task.
+     * @return the index of the task.
+     */
+    uint32 addTask(const std::string& name, const std::function<void()>& function);
+
+    /**
+     * @brief Makes a task wait for another one.
+     * @param task = The task that waits.
+     * @param dependency = The task that has to finish first.
+     * @return false if an index is invalid or the dependency would close a cycle.
+     */
+    bool addDependency(uint32 task, uint32 dependency);
+
+    /**
+     * @brief Removes every task.
+     */
+    void clear();
+
+    /**
+     * @brief Runs every task once, in dependency order, and waits for all of them.
+     * @param jobs = The job system to run on.
+     */
+    void run(JobSystem& jobs);
+
+    /**
+     * @brief Runs every task once on the shared job system and waits for all of them.
+     */
+    void run();
+
+    /**
+     * @brief Get the timing of a task during the last run.
+     * @param task = The index of the task.
+     * @return the timing, all zero before the first run.
+     */
+    const TaskTiming& getTiming(uint32 task) const;
+
+    /**
+     * @brief Get the name given to a task.
+     * @param task = The index of the task.
+     * @return the name.
+     */
+    const std::string& getName(uint32 task) const;
+
+    /**
+     * @brief Get the duration of the last run, from the first task start to the last task end.
+     * @return the duration in nanoseconds.
+     */
+    int64 getRunTime() const { return mRunTime; }
+
+    std::size_t size() const { return mTasks.size(); }
+    bool empty() const { return mTasks.empty(); }
+
+private:
+
+    struct Task;
+
+    static void runTask(void* data);
+    bool dependsOn(uint32 task, uint32 dependency) const;
+
+    std::vector<std::unique_ptr<Task> > mTasks;
+
+    // Set for the duration of a run.
+    JobSystem* mJobs;
+    JobCounter mCounter;
+    int64 mRunStart;
+    int64 mRunTime;
+};
+
+} // namespace nx
+
+#endif // TASKGRAPH_H_INCLUDE
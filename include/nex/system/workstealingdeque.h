@@ -0,0 +1,142 @@
+#ifndef WORKSTEALINGDEQUE_H_INCLUDE
+#define WORKSTEALINGDEQUE_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+#include <nex/system/memory.h>
+#include <nex/system/noncopyable.h>
+
+// Standard includes.
+#include <atomic>
+#include <cstddef>
+
+namespace nx
+{
+
+/**
+ * Bounded Chase-Lev work stealing deque.
+ *
+ * One owner thread pushes and pops at the bottom, like a stack, while any
+ * other thread steals from the top. The owner only synchronizes with thieves
+ * when a single item is left, every other push and pop is a couple of plain
+ * loads and stores. The capacity is fixed, push fails instead of growing.
+ *
+ * T must be trivially copyable and lock free as a std::atomic, typically a
+ * pointer to a job.
+ */
+template <typename T>
+class WorkStealingDeque : public NonCopyable
+{
+public:
+
+    /**
+     * @brief Creates an empty deque.
+     * @param capacity = The largest number of items, rounded up to a power of two.
+     */
+    explicit WorkStealingDeque(std::size_t capacity = 1024) :
+        mTop(0),
+        mBottom(0)
+    {
+        std::size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+
+        mMask = size - 1;
+        mItems = new std::atomic<T>[size];
+    }
+
+    ~WorkStealingDeque()
+    {
+        delete[] mItems;
+    }
+
+    /**
+     * @brief Adds an item at the bottom, only the owner may call it.
+     * @param item = The item.
+     * @return false if the deque is full.
+     */
+    bool push(T item)
+    {
+        const int64 bottom = mBottom.load(std::memory_order_relaxed);
+        const int64 top = mTop.load(std::memory_order_acquire);
+
+        if (bottom - top > static_cast<int64>(mMask))
+            return false;
+
+        mItems[bottom & mMask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        mBottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Takes the most recently pushed item, only the owner may call it.
+     * @param item = Receives the item.
+     * @return false if the deque is empty.
+     */
+    bool pop(T& item)
+    {
+        const int64 bottom = mBottom.load(std::memory_order_relaxed) - 1;
+        mBottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 top = mTop.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = mItems[bottom & mMask].load(std::memory_order_relaxed);
+        if (top != bottom)
+            return true;
+
+        // The last item, a thief may be taking it at the same time.
+        const bool won = mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        mBottom.store(bottom + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    /**
+     * @brief Takes the oldest item, any thread may call it.
+     * @param item = Receives the item.
+     * @return false if the deque is empty or another thread took the item first.
+     */
+    bool steal(T& item)
+    {
+        int64 top = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64 bottom = mBottom.load(std::memory_order_acquire);
+
+        if (top >= bottom)
+            return false;
+
+        item = mItems[top & mMask].load(std::memory_order_relaxed);
+        return mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get an estimate of the number of items, exact only for the owner when no thief is active.
+     * @return the number of items.
+     */
+    std::size_t size() const
+    {
+        const int64 count = mBottom.load(std::memory_order_relaxed) - mTop.load(std::memory_order_relaxed);
+        return count > 0 ? static_cast<std::size_t>(count) : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+    std::size_t capacity() const { return mMask + 1; }
+
+private:
+
+    // The owner and the thieves hammer different ends, each on its own cache line.
+    alignas(CacheLineSize) std::atomic<int64> mTop;
+    alignas(CacheLineSize) std::atomic<int64> mBottom;
+    alignas(CacheLineSize) std::atomic<T>* mItems;
+    std::size_t mMask;
+};
+
+} // namespace nx
+
+#endif // WORKSTEALINGDEQUE_H_INCLUDE
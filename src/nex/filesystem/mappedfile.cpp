@@ -0,0 +1,17 @@
+#include <nex/filesystem/mappedfile.h>
+
+
+namespace nx
+{
+
+MappedFile::MappedFile() :
+    mData(0),
+    mSize(0)
+{ }
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+} // namespace nx
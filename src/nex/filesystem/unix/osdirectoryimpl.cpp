@@ -133,36 +133,45 @@ std::vector<DirectoryInfo> Directory::getDirectories(const std::string& dirname)
 }
 
 std::vector<FileInfo> Directory::getFiles(const std::string& dirname)
+{
+    std::vector<FileInfo> files;
+    getFiles(dirname, files);
+
+    return files;
+}
+
+void Directory::getFiles(const std::string& dirname, std::vector<FileInfo>& files)
 {
     DIR* dir;
     struct dirent* entry;
-    std::string path;
 
-    std::vector<FileInfo> files;
+    std::size_t count = 0;
 
     dir = opendir(dirname.c_str());
     if (dir != NULL) {
         while ((entry = readdir(dir)) != NULL) {
 
-            if (strcmp(entry->d_name, ".") && strcmp(entry->d_name, "..")) {
+            if (strcmp(entry->d_name, ".") && strcmp(entry->d_name, "..") && entry->d_type != DT_DIR) {
 
-                path = dirname + "/" + std::string(entry->d_name);
-                if (entry->d_type != DT_DIR) {
+                // Assigning over the entries of a previous call reuses their strings.
+                if (count == files.size())
+                    files.push_back(FileInfo());
+                FileInfo& info = files[count++];
 
-                    FileInfo info;
-                    info.path = path;
-                    info.name = Path::getFileName(path);
-                    info.extention = Path::getExtension(path);
+                info.path.assign(dirname);
+                info.path += '/';
+                info.path += entry->d_name;
+                info.name.assign(entry->d_name);
 
-                    files.push_back(info);
-                }
+                const char* extension = strrchr(entry->d_name, '.');
+                info.extention.assign(extension ? extension : "");
             }
 
         }
+        closedir(dir);
     }
-    closedir(dir);
 
-    return files;
+    files.resize(count);
 }
 
 } // namespace nx
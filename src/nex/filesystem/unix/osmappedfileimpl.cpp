@@ -0,0 +1,54 @@
+#include <nex/filesystem/mappedfile.h>
+
+/**
+ * Unix mapped file implementation.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace nx
+{
+
+bool MappedFile::open(const std::string& filepath)
+{
+    close();
+
+    int descriptor = ::open(filepath.c_str(), O_RDONLY);
+    if (descriptor == -1)
+        return false;
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size <= 0)
+    {
+        ::close(descriptor);
+        return false;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(status.st_size);
+    void* data = mmap(0, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+    // The mapping keeps its own reference to the file
+    ::close(descriptor);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    mData = data;
+    mSize = size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (mData)
+    {
+        munmap(mData, mSize);
+        mData = 0;
+        mSize = 0;
+    }
+}
+
+} // namespace nx
@@ -143,37 +143,42 @@ std::vector<DirectoryInfo> Directory::getDirectories(const std::string& dirname)
 }
 
 std::vector<FileInfo> Directory::getFiles(const std::string& dirname)
+{
+    std::vector<FileInfo> found;
+    getFiles(dirname, found);
+
+    return found;
+}
+
+void Directory::getFiles(const std::string& dirname, std::vector<FileInfo>& found)
 {
     WIN32_FIND_DATA filePtr;
 
     std::string tempPath = dirname;
     tempPath += "\\*.*";
 
-    std::string currFile = "";
-
-    std::vector<FileInfo> found;
+    std::size_t count = 0;
 
     HANDLE hFind = FindFirstFile(tempPath.c_str(), &filePtr );
-    if (hFind == INVALID_HANDLE_VALUE) {
-       return found;
-    }
-    else
+    if (hFind != INVALID_HANDLE_VALUE)
     {
         do
         {
             //check if its a file.
             if (!(filePtr.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ))
             {
-                tempPath = dirname + "\\";
-                currFile = tempPath + filePtr.cFileName;
-
-                FileInfo info;
-
-                info.path = currFile;
-                info.name = filePtr.cFileName;
-                info.extention = Path::getExtension(currFile);
-
-                found.push_back(info);
+                // Assigning over the entries of a previous call reuses their strings.
+                if (count == found.size())
+                    found.push_back(FileInfo());
+                FileInfo& info = found[count++];
+
+                info.path.assign(dirname);
+                info.path += '\\';
+                info.path += filePtr.cFileName;
+                info.name.assign(filePtr.cFileName);
+
+                const char* extension = strrchr(filePtr.cFileName, '.');
+                info.extention.assign(extension ? extension : "");
             }
         }
         while (FindNextFile(hFind, &filePtr) != 0);
@@ -182,7 +187,7 @@ std::vector<FileInfo> Directory::getFiles(const std::string& dirname)
 
     }
 
-    return found;
+    found.resize(count);
 }
 
 } // namespace nx
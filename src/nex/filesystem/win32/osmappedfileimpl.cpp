@@ -0,0 +1,54 @@
+#include <nex/filesystem/mappedfile.h>
+
+/**
+ * Win32 mapped file implementation.
+ */
+
+#include <windows.h>
+
+namespace nx
+{
+
+bool MappedFile::open(const std::string& filepath)
+{
+    close();
+
+    HANDLE file = ::CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+    {
+        ::CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = ::CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    ::CloseHandle(file);
+    if (!mapping)
+        return false;
+
+    // The view keeps the mapping alive
+    void* data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    ::CloseHandle(mapping);
+
+    if (!data)
+        return false;
+
+    mData = data;
+    mSize = static_cast<std::size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (mData)
+    {
+        ::UnmapViewOfFile(mData);
+        mData = 0;
+        mSize = 0;
+    }
+}
+
+} // namespace nx
@@ -1,5 +1,7 @@
 #include <nex/gfx/font.h>
 #include <nex/system/instream.h>
+#include <nex/system/outstream.h>
+#include <nex/filesystem/mappedfile.h>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -7,9 +9,13 @@
 #include FT_OUTLINE_H
 #include FT_BITMAP_H
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <limits>
+#include <utility>
 
 namespace
 {
@@ -32,18 +38,171 @@ namespace
     {
 
     }
+
+    // "NXFA", followed by the version of the layout.
+    const uint32 BakedMagic = 0x4146584E;
+    const uint32 BakedVersion = 1;
+
+    // Bit of a glyph key telling the bold version apart.
+    const uint32 BoldKeyBit = 0x80000000;
+
+    // Followed by the family name, the pages, then the RGBA pixels of the atlas.
+    struct BakedHeader
+    {
+        uint32 magic;
+        uint32 version;
+        uint32 atlasWidth;
+        uint32 atlasHeight;
+        uint32 pageCount;
+        uint32 familyLength;
+    };
+
+    // Followed by the glyphs, then the kerning pairs of the page.
+    struct BakedPage
+    {
+        uint32 characterSize;
+        uint32 glyphCount;
+        uint32 kerningCount;
+        real32 lineSpacing;
+        real32 underlinePosition;
+        real32 underlineThickness;
+    };
+
+    struct BakedGlyph
+    {
+        uint32 key;
+        real32 advance;
+        real32 bounds[4];
+        int32 textureRect[4];
+    };
+
+    struct BakedKerning
+    {
+        uint32 first;
+        uint32 second;
+        real32 value;
+    };
+
+    // Coverage of a glyph waiting for its place in the atlas.
+    struct BakedBitmap
+    {
+        std::size_t glyph;
+        uint32 width;
+        uint32 height;
+        std::size_t coverage;
+    };
+
+    bool compareBitmaps(const BakedBitmap& left, const BakedBitmap& right)
+    {
+        return left.height > right.height;
+    }
+
+    // Distance field glyphs are rendered this many times larger, then sampled
+    // down, so the outline is found to a fraction of a pixel.
+    const uint32 DistanceFieldOversampling = 4;
+
+    // Stands for "no seed pixel" in the distance transform, far above any real squared distance.
+    const double DistanceUnreached = 1e10;
+
+    // Exact squared Euclidean distance transform of one line of a grid, after
+    // Felzenszwalb and Huttenlocher. Seeds hold 0, other cells DistanceUnreached.
+    void transformLine(double* line, std::size_t count, std::size_t stride, std::vector<double>& values,
+                       std::vector<double>& bounds, std::vector<int>& parabolas)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            values[i] = line[i * stride];
+
+        // Lower envelope of the parabolas rooted at every cell
+        int k = 0;
+        parabolas[0] = 0;
+        bounds[0] = -std::numeric_limits<double>::infinity();
+        bounds[1] = std::numeric_limits<double>::infinity();
+        for (int q = 1; q < static_cast<int>(count); ++q)
+        {
+            double s;
+            for (;;)
+            {
+                const int p = parabolas[k];
+                s = ((values[q] + q * q) - (values[p] + p * p)) / (2 * q - 2 * p);
+                if (s > bounds[k])
+                    break;
+                --k;
+            }
+
+            ++k;
+            parabolas[k] = q;
+            bounds[k] = s;
+            bounds[k + 1] = std::numeric_limits<double>::infinity();
+        }
+
+        k = 0;
+        for (int q = 0; q < static_cast<int>(count); ++q)
+        {
+            while (bounds[k + 1] < q)
+                ++k;
+
+            const double offset = q - parabolas[k];
+            line[q * stride] = offset * offset + values[parabolas[k]];
+        }
+    }
+
+    // Squared distance from every cell to the nearest seed.
+    void transformGrid(std::vector<double>& grid, uint32 width, uint32 height)
+    {
+        const std::size_t length = std::max(width, height);
+        std::vector<double> values(length);
+        std::vector<double> bounds(length + 1);
+        std::vector<int> parabolas(length);
+
+        for (uint32 x = 0; x < width; ++x)
+            transformLine(&grid[x], height, width, values, bounds, parabolas);
+
+        for (uint32 y = 0; y < height; ++y)
+            transformLine(&grid[y * width], width, 1, values, bounds, parabolas);
+    }
+
+    bool writeBytes(nx::OutStream& stream, const void* data, std::size_t size)
+    {
+        if (size == 0)
+            return true;
+
+        return stream.write(const_cast<void*>(data), static_cast<int64>(size)) == static_cast<int64>(size);
+    }
+
+    // Copies the next record out of a mapped file, records need not be aligned there.
+    bool readBytes(const uint8* data, std::size_t size, std::size_t& offset, void* record, std::size_t recordSize)
+    {
+        if (size - offset < recordSize)
+            return false;
+
+        std::memcpy(record, data + offset, recordSize);
+        offset += recordSize;
+        return true;
+    }
 }
 
 namespace nx
 {
 
+const uint32 Font::DistanceFieldSize;
+const uint32 Font::DistanceFieldSpread;
+
 Font::Font() :
     m_library(0),
     m_face(0),
     m_streamRec(0),
     m_refCount(0),
-    m_info()
-{ }
+    m_info(),
+    m_lastPage(0),
+    m_lastPageSize(0),
+    m_distanceField(false)
+{
+    m_stats.pageCount = 0;
+    m_stats.atlasCount = 0;
+    m_stats.atlasBytes = 0;
+    m_stats.glyphsRasterized = 0;
+    m_stats.cacheMisses = 0;
+}
 
 Font::Font(const Font& copy) :
     m_library(copy.m_library),
@@ -52,13 +211,27 @@ Font::Font(const Font& copy) :
     m_refCount(copy.m_refCount),
     m_info(copy.m_info),
     m_pages(copy.m_pages),
-    m_pixelBuffer(copy.m_pixelBuffer)
+    m_lastPage(0),
+    m_lastPageSize(0),
+    m_distanceField(copy.m_distanceField),
+    m_distanceFieldPage(copy.m_distanceFieldPage),
+    m_pixelBuffer(copy.m_pixelBuffer),
+    m_stats(copy.m_stats)
 {
     // Note: as FreeType doesn't provide functions for copying/cloning,
     // we must share all the FreeType pointers
 
     if (m_refCount)
         (*m_refCount)++;
+
+    // A Texture copy would share its GL name, the atlas is uploaded again instead
+    if (copy.m_atlas)
+    {
+        m_atlas.reset(new Texture());
+        if (!m_atlas->loadFromImage(copy.m_atlas->copyToImage()))
+            std::cout << "Failed to copy the atlas of a baked font" << std::endl;
+        m_atlas->setSmooth(copy.m_atlas->getSmooth());
+    }
 }
 
 Font::~Font()
@@ -214,6 +387,327 @@ bool Font::loadFromStream(InStream& stream)
     return true;
 }
 
+bool Font::loadFromBaked(const std::string& filename)
+{
+    // Cleanup the previous resources
+    cleanup();
+
+    MappedFile file;
+    if (!file.open(filename))
+    {
+        std::cout << "Failed to load baked font \"" << filename << "\" (failed to map the file)" << std::endl;
+        return false;
+    }
+
+    const uint8* data = file.getData();
+    const std::size_t size = file.getSize();
+    std::size_t offset = 0;
+
+    BakedHeader header;
+    if (!readBytes(data, size, offset, &header, sizeof(header)) || header.magic != BakedMagic || header.version != BakedVersion)
+    {
+        std::cout << "Failed to load baked font \"" << filename << "\" (not a baked font, or another version)" << std::endl;
+        return false;
+    }
+
+    // The atlas ends the file, a size it could not hold is damage. Dividing
+    // keeps huge dimensions from wrapping around.
+    if ((header.atlasWidth == 0) || (header.atlasHeight == 0) || (header.atlasWidth > size / 4 / header.atlasHeight))
+    {
+        std::cout << "Failed to load baked font \"" << filename << "\" (invalid atlas size)" << std::endl;
+        return false;
+    }
+
+    bool valid = header.familyLength <= size - offset;
+    if (valid)
+    {
+        m_info.family.assign(reinterpret_cast<const char*>(data + offset), header.familyLength);
+        offset += header.familyLength;
+    }
+
+    // Fill the caches the way getGlyph and getKerning would have
+    for (uint32 i = 0; valid && i < header.pageCount; ++i)
+    {
+        BakedPage record;
+        if (!readBytes(data, size, offset, &record, sizeof(record)))
+        {
+            valid = false;
+            break;
+        }
+
+        Page& page = m_pages[record.characterSize];
+        page.lineSpacing = record.lineSpacing;
+        page.underlinePosition = record.underlinePosition;
+        page.underlineThickness = record.underlineThickness;
+
+        for (uint32 j = 0; valid && j < record.glyphCount; ++j)
+        {
+            BakedGlyph baked;
+            valid = readBytes(data, size, offset, &baked, sizeof(baked));
+            if (!valid)
+                break;
+
+            // Texts sample whatever rectangle they are given, it must lie in the atlas
+            const int32* rect = baked.textureRect;
+            valid = (rect[0] >= 0) && (rect[1] >= 0) && (rect[2] >= 0) && (rect[3] >= 0) &&
+                    (static_cast<int64>(rect[0]) + rect[2] <= header.atlasWidth) &&
+                    (static_cast<int64>(rect[1]) + rect[3] <= header.atlasHeight);
+            if (!valid)
+                break;
+
+            Glyph glyph;
+            glyph.advance = baked.advance;
+            glyph.bounds = rectf(baked.bounds[0], baked.bounds[1], baked.bounds[2], baked.bounds[3]);
+            glyph.textureRect = recti(baked.textureRect[0], baked.textureRect[1], baked.textureRect[2], baked.textureRect[3]);
+
+            insertGlyph(page, baked.key & ~BoldKeyBit, (baked.key & BoldKeyBit) != 0, glyph);
+        }
+
+        for (uint32 j = 0; valid && j < record.kerningCount; ++j)
+        {
+            BakedKerning kerning;
+            valid = readBytes(data, size, offset, &kerning, sizeof(kerning));
+            if (valid)
+                page.kerning.insert((static_cast<uint64>(kerning.first) << 32) | kerning.second, kerning.value);
+        }
+    }
+
+    const std::size_t pixelBytes = static_cast<std::size_t>(header.atlasWidth) * header.atlasHeight * 4;
+    if (!valid || size - offset < pixelBytes)
+    {
+        cleanup();
+        std::cout << "Failed to load baked font \"" << filename << "\" (the file is truncated or damaged)" << std::endl;
+        return false;
+    }
+
+    // The pixels go from the mapped pages straight to the driver, in one upload
+    std::unique_ptr<Texture> atlas(new Texture());
+    if (!atlas->create(header.atlasWidth, header.atlasHeight))
+    {
+        cleanup();
+        std::cout << "Failed to load baked font \"" << filename << "\" (failed to create the atlas texture)" << std::endl;
+        return false;
+    }
+
+    atlas->update(data + offset);
+    atlas->setSmooth(true);
+    m_atlas = std::move(atlas);
+
+    // Baked glyphs are bitmaps
+    m_distanceField = false;
+
+    return true;
+}
+
+bool Font::saveBaked(OutStream& stream, const std::vector<uint32>& characterSizes, const String& charset, bool bold) const
+{
+    FT_Face face = static_cast<FT_Face>(m_face);
+    if (!face)
+    {
+        std::cout << "Failed to bake font (no font face is loaded)" << std::endl;
+        return false;
+    }
+
+    // Every character once, in a stable order
+    std::vector<uint32> codePoints(charset.begin(), charset.end());
+    std::sort(codePoints.begin(), codePoints.end());
+    codePoints.erase(std::unique(codePoints.begin(), codePoints.end()), codePoints.end());
+
+    std::vector<BakedPage> pages;
+    std::vector<BakedGlyph> glyphs;
+    std::vector<BakedKerning> kernings;
+    std::vector<BakedBitmap> bitmaps;
+    std::vector<uint8> coverage;
+
+    for (std::size_t i = 0; i < characterSizes.size(); ++i)
+    {
+        const uint32 characterSize = characterSizes[i];
+        if (!setCurrentSize(characterSize))
+        {
+            std::cout << "Failed to bake font (unsupported character size " << characterSize << ")" << std::endl;
+            return false;
+        }
+
+        BakedPage page;
+        page.characterSize = characterSize;
+        page.glyphCount = 0;
+        page.kerningCount = 0;
+        page.lineSpacing = getLineSpacing(characterSize);
+        page.underlinePosition = getUnderlinePosition(characterSize);
+        page.underlineThickness = getUnderlineThickness(characterSize);
+
+        for (uint32 style = 0; style < (bold ? 2u : 1u); ++style)
+        {
+            for (std::size_t j = 0; j < codePoints.size(); ++j)
+            {
+                Glyph glyph;
+                vec2u bitmapSize;
+                if (!rasterizeGlyph(codePoints[j], characterSize, style == 1, glyph, bitmapSize))
+                    continue;
+
+                BakedGlyph baked;
+                baked.key = codePoints[j] | (style == 1 ? BoldKeyBit : 0);
+                baked.advance = glyph.advance;
+                baked.bounds[0] = glyph.bounds.x;
+                baked.bounds[1] = glyph.bounds.y;
+                baked.bounds[2] = glyph.bounds.width;
+                baked.bounds[3] = glyph.bounds.height;
+                std::fill(baked.textureRect, baked.textureRect + 4, 0);
+
+                if ((bitmapSize.x > 0) && (bitmapSize.y > 0))
+                {
+                    BakedBitmap bitmap;
+                    bitmap.glyph = glyphs.size();
+                    bitmap.width = bitmapSize.x;
+                    bitmap.height = bitmapSize.y;
+                    bitmap.coverage = coverage.size();
+                    bitmaps.push_back(bitmap);
+
+                    for (std::size_t pixel = 0; pixel < bitmapSize.x * bitmapSize.y; ++pixel)
+                        coverage.push_back(m_pixelBuffer[pixel * 4 + 3]);
+                }
+
+                glyphs.push_back(baked);
+                ++page.glyphCount;
+            }
+        }
+
+        // Only the pairs that move something, the loader answers 0 for the others
+        if (FT_HAS_KERNING(face))
+        {
+            for (std::size_t first = 0; first < codePoints.size(); ++first)
+            {
+                for (std::size_t second = 0; second < codePoints.size(); ++second)
+                {
+                    BakedKerning kerning;
+                    kerning.first = codePoints[first];
+                    kerning.second = codePoints[second];
+                    kerning.value = computeKerning(kerning.first, kerning.second, characterSize);
+                    if (kerning.value != 0.f)
+                    {
+                        kernings.push_back(kerning);
+                        ++page.kerningCount;
+                    }
+                }
+            }
+        }
+
+        pages.push_back(page);
+    }
+
+    // Leave a small padding around characters, as loadGlyph does
+    const uint32 padding = 1;
+
+    // Tallest glyphs first, so the rows waste little height
+    std::stable_sort(bitmaps.begin(), bitmaps.end(), &compareBitmaps);
+
+    std::size_t area = 0;
+    uint32 widest = 0;
+    for (std::size_t i = 0; i < bitmaps.size(); ++i)
+    {
+        area += static_cast<std::size_t>(bitmaps[i].width + 2 * padding) * (bitmaps[i].height + 2 * padding);
+        widest = std::max(widest, bitmaps[i].width + 2 * padding);
+    }
+
+    uint32 atlasWidth = 128;
+    while ((static_cast<std::size_t>(atlasWidth) * atlasWidth < area) || (atlasWidth < widest))
+        atlasWidth *= 2;
+
+    // Rows start below the 2x2 white square reserved for underlines, as in the pages
+    uint32 x = 0;
+    uint32 y = 3;
+    uint32 rowHeight = 0;
+    for (std::size_t i = 0; i < bitmaps.size(); ++i)
+    {
+        const uint32 width = bitmaps[i].width + 2 * padding;
+        const uint32 height = bitmaps[i].height + 2 * padding;
+        if (x + width > atlasWidth)
+        {
+            y += rowHeight;
+            x = 0;
+            rowHeight = 0;
+        }
+
+        BakedGlyph& glyph = glyphs[bitmaps[i].glyph];
+        glyph.textureRect[0] = x + padding;
+        glyph.textureRect[1] = y + padding;
+        glyph.textureRect[2] = bitmaps[i].width;
+        glyph.textureRect[3] = bitmaps[i].height;
+
+        x += width;
+        rowHeight = std::max(rowHeight, height);
+    }
+
+    uint32 atlasHeight = 128;
+    while (atlasHeight < y + rowHeight)
+        atlasHeight *= 2;
+
+    // White everywhere, the glyphs only write their coverage into the alpha channel
+    std::vector<uint8> pixels(static_cast<std::size_t>(atlasWidth) * atlasHeight * 4, 255);
+    for (std::size_t pixel = 0; pixel < pixels.size() / 4; ++pixel)
+        pixels[pixel * 4 + 3] = 0;
+
+    for (uint32 row = 0; row < 2; ++row)
+        for (uint32 column = 0; column < 2; ++column)
+            pixels[(row * atlasWidth + column) * 4 + 3] = 255;
+
+    for (std::size_t i = 0; i < bitmaps.size(); ++i)
+    {
+        const BakedBitmap& bitmap = bitmaps[i];
+        const BakedGlyph& glyph = glyphs[bitmap.glyph];
+        for (uint32 row = 0; row < bitmap.height; ++row)
+        {
+            for (uint32 column = 0; column < bitmap.width; ++column)
+            {
+                const std::size_t index = (static_cast<std::size_t>(glyph.textureRect[1] + row) * atlasWidth + glyph.textureRect[0] + column) * 4 + 3;
+                pixels[index] = coverage[bitmap.coverage + row * bitmap.width + column];
+            }
+        }
+    }
+
+    BakedHeader header;
+    header.magic = BakedMagic;
+    header.version = BakedVersion;
+    header.atlasWidth = atlasWidth;
+    header.atlasHeight = atlasHeight;
+    header.pageCount = static_cast<uint32>(pages.size());
+    header.familyLength = static_cast<uint32>(m_info.family.size());
+
+    bool written = writeBytes(stream, &header, sizeof(header)) &&
+                   writeBytes(stream, m_info.family.data(), m_info.family.size());
+
+    std::size_t firstGlyph = 0;
+    std::size_t firstKerning = 0;
+    for (std::size_t i = 0; written && i < pages.size(); ++i)
+    {
+        written = writeBytes(stream, &pages[i], sizeof(BakedPage)) &&
+                  writeBytes(stream, glyphs.empty() ? 0 : &glyphs[firstGlyph], pages[i].glyphCount * sizeof(BakedGlyph)) &&
+                  writeBytes(stream, kernings.empty() ? 0 : &kernings[firstKerning], pages[i].kerningCount * sizeof(BakedKerning));
+
+        firstGlyph += pages[i].glyphCount;
+        firstKerning += pages[i].kerningCount;
+    }
+
+    return written && writeBytes(stream, &pixels[0], pixels.size());
+}
+
+void Font::setDistanceField(bool distanceField)
+{
+    if (m_atlas || m_distanceField == distanceField)
+        return;
+
+    // Glyphs of the other mode have nothing to do with the new ones
+    m_distanceField = distanceField;
+    m_pages.clear();
+    m_distanceFieldPage.reset();
+    m_lastPage = 0;
+}
+
+bool Font::isDistanceField() const
+{
+    return m_distanceField;
+}
+
 const Font::Info& Font::getInfo() const
 {
     return m_info;
@@ -222,24 +716,31 @@ const Font::Info& Font::getInfo() const
 const Glyph& Font::getGlyph(uint32 codePoint, uint32 characterSize, bool bold) const
 {
     // Get the page corresponding to the character size
-    GlyphTable& glyphs = m_pages[characterSize].glyphs;
-
-    // Build the key by combining the code point and the bold flag
-    uint32 key = ((bold ? 1 : 0) << 31) | codePoint;
+    Page& page = getPage(characterSize);
 
     // Search the glyph into the cache
-    GlyphTable::const_iterator it = glyphs.find(key);
-    if (it != glyphs.end())
-    {
-        // Found: just return it
-        return it->second;
-    }
-    else
+    if (const Glyph* glyph = findGlyph(page, codePoint, bold))
+        return *glyph;
+
+    ++m_stats.cacheMisses;
+
+    // Not found: distance fields are rendered once and scaled to the size
+    if (m_distanceField)
     {
-        // Not found: we have to load it
-        Glyph glyph = loadGlyph(codePoint, characterSize, bold);
-        return glyphs.insert(std::make_pair(key, glyph)).first->second;
+        const float scale = static_cast<float>(characterSize) / DistanceFieldSize;
+
+        Glyph glyph = getDistanceFieldGlyph(codePoint, bold);
+        glyph.advance *= scale;
+        glyph.bounds.x *= scale;
+        glyph.bounds.y *= scale;
+        glyph.bounds.width *= scale;
+        glyph.bounds.height *= scale;
+
+        return insertGlyph(page, codePoint, bold, glyph);
     }
+
+    // Not found: we have to load it
+    return insertGlyph(page, codePoint, bold, loadGlyph(codePoint, characterSize, bold));
 }
 
 float Font::getKerning(uint32 first, uint32 second, uint32 characterSize) const
@@ -248,34 +749,36 @@ float Font::getKerning(uint32 first, uint32 second, uint32 characterSize) const
     if (first == 0 || second == 0)
         return 0.f;
 
-    FT_Face face = static_cast<FT_Face>(m_face);
+    const uint64 key = (static_cast<uint64>(first) << 32) | second;
 
-    if (face && FT_HAS_KERNING(face) && setCurrentSize(characterSize))
+    // Baked fonts hold every pair that kerns, the others do not
+    if (m_atlas)
     {
-        // Convert the characters to indices
-        FT_UInt index1 = FT_Get_Char_Index(face, first);
-        FT_UInt index2 = FT_Get_Char_Index(face, second);
-
-        // Get the kerning vector
-        FT_Vector kerning;
-        FT_Get_Kerning(face, index1, index2, FT_KERNING_DEFAULT, &kerning);
+        const float* kerning = getPage(characterSize).kerning.find(key);
+        return kerning ? *kerning : 0.f;
+    }
 
-        // X advance is already in pixels for bitmap fonts
-        if (!FT_IS_SCALABLE(face))
-            return static_cast<float>(kerning.x);
+    FT_Face face = static_cast<FT_Face>(m_face);
 
-        // Return the X advance
-        return static_cast<float>(kerning.x) / static_cast<float>(1 << 6);
-    }
-    else
-    {
-        // Invalid font, or no kerning
+    // Invalid font, or no kerning
+    if (!face || !FT_HAS_KERNING(face))
         return 0.f;
-    }
+
+    // Pairs already asked for at this size never reach FreeType again
+    Page& page = getPage(characterSize);
+    if (const float* kerning = page.kerning.find(key))
+        return *kerning;
+
+    const float value = computeKerning(first, second, characterSize);
+    page.kerning.insert(key, value);
+    return value;
 }
 
 float Font::getLineSpacing(uint32 characterSize) const
 {
+    if (m_atlas)
+        return getPage(characterSize).lineSpacing;
+
     FT_Face face = static_cast<FT_Face>(m_face);
 
     if (face && setCurrentSize(characterSize))
@@ -290,6 +793,9 @@ float Font::getLineSpacing(uint32 characterSize) const
 
 float Font::getUnderlinePosition(uint32 characterSize) const
 {
+    if (m_atlas)
+        return getPage(characterSize).underlinePosition;
+
     FT_Face face = static_cast<FT_Face>(m_face);
 
     if (face && setCurrentSize(characterSize))
@@ -308,6 +814,9 @@ float Font::getUnderlinePosition(uint32 characterSize) const
 
 float Font::getUnderlineThickness(uint32 characterSize) const
 {
+    if (m_atlas)
+        return getPage(characterSize).underlineThickness;
+
     FT_Face face = static_cast<FT_Face>(m_face);
 
     if (face && setCurrentSize(characterSize))
@@ -326,7 +835,51 @@ float Font::getUnderlineThickness(uint32 characterSize) const
 
 const Texture& Font::getTexture(uint32 characterSize) const
 {
-    return m_pages[characterSize].texture;
+    if (m_atlas)
+        return *m_atlas;
+
+    // Every size shares the atlas of the distance field page
+    if (m_distanceField)
+        return getDistanceFieldPage().texture;
+
+    return getPage(characterSize).texture;
+}
+
+FontStats Font::getStats() const
+{
+    FontStats stats = m_stats;
+    stats.pageCount = static_cast<uint32>(m_pages.size());
+    stats.atlasCount = 0;
+    stats.atlasBytes = 0;
+
+    // Baked fonts keep one atlas, distance field fonts one page shared by every size
+    std::vector<const Texture*> textures;
+    if (m_atlas)
+    {
+        textures.push_back(m_atlas.get());
+    }
+    else if (m_distanceField)
+    {
+        if (m_distanceFieldPage)
+            textures.push_back(&m_distanceFieldPage->texture);
+    }
+    else
+    {
+        for (PageTable::const_iterator it = m_pages.begin(); it != m_pages.end(); ++it)
+            textures.push_back(&it->second.texture);
+    }
+
+    for (std::size_t i = 0; i < textures.size(); ++i)
+    {
+        const vec2u size = textures[i]->size();
+        if (size.x > 0 && size.y > 0)
+        {
+            ++stats.atlasCount;
+            stats.atlasBytes += static_cast<std::size_t>(size.x) * size.y * 4;
+        }
+    }
+
+    return stats;
 }
 
 Font& Font::operator =(const Font& right)
@@ -340,6 +893,13 @@ Font& Font::operator =(const Font& right)
     std::swap(m_info, temp.m_info);
     std::swap(m_pages, temp.m_pages);
     std::swap(m_pixelBuffer, temp.m_pixelBuffer);
+    std::swap(m_atlas, temp.m_atlas);
+    std::swap(m_distanceField, temp.m_distanceField);
+    std::swap(m_distanceFieldPage, temp.m_distanceFieldPage);
+    std::swap(m_stats, temp.m_stats);
+
+    // The cached page belongs to the old table
+    m_lastPage = 0;
 
     return *this;
 }
@@ -379,33 +939,89 @@ void Font::cleanup()
     m_refCount = 0;
     m_pages.clear();
     m_pixelBuffer.clear();
+    m_atlas.reset();
+    m_distanceFieldPage.reset();
+    m_lastPage = 0;
+    m_stats.glyphsRasterized = 0;
+    m_stats.cacheMisses = 0;
 }
 
-Glyph Font::loadGlyph(uint32 codePoint, uint32 characterSize, bool bold) const
+Font::Page& Font::getPage(uint32 characterSize) const
 {
-    // The glyph to return
-    Glyph glyph;
+    // Map nodes never move, the pointer stays valid until the pages are cleared
+    if (!m_lastPage || m_lastPageSize != characterSize)
+    {
+        PageTable::iterator it = m_pages.find(characterSize);
+        if (it != m_pages.end())
+        {
+            m_lastPage = &it->second;
+        }
+        else
+        {
+            // Glyphs of baked and distance field fonts all live in one atlas
+            m_lastPage = &m_pages[characterSize];
+            if (!m_atlas && !m_distanceField)
+                m_lastPage->createTexture();
+        }
 
+        m_lastPageSize = characterSize;
+    }
+
+    return *m_lastPage;
+}
+
+const Glyph* Font::findGlyph(const Page& page, uint32 codePoint, bool bold)
+{
+    // Latin-1 code points index a flat table directly
+    if (codePoint < LatinGlyphCount)
+    {
+        const uint32 index = page.latinGlyphs[codePoint + (bold ? LatinGlyphCount : 0)];
+        return index ? &page.glyphs[index - 1] : 0;
+    }
+
+    // Build the key by combining the code point and the bold flag
+    const uint32* index = page.glyphTable.find(((bold ? 1 : 0) << 31) | codePoint);
+    return index ? &page.glyphs[*index] : 0;
+}
+
+const Glyph& Font::insertGlyph(Page& page, uint32 codePoint, bool bold, const Glyph& glyph)
+{
+    page.glyphs.push_back(glyph);
+    const uint32 index = static_cast<uint32>(page.glyphs.size() - 1);
+
+    if (codePoint < LatinGlyphCount)
+        page.latinGlyphs[codePoint + (bold ? LatinGlyphCount : 0)] = index + 1;
+    else
+        page.glyphTable.insert(((bold ? 1 : 0) << 31) | codePoint, index);
+
+    return page.glyphs.back();
+}
+
+bool Font::rasterizeGlyph(uint32 codePoint, uint32 characterSize, bool bold, Glyph& glyph, vec2u& size, uint32 oversampling) const
+{
     // First, transform our ugly void* to a FT_Face
     FT_Face face = static_cast<FT_Face>(m_face);
     if (!face)
-        return glyph;
+        return false;
 
     // Set the character size
-    if (!setCurrentSize(characterSize))
-        return glyph;
+    if (!setCurrentSize(characterSize * oversampling))
+        return false;
+
+    // Oversampled glyphs are scaled afterwards, hinting them for one size would distort the others
+    const FT_Int32 flags = oversampling > 1 ? FT_LOAD_NO_HINTING : FT_LOAD_TARGET_NORMAL | FT_LOAD_FORCE_AUTOHINT;
 
     // Load the glyph corresponding to the code point
-    if (FT_Load_Char(face, codePoint, FT_LOAD_TARGET_NORMAL | FT_LOAD_FORCE_AUTOHINT) != 0)
-        return glyph;
+    if (FT_Load_Char(face, codePoint, flags) != 0)
+        return false;
 
     // Retrieve the glyph
     FT_Glyph glyphDesc;
     if (FT_Get_Glyph(face->glyph, &glyphDesc) != 0)
-        return glyph;
+        return false;
 
     // Apply bold if necessary -- first technique using outline (highest quality)
-    FT_Pos weight = 1 << 6;
+    FT_Pos weight = (1 << 6) * oversampling;
     bool outline = (glyphDesc->format == FT_GLYPH_FORMAT_OUTLINE);
     if (bold && outline)
     {
@@ -423,38 +1039,27 @@ Glyph Font::loadGlyph(uint32 codePoint, uint32 characterSize, bool bold) const
         FT_Bitmap_Embolden(static_cast<FT_Library>(m_library), &bitmap, weight, weight);
     }
 
+    // Metrics are brought back to characterSize
+    const float unit = static_cast<float>((1 << 6) * oversampling);
+
     // Compute the glyph's advance offset
-    glyph.advance = static_cast<float>(face->glyph->metrics.horiAdvance) / static_cast<float>(1 << 6);
+    glyph.advance = static_cast<float>(face->glyph->metrics.horiAdvance) / unit;
     if (bold)
-        glyph.advance += static_cast<float>(weight) / static_cast<float>(1 << 6);
+        glyph.advance += static_cast<float>(weight) / unit;
 
     int width  = bitmap.width;
     int height = bitmap.rows;
+    size = vec2u(0, 0);
 
     if ((width > 0) && (height > 0))
     {
-        // Leave a small padding around characters, so that filtering doesn't
-        // pollute them with pixels from neighbors
-        const unsigned int padding = 1;
-
-        // Get the glyphs page corresponding to the character size
-        Page& page = m_pages[characterSize];
-
-        // Find a good position for the new glyph into the texture
-        glyph.textureRect = findGlyphRect(page, width + 2 * padding, height + 2 * padding);
-
-        // Make sure the texture data is positioned in the center
-        // of the allocated texture rectangle
-        glyph.textureRect.x += padding;
-        glyph.textureRect.y += padding;
-        glyph.textureRect.width -= 2 * padding;
-        glyph.textureRect.height -= 2 * padding;
+        size = vec2u(width, height);
 
         // Compute the glyph's bounding box
-        glyph.bounds.x = static_cast<float>(face->glyph->metrics.horiBearingX) / static_cast<float>(1 << 6);
-        glyph.bounds.y = -static_cast<float>(face->glyph->metrics.horiBearingY) / static_cast<float>(1 << 6);
-        glyph.bounds.width  = static_cast<float>(face->glyph->metrics.width) / static_cast<float>(1 << 6);
-        glyph.bounds.height = static_cast<float>(face->glyph->metrics.height) / static_cast<float>(1 << 6);
+        glyph.bounds.x = static_cast<float>(face->glyph->metrics.horiBearingX) / unit;
+        glyph.bounds.y = -static_cast<float>(face->glyph->metrics.horiBearingY) / unit;
+        glyph.bounds.width  = static_cast<float>(face->glyph->metrics.width) / unit;
+        glyph.bounds.height = static_cast<float>(face->glyph->metrics.height) / unit;
 
         // Extract the glyph's pixels from the bitmap
         m_pixelBuffer.resize(width * height * 4, 255);
@@ -487,6 +1092,65 @@ Glyph Font::loadGlyph(uint32 codePoint, uint32 characterSize, bool bold) const
                 pixels += bitmap.pitch;
             }
         }
+    }
+
+    // Delete the FT glyph
+    FT_Done_Glyph(glyphDesc);
+
+    ++m_stats.glyphsRasterized;
+
+    return true;
+}
+
+float Font::computeKerning(uint32 first, uint32 second, uint32 characterSize) const
+{
+    FT_Face face = static_cast<FT_Face>(m_face);
+    if (!face || !setCurrentSize(characterSize))
+        return 0.f;
+
+    // Convert the characters to indices
+    FT_UInt index1 = FT_Get_Char_Index(face, first);
+    FT_UInt index2 = FT_Get_Char_Index(face, second);
+
+    // Get the kerning vector
+    FT_Vector kerning;
+    FT_Get_Kerning(face, index1, index2, FT_KERNING_DEFAULT, &kerning);
+
+    // X advance is already in pixels for bitmap fonts
+    if (!FT_IS_SCALABLE(face))
+        return static_cast<float>(kerning.x);
+    else
+        return static_cast<float>(kerning.x) / static_cast<float>(1 << 6);
+}
+
+Glyph Font::loadGlyph(uint32 codePoint, uint32 characterSize, bool bold) const
+{
+    // The glyph to return
+    Glyph glyph;
+
+    // Render the glyph into the pixel buffer
+    vec2u size;
+    if (!rasterizeGlyph(codePoint, characterSize, bold, glyph, size))
+        return glyph;
+
+    if ((size.x > 0) && (size.y > 0))
+    {
+        // Leave a small padding around characters, so that filtering doesn't
+        // pollute them with pixels from neighbors
+        const unsigned int padding = 1;
+
+        // Get the glyphs page corresponding to the character size
+        Page& page = getPage(characterSize);
+
+        // Find a good position for the new glyph into the texture
+        glyph.textureRect = findGlyphRect(page, size.x + 2 * padding, size.y + 2 * padding);
+
+        // Make sure the texture data is positioned in the center
+        // of the allocated texture rectangle
+        glyph.textureRect.x += padding;
+        glyph.textureRect.y += padding;
+        glyph.textureRect.width -= 2 * padding;
+        glyph.textureRect.height -= 2 * padding;
 
         // Write the pixels to the texture
         unsigned int x = glyph.textureRect.x;
@@ -496,9 +1160,6 @@ Glyph Font::loadGlyph(uint32 codePoint, uint32 characterSize, bool bold) const
         page.texture.update(&m_pixelBuffer[0], w, h, x, y);
     }
 
-    // Delete the FT glyph
-    FT_Done_Glyph(glyphDesc);
-
     // Force an OpenGL flush, so that the font's texture will appear updated
     // in all contexts immediately (solves problems in multi-threaded apps)
     glFlush();
@@ -507,6 +1168,111 @@ Glyph Font::loadGlyph(uint32 codePoint, uint32 characterSize, bool bold) const
     return glyph;
 }
 
+Font::Page& Font::getDistanceFieldPage() const
+{
+    // Shared by copies of the font, like the FreeType face the glyphs come from
+    if (!m_distanceFieldPage)
+    {
+        m_distanceFieldPage.reset(new Page());
+        m_distanceFieldPage->createTexture();
+    }
+
+    return *m_distanceFieldPage;
+}
+
+const Glyph& Font::getDistanceFieldGlyph(uint32 codePoint, bool bold) const
+{
+    Page& page = getDistanceFieldPage();
+    if (const Glyph* glyph = findGlyph(page, codePoint, bold))
+        return *glyph;
+
+    return insertGlyph(page, codePoint, bold, loadDistanceFieldGlyph(codePoint, bold));
+}
+
+Glyph Font::loadDistanceFieldGlyph(uint32 codePoint, bool bold) const
+{
+    // The glyph to return
+    Glyph glyph;
+
+    // Render the oversampled coverage into the pixel buffer
+    vec2u size;
+    if (!rasterizeGlyph(codePoint, DistanceFieldSize, bold, glyph, size, DistanceFieldOversampling))
+        return glyph;
+
+    if ((size.x == 0) || (size.y == 0))
+        return glyph;
+
+    const uint32 spread = DistanceFieldSpread;
+    const uint32 scale = DistanceFieldOversampling;
+
+    // The field extends past the outline by the spread on every side
+    const uint32 width = (size.x + scale - 1) / scale + 2 * spread;
+    const uint32 height = (size.y + scale - 1) / scale + 2 * spread;
+
+    // Seed the transforms on the oversampled grid, the bitmap in the middle
+    const uint32 gridWidth = width * scale;
+    const uint32 gridHeight = height * scale;
+    std::vector<bool> inside(gridWidth * gridHeight, false);
+    for (uint32 y = 0; y < size.y; ++y)
+        for (uint32 x = 0; x < size.x; ++x)
+            inside[(y + spread * scale) * gridWidth + x + spread * scale] = m_pixelBuffer[(x + y * size.x) * 4 + 3] >= 128;
+
+    std::vector<double> toInside(inside.size());
+    std::vector<double> toOutside(inside.size());
+    for (std::size_t i = 0; i < inside.size(); ++i)
+    {
+        toInside[i] = inside[i] ? 0.0 : DistanceUnreached;
+        toOutside[i] = inside[i] ? DistanceUnreached : 0.0;
+    }
+
+    transformGrid(toInside, gridWidth, gridHeight);
+    transformGrid(toOutside, gridWidth, gridHeight);
+
+    // Sample the signed distance, positive inside, at the middle of every pixel
+    // and map the spread onto the alpha channel around 128
+    std::vector<uint8> pixels(width * height * 4, 255);
+    for (uint32 y = 0; y < height; ++y)
+    {
+        for (uint32 x = 0; x < width; ++x)
+        {
+            const std::size_t cell = (y * scale + scale / 2) * gridWidth + x * scale + scale / 2;
+
+            // The outline lies half a cell before the nearest cell of the other side
+            double distance = inside[cell] ? std::sqrt(toOutside[cell]) - 0.5 : 0.5 - std::sqrt(toInside[cell]);
+            distance /= scale;
+
+            const double alpha = 128.0 + distance * 127.0 / spread;
+            pixels[(x + y * width) * 4 + 3] = static_cast<uint8>(std::min(255.0, std::max(0.0, alpha + 0.5)));
+        }
+    }
+
+    // The quad covers the whole field, one texel per pixel at DistanceFieldSize
+    glyph.bounds.x -= static_cast<float>(spread);
+    glyph.bounds.y -= static_cast<float>(spread);
+    glyph.bounds.width = static_cast<float>(width);
+    glyph.bounds.height = static_cast<float>(height);
+
+    Page& page = getDistanceFieldPage();
+
+    // Leave a small padding around characters, so that filtering doesn't
+    // pollute them with pixels from neighbors
+    const unsigned int padding = 1;
+
+    glyph.textureRect = findGlyphRect(page, width + 2 * padding, height + 2 * padding);
+    glyph.textureRect.x += padding;
+    glyph.textureRect.y += padding;
+    glyph.textureRect.width -= 2 * padding;
+    glyph.textureRect.height -= 2 * padding;
+
+    page.texture.update(&pixels[0], width, height, glyph.textureRect.x, glyph.textureRect.y);
+
+    // Force an OpenGL flush, so that the font's texture will appear updated
+    // in all contexts immediately (solves problems in multi-threaded apps)
+    glFlush();
+
+    return glyph;
+}
+
 recti Font::findGlyphRect(Page& page, uint32 width, uint32 height) const
 {
     // Find the line that fits well the glyph
@@ -607,7 +1373,15 @@ bool Font::setCurrentSize(unsigned int characterSize) const
 }
 
 Font::Page::Page() :
-nextRow(3)
+nextRow(3),
+lineSpacing(0.f),
+underlinePosition(0.f),
+underlineThickness(0.f)
+{
+    std::fill(latinGlyphs, latinGlyphs + LatinGlyphCount * 2, 0);
+}
+
+void Font::Page::createTexture()
 {
     // Make sure that the texture is initialized by default
     nx::Image image;
@@ -1,9 +1,27 @@
 #include <nex/gfx/image.h>
 #include <nex/gfx/imageloader.h>
+#include <nex/system/jobsystem.h>
 
 // Standard includes.
 #include <cstring>
 
+namespace
+{
+    // Calls function(begin, end) over [0, rows), split between the threads of jobs when there is one.
+    template <typename Function>
+    void forEachRow(nx::JobSystem* jobs, std::size_t rows, std::size_t width, Function function)
+    {
+        if (!jobs)
+        {
+            function(static_cast<std::size_t>(0), rows);
+            return;
+        }
+
+        const std::size_t grain = std::max<std::size_t>(1, nx::ImageParallelPixels / std::max<std::size_t>(1, width));
+        jobs->parallelFor(rows, grain, function);
+    }
+}
+
 namespace nx
 {
 
@@ -88,23 +106,49 @@ bool Image::saveToFile(const std::string& filename) const
 }
 
 void Image::createMaskFromColor(const Color& color, uint8 alpha)
+{
+    createMaskFromColorRows(color, alpha, 0);
+}
+
+void Image::createMaskFromColor(const Color& color, uint8 alpha, JobSystem& jobs)
+{
+    createMaskFromColorRows(color, alpha, &jobs);
+}
+
+void Image::createMaskFromColorRows(const Color& color, uint8 alpha, JobSystem* jobs)
 {
     // Make sure that the image is not empty
     if (!m_pixels.empty())
     {
-        // Replace the alpha of the pixels that match the transparent color
-        uint8* ptr = &m_pixels[0];
-        uint8* end = ptr + m_pixels.size();
-        while (ptr < end)
+        const std::size_t rowSize = m_size.x * 4;
+        uint8* pixels = &m_pixels[0];
+
+        forEachRow(jobs, m_size.y, m_size.x, [&](std::size_t first, std::size_t last)
         {
-            if ((ptr[0] == color.r) && (ptr[1] == color.g) && (ptr[2] == color.b) && (ptr[3] == color.a))
-                ptr[3] = alpha;
-            ptr += 4;
-        }
+            // Replace the alpha of the pixels that match the transparent color
+            uint8* ptr = pixels + first * rowSize;
+            uint8* end = pixels + last * rowSize;
+            while (ptr < end)
+            {
+                if ((ptr[0] == color.r) && (ptr[1] == color.g) && (ptr[2] == color.b) && (ptr[3] == color.a))
+                    ptr[3] = alpha;
+                ptr += 4;
+            }
+        });
     }
 }
 
 void Image::copy(const Image& source, uint32 destX, uint32 destY, const recti& sourceRect, bool applyAlpha)
+{
+    copyRows(source, destX, destY, sourceRect, applyAlpha, 0);
+}
+
+void Image::copy(const Image& source, uint32 destX, uint32 destY, const recti& sourceRect, bool applyAlpha, JobSystem& jobs)
+{
+    copyRows(source, destX, destY, sourceRect, applyAlpha, &jobs);
+}
+
+void Image::copyRows(const Image& source, uint32 destX, uint32 destY, const recti& sourceRect, bool applyAlpha, JobSystem* jobs)
 {
     // Make sure that both images are valid
     if ((source.m_size.x == 0) || (source.m_size.y == 0) || (m_size.x == 0) || (m_size.y == 0))
@@ -157,39 +201,45 @@ void Image::copy(const Image& source, uint32 destX, uint32 destY, const recti& s
     uint8* dstPixels = &m_pixels[0] + (destX + destY * m_size.x) * 4;
 
     // Copy the pixels
-    if (applyAlpha)
+    forEachRow(jobs, rows, width, [&](std::size_t first, std::size_t last)
     {
-        // Interpolation using alpha values, pixel by pixel (slower)
-        for (int i = 0; i < rows; ++i)
+        const uint8* srcRow = srcPixels + first * srcStride;
+        uint8* dstRow = dstPixels + first * dstStride;
+
+        if (applyAlpha)
         {
-            for (int j = 0; j < width; ++j)
+            // Interpolation using alpha values, pixel by pixel (slower)
+            for (std::size_t i = first; i < last; ++i)
             {
-                // Get a direct pointer to the components of the current pixel
-                const uint8* src = srcPixels + j * 4;
-                uint8* dst = dstPixels + j * 4;
-
-                // Interpolate RGBA components using the alpha value of the source pixel
-                uint8 alpha = src[3];
-                dst[0] = (src[0] * alpha + dst[0] * (255 - alpha)) / 255;
-                dst[1] = (src[1] * alpha + dst[1] * (255 - alpha)) / 255;
-                dst[2] = (src[2] * alpha + dst[2] * (255 - alpha)) / 255;
-                dst[3] = alpha + dst[3] * (255 - alpha) / 255;
+                for (int j = 0; j < width; ++j)
+                {
+                    // Get a direct pointer to the components of the current pixel
+                    const uint8* src = srcRow + j * 4;
+                    uint8* dst = dstRow + j * 4;
+
+                    // Interpolate RGBA components using the alpha value of the source pixel
+                    uint8 alpha = src[3];
+                    dst[0] = (src[0] * alpha + dst[0] * (255 - alpha)) / 255;
+                    dst[1] = (src[1] * alpha + dst[1] * (255 - alpha)) / 255;
+                    dst[2] = (src[2] * alpha + dst[2] * (255 - alpha)) / 255;
+                    dst[3] = alpha + dst[3] * (255 - alpha) / 255;
+                }
+
+                srcRow += srcStride;
+                dstRow += dstStride;
             }
-
-            srcPixels += srcStride;
-            dstPixels += dstStride;
         }
-    }
-    else
-    {
-        // Optimized copy ignoring alpha values, row by row (faster)
-        for (int i = 0; i < rows; ++i)
+        else
         {
-            std::memcpy(dstPixels, srcPixels, pitch);
-            srcPixels += srcStride;
-            dstPixels += dstStride;
+            // Optimized copy ignoring alpha values, row by row (faster)
+            for (std::size_t i = first; i < last; ++i)
+            {
+                std::memcpy(dstRow, srcRow, pitch);
+                srcRow += srcStride;
+                dstRow += dstStride;
+            }
         }
-    }
+    });
 }
 
 void Image::setPixel(unsigned int x, unsigned int y, const Color& color)
@@ -220,43 +270,70 @@ const uint8* Image::getPixelsPtr() const
 }
 
 void Image::flipHorizontally()
+{
+    flipRowsHorizontally(0);
+}
+
+void Image::flipHorizontally(JobSystem& jobs)
+{
+    flipRowsHorizontally(&jobs);
+}
+
+void Image::flipRowsHorizontally(JobSystem* jobs)
 {
     if (!m_pixels.empty())
     {
         std::size_t rowSize = m_size.x * 4;
 
-        for (std::size_t y = 0; y < m_size.y; ++y)
+        forEachRow(jobs, m_size.y, m_size.x, [&](std::size_t first, std::size_t last)
         {
-            std::vector<uint8>::iterator left = m_pixels.begin() + y * rowSize;
-            std::vector<uint8>::iterator right = m_pixels.begin() + (y + 1) * rowSize - 4;
-
-            for (std::size_t x = 0; x < m_size.x / 2; ++x)
+            for (std::size_t y = first; y < last; ++y)
             {
-                std::swap_ranges(left, left + 4, right);
+                std::vector<uint8>::iterator left = m_pixels.begin() + y * rowSize;
+                std::vector<uint8>::iterator right = m_pixels.begin() + (y + 1) * rowSize - 4;
 
-                left += 4;
-                right -= 4;
+                for (std::size_t x = 0; x < m_size.x / 2; ++x)
+                {
+                    std::swap_ranges(left, left + 4, right);
+
+                    left += 4;
+                    right -= 4;
+                }
             }
-        }
+        });
     }
 }
 
 void Image::flipVertically()
+{
+    flipRowsVertically(0);
+}
+
+void Image::flipVertically(JobSystem& jobs)
+{
+    flipRowsVertically(&jobs);
+}
+
+void Image::flipRowsVertically(JobSystem* jobs)
 {
     if (!m_pixels.empty())
     {
         std::size_t rowSize = m_size.x * 4;
 
-        std::vector<uint8>::iterator top = m_pixels.begin();
-        std::vector<uint8>::iterator bottom = m_pixels.end() - rowSize;
-
-        for (std::size_t y = 0; y < m_size.y / 2; ++y)
+        // Every row of the top half swaps with its mirror in the bottom half.
+        forEachRow(jobs, m_size.y / 2, m_size.x, [&](std::size_t first, std::size_t last)
         {
-            std::swap_ranges(top, top + rowSize, bottom);
+            std::vector<uint8>::iterator top = m_pixels.begin() + first * rowSize;
+            std::vector<uint8>::iterator bottom = m_pixels.end() - (first + 1) * rowSize;
 
-            top += rowSize;
-            bottom -= rowSize;
-        }
+            for (std::size_t y = first; y < last; ++y)
+            {
+                std::swap_ranges(top, top + rowSize, bottom);
+
+                top += rowSize;
+                bottom -= rowSize;
+            }
+        });
     }
 }
 
@@ -1,7 +1,15 @@
 #include <nex/gfx/text.h>
 
 // Standard includes.
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+
+namespace
+{
+    // m_uploadFrom when the vertex buffer is up to date.
+    const uint32 NoPendingUpload = 0xFFFFFFFF;
+}
 
 namespace nx
 {
@@ -13,7 +21,11 @@ Text::Text() :
     m_style(Regular),
     m_color(255, 255, 255),
     m_bounds(),
-    m_geometryNeedUpdate(false)
+    m_geometryNeedUpdate(false),
+    m_colorNeedUpdate(false),
+    m_firstChangedChar(0),
+    m_bufferCapacity(0),
+    m_uploadFrom(NoPendingUpload)
 {
     m_vertexArray.create();
     m_vertexBuffer.create();
@@ -26,7 +38,11 @@ m_characterSize     (characterSize),
 m_style             (Regular),
 m_color             (255, 255, 255),
 m_bounds            (),
-m_geometryNeedUpdate(true)
+m_geometryNeedUpdate(true),
+m_colorNeedUpdate   (false),
+m_firstChangedChar  (0),
+m_bufferCapacity    (0),
+m_uploadFrom        (NoPendingUpload)
 {
 
 }
@@ -35,8 +51,14 @@ void Text::setString(const String& string)
 {
     if (m_string != string)
     {
+        // Only the characters after the common prefix need a new layout.
+        const std::size_t length = std::min(m_string.getSize(), string.getSize());
+        std::size_t first = 0;
+        while (first < length && m_string[first] == string[first])
+            ++first;
+
         m_string = string;
-        m_geometryNeedUpdate = true;
+        invalidateFrom(first);
     }
 }
 
@@ -45,7 +67,7 @@ void Text::setFont(const Font& font)
     if (m_font != &font)
     {
         m_font = &font;
-        m_geometryNeedUpdate = true;
+        invalidateFrom(0);
     }
 }
 
@@ -54,7 +76,7 @@ void Text::setCharacterSize(unsigned int size)
     if (m_characterSize != size)
     {
         m_characterSize = size;
-        m_geometryNeedUpdate = true;
+        invalidateFrom(0);
     }
 }
 
@@ -63,7 +85,7 @@ void Text::setStyle(uint32 style)
     if (m_style != style)
     {
         m_style = style;
-        m_geometryNeedUpdate = true;
+        invalidateFrom(0);
     }
 }
 
@@ -73,13 +95,9 @@ void Text::setColor(const Color& color)
     {
         m_color = color;
 
-        // Change vertex colors directly, no need to update whole geometry
-        // (if geometry is updated anyway, we can skip this step)
-        if (!m_geometryNeedUpdate)
-        {
-            for (std::size_t i = 0; i < m_vertices.size(); ++i)
-                m_vertices[i].color = m_color.toVector();
-        }
+        // Vertex colors are rewritten in place on the next update, the
+        // layout stays as it is.
+        m_colorNeedUpdate = true;
     }
 }
 
@@ -166,35 +184,71 @@ void Text::render() const
     if (m_font) {
         ensureGeometryUpdate();
 
+        if (m_vertices.size() == 0)
+            return;
+
+        upload(m_uploadFrom);
+        m_uploadFrom = NoPendingUpload;
+
         glActiveTexture(GL_TEXTURE0);
         m_font->getTexture(m_characterSize).bind();
 
+        m_vertexArray.bind();
+        glDrawArrays(GL_TRIANGLES, 0, m_vertices.size());
+    }
+}
 
+const VertexList2d& Text::getVertices() const
+{
+    ensureGeometryUpdate();
 
-        glDrawArrays(GL_TRIANGLES, 0, m_vertices.size() * sizeof(Vertex2d));
-    }
+    return m_vertices;
+}
+
+void Text::invalidateFrom(std::size_t index)
+{
+    if (!m_geometryNeedUpdate || index < m_firstChangedChar)
+        m_firstChangedChar = index;
+
+    m_geometryNeedUpdate = true;
 }
 
 void Text::ensureGeometryUpdate() const
 {
-    // Do nothing, if geometry has not changed
+    // Only the color changed: rewrite it in place, the layout stays valid
     if (!m_geometryNeedUpdate)
+    {
+        if (m_colorNeedUpdate)
+        {
+            m_colorNeedUpdate = false;
+
+            const vec3f color = m_color.toVector();
+            for (std::size_t i = 0; i < m_vertices.size(); ++i)
+                m_vertices[i].color = color;
+
+            m_uploadFrom = 0;
+        }
+
         return;
+    }
 
     // Mark geometry as updated
     m_geometryNeedUpdate = false;
 
-    // Clear the previous geometry
-    m_vertices.clear();
-    m_bounds = rectf();
-
-    // No font: nothing to draw
-    if (!m_font)
+    // No font or no text: nothing to draw
+    if (!m_font || m_string.isEmpty())
+    {
+        m_vertices.clear();
+        m_layout.clear();
+        m_bounds = rectf();
+        m_colorNeedUpdate = false;
         return;
+    }
 
-    // No text: nothing to draw
-    if (m_string.isEmpty())
-        return;
+    // Resume the layout at the first changed character, everything before
+    // it keeps its vertices
+    std::size_t first = m_layout.empty() ? 0 : std::min(m_firstChangedChar, m_layout.size() - 1);
+    first = std::min(first, m_string.getSize());
 
     // Compute values related to the text style
     bool bold = (m_style & Bold) != 0;
@@ -214,20 +268,53 @@ void Text::ensureGeometryUpdate() const
     // Precompute the variables needed by the algorithm
     float hspace = static_cast<float>(m_font->getGlyph(L' ', m_characterSize, bold).advance);
     float vspace = static_cast<float>(m_font->getLineSpacing(m_characterSize));
-    float x = 0.f;
-    float y = static_cast<float>(m_characterSize);
 
-    // Create one quad for each character
-    float minX = static_cast<float>(m_characterSize);
-    float minY = static_cast<float>(m_characterSize);
-    float maxX = 0.f;
-    float maxY = 0.f;
+    LayoutState state;
+    if (first > 0)
+    {
+        state = m_layout[first];
+    }
+    else
+    {
+        state.x = 0.f;
+        state.y = static_cast<float>(m_characterSize);
+        state.minX = static_cast<float>(m_characterSize);
+        state.minY = static_cast<float>(m_characterSize);
+        state.maxX = 0.f;
+        state.maxY = 0.f;
+        state.prevChar = 0;
+        state.vertexCount = 0;
+    }
+
+    float x = state.x;
+    float y = state.y;
+    float minX = state.minX;
+    float minY = state.minY;
+    float maxX = state.maxX;
+    float maxY = state.maxY;
+    uint32 prevChar = state.prevChar;
 
     const vec3f color = m_color.toVector();
 
-    uint32 prevChar = 0;
-    for (std::size_t i = 0; i < m_string.getSize(); ++i)
+    // One quad per character and the two closing lines, the list keeps its
+    // storage across updates so only a longer string grows it.
+    m_vertices.resize(state.vertexCount);
+    m_vertices.reserve((m_string.getSize() + 2) * 6);
+    m_layout.resize(m_string.getSize() + 1);
+
+    for (std::size_t i = first; i < m_string.getSize(); ++i)
     {
+        // Remember where this character starts
+        LayoutState& layout = m_layout[i];
+        layout.x = x;
+        layout.y = y;
+        layout.minX = minX;
+        layout.minY = minY;
+        layout.maxX = maxX;
+        layout.maxY = maxY;
+        layout.prevChar = prevChar;
+        layout.vertexCount = m_vertices.size();
+
         uint32 curChar = m_string[i];
 
         // Apply the kerning offset
@@ -315,6 +402,16 @@ void Text::ensureGeometryUpdate() const
         x += glyph.advance;
     }
 
+    LayoutState& end = m_layout[m_string.getSize()];
+    end.x = x;
+    end.y = y;
+    end.minX = minX;
+    end.minY = minY;
+    end.maxX = maxX;
+    end.maxY = maxY;
+    end.prevChar = prevChar;
+    end.vertexCount = m_vertices.size();
+
     // If we're using the underlined style, add the last line
     if (underlined)
     {
@@ -349,20 +446,44 @@ void Text::ensureGeometryUpdate() const
     m_bounds.width = maxX - minX;
     m_bounds.height = maxY - minY;
 
-    if (m_vertexBuffer.isCreated()) {
-        m_vertexBuffer.destroy();
-    }
+    // A color change also touches the vertices before the changed range
+    uint32 uploadFrom = m_layout[first].vertexCount;
+    if (m_colorNeedUpdate)
+    {
+        m_colorNeedUpdate = false;
+
+        for (std::size_t i = 0; i < uploadFrom; ++i)
+            m_vertices[i].color = color;
 
-    if (m_vertexArray.isCreated()) {
-        m_vertexBuffer.destroy();
+        uploadFrom = 0;
     }
 
-    m_vertexArray.create();
-    m_vertexArray.bind();
+    m_uploadFrom = std::min(m_uploadFrom, uploadFrom);
+}
 
-    m_vertexBuffer.create();
-    m_vertexBuffer.bind();
+void Text::upload(uint32 first) const
+{
+    const uint32 count = m_vertices.size();
+
+    if (count > m_bufferCapacity || !m_vertexBuffer.isCreated())
+    {
+        // Grow geometrically so a string typed one character at a time
+        // reallocates the buffer only a few times
+        m_bufferCapacity = std::max(count, std::max<uint32>(m_bufferCapacity * 2, 64));
+        first = 0;
+
+        if (!m_vertexArray.isCreated())
+            m_vertexArray.create();
+        m_vertexArray.bind();
+
+        m_vertexBuffer.bufferData(m_bufferCapacity * sizeof(Vertex2d), 0, DrawType::DRAW_TYPE_DYNAMIC);
+        m_vertexArray.setAttribute(VERTEX2D_POSITION, 2, sizeof(Vertex2d), offsetof(Vertex2d, position));
+        m_vertexArray.setAttribute(VERTEX2D_COLOR, 3, sizeof(Vertex2d), offsetof(Vertex2d, color));
+        m_vertexArray.setAttribute(VERTEX2D_UV, 2, sizeof(Vertex2d), offsetof(Vertex2d, uv));
+        m_vertexArray.unbind();
+    }
 
-    m_vertexBuffer.bufferData(m_vertices.size() * sizeof(Vertex2d), m_vertices.getFloatPtr(), DrawType::DRAW_TYPE_STATIC);
+    if (first < count)
+        m_vertexBuffer.subData(first * sizeof(Vertex2d), (count - first) * sizeof(Vertex2d), &m_vertices[first]);
 }
 } // namespace nx
@@ -0,0 +1,195 @@
+#include <nex/gfx/textbatch.h>
+#include <nex/gfx/font.h>
+
+// Standard includes.
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+
+namespace
+{
+    // Quads both buffers start with.
+    const uint32 MinimumQuadCapacity = 256;
+
+    // Text emits six vertices per quad, the batch keeps four and indexes them.
+    const std::size_t TextQuadVertices = 6;
+}
+
+namespace nx
+{
+
+TextBatch::TextBatch() :
+    m_vertexCapacity(0),
+    m_indexCapacity(0)
+{
+    begin();
+}
+
+TextBatch::~TextBatch()
+{ }
+
+void TextBatch::begin()
+{
+    m_items.clear();
+
+    m_stats.drawCalls = 0;
+    m_stats.bytesUploaded = 0;
+    m_stats.quadCount = 0;
+    m_stats.textCount = 0;
+}
+
+void TextBatch::draw(const Text& text, const vec2f& position)
+{
+    const Font* font = text.getFont();
+    if (!font)
+        return;
+
+    // Laying out first may add glyphs to the atlas.
+    if (text.getVertices().size() == 0)
+        return;
+
+    Item item;
+    item.text = &text;
+    item.texture = &font->getTexture(text.getCharacterSize());
+    item.position = position;
+    item.order = static_cast<uint32>(m_items.size());
+    m_items.push_back(item);
+}
+
+void TextBatch::flush(GLint textureSizeUniform)
+{
+    m_stats.drawCalls = 0;
+    m_stats.bytesUploaded = 0;
+    m_stats.quadCount = 0;
+    m_stats.textCount = static_cast<uint32>(m_items.size());
+
+    if (m_items.empty())
+        return;
+
+    // Texts sharing an atlas end up next to each other, in the order they were drawn.
+    std::sort(m_items.begin(), m_items.end(), &compareItems);
+
+    m_vertices.clear();
+    m_ranges.clear();
+
+    for (std::size_t i = 0; i < m_items.size(); ++i)
+    {
+        const Item& item = m_items[i];
+        const VertexList2d& vertices = item.text->getVertices();
+        const uint32 quadCount = static_cast<uint32>(vertices.size() / TextQuadVertices);
+
+        if (m_ranges.empty() || m_ranges.back().texture != item.texture)
+        {
+            Range range;
+            range.texture = item.texture;
+            range.firstQuad = static_cast<uint32>(m_vertices.size() / 4);
+            range.quadCount = 0;
+            m_ranges.push_back(range);
+        }
+
+        // Corners 0, 1 and 2 of the first triangle and corner 5 of the second
+        for (uint32 quad = 0; quad < quadCount; ++quad)
+        {
+            const std::size_t first = quad * TextQuadVertices;
+            const std::size_t corners[4] = { first, first + 1, first + 2, first + 5 };
+
+            for (std::size_t corner = 0; corner < 4; ++corner)
+            {
+                Vertex2d vertex = vertices[corners[corner]];
+                vertex.position += item.position;
+                m_vertices.push_back(vertex);
+            }
+        }
+
+        m_ranges.back().quadCount += quadCount;
+    }
+
+    const uint32 quadCount = static_cast<uint32>(m_vertices.size() / 4);
+    m_stats.quadCount = quadCount;
+    if (quadCount == 0)
+        return;
+
+    if (!m_vertexArray.isCreated())
+        m_vertexArray.create();
+    m_vertexArray.bind();
+
+    if (quadCount > m_vertexCapacity)
+    {
+        m_vertexCapacity = std::max(quadCount, std::max(m_vertexCapacity * 2, MinimumQuadCapacity));
+
+        m_vertexBuffer.bufferData(m_vertexCapacity * 4 * sizeof(Vertex2d), 0, DrawType::DRAW_TYPE_STREAM);
+        m_vertexArray.setAttribute(VERTEX2D_POSITION, 2, sizeof(Vertex2d), offsetof(Vertex2d, position));
+        m_vertexArray.setAttribute(VERTEX2D_COLOR, 3, sizeof(Vertex2d), offsetof(Vertex2d, color));
+        m_vertexArray.setAttribute(VERTEX2D_UV, 2, sizeof(Vertex2d), offsetof(Vertex2d, uv));
+    }
+    else
+    {
+        // Orphan the storage of the previous frame, the driver need not wait for it
+        m_vertexBuffer.bufferData(m_vertexCapacity * 4 * sizeof(Vertex2d), 0, DrawType::DRAW_TYPE_STREAM);
+    }
+
+    const std::size_t vertexBytes = m_vertices.size() * sizeof(Vertex2d);
+    m_vertexBuffer.subData(0, vertexBytes, &m_vertices[0]);
+    m_stats.bytesUploaded += vertexBytes;
+
+    ensureIndices(quadCount);
+
+    glActiveTexture(GL_TEXTURE0);
+    for (std::size_t i = 0; i < m_ranges.size(); ++i)
+    {
+        const Range& range = m_ranges[i];
+        if (range.quadCount == 0)
+            continue;
+
+        // Texture coordinates are in atlas pixels, a program normalizing them
+        // needs the size of each atlas, not just the one it was bound with
+        range.texture->bind();
+        if (textureSizeUniform != -1)
+            glUniform2f(textureSizeUniform, static_cast<float>(range.texture->size().x), static_cast<float>(range.texture->size().y));
+
+        glDrawElements(GL_TRIANGLES, range.quadCount * 6, GL_UNSIGNED_INT,
+                       reinterpret_cast<const GLvoid*>(range.firstQuad * 6 * sizeof(uint32)));
+        ++m_stats.drawCalls;
+    }
+
+    m_vertexArray.unbind();
+}
+
+bool TextBatch::compareItems(const Item& left, const Item& right)
+{
+    if (left.texture != right.texture)
+        return std::less<const Texture*>()(left.texture, right.texture);
+
+    return left.order < right.order;
+}
+
+void TextBatch::ensureIndices(uint32 quadCount)
+{
+    if (quadCount <= m_indexCapacity)
+    {
+        m_elementBuffer.bind();
+        return;
+    }
+
+    // The pattern never changes, it is only rebuilt when more quads are needed
+    m_indexCapacity = std::max(quadCount, std::max(m_indexCapacity * 2, MinimumQuadCapacity));
+
+    std::vector<uint32> indices(m_indexCapacity * 6);
+    for (uint32 quad = 0; quad < m_indexCapacity; ++quad)
+    {
+        const uint32 vertex = quad * 4;
+        uint32* index = &indices[quad * 6];
+
+        index[0] = vertex;
+        index[1] = vertex + 1;
+        index[2] = vertex + 2;
+        index[3] = vertex + 2;
+        index[4] = vertex + 1;
+        index[5] = vertex + 3;
+    }
+
+    m_elementBuffer.bufferData(indices.size() * sizeof(uint32), &indices[0], DrawType::DRAW_TYPE_STATIC);
+    m_stats.bytesUploaded += indices.size() * sizeof(uint32);
+}
+
+} // namespace nx
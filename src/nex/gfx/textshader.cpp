@@ -0,0 +1,128 @@
+#include <nex/gfx/textshader.h>
+#include <nex/gfx/font.h>
+
+namespace
+{
+    // Attribute locations are those of Vertex2dAttribute.
+    const char* VertexSource =
+        "#version 330 core\n"
+        "layout(location = 0) in vec2 position;\n"
+        "layout(location = 1) in vec3 color;\n"
+        "layout(location = 2) in vec2 uv;\n"
+        "uniform mat4 u_projection;\n"
+        "uniform vec2 u_textureSize;\n"
+        "out vec3 v_color;\n"
+        "out vec2 v_uv;\n"
+        "void main()\n"
+        "{\n"
+        "    v_color = color;\n"
+        "    v_uv = uv / u_textureSize;\n"
+        "    gl_Position = u_projection * vec4(position, 0.0, 1.0);\n"
+        "}\n";
+
+    const char* BitmapFragmentSource =
+        "#version 330 core\n"
+        "in vec3 v_color;\n"
+        "in vec2 v_uv;\n"
+        "uniform sampler2D u_texture;\n"
+        "out vec4 o_color;\n"
+        "void main()\n"
+        "{\n"
+        "    o_color = vec4(v_color, 1.0) * texture(u_texture, v_uv);\n"
+        "}\n";
+
+    // The smoothing band follows the screen size of a texel, so edges stay
+    // one pixel soft at any character size.
+    const char* DistanceFieldFragmentSource =
+        "#version 330 core\n"
+        "in vec3 v_color;\n"
+        "in vec2 v_uv;\n"
+        "uniform sampler2D u_texture;\n"
+        "uniform float u_threshold;\n"
+        "uniform float u_outlineWidth;\n"
+        "uniform vec4 u_outlineColor;\n"
+        "out vec4 o_color;\n"
+        "void main()\n"
+        "{\n"
+        "    float distance = texture(u_texture, v_uv).a;\n"
+        "    float smoothing = 0.7 * fwidth(distance);\n"
+        "    float fill = smoothstep(u_threshold - smoothing, u_threshold + smoothing, distance);\n"
+        "    float outer = u_threshold - u_outlineWidth;\n"
+        "    float coverage = smoothstep(outer - smoothing, outer + smoothing, distance);\n"
+        "    vec4 outline = u_outlineWidth > 0.0 ? u_outlineColor : vec4(v_color, 1.0);\n"
+        "    vec4 color = mix(outline, vec4(v_color, 1.0), fill);\n"
+        "    o_color = vec4(color.rgb, color.a * coverage);\n"
+        "}\n";
+}
+
+namespace nx
+{
+
+const float TextShader::DistanceFieldThreshold = 128.f / 255.f;
+
+TextShader::TextShader() :
+    m_textureSizeUniform(-1),
+    m_distanceField(false),
+    m_threshold(DistanceFieldThreshold),
+    m_outlineThickness(0.f),
+    m_outlineColor(0, 0, 0)
+{ }
+
+bool TextShader::create(bool distanceField)
+{
+    m_distanceField = distanceField;
+
+    if (!m_shader.compileShader(VertexSource, VertexShader) ||
+        !m_shader.compileShader(distanceField ? DistanceFieldFragmentSource : BitmapFragmentSource, FragmentShader))
+        return false;
+
+    m_shader.linkProgram();
+
+    m_shader.addUniform("u_projection");
+    m_shader.addUniform("u_textureSize");
+    m_shader.addUniform("u_texture");
+    m_textureSizeUniform = static_cast<GLint>(m_shader.getUniform("u_textureSize"));
+
+    if (distanceField)
+    {
+        m_shader.addUniform("u_threshold");
+        m_shader.addUniform("u_outlineWidth");
+        m_shader.addUniform("u_outlineColor");
+    }
+
+    return true;
+}
+
+void TextShader::setThreshold(float threshold)
+{
+    m_threshold = threshold;
+}
+
+void TextShader::setOutline(float thickness, const Color& color)
+{
+    m_outlineThickness = thickness;
+    m_outlineColor = color;
+}
+
+void TextShader::bind(const mat4f& projection, const Texture& atlas)
+{
+    m_shader.bind();
+
+    mat4f matrix = projection;
+    glUniformMatrix4fv(m_shader.getUniform("u_projection"), 1, GL_FALSE, matrix.getPtr());
+    glUniform2f(m_shader.getUniform("u_textureSize"), static_cast<float>(atlas.size().x), static_cast<float>(atlas.size().y));
+    glUniform1i(m_shader.getUniform("u_texture"), 0);
+
+    if (m_distanceField)
+    {
+        // Pixels at the distance field size to alpha, the spread covers 127 steps
+        const float outlineWidth = m_outlineThickness * 127.f / (255.f * Font::DistanceFieldSpread);
+
+        glUniform1f(m_shader.getUniform("u_threshold"), m_threshold);
+        glUniform1f(m_shader.getUniform("u_outlineWidth"), outlineWidth);
+        glUniform4f(m_shader.getUniform("u_outlineColor"), m_outlineColor.r / 255.f, m_outlineColor.g / 255.f,
+                    m_outlineColor.b / 255.f, m_outlineColor.a / 255.f);
+    }
+}
+
+} // namespace nx
@@ -76,11 +76,7 @@ bool Texture::create(uint32 width, uint32 height)
 
     // Create the OpenGL texture if it doesn't exist yet
     if (!m_id)
-    {
-        GLuint texture;
         glGenTextures(1, &m_id);
-        m_id = static_cast<unsigned int>(texture);
-    }
 
     // Initialize the texture
     glBindTexture(GL_TEXTURE_2D, m_id);
@@ -91,6 +87,8 @@ bool Texture::create(uint32 width, uint32 height)
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_smooth ? GL_LINEAR : GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_smooth ? GL_LINEAR : GL_NEAREST);
+
+    return true;
 }
 
 bool Texture::loadFromFile(const std::string& file)
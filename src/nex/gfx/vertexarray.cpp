@@ -27,4 +27,10 @@ void VertexArray::destroy()
     }
 }
 
+void VertexArray::setAttribute(GLuint index, GLint components, GLsizei stride, std::size_t offset)
+{
+    glVertexAttribPointer(index, components, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid*>(offset));
+    glEnableVertexAttribArray(index);
+}
+
 } // namespace nx
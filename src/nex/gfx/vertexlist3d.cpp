@@ -1,4 +1,5 @@
 #include <nex/gfx/vertexlist3d.h>
+#include <nex/math/batchtransform.h>
 
 namespace nx
 {
@@ -11,4 +12,18 @@ VertexList3d::~VertexList3d()
     m_vertices.clear();
 }
 
+void VertexList3d::transform(const mat4f& matrix)
+{
+    if (m_vertices.empty())
+        return;
+
+    Vertex3d* vertices = &m_vertices[0];
+    const std::size_t count = m_vertices.size();
+
+    transformPositions(matrix, &vertices->position, sizeof(Vertex3d), &vertices->position, sizeof(Vertex3d), count);
+
+    const mat4f normalMatrix = mat4f::transpose(mat4f::affineInverse(matrix));
+    transformNormals(normalMatrix, &vertices->normal, sizeof(Vertex3d), &vertices->normal, sizeof(Vertex3d), count);
+}
+
 } // namespace nx
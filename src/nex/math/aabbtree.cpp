@@ -0,0 +1,441 @@
+#include <nex/math/aabbtree.h>
+
+// Standard includes.
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    using nx::AABB;
+    using nx::vec3f;
+
+    // Half the surface area, only ever compared against other areas.
+    float area(const AABB& box)
+    {
+        const vec3f size = box.max - box.min;
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    bool containsBox(const AABB& outer, const AABB& inner)
+    {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+               inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+    }
+
+    AABB fatten(const AABB& box, float margin, const vec3f& displacement)
+    {
+        AABB result(box.min - vec3f(margin), box.max + vec3f(margin));
+
+        // Stretch the bounds in the direction of motion.
+        result.min = vec3f::min(result.min, result.min + displacement);
+        result.max = vec3f::max(result.max, result.max + displacement);
+
+        return result;
+    }
+}
+
+namespace nx
+{
+
+AABBTree::AABBTree(float margin) :
+    mRoot(NullNode),
+    mFreeList(NullNode),
+    mProxyCount(0),
+    mMargin(margin)
+{ }
+
+int32 AABBTree::allocateNode()
+{
+    if (mFreeList == NullNode)
+    {
+        Node node;
+        node.userData = 0;
+        node.parent = NullNode;
+        node.child1 = NullNode;
+        node.child2 = NullNode;
+        node.height = 0;
+
+        mNodes.push_back(node);
+        return static_cast<int32>(mNodes.size() - 1);
+    }
+
+    const int32 index = mFreeList;
+    Node& node = mNodes[index];
+    mFreeList = node.parent;
+
+    node.userData = 0;
+    node.parent = NullNode;
+    node.child1 = NullNode;
+    node.child2 = NullNode;
+    node.height = 0;
+    return index;
+}
+
+void AABBTree::freeNode(int32 index)
+{
+    Node& node = mNodes[index];
+    node.parent = mFreeList;
+    node.height = -1;
+    mFreeList = index;
+}
+
+int32 AABBTree::insert(const AABB& box, void* userData)
+{
+    const int32 proxy = allocateNode();
+
+    mNodes[proxy].box = fatten(box, mMargin, vec3f());
+    mNodes[proxy].userData = userData;
+
+    insertLeaf(proxy);
+    ++mProxyCount;
+
+    return proxy;
+}
+
+void AABBTree::remove(int32 proxy)
+{
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --mProxyCount;
+}
+
+bool AABBTree::move(int32 proxy, const AABB& box, const vec3f& displacement)
+{
+    if (containsBox(mNodes[proxy].box, box))
+        return false;
+
+    removeLeaf(proxy);
+    mNodes[proxy].box = fatten(box, mMargin, displacement);
+    insertLeaf(proxy);
+
+    return true;
+}
+
+void AABBTree::clear()
+{
+    mNodes.clear();
+    mRoot = NullNode;
+    mFreeList = NullNode;
+    mProxyCount = 0;
+}
+
+void AABBTree::insertLeaf(int32 leaf)
+{
+    if (mRoot == NullNode)
+    {
+        mRoot = leaf;
+        mNodes[leaf].parent = NullNode;
+        return;
+    }
+
+    // Walk down to the sibling that increases the total surface area the least.
+    const AABB leafBox = mNodes[leaf].box;
+    int32 index = mRoot;
+
+    while (!mNodes[index].isLeaf())
+    {
+        const Node& node = mNodes[index];
+        const float nodeArea = area(node.box);
+        const float combinedArea = area(AABB::createMerged(node.box, leafBox));
+
+        // Cost of pairing the leaf with this node, and the cost pushed down to the children.
+        const float cost = 2.0f * combinedArea;
+        const float inheritanceCost = 2.0f * (combinedArea - nodeArea);
+
+        float childCost[2];
+        const int32 children[2] = { node.child1, node.child2 };
+        for (int i = 0; i < 2; ++i)
+        {
+            const Node& child = mNodes[children[i]];
+            const float mergedArea = area(AABB::createMerged(leafBox, child.box));
+            childCost[i] = (child.isLeaf() ? mergedArea : mergedArea - area(child.box)) + inheritanceCost;
+        }
+
+        if (cost < childCost[0] && cost < childCost[1])
+            break;
+
+        index = childCost[0] < childCost[1] ? children[0] : children[1];
+    }
+
+    const int32 sibling = index;
+    const int32 oldParent = mNodes[sibling].parent;
+    const int32 newParent = allocateNode();
+
+    Node& parent = mNodes[newParent];
+    parent.parent = oldParent;
+    parent.box = AABB::createMerged(leafBox, mNodes[sibling].box);
+    parent.height = mNodes[sibling].height + 1;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+
+    if (oldParent != NullNode)
+    {
+        if (mNodes[oldParent].child1 == sibling)
+            mNodes[oldParent].child1 = newParent;
+        else
+            mNodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        mRoot = newParent;
+    }
+
+    mNodes[sibling].parent = newParent;
+    mNodes[leaf].parent = newParent;
+
+    refit(mNodes[leaf].parent);
+}
+
+void AABBTree::removeLeaf(int32 leaf)
+{
+    if (leaf == mRoot)
+    {
+        mRoot = NullNode;
+        return;
+    }
+
+    const int32 parent = mNodes[leaf].parent;
+    const int32 grandParent = mNodes[parent].parent;
+    const int32 sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+    freeNode(parent);
+
+    if (grandParent == NullNode)
+    {
+        mRoot = sibling;
+        mNodes[sibling].parent = NullNode;
+        return;
+    }
+
+    if (mNodes[grandParent].child1 == parent)
+        mNodes[grandParent].child1 = sibling;
+    else
+        mNodes[grandParent].child2 = sibling;
+
+    mNodes[sibling].parent = grandParent;
+
+    refit(grandParent);
+}
+
+void AABBTree::refit(int32 index)
+{
+    // Rebalance and update the bounds and heights up to the root.
+    while (index != NullNode)
+    {
+        index = balance(index);
+
+        Node& node = mNodes[index];
+        const Node& child1 = mNodes[node.child1];
+        const Node& child2 = mNodes[node.child2];
+
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.box = AABB::createMerged(child1.box, child2.box);
+
+        index = node.parent;
+    }
+}
+
+int32 AABBTree::balance(int32 indexA)
+{
+    Node& a = mNodes[indexA];
+    if (a.isLeaf() || a.height < 2)
+        return indexA;
+
+    const int32 indexB = a.child1;
+    const int32 indexC = a.child2;
+    Node& b = mNodes[indexB];
+    Node& c = mNodes[indexC];
+
+    const int32 difference = c.height - b.height;
+
+    // Rotate C up.
+    if (difference > 1)
+    {
+        const int32 indexF = c.child1;
+        const int32 indexG = c.child2;
+        Node& f = mNodes[indexF];
+        Node& g = mNodes[indexG];
+
+        c.child1 = indexA;
+        c.parent = a.parent;
+        a.parent = indexC;
+
+        if (c.parent != NullNode)
+        {
+            if (mNodes[c.parent].child1 == indexA)
+                mNodes[c.parent].child1 = indexC;
+            else
+                mNodes[c.parent].child2 = indexC;
+        }
+        else
+        {
+            mRoot = indexC;
+        }
+
+        // Keep the taller grandchild under C.
+        if (f.height > g.height)
+        {
+            c.child2 = indexF;
+            a.child2 = indexG;
+            g.parent = indexA;
+            a.box = AABB::createMerged(b.box, g.box);
+            c.box = AABB::createMerged(a.box, f.box);
+
+            a.height = 1 + std::max(b.height, g.height);
+            c.height = 1 + std::max(a.height, f.height);
+        }
+        else
+        {
+            c.child2 = indexG;
+            a.child2 = indexF;
+            f.parent = indexA;
+            a.box = AABB::createMerged(b.box, f.box);
+            c.box = AABB::createMerged(a.box, g.box);
+
+            a.height = 1 + std::max(b.height, f.height);
+            c.height = 1 + std::max(a.height, g.height);
+        }
+
+        return indexC;
+    }
+
+    // Rotate B up.
+    if (difference < -1)
+    {
+        const int32 indexD = b.child1;
+        const int32 indexE = b.child2;
+        Node& d = mNodes[indexD];
+        Node& e = mNodes[indexE];
+
+        b.child1 = indexA;
+        b.parent = a.parent;
+        a.parent = indexB;
+
+        if (b.parent != NullNode)
+        {
+            if (mNodes[b.parent].child1 == indexA)
+                mNodes[b.parent].child1 = indexB;
+            else
+                mNodes[b.parent].child2 = indexB;
+        }
+        else
+        {
+            mRoot = indexB;
+        }
+
+        if (d.height > e.height)
+        {
+            b.child2 = indexD;
+            a.child1 = indexE;
+            e.parent = indexA;
+            a.box = AABB::createMerged(c.box, e.box);
+            b.box = AABB::createMerged(a.box, d.box);
+
+            a.height = 1 + std::max(c.height, e.height);
+            b.height = 1 + std::max(a.height, d.height);
+        }
+        else
+        {
+            b.child2 = indexE;
+            a.child1 = indexD;
+            d.parent = indexA;
+            a.box = AABB::createMerged(c.box, d.box);
+            b.box = AABB::createMerged(a.box, e.box);
+
+            a.height = 1 + std::max(c.height, d.height);
+            b.height = 1 + std::max(a.height, e.height);
+        }
+
+        return indexB;
+    }
+
+    return indexA;
+}
+
+void AABBTree::query(const AABB& box, std::vector<int32>& results) const
+{
+    if (mRoot == NullNode)
+        return;
+
+    std::vector<int32> stack;
+    stack.reserve(64);
+    stack.push_back(mRoot);
+
+    while (!stack.empty())
+    {
+        const Node& node = mNodes[stack.back()];
+        const int32 index = stack.back();
+        stack.pop_back();
+
+        if (!node.box.intersects(box))
+            continue;
+
+        if (node.isLeaf())
+        {
+            results.push_back(index);
+        }
+        else
+        {
+            stack.push_back(node.child2);
+            stack.push_back(node.child1);
+        }
+    }
+}
+
+void AABBTree::queryPairs(std::vector<AABBTreePair>& pairs) const
+{
+    if (mRoot == NullNode)
+        return;
+
+    // Descends the tree against itself: (n, n) stands for the pairs inside the
+    // subtree of n, (a, b) for the pairs between two disjoint subtrees. Every
+    // overlapping pair is reached exactly once.
+    std::vector<std::pair<int32, int32> > stack;
+    stack.reserve(64);
+    stack.push_back(std::make_pair(mRoot, mRoot));
+
+    while (!stack.empty())
+    {
+        const int32 indexA = stack.back().first;
+        const int32 indexB = stack.back().second;
+        stack.pop_back();
+
+        const Node& a = mNodes[indexA];
+
+        if (indexA == indexB)
+        {
+            if (a.isLeaf())
+                continue;
+
+            stack.push_back(std::make_pair(a.child1, a.child2));
+            stack.push_back(std::make_pair(a.child2, a.child2));
+            stack.push_back(std::make_pair(a.child1, a.child1));
+            continue;
+        }
+
+        const Node& b = mNodes[indexB];
+
+        if (!a.box.intersects(b.box))
+            continue;
+
+        if (a.isLeaf() && b.isLeaf())
+        {
+            AABBTreePair pair;
+            pair.proxyA = std::min(indexA, indexB);
+            pair.proxyB = std::max(indexA, indexB);
+            pairs.push_back(pair);
+        }
+        else if (b.isLeaf() || (!a.isLeaf() && area(a.box) >= area(b.box)))
+        {
+            stack.push_back(std::make_pair(a.child2, indexB));
+            stack.push_back(std::make_pair(a.child1, indexB));
+        }
+        else
+        {
+            stack.push_back(std::make_pair(indexA, b.child2));
+            stack.push_back(std::make_pair(indexA, b.child1));
+        }
+    }
+}
+
+} // namespace nx
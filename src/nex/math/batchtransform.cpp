@@ -0,0 +1,496 @@
+#include <nex/math/batchtransform.h>
+#include <nex/math/simd.h>
+#include <nex/math/simdlane.h>
+#include <nex/math/parallel.h>
+
+// Standard includes.
+#include <climits>
+
+namespace
+{
+    using nx::mat4f;
+    using nx::vec3f;
+    using nx::vec4f;
+
+    // Normals are positions transformed without the translation column.
+    mat4f removeTranslation(const mat4f& matrix)
+    {
+        mat4f result = matrix;
+        result[3][0] = 0.0f;
+        result[3][1] = 0.0f;
+        result[3][2] = 0.0f;
+        return result;
+    }
+
+#if defined(NEX_SIMD_SSE)
+    // Computes one row of column0 * x + column1 * y + column2 * z + column3 for 4 lanes.
+    inline __m128 transformRow4(const mat4f& matrix, int row, __m128 x, __m128 y, __m128 z)
+    {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(matrix[0][row]), x),
+                                     _mm_mul_ps(_mm_set1_ps(matrix[1][row]), y)),
+                          _mm_add_ps(_mm_mul_ps(_mm_set1_ps(matrix[2][row]), z),
+                                     _mm_set1_ps(matrix[3][row])));
+    }
+#endif
+
+#if defined(NEX_SIMD_AVX)
+    inline __m256 multiplyAdd(__m256 a, __m256 b, __m256 c)
+    {
+#if defined(NEX_SIMD_AVX2)
+        return _mm256_fmadd_ps(a, b, c);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+    }
+
+    // Computes column0 * x + column1 * y + column2 * z + column3 for 8 lanes.
+    inline void transform8(const mat4f& matrix, __m256 x, __m256 y, __m256 z, __m256& outX, __m256& outY, __m256& outZ)
+    {
+        outX = multiplyAdd(_mm256_set1_ps(matrix[0][0]), x,
+               multiplyAdd(_mm256_set1_ps(matrix[1][0]), y,
+               multiplyAdd(_mm256_set1_ps(matrix[2][0]), z, _mm256_set1_ps(matrix[3][0]))));
+        outY = multiplyAdd(_mm256_set1_ps(matrix[0][1]), x,
+               multiplyAdd(_mm256_set1_ps(matrix[1][1]), y,
+               multiplyAdd(_mm256_set1_ps(matrix[2][1]), z, _mm256_set1_ps(matrix[3][1]))));
+        outZ = multiplyAdd(_mm256_set1_ps(matrix[0][2]), x,
+               multiplyAdd(_mm256_set1_ps(matrix[1][2]), y,
+               multiplyAdd(_mm256_set1_ps(matrix[2][2]), z, _mm256_set1_ps(matrix[3][2]))));
+    }
+#endif
+
+    void transformPacked(const mat4f& matrix, const vec3f* input, vec3f* output, std::size_t begin, std::size_t end)
+    {
+        std::size_t index = begin;
+
+#if defined(NEX_SIMD_AVX)
+        // 8 packed vec3f are 24 floats, split them into x, y and z registers and back again.
+        for (; index + 8 <= end; index += 8)
+        {
+            const float* source = &input[index].x;
+
+            __m256 m03 = _mm256_castps128_ps256(_mm_loadu_ps(source + 0));
+            __m256 m14 = _mm256_castps128_ps256(_mm_loadu_ps(source + 4));
+            __m256 m25 = _mm256_castps128_ps256(_mm_loadu_ps(source + 8));
+            m03 = _mm256_insertf128_ps(m03, _mm_loadu_ps(source + 12), 1);
+            m14 = _mm256_insertf128_ps(m14, _mm_loadu_ps(source + 16), 1);
+            m25 = _mm256_insertf128_ps(m25, _mm_loadu_ps(source + 20), 1);
+
+            const __m256 xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+            const __m256 yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+            const __m256 x = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+            const __m256 y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+            const __m256 z = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+
+            __m256 outX, outY, outZ;
+            transform8(matrix, x, y, z, outX, outY, outZ);
+
+            const __m256 rxy = _mm256_shuffle_ps(outX, outY, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m256 ryz = _mm256_shuffle_ps(outY, outZ, _MM_SHUFFLE(3, 1, 3, 1));
+            const __m256 rzx = _mm256_shuffle_ps(outZ, outX, _MM_SHUFFLE(3, 1, 2, 0));
+            const __m256 r03 = _mm256_shuffle_ps(rxy, rzx, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m256 r14 = _mm256_shuffle_ps(ryz, rxy, _MM_SHUFFLE(3, 1, 2, 0));
+            const __m256 r25 = _mm256_shuffle_ps(rzx, ryz, _MM_SHUFFLE(3, 1, 3, 1));
+
+            float* destination = &output[index].x;
+            _mm_storeu_ps(destination + 0, _mm256_castps256_ps128(r03));
+            _mm_storeu_ps(destination + 4, _mm256_castps256_ps128(r14));
+            _mm_storeu_ps(destination + 8, _mm256_castps256_ps128(r25));
+            _mm_storeu_ps(destination + 12, _mm256_extractf128_ps(r03, 1));
+            _mm_storeu_ps(destination + 16, _mm256_extractf128_ps(r14, 1));
+            _mm_storeu_ps(destination + 20, _mm256_extractf128_ps(r25, 1));
+        }
+#elif defined(NEX_SIMD_SSE)
+        // 4 packed vec3f are 12 floats, the same shuffles as above on a single 128 bit lane.
+        for (; index + 4 <= end; index += 4)
+        {
+            const float* source = &input[index].x;
+
+            const __m128 m0 = _mm_loadu_ps(source + 0);
+            const __m128 m1 = _mm_loadu_ps(source + 4);
+            const __m128 m2 = _mm_loadu_ps(source + 8);
+
+            const __m128 xy = _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 1, 3, 2));
+            const __m128 yz = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 0, 2, 1));
+            const __m128 x = _mm_shuffle_ps(m0, xy, _MM_SHUFFLE(2, 0, 3, 0));
+            const __m128 y = _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+            const __m128 z = _mm_shuffle_ps(yz, m2, _MM_SHUFFLE(3, 0, 3, 1));
+
+            const __m128 outX = transformRow4(matrix, 0, x, y, z);
+            const __m128 outY = transformRow4(matrix, 1, x, y, z);
+            const __m128 outZ = transformRow4(matrix, 2, x, y, z);
+
+            const __m128 rxy = _mm_shuffle_ps(outX, outY, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 ryz = _mm_shuffle_ps(outY, outZ, _MM_SHUFFLE(3, 1, 3, 1));
+            const __m128 rzx = _mm_shuffle_ps(outZ, outX, _MM_SHUFFLE(3, 1, 2, 0));
+
+            float* destination = &output[index].x;
+            _mm_storeu_ps(destination + 0, _mm_shuffle_ps(rxy, rzx, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(destination + 4, _mm_shuffle_ps(ryz, rxy, _MM_SHUFFLE(3, 1, 2, 0)));
+            _mm_storeu_ps(destination + 8, _mm_shuffle_ps(rzx, ryz, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+#endif
+
+        for (; index < end; ++index)
+            output[index] = mat4f::transform(input[index], matrix);
+    }
+
+    void transformSoA(const mat4f& matrix,
+                      const float* inputX, const float* inputY, const float* inputZ,
+                      float* outputX, float* outputY, float* outputZ,
+                      std::size_t begin, std::size_t end)
+    {
+        std::size_t index = begin;
+
+#if defined(NEX_SIMD_AVX)
+        for (; index + 8 <= end; index += 8)
+        {
+            __m256 outX, outY, outZ;
+            transform8(matrix,
+                       _mm256_loadu_ps(inputX + index),
+                       _mm256_loadu_ps(inputY + index),
+                       _mm256_loadu_ps(inputZ + index),
+                       outX, outY, outZ);
+
+            _mm256_storeu_ps(outputX + index, outX);
+            _mm256_storeu_ps(outputY + index, outY);
+            _mm256_storeu_ps(outputZ + index, outZ);
+        }
+#elif defined(NEX_SIMD_SSE)
+        for (; index + 4 <= end; index += 4)
+        {
+            const __m128 x = _mm_loadu_ps(inputX + index);
+            const __m128 y = _mm_loadu_ps(inputY + index);
+            const __m128 z = _mm_loadu_ps(inputZ + index);
+
+            _mm_storeu_ps(outputX + index, transformRow4(matrix, 0, x, y, z));
+            _mm_storeu_ps(outputY + index, transformRow4(matrix, 1, x, y, z));
+            _mm_storeu_ps(outputZ + index, transformRow4(matrix, 2, x, y, z));
+        }
+#endif
+
+        for (; index < end; ++index)
+        {
+            const float x = inputX[index];
+            const float y = inputY[index];
+            const float z = inputZ[index];
+
+            outputX[index] = matrix[0][0] * x + matrix[1][0] * y + matrix[2][0] * z + matrix[3][0];
+            outputY[index] = matrix[0][1] * x + matrix[1][1] * y + matrix[2][1] * z + matrix[3][1];
+            outputZ[index] = matrix[0][2] * x + matrix[1][2] * y + matrix[2][2] * z + matrix[3][2];
+        }
+    }
+
+    void transformStrided(const mat4f& matrix,
+                          const uint8* input, std::size_t inputStride,
+                          uint8* output, std::size_t outputStride,
+                          std::size_t begin, std::size_t end)
+    {
+        std::size_t index = begin;
+
+#if defined(NEX_SIMD_AVX2)
+        // Gathers the x, y and z of 8 vertices, the offsets are 32 bit so huge strides stay scalar.
+        // There is no scatter store, the results go back one vertex at a time.
+        if (inputStride <= static_cast<std::size_t>(INT_MAX / 8))
+        {
+            const int stride = static_cast<int>(inputStride);
+            const __m256i offsets = _mm256_setr_epi32(0, stride, 2 * stride, 3 * stride,
+                                                      4 * stride, 5 * stride, 6 * stride, 7 * stride);
+
+            for (; index + 8 <= end; index += 8)
+            {
+                const float* source = reinterpret_cast<const float*>(input + index * inputStride);
+
+                __m256 outX, outY, outZ;
+                transform8(matrix,
+                           _mm256_i32gather_ps(source + 0, offsets, 1),
+                           _mm256_i32gather_ps(source + 1, offsets, 1),
+                           _mm256_i32gather_ps(source + 2, offsets, 1),
+                           outX, outY, outZ);
+
+                float results[3][8];
+                _mm256_storeu_ps(results[0], outX);
+                _mm256_storeu_ps(results[1], outY);
+                _mm256_storeu_ps(results[2], outZ);
+
+                for (int lane = 0; lane < 8; ++lane)
+                {
+                    float* destination = reinterpret_cast<float*>(output + (index + lane) * outputStride);
+                    destination[0] = results[0][lane];
+                    destination[1] = results[1][lane];
+                    destination[2] = results[2][lane];
+                }
+            }
+        }
+#endif
+
+        for (; index < end; ++index)
+        {
+            const vec3f& source = *reinterpret_cast<const vec3f*>(input + index * inputStride);
+            vec3f& destination = *reinterpret_cast<vec3f*>(output + index * outputStride);
+
+            destination = mat4f::transform(source, matrix);
+        }
+    }
+
+    void transformPacked4(const mat4f& matrix, const vec4f* input, vec4f* output, std::size_t begin, std::size_t end)
+    {
+        std::size_t index = begin;
+
+#if defined(NEX_SIMD_AVX)
+        const __m256 column0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix[0]));
+        const __m256 column1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix[1]));
+        const __m256 column2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix[2]));
+        const __m256 column3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix[3]));
+
+        // Two vectors per register, each 128 bit half broadcasts its own components.
+        for (; index + 2 <= end; index += 2)
+        {
+            const __m256 pair = _mm256_loadu_ps(&input[index].x);
+
+            __m256 sum = _mm256_mul_ps(column3, _mm256_shuffle_ps(pair, pair, 0xFF));
+            sum = multiplyAdd(column2, _mm256_shuffle_ps(pair, pair, 0xAA), sum);
+            sum = multiplyAdd(column1, _mm256_shuffle_ps(pair, pair, 0x55), sum);
+            sum = multiplyAdd(column0, _mm256_shuffle_ps(pair, pair, 0x00), sum);
+
+            _mm256_storeu_ps(&output[index].x, sum);
+        }
+#endif
+
+        for (; index < end; ++index)
+            output[index] = mat4f::transform(input[index], matrix);
+    }
+
+    // A box is 15 floats: the center, the three axes and the half extents.
+    const int BoxFields = 15;
+    static_assert(sizeof(nx::OBB) == BoxFields * sizeof(float), "OBB must be tightly packed floats");
+
+    // Transposes Lane::Width boxes into one register per field, so each lane transforms a whole box.
+    template <typename Lane>
+    std::size_t transformBoxKernel(const mat4f& matrix, const nx::OBB* input, nx::OBB* output, std::size_t index, std::size_t end)
+    {
+        typedef typename Lane::Type Type;
+
+        Type columns[4][3];
+        for (int column = 0; column < 4; ++column)
+        {
+            for (int row = 0; row < 3; ++row)
+                columns[column][row] = Lane::set(matrix[column][row]);
+        }
+
+        for (; index + Lane::Width <= end; index += Lane::Width)
+        {
+            float fields[BoxFields][Lane::Width];
+
+            const float* source = &input[index].center.x;
+            for (int box = 0; box < Lane::Width; ++box)
+            {
+                for (int field = 0; field < BoxFields; ++field)
+                    fields[field][box] = source[box * BoxFields + field];
+            }
+
+            Type values[BoxFields];
+            for (int field = 0; field < BoxFields; ++field)
+                values[field] = Lane::loadUnaligned(fields[field]);
+
+            // The center takes the translation, the axes only the upper 3x3 and are renormalized into the extents.
+            for (int vector = 0; vector < 4; ++vector)
+            {
+                const Type x = values[vector * 3 + 0];
+                const Type y = values[vector * 3 + 1];
+                const Type z = values[vector * 3 + 2];
+
+                Type result[3];
+                for (int row = 0; row < 3; ++row)
+                {
+                    result[row] = Lane::multiplyAdd(columns[0][row], x, Lane::multiplyAdd(columns[1][row], y, Lane::mul(columns[2][row], z)));
+                    if (vector == 0)
+                        result[row] = Lane::add(result[row], columns[3][row]);
+                }
+
+                if (vector > 0)
+                {
+                    const Type length = Lane::sqrt(Lane::multiplyAdd(result[0], result[0],
+                                                   Lane::multiplyAdd(result[1], result[1], Lane::mul(result[2], result[2]))));
+                    const Type inverse = Lane::div(Lane::set(1.0f), length);
+
+                    for (int row = 0; row < 3; ++row)
+                        result[row] = Lane::mul(result[row], inverse);
+
+                    values[12 + vector - 1] = Lane::mul(values[12 + vector - 1], length);
+                }
+
+                for (int row = 0; row < 3; ++row)
+                    values[vector * 3 + row] = result[row];
+            }
+
+            for (int field = 0; field < BoxFields; ++field)
+                Lane::storeUnaligned(fields[field], values[field]);
+
+            float* destination = &output[index].center.x;
+            for (int box = 0; box < Lane::Width; ++box)
+            {
+                for (int field = 0; field < BoxFields; ++field)
+                    destination[box * BoxFields + field] = fields[field][box];
+            }
+        }
+        return index;
+    }
+}
+
+namespace nx
+{
+
+namespace
+{
+    // The batch functions, jobs is 0 to stay on the calling thread.
+    void runPacked(JobSystem* jobs, const mat4f& matrix, const vec3f* input, vec3f* output, std::size_t count)
+    {
+        priv::parallelRange(jobs, count, BatchTransformParallelSize, [&](std::size_t begin, std::size_t end) {
+            transformPacked(matrix, input, output, begin, end);
+        });
+    }
+
+    void runPacked4(JobSystem* jobs, const mat4f& matrix, const vec4f* input, vec4f* output, std::size_t count)
+    {
+        priv::parallelRange(jobs, count, BatchTransformParallelSize, [&](std::size_t begin, std::size_t end) {
+            transformPacked4(matrix, input, output, begin, end);
+        });
+    }
+
+    void runSoA(JobSystem* jobs, const mat4f& matrix,
+                const float* inputX, const float* inputY, const float* inputZ,
+                float* outputX, float* outputY, float* outputZ,
+                std::size_t count)
+    {
+        priv::parallelRange(jobs, count, BatchTransformParallelSize, [&](std::size_t begin, std::size_t end) {
+            transformSoA(matrix, inputX, inputY, inputZ, outputX, outputY, outputZ, begin, end);
+        });
+    }
+
+    void runStrided(JobSystem* jobs, const mat4f& matrix,
+                    const void* input, std::size_t inputStride,
+                    void* output, std::size_t outputStride,
+                    std::size_t count)
+    {
+        const uint8* source = static_cast<const uint8*>(input);
+        uint8* destination = static_cast<uint8*>(output);
+
+        priv::parallelRange(jobs, count, BatchTransformParallelSize, [&](std::size_t begin, std::size_t end) {
+            transformStrided(matrix, source, inputStride, destination, outputStride, begin, end);
+        });
+    }
+
+    void runBoxes(JobSystem* jobs, const mat4f& matrix, const OBB* input, OBB* output, std::size_t count)
+    {
+        priv::parallelRange(jobs, count, BatchTransformParallelSize, [&](std::size_t begin, std::size_t end) {
+            const std::size_t index = transformBoxKernel<priv::WideLane>(matrix, input, output, begin, end);
+            transformBoxKernel<priv::ScalarLane>(matrix, input, output, index, end);
+        });
+    }
+}
+
+void transformPositions(const mat4f& matrix, const vec3f* input, vec3f* output, std::size_t count)
+{
+    runPacked(0, matrix, input, output, count);
+}
+
+void transformPositions(const mat4f& matrix, const vec3f* input, vec3f* output, std::size_t count, JobSystem& jobs)
+{
+    runPacked(&jobs, matrix, input, output, count);
+}
+
+void transformNormals(const mat4f& matrix, const vec3f* input, vec3f* output, std::size_t count)
+{
+    runPacked(0, removeTranslation(matrix), input, output, count);
+}
+
+void transformNormals(const mat4f& matrix, const vec3f* input, vec3f* output, std::size_t count, JobSystem& jobs)
+{
+    runPacked(&jobs, removeTranslation(matrix), input, output, count);
+}
+
+void transformVectors(const mat4f& matrix, const vec4f* input, vec4f* output, std::size_t count)
+{
+    runPacked4(0, matrix, input, output, count);
+}
+
+void transformVectors(const mat4f& matrix, const vec4f* input, vec4f* output, std::size_t count, JobSystem& jobs)
+{
+    runPacked4(&jobs, matrix, input, output, count);
+}
+
+void transformPositions(const mat4f& matrix,
+                        const float* inputX, const float* inputY, const float* inputZ,
+                        float* outputX, float* outputY, float* outputZ,
+                        std::size_t count)
+{
+    runSoA(0, matrix, inputX, inputY, inputZ, outputX, outputY, outputZ, count);
+}
+
+void transformPositions(const mat4f& matrix,
+                        const float* inputX, const float* inputY, const float* inputZ,
+                        float* outputX, float* outputY, float* outputZ,
+                        std::size_t count, JobSystem& jobs)
+{
+    runSoA(&jobs, matrix, inputX, inputY, inputZ, outputX, outputY, outputZ, count);
+}
+
+void transformNormals(const mat4f& matrix,
+                      const float* inputX, const float* inputY, const float* inputZ,
+                      float* outputX, float* outputY, float* outputZ,
+                      std::size_t count)
+{
+    runSoA(0, removeTranslation(matrix), inputX, inputY, inputZ, outputX, outputY, outputZ, count);
+}
+
+void transformNormals(const mat4f& matrix,
+                      const float* inputX, const float* inputY, const float* inputZ,
+                      float* outputX, float* outputY, float* outputZ,
+                      std::size_t count, JobSystem& jobs)
+{
+    runSoA(&jobs, removeTranslation(matrix), inputX, inputY, inputZ, outputX, outputY, outputZ, count);
+}
+
+void transformPositions(const mat4f& matrix,
+                        const void* input, std::size_t inputStride,
+                        void* output, std::size_t outputStride,
+                        std::size_t count)
+{
+    runStrided(0, matrix, input, inputStride, output, outputStride, count);
+}
+
+void transformPositions(const mat4f& matrix,
+                        const void* input, std::size_t inputStride,
+                        void* output, std::size_t outputStride,
+                        std::size_t count, JobSystem& jobs)
+{
+    runStrided(&jobs, matrix, input, inputStride, output, outputStride, count);
+}
+
+void transformNormals(const mat4f& matrix,
+                      const void* input, std::size_t inputStride,
+                      void* output, std::size_t outputStride,
+                      std::size_t count)
+{
+    runStrided(0, removeTranslation(matrix), input, inputStride, output, outputStride, count);
+}
+
+void transformNormals(const mat4f& matrix,
+                      const void* input, std::size_t inputStride,
+                      void* output, std::size_t outputStride,
+                      std::size_t count, JobSystem& jobs)
+{
+    runStrided(&jobs, removeTranslation(matrix), input, inputStride, output, outputStride, count);
+}
+
+void transformBoxes(const mat4f& matrix, const OBB* input, OBB* output, std::size_t count)
+{
+    runBoxes(0, matrix, input, output, count);
+}
+
+void transformBoxes(const mat4f& matrix, const OBB* input, OBB* output, std::size_t count, JobSystem& jobs)
+{
+    runBoxes(&jobs, matrix, input, output, count);
+}
+
+} // namespace nx
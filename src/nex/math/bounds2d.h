@@ -0,0 +1,94 @@
+#ifndef BOUNDS2D_H_INCLUDE
+#define BOUNDS2D_H_INCLUDE
+
+// Nex includes.
+#include <nex/math/vec2.h>
+#include <nex/math/rect.h>
+#include <nex/math/circle.h>
+
+// Standard includes.
+#include <algorithm>
+
+namespace nx
+{
+namespace priv
+{
+
+/**
+ * @brief A rectangle stored as its min and max corners, negative sizes already resolved.
+ */
+struct Bounds2d
+{
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+};
+
+/**
+ * @brief Converts a rectangle to min and max corners.
+ * @param rect = The rectangle, its width and height may be negative.
+ * @return the corners.
+ */
+inline Bounds2d toBounds(const rectf& rect)
+{
+    Bounds2d bounds;
+    bounds.minX = std::min(rect.x, rect.x + rect.width);
+    bounds.maxX = std::max(rect.x, rect.x + rect.width);
+    bounds.minY = std::min(rect.y, rect.y + rect.height);
+    bounds.maxY = std::max(rect.y, rect.y + rect.height);
+    return bounds;
+}
+
+/**
+ * @brief Overlap test with the same rules as Rect::intersects, touching edges do not count.
+ */
+struct RegionTest
+{
+    explicit RegionTest(const Bounds2d& region) : region(region) { }
+
+    bool operator()(float minX, float minY, float maxX, float maxY) const
+    {
+        return std::max(minX, region.minX) < std::min(maxX, region.maxX) &&
+               std::max(minY, region.minY) < std::min(maxY, region.maxY);
+    }
+
+    Bounds2d region;
+};
+
+/**
+ * @brief Point test with the same rules as Rect::contains, the max edges are excluded.
+ */
+struct PointTest
+{
+    explicit PointTest(const vec2f& point) : point(point) { }
+
+    bool operator()(float minX, float minY, float maxX, float maxY) const
+    {
+        return point.x >= minX && point.x < maxX && point.y >= minY && point.y < maxY;
+    }
+
+    vec2f point;
+};
+
+/**
+ * @brief Circle test with the same rules as Circle::intersects.
+ */
+struct CircleTest
+{
+    explicit CircleTest(const Circle& circle) : circle(circle) { }
+
+    bool operator()(float minX, float minY, float maxX, float maxY) const
+    {
+        const float distanceX = circle.center.x - std::min(std::max(circle.center.x, minX), maxX);
+        const float distanceY = circle.center.y - std::min(std::max(circle.center.y, minY), maxY);
+        return distanceX * distanceX + distanceY * distanceY < circle.radius * circle.radius;
+    }
+
+    Circle circle;
+};
+
+} // namespace priv
+} // namespace nx
+
+#endif // BOUNDS2D_H_INCLUDE
@@ -0,0 +1,529 @@
+#include <nex/math/bvh.h>
+#include <nex/math/frustum.h>
+#include <nex/math/sphere.h>
+#include <nex/math/parallel.h>
+#include <nex/system/memory.h>
+
+// Standard includes.
+#include <atomic>
+#include <cstring>
+#include <new>
+
+namespace
+{
+    using nx::BVHNode;
+    using nx::vec3f;
+
+    const int BinCount = 16;
+
+    // Past this depth the builder splits at the median, which halves the
+    // primitive count per level and bounds the depth by BVHMaxDepth.
+    const int MedianSplitDepth = 30;
+
+    struct Bounds
+    {
+        Bounds() :
+            min(std::numeric_limits<float>::max()),
+            max(-std::numeric_limits<float>::max())
+        { }
+
+        void grow(const vec3f& point)
+        {
+            min = vec3f::min(min, point);
+            max = vec3f::max(max, point);
+        }
+
+        void grow(const Bounds& bounds)
+        {
+            min = vec3f::min(min, bounds.min);
+            max = vec3f::max(max, bounds.max);
+        }
+
+        // Half the surface area, the factor cancels out of every SAH ratio.
+        float area() const
+        {
+            if (min.x > max.x)
+                return 0.0f;
+
+            const vec3f size = max - min;
+            return size.x * size.y + size.y * size.z + size.z * size.x;
+        }
+
+        vec3f min;
+        vec3f max;
+    };
+
+    struct Bin
+    {
+        Bin() : count(0) { }
+
+        Bounds bounds;
+        uint32 count;
+    };
+
+    float component(const vec3f& vector, int axis)
+    {
+        return axis == 0 ? vector.x : (axis == 1 ? vector.y : vector.z);
+    }
+
+    class Builder
+    {
+    public:
+
+        Builder(BVHNode* nodes, const std::vector<vec3f>& min, const std::vector<vec3f>& max,
+                uint32* indices, uint32 maxLeafSize, nx::JobSystem* jobs) :
+            mNodes(nodes),
+            mMin(min),
+            mMax(max),
+            mIndices(indices),
+            mMaxLeafSize(maxLeafSize),
+            mNodeCount(2),
+            mJobs(jobs),
+            mParallelDepth(0)
+        {
+            mCentroids.resize(min.size());
+            for (std::size_t i = 0; i < min.size(); ++i)
+                mCentroids[i] = (min[i] + max[i]) * 0.5f;
+
+            // Enough levels of jobs to cover the threads of the pool.
+            const std::size_t threads = jobs ? jobs->getThreadCount() : 1;
+            while ((static_cast<std::size_t>(1) << mParallelDepth) < threads)
+                ++mParallelDepth;
+        }
+
+        uint32 getNodeCount() const { return mNodeCount; }
+
+        void build(uint32 nodeIndex, uint32 begin, uint32 end, int depth)
+        {
+            BVHNode& node = mNodes[nodeIndex];
+
+            Bounds bounds;
+            Bounds centroidBounds;
+            for (uint32 i = begin; i < end; ++i)
+            {
+                const uint32 primitive = mIndices[i];
+                bounds.grow(mMin[primitive]);
+                bounds.grow(mMax[primitive]);
+                centroidBounds.grow(mCentroids[primitive]);
+            }
+
+            setBounds(node, bounds);
+
+            const uint32 count = end - begin;
+            const uint32 middle = count <= 1 ? end : partition(begin, end, depth, bounds, centroidBounds);
+
+            if (middle == end)
+            {
+                node.first = begin;
+                node.count = count;
+                return;
+            }
+
+            // Siblings are allocated together, the first pair starts at node 2 so
+            // every pair fills one cache line.
+            const uint32 left = mNodeCount.fetch_add(2);
+            node.first = left;
+            node.count = 0;
+
+            if (depth < mParallelDepth && count >= nx::BVHParallelBuildSize)
+            {
+                nx::priv::parallelInvoke(mJobs, [&]() { build(left, begin, middle, depth + 1); },
+                                         [&]() { build(left + 1, middle, end, depth + 1); });
+            }
+            else
+            {
+                build(left, begin, middle, depth + 1);
+                build(left + 1, middle, end, depth + 1);
+            }
+        }
+
+    private:
+
+        static void setBounds(BVHNode& node, const Bounds& bounds)
+        {
+            node.min[0] = bounds.min.x;
+            node.min[1] = bounds.min.y;
+            node.min[2] = bounds.min.z;
+            node.max[0] = bounds.max.x;
+            node.max[1] = bounds.max.y;
+            node.max[2] = bounds.max.z;
+        }
+
+        // Returns the split position, or end when a leaf is cheaper than any split.
+        uint32 partition(uint32 begin, uint32 end, int depth, const Bounds& bounds, const Bounds& centroidBounds)
+        {
+            const uint32 count = end - begin;
+
+            int bestAxis = -1;
+            int bestBin = 0;
+            float bestCost = std::numeric_limits<float>::max();
+
+            if (depth < MedianSplitDepth)
+            {
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    const float low = component(centroidBounds.min, axis);
+                    const float extent = component(centroidBounds.max, axis) - low;
+                    if (extent <= 0.0f)
+                        continue;
+
+                    Bin bins[BinCount];
+                    const float scale = BinCount / extent;
+
+                    for (uint32 i = begin; i < end; ++i)
+                    {
+                        const uint32 primitive = mIndices[i];
+                        Bin& bin = bins[binIndex(component(mCentroids[primitive], axis), low, scale)];
+                        bin.bounds.grow(mMin[primitive]);
+                        bin.bounds.grow(mMax[primitive]);
+                        ++bin.count;
+                    }
+
+                    // Sweep from the right to know the cost of every right side.
+                    float rightCost[BinCount];
+                    Bounds right;
+                    uint32 rightCount = 0;
+                    for (int bin = BinCount - 1; bin > 0; --bin)
+                    {
+                        right.grow(bins[bin].bounds);
+                        rightCount += bins[bin].count;
+                        rightCost[bin] = right.area() * rightCount;
+                    }
+
+                    Bounds left;
+                    uint32 leftCount = 0;
+                    for (int bin = 0; bin < BinCount - 1; ++bin)
+                    {
+                        left.grow(bins[bin].bounds);
+                        leftCount += bins[bin].count;
+
+                        const float cost = left.area() * leftCount + rightCost[bin + 1];
+                        if (leftCount > 0 && leftCount < count && cost < bestCost)
+                        {
+                            bestCost = cost;
+                            bestAxis = axis;
+                            bestBin = bin;
+                        }
+                    }
+                }
+            }
+
+            if (bestAxis >= 0)
+            {
+                // One traversal step plus the expected number of primitive tests.
+                const float area = bounds.area();
+                const float splitCost = 1.0f + (area > 0.0f ? bestCost / area : 0.0f);
+                if (count <= mMaxLeafSize && splitCost >= static_cast<float>(count))
+                    return end;
+
+                const float low = component(centroidBounds.min, bestAxis);
+                const float scale = BinCount / (component(centroidBounds.max, bestAxis) - low);
+
+                uint32* middle = std::partition(mIndices + begin, mIndices + end, [&](uint32 primitive) {
+                    return binIndex(component(mCentroids[primitive], bestAxis), low, scale) <= bestBin;
+                });
+
+                if (middle != mIndices + begin && middle != mIndices + end)
+                    return static_cast<uint32>(middle - mIndices);
+            }
+
+            if (count <= mMaxLeafSize)
+                return end;
+
+            // Coincident centroids or too deep, split the longest axis at the median.
+            const vec3f extent = centroidBounds.max - centroidBounds.min;
+            const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+            const uint32 middle = begin + count / 2;
+
+            std::nth_element(mIndices + begin, mIndices + middle, mIndices + end, [&](uint32 a, uint32 b) {
+                return component(mCentroids[a], axis) < component(mCentroids[b], axis);
+            });
+
+            return middle;
+        }
+
+        static int binIndex(float value, float low, float scale)
+        {
+            const int bin = static_cast<int>((value - low) * scale);
+            return bin < 0 ? 0 : (bin >= BinCount ? BinCount - 1 : bin);
+        }
+
+        BVHNode* mNodes;
+        const std::vector<vec3f>& mMin;
+        const std::vector<vec3f>& mMax;
+        std::vector<vec3f> mCentroids;
+        uint32* mIndices;
+        uint32 mMaxLeafSize;
+        std::atomic<uint32> mNodeCount;
+        nx::JobSystem* mJobs;
+        int mParallelDepth;
+    };
+
+    bool overlaps(const BVHNode& node, const vec3f& min, const vec3f& max)
+    {
+        return node.min[0] <= max.x && node.max[0] >= min.x &&
+               node.min[1] <= max.y && node.max[1] >= min.y &&
+               node.min[2] <= max.z && node.max[2] >= min.z;
+    }
+
+    bool overlaps(const vec3f& minA, const vec3f& maxA, const vec3f& minB, const vec3f& maxB)
+    {
+        return minA.x <= maxB.x && maxA.x >= minB.x &&
+               minA.y <= maxB.y && maxA.y >= minB.y &&
+               minA.z <= maxB.z && maxA.z >= minB.z;
+    }
+
+    float distanceSquared(const float* min, const float* max, const vec3f& point)
+    {
+        const float coordinates[3] = { point.x, point.y, point.z };
+
+        float result = 0.0f;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float clamped = std::min(std::max(coordinates[axis], min[axis]), max[axis]);
+            const float delta = coordinates[axis] - clamped;
+            result += delta * delta;
+        }
+        return result;
+    }
+}
+
+namespace nx
+{
+
+BVH::BVH() :
+    mNodes(0),
+    mNodeCount(0),
+    mNodeCapacity(0)
+{ }
+
+BVH::BVH(const BVH& other) :
+    mNodes(0),
+    mNodeCount(0),
+    mNodeCapacity(0)
+{
+    *this = other;
+}
+
+BVH& BVH::operator=(const BVH& other)
+{
+    if (this == &other)
+        return *this;
+
+    reserveNodes(other.mNodeCount);
+    if (other.mNodeCount > 0)
+        std::memcpy(mNodes, other.mNodes, other.mNodeCount * sizeof(BVHNode));
+
+    mNodeCount = other.mNodeCount;
+    mIndices = other.mIndices;
+    mMin = other.mMin;
+    mMax = other.mMax;
+
+    return *this;
+}
+
+BVH::~BVH()
+{
+    alignedFree(mNodes);
+}
+
+void BVH::reserveNodes(std::size_t capacity)
+{
+    if (capacity <= mNodeCapacity)
+        return;
+
+    BVHNode* nodes = static_cast<BVHNode*>(alignedMalloc(capacity * sizeof(BVHNode), CacheLineSize));
+    if (!nodes)
+        throw std::bad_alloc();
+
+    alignedFree(mNodes);
+    mNodes = nodes;
+    mNodeCapacity = capacity;
+}
+
+void BVH::build(const AABB* boxes, std::size_t count, uint32 maxLeafSize)
+{
+    buildTree(boxes, count, maxLeafSize, 0);
+}
+
+void BVH::build(const AABB* boxes, std::size_t count, uint32 maxLeafSize, JobSystem& jobs)
+{
+    buildTree(boxes, count, maxLeafSize, &jobs);
+}
+
+void BVH::build(const std::vector<AABB>& boxes, uint32 maxLeafSize)
+{
+    buildTree(boxes.empty() ? 0 : &boxes[0], boxes.size(), maxLeafSize, 0);
+}
+
+void BVH::build(const std::vector<AABB>& boxes, uint32 maxLeafSize, JobSystem& jobs)
+{
+    buildTree(boxes.empty() ? 0 : &boxes[0], boxes.size(), maxLeafSize, &jobs);
+}
+
+void BVH::buildTree(const AABB* boxes, std::size_t count, uint32 maxLeafSize, JobSystem* jobs)
+{
+    clear();
+
+    if (count == 0)
+        return;
+
+    mMin.resize(count);
+    mMax.resize(count);
+    mIndices.resize(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        mMin[i] = boxes[i].min;
+        mMax[i] = boxes[i].max;
+        mIndices[i] = static_cast<uint32>(i);
+    }
+
+    // A binary tree over n leaves has at most 2n - 1 nodes, plus the padding node 1.
+    reserveNodes(2 * count);
+    std::memset(mNodes, 0, 2 * sizeof(BVHNode));
+
+    Builder builder(mNodes, mMin, mMax, &mIndices[0], std::max<uint32>(1, maxLeafSize), jobs);
+    builder.build(0, 0, static_cast<uint32>(count), 0);
+
+    mNodeCount = builder.getNodeCount();
+}
+
+void BVH::clear()
+{
+    mNodeCount = 0;
+    mIndices.clear();
+    mMin.clear();
+    mMax.clear();
+}
+
+bool BVH::raycast(const Ray& ray, BVHHit& hit, float maxDistance) const
+{
+    const priv::BVHRay prepared(ray);
+
+    return raycast(ray, [&](uint32 index, float& distance) {
+        const float min[3] = { mMin[index].x, mMin[index].y, mMin[index].z };
+        const float max[3] = { mMax[index].x, mMax[index].y, mMax[index].z };
+        return prepared.intersects(min, max, std::numeric_limits<float>::max(), distance);
+    }, hit, maxDistance);
+}
+
+void BVH::query(const Frustum& frustum, std::vector<uint32>& results) const
+{
+    if (mNodeCount == 0)
+        return;
+
+    // The second member tells whether the node is already known to be inside.
+    std::pair<uint32, bool> stack[BVHMaxDepth];
+    std::size_t top = 0;
+    stack[top++] = std::make_pair(0u, false);
+
+    while (top > 0)
+    {
+        const std::pair<uint32, bool> current = stack[--top];
+        const BVHNode& node = mNodes[current.first];
+
+        bool inside = current.second;
+        if (!inside)
+        {
+            const ContainmentType containment = frustum.contains(AABB(vec3f(node.min[0], node.min[1], node.min[2]),
+                                                                      vec3f(node.max[0], node.max[1], node.max[2])));
+            if (containment == ContainmentType::Disjoint)
+                continue;
+
+            inside = containment == ContainmentType::Contains;
+        }
+
+        if (node.isLeaf())
+        {
+            for (uint32 i = node.first; i < node.first + node.count; ++i)
+            {
+                const uint32 primitive = mIndices[i];
+                if (inside || frustum.intersects(AABB(mMin[primitive], mMax[primitive])))
+                    results.push_back(primitive);
+            }
+            continue;
+        }
+
+        stack[top++] = std::make_pair(node.first + 1, inside);
+        stack[top++] = std::make_pair(node.first, inside);
+    }
+}
+
+void BVH::query(const Sphere& sphere, std::vector<uint32>& results) const
+{
+    if (mNodeCount == 0)
+        return;
+
+    const float radiusSquared = sphere.radius * sphere.radius;
+
+    uint32 stack[BVHMaxDepth];
+    std::size_t top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const BVHNode& node = mNodes[stack[--top]];
+
+        if (distanceSquared(node.min, node.max, sphere.center) > radiusSquared)
+            continue;
+
+        if (node.isLeaf())
+        {
+            for (uint32 i = node.first; i < node.first + node.count; ++i)
+            {
+                const uint32 primitive = mIndices[i];
+                const vec3f clamped = vec3f::clamp(sphere.center, mMin[primitive], mMax[primitive]);
+                if (vec3f::distanceSquared(sphere.center, clamped) <= radiusSquared)
+                    results.push_back(primitive);
+            }
+            continue;
+        }
+
+        stack[top++] = node.first + 1;
+        stack[top++] = node.first;
+    }
+}
+
+void BVH::query(const AABB& box, std::vector<uint32>& results) const
+{
+    if (mNodeCount == 0)
+        return;
+
+    uint32 stack[BVHMaxDepth];
+    std::size_t top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const BVHNode& node = mNodes[stack[--top]];
+
+        if (!overlaps(node, box.min, box.max))
+            continue;
+
+        if (node.isLeaf())
+        {
+            for (uint32 i = node.first; i < node.first + node.count; ++i)
+            {
+                const uint32 primitive = mIndices[i];
+                if (overlaps(mMin[primitive], mMax[primitive], box.min, box.max))
+                    results.push_back(primitive);
+            }
+            continue;
+        }
+
+        stack[top++] = node.first + 1;
+        stack[top++] = node.first;
+    }
+}
+
+AABB BVH::getBounds() const
+{
+    if (mNodeCount == 0)
+        return AABB();
+
+    return AABB(vec3f(mNodes[0].min[0], mNodes[0].min[1], mNodes[0].min[2]),
+                vec3f(mNodes[0].max[0], mNodes[0].max[1], mNodes[0].max[2]));
+}
+
+} // namespace nx
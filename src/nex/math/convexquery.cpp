@@ -0,0 +1,801 @@
+#include <nex/math/convexquery.h>
+
+// Standard includes.
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    using nx::vec3f;
+    using nx::ConvexCache;
+    using nx::ConvexResult;
+    using nx::priv::SupportFunction;
+
+    // GJK stops when a new support point brings the squared distance closer by less than this fraction.
+    const float GJKTolerance = 1e-6f;
+
+    // Squared distances below this fraction of the simplex size count as touching the origin.
+    const float GJKTouchTolerance = 1e-10f;
+
+    // Tetrahedra whose height is below this fraction of their size are treated as flat.
+    const float GJKFlatTolerance = 1e-4f;
+
+    // EPA stops when the polytope grows by less than this fraction of the depth.
+    const float EPATolerance = 1e-4f;
+
+    // Curved shapes need many polytope vertices before EPA settles on a deep penetration.
+    const int EPAMaxIterations = 128;
+    const int EPAMaxVertices = EPAMaxIterations + 4;
+
+    // A closed polytope with V vertices has 2V - 4 faces, the horizon needs at most one edge per face side.
+    const int EPAMaxFaces = 2 * EPAMaxVertices;
+    const int EPAMaxEdges = 3 * EPAMaxFaces;
+
+    // A vertex of the Minkowski difference A - B and the points and direction that produced it.
+    struct Vertex
+    {
+        vec3f a;
+        vec3f b;
+        vec3f w;
+        vec3f direction;
+    };
+
+    struct Simplex
+    {
+        Vertex vertices[4];
+        float lambda[4];
+        int count;
+    };
+
+    // Closest point of a sub-simplex to the origin, as weights of the vertices it kept.
+    struct Closest
+    {
+        vec3f point;
+        int index[4];
+        float lambda[4];
+        int count;
+    };
+
+    Vertex support(const SupportFunction& shapeA, const SupportFunction& shapeB, const vec3f& direction)
+    {
+        Vertex vertex;
+        vertex.direction = direction;
+        vertex.a = shapeA(direction);
+        vertex.b = shapeB(-direction);
+        vertex.w = vertex.a - vertex.b;
+        return vertex;
+    }
+
+    Closest closestVertex(const Vertex* vertices, int i0)
+    {
+        Closest closest;
+        closest.point = vertices[i0].w;
+        closest.index[0] = i0;
+        closest.lambda[0] = 1.0f;
+        closest.count = 1;
+        return closest;
+    }
+
+    Closest closestSegment(const Vertex* vertices, int i0, int i1)
+    {
+        const vec3f& a = vertices[i0].w;
+        const vec3f& b = vertices[i1].w;
+        const vec3f ab = b - a;
+
+        const float lengthSquared = ab.lengthSquared();
+        const float t = lengthSquared > 0.0f ? -vec3f::dot(a, ab) / lengthSquared : 0.0f;
+
+        if (t <= 0.0f)
+            return closestVertex(vertices, i0);
+        if (t >= 1.0f)
+            return closestVertex(vertices, i1);
+
+        Closest closest;
+        closest.point = a + ab * t;
+        closest.index[0] = i0;
+        closest.index[1] = i1;
+        closest.lambda[0] = 1.0f - t;
+        closest.lambda[1] = t;
+        closest.count = 2;
+        return closest;
+    }
+
+    Closest closestTriangle(const Vertex* vertices, int i0, int i1, int i2)
+    {
+        // Voronoi regions of the triangle, Ericson's Real-Time Collision Detection 5.1.5.
+        const vec3f& a = vertices[i0].w;
+        const vec3f& b = vertices[i1].w;
+        const vec3f& c = vertices[i2].w;
+        const vec3f ab = b - a;
+        const vec3f ac = c - a;
+
+        const float d1 = -vec3f::dot(ab, a);
+        const float d2 = -vec3f::dot(ac, a);
+        if (d1 <= 0.0f && d2 <= 0.0f)
+            return closestVertex(vertices, i0);
+
+        const float d3 = -vec3f::dot(ab, b);
+        const float d4 = -vec3f::dot(ac, b);
+        if (d3 >= 0.0f && d4 <= d3)
+            return closestVertex(vertices, i1);
+
+        const float d5 = -vec3f::dot(ab, c);
+        const float d6 = -vec3f::dot(ac, c);
+        if (d6 >= 0.0f && d5 <= d6)
+            return closestVertex(vertices, i2);
+
+        const float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+            return closestSegment(vertices, i0, i1);
+
+        const float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+            return closestSegment(vertices, i0, i2);
+
+        const float va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+            return closestSegment(vertices, i1, i2);
+
+        const float sum = va + vb + vc;
+        if (!(sum > 0.0f))
+        {
+            // Degenerate triangle, the answer lies on one of its edges.
+            Closest best = closestSegment(vertices, i0, i1);
+            const Closest edges[2] = { closestSegment(vertices, i0, i2), closestSegment(vertices, i1, i2) };
+            for (int i = 0; i < 2; ++i)
+            {
+                if (edges[i].point.lengthSquared() < best.point.lengthSquared())
+                    best = edges[i];
+            }
+            return best;
+        }
+
+        const float v = vb / sum;
+        const float w = vc / sum;
+
+        Closest closest;
+        closest.point = a + ab * v + ac * w;
+        closest.index[0] = i0;
+        closest.index[1] = i1;
+        closest.index[2] = i2;
+        closest.lambda[0] = 1.0f - v - w;
+        closest.lambda[1] = v;
+        closest.lambda[2] = w;
+        closest.count = 3;
+        return closest;
+    }
+
+    // Whether the origin and the opposite vertex lie on different sides of a face. Nearly
+    // flat tetrahedra give noisy signs, every face then counts as outside.
+    bool outsideFace(const vec3f& a, const vec3f& b, const vec3f& c, const vec3f& opposite)
+    {
+        const vec3f normal = vec3f::cross(b - a, c - a);
+        const float signOrigin = -vec3f::dot(a, normal);
+        const float signOpposite = vec3f::dot(opposite - a, normal);
+
+        const float flatness = GJKFlatTolerance * GJKFlatTolerance * normal.lengthSquared() * (opposite - a).lengthSquared();
+        return signOrigin * signOpposite < 0.0f || signOpposite * signOpposite <= flatness;
+    }
+
+    Closest closestTetrahedron(const Vertex* vertices)
+    {
+        static const int Faces[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+
+        Closest best;
+        best.count = 0;
+        float bestDistance = 0.0f;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            const int* face = Faces[i];
+            if (!outsideFace(vertices[face[0]].w, vertices[face[1]].w, vertices[face[2]].w, vertices[face[3]].w))
+                continue;
+
+            const Closest closest = closestTriangle(vertices, face[0], face[1], face[2]);
+            const float distance = closest.point.lengthSquared();
+            if (best.count == 0 || distance < bestDistance)
+            {
+                best = closest;
+                bestDistance = distance;
+            }
+        }
+
+        if (best.count != 0)
+            return best;
+
+        // The origin is inside.
+        best.point = vec3f(0.0f);
+        best.count = 4;
+        for (int i = 0; i < 4; ++i)
+        {
+            best.index[i] = i;
+            best.lambda[i] = 0.25f;
+        }
+        return best;
+    }
+
+    // Replaces the simplex by the vertices that support its closest point and returns that point.
+    vec3f reduce(Simplex& simplex)
+    {
+        Closest closest;
+        switch (simplex.count)
+        {
+            case 1: closest = closestVertex(simplex.vertices, 0); break;
+            case 2: closest = closestSegment(simplex.vertices, 0, 1); break;
+            case 3: closest = closestTriangle(simplex.vertices, 0, 1, 2); break;
+            default: closest = closestTetrahedron(simplex.vertices); break;
+        }
+
+        Vertex kept[4];
+        for (int i = 0; i < closest.count; ++i)
+            kept[i] = simplex.vertices[closest.index[i]];
+
+        for (int i = 0; i < closest.count; ++i)
+        {
+            simplex.vertices[i] = kept[i];
+            simplex.lambda[i] = closest.lambda[i];
+        }
+        simplex.count = closest.count;
+
+        return closest.point;
+    }
+
+    float simplexSize(const Simplex& simplex)
+    {
+        float size = 0.0f;
+        for (int i = 0; i < simplex.count; ++i)
+            size = std::max(size, simplex.vertices[i].w.lengthSquared());
+        return size;
+    }
+
+    bool containsPoint(const Simplex& simplex, const vec3f& point)
+    {
+        for (int i = 0; i < simplex.count; ++i)
+        {
+            if ((simplex.vertices[i].w - point).lengthSquared() <= GJKTouchTolerance * std::max(1.0f, point.lengthSquared()))
+                return true;
+        }
+        return false;
+    }
+
+    void storeCache(const Simplex& simplex, ConvexCache* cache)
+    {
+        if (cache == 0)
+            return;
+
+        cache->count = simplex.count;
+        for (int i = 0; i < simplex.count; ++i)
+            cache->directions[i] = simplex.vertices[i].direction;
+    }
+
+    /**
+     * Runs GJK until the closest point of A - B to the origin is found or the
+     * origin is enclosed. With earlyOut, stops at the first direction that
+     * separates the shapes, the closest point is then not exact.
+     * Returns true if the shapes overlap.
+     */
+    bool gjk(const SupportFunction& shapeA, const SupportFunction& shapeB, ConvexCache* cache, bool earlyOut,
+             Simplex& simplex, vec3f& closest, int& iterations)
+    {
+        simplex.count = 0;
+
+        if (cache != 0 && cache->count > 0)
+        {
+            // Rebuild the previous simplex from the moved shapes.
+            for (int i = 0; i < cache->count && i < 4; ++i)
+            {
+                const Vertex vertex = support(shapeA, shapeB, cache->directions[i]);
+                if (!containsPoint(simplex, vertex.w))
+                    simplex.vertices[simplex.count++] = vertex;
+            }
+        }
+        else
+        {
+            simplex.vertices[simplex.count++] = support(shapeA, shapeB, vec3f(1.0f, 0.0f, 0.0f));
+        }
+
+        closest = reduce(simplex);
+        float distanceSquared = closest.lengthSquared();
+
+        iterations = 0;
+        bool intersecting = false;
+
+        while (iterations < nx::ConvexQueryMaxIterations)
+        {
+            if (simplex.count == 4 || distanceSquared <= GJKTouchTolerance * simplexSize(simplex))
+            {
+                intersecting = true;
+                break;
+            }
+
+            ++iterations;
+
+            const Vertex vertex = support(shapeA, shapeB, -closest);
+            const float progress = vec3f::dot(closest, vertex.w);
+
+            if (earlyOut && progress > 0.0f)
+                break;
+
+            // No support point gets meaningfully closer, closest is the answer.
+            if (distanceSquared - progress <= GJKTolerance * distanceSquared || containsPoint(simplex, vertex.w))
+                break;
+
+            const Simplex previous = simplex;
+            simplex.vertices[simplex.count++] = vertex;
+
+            const vec3f next = reduce(simplex);
+            const float nextDistanceSquared = next.lengthSquared();
+
+            // Rounding in a nearly flat simplex can move away from the origin,
+            // the previous simplex is then as close as GJK gets.
+            if (nextDistanceSquared >= distanceSquared)
+            {
+                simplex = previous;
+                break;
+            }
+
+            closest = next;
+            distanceSquared = nextDistanceSquared;
+        }
+
+        if (!intersecting && simplex.count == 4)
+            intersecting = true;
+
+        storeCache(simplex, cache);
+        return intersecting;
+    }
+
+    struct Face
+    {
+        int index[3];
+        vec3f normal;
+        float distance;
+    };
+
+    struct Polytope
+    {
+        Vertex vertices[EPAMaxVertices];
+        int vertexCount;
+
+        Face faces[EPAMaxFaces];
+        int faceCount;
+    };
+
+    // Fills a face with outward normal (i1 - i0) x (i2 - i0), fails when the three vertices are collinear.
+    bool makeFace(const Polytope& polytope, int i0, int i1, int i2, Face& face)
+    {
+        const vec3f& a = polytope.vertices[i0].w;
+        vec3f normal = vec3f::cross(polytope.vertices[i1].w - a, polytope.vertices[i2].w - a);
+
+        const float length = normal.length();
+        if (!(length > 0.0f))
+            return false;
+
+        normal = normal / length;
+
+        face.index[0] = i0;
+        face.index[1] = i1;
+        face.index[2] = i2;
+        face.normal = normal;
+        face.distance = vec3f::dot(normal, a);
+        return true;
+    }
+
+    bool addFace(Polytope& polytope, int i0, int i1, int i2)
+    {
+        if (polytope.faceCount == EPAMaxFaces || !makeFace(polytope, i0, i1, i2, polytope.faces[polytope.faceCount]))
+            return false;
+
+        ++polytope.faceCount;
+        return true;
+    }
+
+    // Whether two faces wound the same way meet along an edge, which they then walk in opposite directions.
+    bool shareEdge(const Face& a, const Face& b)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                if (a.index[i] == b.index[(j + 1) % 3] && a.index[(i + 1) % 3] == b.index[j])
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    // The face holding the directed edge from -> to, -1 if there is none.
+    int findFace(const Polytope& polytope, int from, int to)
+    {
+        for (int i = 0; i < polytope.faceCount; ++i)
+        {
+            const int* index = polytope.faces[i].index;
+            for (int side = 0; side < 3; ++side)
+            {
+                if (index[side] == from && index[(side + 1) % 3] == to)
+                    return i;
+            }
+        }
+
+        return -1;
+    }
+
+    // Whether the edges chain into one closed loop, the border of a hole the new faces can close.
+    bool isLoop(const int (*edges)[2], int edgeCount)
+    {
+        if (edgeCount < 3)
+            return false;
+
+        int current = 0;
+        int length = 0;
+
+        do
+        {
+            int next = -1;
+            for (int e = 0; e < edgeCount && next < 0; ++e)
+            {
+                if (edges[e][0] == edges[current][1])
+                    next = e;
+            }
+
+            current = next;
+            ++length;
+        }
+        while (current > 0 && length < edgeCount);
+
+        return current == 0 && length == edgeCount;
+    }
+
+    // Grows a simplex that touches the origin into a tetrahedron, fails for flat shapes.
+    bool blowUp(const SupportFunction& shapeA, const SupportFunction& shapeB, Simplex& simplex)
+    {
+        const float tolerance = 1e-6f * std::max(1.0f, simplexSize(simplex));
+
+        static const vec3f Axes[6] = { vec3f(1.0f, 0.0f, 0.0f), vec3f(-1.0f, 0.0f, 0.0f),
+                                       vec3f(0.0f, 1.0f, 0.0f), vec3f(0.0f, -1.0f, 0.0f),
+                                       vec3f(0.0f, 0.0f, 1.0f), vec3f(0.0f, 0.0f, -1.0f) };
+
+        if (simplex.count == 1)
+        {
+            for (int i = 0; i < 6 && simplex.count == 1; ++i)
+            {
+                const Vertex vertex = support(shapeA, shapeB, Axes[i]);
+                if ((vertex.w - simplex.vertices[0].w).lengthSquared() > tolerance)
+                    simplex.vertices[simplex.count++] = vertex;
+            }
+        }
+
+        if (simplex.count == 2)
+        {
+            const vec3f line = vec3f::normalize(simplex.vertices[1].w - simplex.vertices[0].w);
+
+            // Start from the axis least aligned with the line.
+            const vec3f axis = std::fabs(line.x) < std::fabs(line.y) ?
+                               (std::fabs(line.x) < std::fabs(line.z) ? Axes[0] : Axes[4]) :
+                               (std::fabs(line.y) < std::fabs(line.z) ? Axes[2] : Axes[4]);
+            const vec3f first = vec3f::normalize(vec3f::cross(line, axis));
+            const vec3f second = vec3f::cross(line, first);
+
+            for (int i = 0; i < 6 && simplex.count == 2; ++i)
+            {
+                const float angle = static_cast<float>(i) * (3.14159265f / 3.0f);
+                const Vertex vertex = support(shapeA, shapeB, first * std::cos(angle) + second * std::sin(angle));
+                if (vec3f::cross(line, vertex.w - simplex.vertices[0].w).lengthSquared() > tolerance)
+                    simplex.vertices[simplex.count++] = vertex;
+            }
+        }
+
+        if (simplex.count == 3)
+        {
+            const vec3f normal = vec3f::cross(simplex.vertices[1].w - simplex.vertices[0].w, simplex.vertices[2].w - simplex.vertices[0].w);
+
+            for (int i = 0; i < 2 && simplex.count == 3; ++i)
+            {
+                const Vertex vertex = support(shapeA, shapeB, i == 0 ? normal : -normal);
+                const float height = vec3f::dot(normal, vertex.w - simplex.vertices[0].w);
+                if (height * height > tolerance * normal.lengthSquared())
+                    simplex.vertices[simplex.count++] = vertex;
+            }
+        }
+
+        return simplex.count == 4;
+    }
+
+    // Expands the polytope towards the boundary of A - B closest to the origin.
+    bool epa(const SupportFunction& shapeA, const SupportFunction& shapeB, const Simplex& simplex, ConvexResult& result)
+    {
+        Polytope polytope;
+        polytope.vertexCount = 4;
+        polytope.faceCount = 0;
+
+        for (int i = 0; i < 4; ++i)
+            polytope.vertices[i] = simplex.vertices[i];
+
+        // Wind the faces so their normals point away from the tetrahedron.
+        const vec3f* w[4] = { &polytope.vertices[0].w, &polytope.vertices[1].w, &polytope.vertices[2].w, &polytope.vertices[3].w };
+        if (vec3f::dot(vec3f::cross(*w[1] - *w[0], *w[2] - *w[0]), *w[3] - *w[0]) > 0.0f)
+            std::swap(polytope.vertices[1], polytope.vertices[2]);
+
+        if (!addFace(polytope, 0, 1, 2) || !addFace(polytope, 0, 3, 1) ||
+            !addFace(polytope, 0, 2, 3) || !addFace(polytope, 1, 3, 2))
+            return false;
+
+        int closestFace = 0;
+
+        for (int iteration = 0; iteration < EPAMaxIterations; ++iteration)
+        {
+            closestFace = 0;
+            for (int i = 1; i < polytope.faceCount; ++i)
+            {
+                if (polytope.faces[i].distance < polytope.faces[closestFace].distance)
+                    closestFace = i;
+            }
+
+            const Face& face = polytope.faces[closestFace];
+            const Vertex vertex = support(shapeA, shapeB, face.normal);
+            const float distance = vec3f::dot(vertex.w, face.normal);
+
+            if (distance - face.distance <= EPATolerance * std::max(1.0f, distance) ||
+                polytope.vertexCount == EPAMaxVertices)
+                break;
+
+            const int newIndex = polytope.vertexCount;
+            polytope.vertices[newIndex] = vertex;
+
+            // Remove the faces the new vertex sees, grown from the closest face across shared edges. A
+            // face coplanar with the new vertex can look visible through rounding alone, and removing it
+            // away from the others would cut a second hole.
+            bool removed[EPAMaxFaces] = { };
+            removed[closestFace] = true;
+            int visibleCount = 1;
+
+            for (bool grown = true; grown; )
+            {
+                grown = false;
+
+                for (int i = 0; i < polytope.faceCount; ++i)
+                {
+                    const Face& seen = polytope.faces[i];
+                    if (removed[i] || vec3f::dot(seen.normal, vertex.w - polytope.vertices[seen.index[0]].w) <= 0.0f)
+                        continue;
+
+                    for (int j = 0; j < polytope.faceCount; ++j)
+                    {
+                        if (removed[j] && shareEdge(seen, polytope.faces[j]))
+                        {
+                            removed[i] = true;
+                            ++visibleCount;
+                            grown = true;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            // Build the faces that close the hole before touching the polytope. A new vertex on the line
+            // of a horizon edge lies in the plane of the face beyond it, that face is removed as well and
+            // the hole rebuilt. A dropped edge, a border that is not one loop or too many faces would
+            // leave the polytope open, then the current closed polytope is the best answer.
+            int edges[EPAMaxEdges][2];
+            Face created[EPAMaxEdges];
+            int edgeCount = 0;
+            bool closed = false;
+
+            for (int attempt = 0; attempt < polytope.faceCount; ++attempt)
+            {
+                edgeCount = 0;
+                bool complete = true;
+
+                for (int i = 0; i < polytope.faceCount; ++i)
+                {
+                    if (!removed[i])
+                        continue;
+
+                    for (int side = 0; side < 3; ++side)
+                    {
+                        const int from = polytope.faces[i].index[side];
+                        const int to = polytope.faces[i].index[(side + 1) % 3];
+
+                        // An edge seen in both directions lies between two removed faces.
+                        bool shared = false;
+                        for (int e = 0; e < edgeCount; ++e)
+                        {
+                            if (edges[e][0] == to && edges[e][1] == from)
+                            {
+                                edges[e][0] = edges[edgeCount - 1][0];
+                                edges[e][1] = edges[edgeCount - 1][1];
+                                --edgeCount;
+                                shared = true;
+                                break;
+                            }
+                        }
+
+                        if (shared)
+                            continue;
+
+                        if (edgeCount == EPAMaxEdges)
+                            complete = false;
+                        else
+                        {
+                            edges[edgeCount][0] = from;
+                            edges[edgeCount][1] = to;
+                            ++edgeCount;
+                        }
+                    }
+                }
+
+                if (!complete || !isLoop(edges, edgeCount) || polytope.faceCount - visibleCount + edgeCount > EPAMaxFaces)
+                    break;
+
+                int flat = -1;
+                for (int e = 0; e < edgeCount && flat < 0; ++e)
+                {
+                    if (!makeFace(polytope, edges[e][0], edges[e][1], newIndex, created[e]))
+                        flat = e;
+                }
+
+                if (flat < 0)
+                {
+                    closed = true;
+                    break;
+                }
+
+                const int beyond = findFace(polytope, edges[flat][1], edges[flat][0]);
+                if (beyond < 0 || removed[beyond])
+                    break;
+
+                removed[beyond] = true;
+                ++visibleCount;
+            }
+
+            if (!closed)
+                break;
+
+            // Going down, the face moved into a removed slot is always one that stays.
+            for (int i = polytope.faceCount - 1; i >= 0; --i)
+            {
+                if (removed[i])
+                    polytope.faces[i] = polytope.faces[--polytope.faceCount];
+            }
+
+            for (int e = 0; e < edgeCount; ++e)
+                polytope.faces[polytope.faceCount++] = created[e];
+
+            ++polytope.vertexCount;
+        }
+
+        closestFace = 0;
+        for (int i = 1; i < polytope.faceCount; ++i)
+        {
+            if (polytope.faces[i].distance < polytope.faces[closestFace].distance)
+                closestFace = i;
+        }
+
+        const Face& face = polytope.faces[closestFace];
+        const Vertex& a = polytope.vertices[face.index[0]];
+        const Vertex& b = polytope.vertices[face.index[1]];
+        const Vertex& c = polytope.vertices[face.index[2]];
+
+        // Barycentric coordinates of the origin projected on the face.
+        const vec3f point = face.normal * face.distance;
+        const vec3f v0 = b.w - a.w;
+        const vec3f v1 = c.w - a.w;
+        const vec3f v2 = point - a.w;
+
+        const float d00 = vec3f::dot(v0, v0);
+        const float d01 = vec3f::dot(v0, v1);
+        const float d11 = vec3f::dot(v1, v1);
+        const float d20 = vec3f::dot(v2, v0);
+        const float d21 = vec3f::dot(v2, v1);
+        const float denominator = d00 * d11 - d01 * d01;
+
+        float u = 1.0f / 3.0f;
+        float v = 1.0f / 3.0f;
+        if (denominator > 0.0f)
+        {
+            u = (d11 * d20 - d01 * d21) / denominator;
+            v = (d00 * d21 - d01 * d20) / denominator;
+        }
+
+        result.depth = std::max(0.0f, face.distance);
+        result.normal = face.normal;
+        result.pointA = a.a * (1.0f - u - v) + b.a * u + c.a * v;
+        result.pointB = a.b * (1.0f - u - v) + b.b * u + c.b * v;
+        return true;
+    }
+}
+
+namespace nx
+{
+
+vec3f SphereSupport::support(const vec3f& direction) const
+{
+    const float length = direction.length();
+    if (!(length > 0.0f))
+        return center;
+
+    return center + direction * (radius / length);
+}
+
+vec3f CapsuleSupport::support(const vec3f& direction) const
+{
+    const vec3f& point = vec3f::dot(direction, end - start) > 0.0f ? end : start;
+
+    const float length = direction.length();
+    if (!(length > 0.0f))
+        return point;
+
+    return point + direction * (radius / length);
+}
+
+vec3f HullSupport::support(const vec3f& direction) const
+{
+    std::size_t best = 0;
+    float bestDot = vec3f::dot(points[0], direction);
+
+    for (std::size_t i = 1; i < count; ++i)
+    {
+        const float dot = vec3f::dot(points[i], direction);
+        if (dot > bestDot)
+        {
+            best = i;
+            bestDot = dot;
+        }
+    }
+
+    return points[best];
+}
+
+namespace priv
+{
+
+bool gjkIntersects(const SupportFunction& shapeA, const SupportFunction& shapeB, ConvexCache* cache)
+{
+    Simplex simplex;
+    vec3f closest;
+    int iterations;
+    return gjk(shapeA, shapeB, cache, true, simplex, closest, iterations);
+}
+
+ConvexResult gjkQuery(const SupportFunction& shapeA, const SupportFunction& shapeB, ConvexCache* cache)
+{
+    Simplex simplex;
+    vec3f closest;
+
+    ConvexResult result;
+    result.intersecting = gjk(shapeA, shapeB, cache, false, simplex, closest, result.iterations);
+
+    if (!result.intersecting)
+    {
+        result.pointA = vec3f(0.0f);
+        result.pointB = vec3f(0.0f);
+        for (int i = 0; i < simplex.count; ++i)
+        {
+            result.pointA += simplex.vertices[i].a * simplex.lambda[i];
+            result.pointB += simplex.vertices[i].b * simplex.lambda[i];
+        }
+
+        result.distance = closest.length();
+        result.depth = 0.0f;
+        result.normal = result.distance > 0.0f ? -closest / result.distance : vec3f(0.0f, 1.0f, 0.0f);
+        return result;
+    }
+
+    result.distance = 0.0f;
+
+    if (!blowUp(shapeA, shapeB, simplex) || !epa(shapeA, shapeB, simplex, result))
+    {
+        // Flat or degenerate overlap, the shapes only touch.
+        result.depth = 0.0f;
+        result.normal = vec3f(0.0f, 1.0f, 0.0f);
+        result.pointA = simplex.vertices[0].a;
+        result.pointB = simplex.vertices[0].b;
+    }
+
+    return result;
+}
+
+} // namespace priv
+
+} // namespace nx
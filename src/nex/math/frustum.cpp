@@ -1,357 +1,609 @@
-#include <nex/math/frustum.h>
-#include <nex/math/sphere.h>
-#include <nex/math/plane.h>
-#include <nex/math/ray.h>
-
-#include <limits>
-
-namespace nx
-{
-    Frustum::Frustum()
-    { }
-
-    void Frustum::setMatrix(const mat4f& value)
-    {
-        // Store our matrix.
-        mMatrix = value;
-
-        // Calculate all of the planes for the bounding frustum.
-        // TODO (Tyler): Test this.
-        mPlanes[2].normal.x = -value[0][3] - value[0][0];
-        mPlanes[2].normal.y = -value[1][3] - value[1][0];
-        mPlanes[2].normal.z = -value[2][3] - value[2][0];
-        mPlanes[2].distance = -value[3][3] - value[3][0];
-
-        mPlanes[3].normal.x = -value[0][3] + value[0][0];
-        mPlanes[3].normal.y = -value[1][3] + value[1][0];
-        mPlanes[3].normal.z = -value[2][3] + value[2][0];
-        mPlanes[3].distance = -value[3][3] + value[3][0];
-
-        mPlanes[4].normal.x = -value[0][3] + value[0][1];
-        mPlanes[4].normal.y = -value[1][3] + value[1][1];
-        mPlanes[4].normal.z = -value[2][3] + value[2][1];
-        mPlanes[4].distance = -value[3][3] + value[3][1];
-
-        mPlanes[5].normal.x = -value[0][3] - value[0][1];
-        mPlanes[5].normal.y = -value[1][3] - value[1][1];
-        mPlanes[5].normal.z = -value[2][3] - value[2][1];
-        mPlanes[5].distance = -value[3][3] - value[3][1];
-
-        mPlanes[0].normal.x = -value[0][2];
-        mPlanes[0].normal.y = -value[1][2];
-        mPlanes[0].normal.z = -value[2][2];
-        mPlanes[0].distance = -value[3][2];
-
-        mPlanes[1].normal.x = -value[0][3] + value[0][2];
-        mPlanes[1].normal.y = -value[1][3] + value[1][2];
-        mPlanes[1].normal.z = -value[2][3] + value[2][2];
-        mPlanes[1].distance = -value[3][3] + value[3][2];
-
-        // Normalize all of the planes.
-        for (int index = 0; index < 6; ++index)
-        {
-            const float oneOverLength = 1.0f / mPlanes[index].normal.length();
-
-            mPlanes[index].normal *= oneOverLength;
-            mPlanes[index].distance *= oneOverLength;
-        }
-
-        Ray intersectionLine1 = Plane::computeIntersectionLine(mPlanes[0], mPlanes[2]);
-        mCornerArray[0] = intersectionLine1.computeIntersection(mPlanes[4]);
-        mCornerArray[3] = intersectionLine1.computeIntersection(mPlanes[5]);
-
-        Ray intersectionLine2 = Plane::computeIntersectionLine(mPlanes[3], mPlanes[0]);
-        mCornerArray[1] = intersectionLine2.computeIntersection(mPlanes[4]);
-        mCornerArray[2] = intersectionLine2.computeIntersection(mPlanes[5]);
-
-        intersectionLine2 = Plane::computeIntersectionLine(mPlanes[2], mPlanes[1]);
-        mCornerArray[4] = intersectionLine2.computeIntersection(mPlanes[4]);
-        mCornerArray[7] = intersectionLine2.computeIntersection(mPlanes[5]);
-
-        intersectionLine2 = Plane::computeIntersectionLine(mPlanes[1], mPlanes[3]);
-        mCornerArray[5] = intersectionLine2.computeIntersection(mPlanes[4]);
-        mCornerArray[6] = intersectionLine2.computeIntersection(mPlanes[5]);
-    }
-
-    vec3f Frustum::supportMapping(const vec3f vector) const
-    {
-        int searchIndex = 0;
-        float thetaA = vec3f::dot(mCornerArray[0], vector);
-
-        for (int index2 = 1; index2 < 8; ++index2)
-        {
-            float thetaB = vec3f::dot(mCornerArray[index2], vector);
-            if (thetaB > thetaA)
-            {
-                searchIndex = index2;
-                thetaA = thetaB;
-            }
-        }
-
-        return mCornerArray[searchIndex];
-    }
-
-    bool Frustum::intersects(const AABB& box) const
-    {
-        mGJK.reset();
-
-        vec3f result1 = mCornerArray[0] - box.min;
-
-        if ((double)result1.lengthSquared() < 9.99999974737875E-06)
-            result1 = mCornerArray[0] - box.max;
-
-        float num1 = std::numeric_limits<float>::max();
-        float num2;
-        do
-        {
-            vec3f v;
-
-            v.x = -result1.x;
-            v.y = -result1.y;
-            v.z = -result1.z;
-
-            vec3f result2 = supportMapping(v);
-            vec3f result3 = supportMapping(result1);
-            vec3f result4 = result2 - result3;
-
-            if (result1.x * result4.x + result1.y * result4.y + result1.z * result4.z > 0.0f)
-                return false;
-
-            mGJK.addSupportPoint(result4);
-
-            result1 = mGJK.closestPoint();
-            float num3 = num1;
-            num1 = result1.lengthSquared();
-            if ((double)num3 - (double)num1 <= 9.99999974737875E-06 * (double)num3)
-                return false;
-            num2 = 4E-05f * mGJK.maxLengthSquared();
-        }
-        while (!mGJK.fullSimplex() && num1 >= num2);
-        return true;
-    }
-
-    bool Frustum::intersects(const Frustum& frustum) const
-    {
-        mGJK.reset();
-
-        const vec3f* otherCorners = frustum.getCorners();
-
-        vec3f result1 = mCornerArray[0] - otherCorners[0];
-
-        if ((double)result1.lengthSquared() < 9.99999974737875E-06)
-            result1 = mCornerArray[0] - otherCorners[1];
-
-        float num1 = std::numeric_limits<float>::max();
-        float num2;
-        do
-        {
-            vec3f v;
-
-            v.x = -result1.x;
-            v.y = -result1.y;
-            v.z = -result1.z;
-
-            vec3f result2 = supportMapping(v);
-            vec3f result3 = frustum.supportMapping(result1);
-            vec3f result4 = result2 - result3;
-
-            if (result1.x * result4.x + result1.y * result4.y + result1.z * result4.z > 0.0f)
-                return false;
-
-            mGJK.addSupportPoint(result4);
-
-            result1 = mGJK.closestPoint();
-
-            float num3 = num1;
-            num1 = result1.lengthSquared();
-            num2 = 4E-05f * mGJK.maxLengthSquared();
-            if ((double) num3 - (double)num1 <= 9.99999974737875E-06 * (double) num3)
-                return false;
-        }
-        while (!mGJK.fullSimplex() && num1 >= num2);
-        return true;
-    }
-
-    float Frustum::intersects(const Ray& ray) const
-    {
-        ContainmentType result1 = contains(ray.position);
-        if (result1 == ContainmentType::Contains)
-        {
-            return  0.0f;
-        }
-        else
-        {
-            float minDistance = std::numeric_limits<float>::min();//float.MinValue;
-            float maxDistance = std::numeric_limits<float>::max();//float.MaxValue;
-
-            for (auto plane : mPlanes)
-            {
-                float dotA = vec3f::dot(ray.direction, plane.normal);
-                float dotB = vec3f::dot(ray.position, plane.normal);
-
-                dotB += plane.distance;
-
-                if (std::abs(dotA) < 9.99999974737875E-06)
-                {
-                    if (dotB > 0.0f)
-                        return 0.0f;
-                }
-                else
-                {
-                    float num3 = -dotB / dotA;
-                    if (dotA < 0.0f)
-                    {
-                        if (num3 > maxDistance)
-                            return 0.0f;
-
-                        if (num3 > minDistance)
-                            minDistance = num3;
-                    }
-                    else
-                    {
-                        if (num3 < minDistance)
-                            return 0.0f;
-                        if (num3 < maxDistance)
-                            maxDistance = num3;
-                    }
-                }
-            }
-
-            float clampedResult = minDistance >= 0.0f ? minDistance : maxDistance;
-
-            if (clampedResult < 0.0f)
-                return 0.0f;
-
-            return clampedResult;
-        }
-    }
-
-    bool Frustum::intersects(const Sphere& sphere) const
-    {
-        mGJK.reset();
-
-        vec3f result1 = mCornerArray[0] - sphere.center;
-
-        if ((double)result1.lengthSquared() < 9.99999974737875E-06)
-            result1 = vec3f::unitX;
-
-        float num1 = std::numeric_limits<float>::max();
-        float num2;
-
-        do
-        {
-            vec3f v;
-            v.x = -result1.x;
-            v.y = -result1.y;
-            v.z = -result1.z;
-
-            vec3f result2 = supportMapping(v);
-            vec3f result3 = supportMapping(result1);
-
-            vec3f result4 = result2 - result3;
-
-            if (result1.x * result4.x + result1.y * result4.y + result1.z * result4.z > 0.0f)
-                return false;
-
-            mGJK.addSupportPoint(result4);
-            result1 = mGJK.closestPoint();
-
-            float num3 = num1;
-
-            num1 = result1.lengthSquared();
-
-            if ((double) num3 - (double) num1 <= 9.99999974737875E-06 * (double)num3)
-                return false;
-
-            num2 = 4E-05f * mGJK.maxLengthSquared();
-        }
-        while (!mGJK.fullSimplex() && num1 >= num2);
-        return true;
-    }
-
-    PlaneIntersectionType Frustum::intersects(const Plane& plane) const
-    {
-        int result = 0;
-        for (int index = 0; index < 8; ++index)
-        {
-            float dotResult = vec3f::dot(mCornerArray[index], plane.normal);
-
-            if (dotResult + plane.distance > 0.0f)
-                result |= 1;
-            else
-                result |= 2;
-
-            if (result == 3)
-                return PlaneIntersectionType::Intersecting;
-        }
-        return result != 1 ? PlaneIntersectionType::Back : PlaneIntersectionType::Front;
-    }
-
-    ContainmentType Frustum::contains(const vec3f& point) const
-    {
-        for (auto plane : mPlanes)
-        {
-            if (((plane.normal.x * point.x + plane.normal.y * point.y + plane.normal.z * point.z) + plane.distance) > 9.99999974737875E-06f)
-                return ContainmentType::Disjoint;
-        }
-        return ContainmentType::Contains;
-    }
-
-    ContainmentType Frustum::contains(const AABB& box) const
-    {
-        bool flag = false;
-        for (auto plane : mPlanes)
-        {
-            switch (plane.intersects(box))
-            {
-            case PlaneIntersectionType::Front:
-                return ContainmentType::Disjoint;
-            case PlaneIntersectionType::Intersecting:
-                flag = true;
-                break;
-            }
-        }
-        return !flag ? ContainmentType::Contains : ContainmentType::Intersects;
-    }
-
-    ContainmentType Frustum::contains(const Frustum& frustum) const
-    {
-        ContainmentType containmentType = ContainmentType::Disjoint;
-        if (intersects(frustum))
-        {
-            containmentType = ContainmentType::Contains;
-            const vec3f* cornerPtr = frustum.getCorners();
-            for (int index = 0; index < 8; ++index)
-            {
-                if (contains(cornerPtr[index]) == ContainmentType::Disjoint)
-                {
-                    containmentType = ContainmentType::Intersects;
-                    break;
-                }
-            }
-        }
-        return containmentType;
-    }
-
-    ContainmentType Frustum::contains(const Sphere& sphere) const
-    {
-        const vec3f center = sphere.center;
-        const float radius = sphere.radius;
-
-        int result = 0;
-
-        for (auto plane : mPlanes)
-        {
-            float cross = (plane.normal.x * center.x + plane.normal.y * center.y + plane.normal.z * center.z) + plane.distance;
-
-            if (cross > radius)
-                return ContainmentType::Disjoint;
-
-            if (cross < -radius)
-                ++result;
-        }
-
-        return result != 6 ? ContainmentType::Intersects : ContainmentType::Contains;
-    }
-
-} //namespace nx
+#include <nex/math/frustum.h>
+#include <nex/math/sphere.h>
+#include <nex/math/obb.h>
+#include <nex/math/plane.h>
+#include <nex/math/ray.h>
+#include <nex/math/simdlane.h>
+#include <nex/math/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    using nx::priv::ScalarLane;
+    using nx::priv::WideLane;
+
+    typedef float PlaneLanes[4][8];
+
+    const int PlaneCount = 6;
+    const int PlaneSlots = 8;
+
+    // Half extents and center of a block of boxes, tested against one plane at a time.
+    template <typename Lane>
+    struct BoxBlock
+    {
+        typedef Lane LaneType;
+        typedef typename Lane::Type Type;
+
+        BoxBlock(const float* const* bounds, std::size_t index)
+        {
+            const Type half = Lane::set(0.5f);
+            const Type minX = Lane::loadUnaligned(bounds[0] + index);
+            const Type minY = Lane::loadUnaligned(bounds[1] + index);
+            const Type minZ = Lane::loadUnaligned(bounds[2] + index);
+            const Type maxX = Lane::loadUnaligned(bounds[3] + index);
+            const Type maxY = Lane::loadUnaligned(bounds[4] + index);
+            const Type maxZ = Lane::loadUnaligned(bounds[5] + index);
+
+            centerX = Lane::mul(Lane::add(minX, maxX), half);
+            centerY = Lane::mul(Lane::add(minY, maxY), half);
+            centerZ = Lane::mul(Lane::add(minZ, maxZ), half);
+            extentX = Lane::mul(Lane::sub(maxX, minX), half);
+            extentY = Lane::mul(Lane::sub(maxY, minY), half);
+            extentZ = Lane::mul(Lane::sub(maxZ, minZ), half);
+        }
+
+        // Bit i is set when the n-vertex of box i is in front of the plane.
+        int outside(const PlaneLanes& planes, int plane) const
+        {
+            const float normalX = planes[0][plane];
+            const float normalY = planes[1][plane];
+            const float normalZ = planes[2][plane];
+
+            const Type distance = Lane::multiplyAdd(Lane::set(normalX), centerX,
+                                  Lane::multiplyAdd(Lane::set(normalY), centerY,
+                                  Lane::multiplyAdd(Lane::set(normalZ), centerZ, Lane::set(planes[3][plane]))));
+            const Type radius = Lane::multiplyAdd(Lane::set(std::fabs(normalX)), extentX,
+                                Lane::multiplyAdd(Lane::set(std::fabs(normalY)), extentY,
+                                Lane::mul(Lane::set(std::fabs(normalZ)), extentZ)));
+
+            return Lane::moveMask(Lane::greater(distance, radius));
+        }
+
+        Type centerX, centerY, centerZ;
+        Type extentX, extentY, extentZ;
+    };
+
+    template <typename Lane>
+    struct SphereBlock
+    {
+        typedef Lane LaneType;
+        typedef typename Lane::Type Type;
+
+        SphereBlock(const float* const* bounds, std::size_t index)
+        {
+            centerX = Lane::loadUnaligned(bounds[0] + index);
+            centerY = Lane::loadUnaligned(bounds[1] + index);
+            centerZ = Lane::loadUnaligned(bounds[2] + index);
+            radius = Lane::loadUnaligned(bounds[3] + index);
+        }
+
+        int outside(const PlaneLanes& planes, int plane) const
+        {
+            const Type distance = Lane::multiplyAdd(Lane::set(planes[0][plane]), centerX,
+                                  Lane::multiplyAdd(Lane::set(planes[1][plane]), centerY,
+                                  Lane::multiplyAdd(Lane::set(planes[2][plane]), centerZ, Lane::set(planes[3][plane]))));
+
+            return Lane::moveMask(Lane::greater(distance, radius));
+        }
+
+        Type centerX, centerY, centerZ;
+        Type radius;
+    };
+
+    // The plane shared by every cached entry of a block, or -1.
+    int sharedPlane(const uint8* lastPlane, int width)
+    {
+        const int plane = lastPlane[0];
+        for (int i = 1; i < width; ++i)
+        {
+            if (lastPlane[i] != plane)
+                return -1;
+        }
+        return plane < PlaneCount ? plane : -1;
+    }
+
+    // Tests Block::LaneType::Width objects at a time against the planes and sets
+    // the visibility bit of the survivors. Blocks start on a multiple of the
+    // width so their bits never straddle two words.
+    template <typename Block>
+    std::size_t cullKernel(const PlaneLanes& planes, const float* const* bounds,
+                           uint32* visibility, uint8* lastPlane, std::size_t index, std::size_t count)
+    {
+        const int width = Block::LaneType::Width;
+        const int allRejected = (1 << width) - 1;
+
+        for (; index + width <= count; index += width)
+        {
+            const Block block(bounds, index);
+
+            int rejected = 0;
+            int cached = -1;
+
+            // Objects tend to stay behind the plane that rejected them last frame.
+            if (lastPlane)
+            {
+                cached = sharedPlane(lastPlane + index, width);
+                if (cached >= 0)
+                    rejected = block.outside(planes, cached);
+            }
+
+            for (int plane = 0; plane < PlaneCount && rejected != allRejected; ++plane)
+            {
+                if (plane == cached)
+                    continue;
+
+                const int outside = block.outside(planes, plane) & ~rejected;
+                if (lastPlane && outside)
+                {
+                    for (int i = 0; i < width; ++i)
+                    {
+                        if (outside & (1 << i))
+                            lastPlane[index + i] = static_cast<uint8>(plane);
+                    }
+                }
+                rejected |= outside;
+            }
+
+            visibility[index / 32] |= static_cast<uint32>(~rejected & allRejected) << (index % 32);
+        }
+        return index;
+    }
+
+    // Culls a whole batch, on the threads of jobs when it is not 0. Batches are
+    // split on visibility words so no two threads write the same word.
+    template <template <typename> class Block>
+    void cullBatch(nx::JobSystem* jobs, const PlaneLanes& planes, const float* const* bounds,
+                   std::size_t count, uint32* visibility, uint8* lastPlane)
+    {
+        nx::priv::parallelRange(jobs, (count + 31) / 32, nx::FrustumCullParallelSize / 32, [&](std::size_t beginWord, std::size_t endWord) {
+            const std::size_t end = std::min(endWord * 32, count);
+
+            std::fill(visibility + beginWord, visibility + endWord, 0u);
+            const std::size_t index = cullKernel<Block<WideLane> >(planes, bounds, visibility, lastPlane, beginWord * 32, end);
+            cullKernel<Block<ScalarLane> >(planes, bounds, visibility, lastPlane, index, end);
+        });
+    }
+
+    // Classifies a single box against every plane, a full register of planes at a time.
+    template <typename Lane>
+    nx::ContainmentType containsBox(const PlaneLanes& planes, const nx::vec3f& center, const nx::vec3f& extent)
+    {
+        typedef typename Lane::Type Type;
+
+        const Type centerX = Lane::set(center.x);
+        const Type centerY = Lane::set(center.y);
+        const Type centerZ = Lane::set(center.z);
+        const Type extentX = Lane::set(extent.x);
+        const Type extentY = Lane::set(extent.y);
+        const Type extentZ = Lane::set(extent.z);
+        const Type zero = Lane::set(0.0f);
+        const int allBack = (1 << Lane::Width) - 1;
+
+        bool intersecting = false;
+        for (int slot = 0; slot < PlaneSlots; slot += Lane::Width)
+        {
+            const Type normalX = Lane::loadUnaligned(planes[0] + slot);
+            const Type normalY = Lane::loadUnaligned(planes[1] + slot);
+            const Type normalZ = Lane::loadUnaligned(planes[2] + slot);
+
+            const Type distance = Lane::multiplyAdd(normalX, centerX,
+                                  Lane::multiplyAdd(normalY, centerY,
+                                  Lane::multiplyAdd(normalZ, centerZ, Lane::loadUnaligned(planes[3] + slot))));
+            const Type radius = Lane::multiplyAdd(Lane::abs(normalX), extentX,
+                                Lane::multiplyAdd(Lane::abs(normalY), extentY,
+                                Lane::mul(Lane::abs(normalZ), extentZ)));
+
+            if (Lane::moveMask(Lane::greater(distance, radius)))
+                return nx::ContainmentType::Disjoint;
+
+            if (Lane::moveMask(Lane::less(Lane::add(distance, radius), zero)) != allBack)
+                intersecting = true;
+        }
+        return intersecting ? nx::ContainmentType::Intersects : nx::ContainmentType::Contains;
+    }
+
+    // As containsBox, the radius of the box along a plane normal sums its three axes.
+    template <typename Lane>
+    nx::ContainmentType containsOrientedBox(const PlaneLanes& planes, const nx::OBB& box)
+    {
+        typedef typename Lane::Type Type;
+
+        const Type centerX = Lane::set(box.center.x);
+        const Type centerY = Lane::set(box.center.y);
+        const Type centerZ = Lane::set(box.center.z);
+        const float extents[3] = { box.halfExtents.x, box.halfExtents.y, box.halfExtents.z };
+        const Type zero = Lane::set(0.0f);
+        const int allBack = (1 << Lane::Width) - 1;
+
+        bool intersecting = false;
+        for (int slot = 0; slot < PlaneSlots; slot += Lane::Width)
+        {
+            const Type normalX = Lane::loadUnaligned(planes[0] + slot);
+            const Type normalY = Lane::loadUnaligned(planes[1] + slot);
+            const Type normalZ = Lane::loadUnaligned(planes[2] + slot);
+
+            const Type distance = Lane::multiplyAdd(normalX, centerX,
+                                  Lane::multiplyAdd(normalY, centerY,
+                                  Lane::multiplyAdd(normalZ, centerZ, Lane::loadUnaligned(planes[3] + slot))));
+
+            Type radius = zero;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const Type projection = Lane::multiplyAdd(normalX, Lane::set(box.axes[axis].x),
+                                        Lane::multiplyAdd(normalY, Lane::set(box.axes[axis].y),
+                                        Lane::mul(normalZ, Lane::set(box.axes[axis].z))));
+                radius = Lane::multiplyAdd(Lane::abs(projection), Lane::set(extents[axis]), radius);
+            }
+
+            if (Lane::moveMask(Lane::greater(distance, radius)))
+                return nx::ContainmentType::Disjoint;
+
+            if (Lane::moveMask(Lane::less(Lane::add(distance, radius), zero)) != allBack)
+                intersecting = true;
+        }
+        return intersecting ? nx::ContainmentType::Intersects : nx::ContainmentType::Contains;
+    }
+
+    template <typename Lane>
+    nx::ContainmentType containsSphere(const PlaneLanes& planes, const nx::vec3f& center, float radius)
+    {
+        typedef typename Lane::Type Type;
+
+        const Type centerX = Lane::set(center.x);
+        const Type centerY = Lane::set(center.y);
+        const Type centerZ = Lane::set(center.z);
+        const Type positiveRadius = Lane::set(radius);
+        const Type negativeRadius = Lane::set(-radius);
+        const int allBack = (1 << Lane::Width) - 1;
+
+        bool intersecting = false;
+        for (int slot = 0; slot < PlaneSlots; slot += Lane::Width)
+        {
+            const Type distance = Lane::multiplyAdd(Lane::loadUnaligned(planes[0] + slot), centerX,
+                                  Lane::multiplyAdd(Lane::loadUnaligned(planes[1] + slot), centerY,
+                                  Lane::multiplyAdd(Lane::loadUnaligned(planes[2] + slot), centerZ,
+                                                    Lane::loadUnaligned(planes[3] + slot))));
+
+            if (Lane::moveMask(Lane::greater(distance, positiveRadius)))
+                return nx::ContainmentType::Disjoint;
+
+            if (Lane::moveMask(Lane::less(distance, negativeRadius)) != allBack)
+                intersecting = true;
+        }
+        return intersecting ? nx::ContainmentType::Intersects : nx::ContainmentType::Contains;
+    }
+}
+
+namespace nx
+{
+    Frustum::Frustum()
+    { }
+
+    void Frustum::setMatrix(const mat4f& value)
+    {
+        // Store our matrix.
+        mMatrix = value;
+
+        // Calculate all of the planes for the bounding frustum.
+        // TODO (Tyler): Test this.
+        mPlanes[2].normal.x = -value[0][3] - value[0][0];
+        mPlanes[2].normal.y = -value[1][3] - value[1][0];
+        mPlanes[2].normal.z = -value[2][3] - value[2][0];
+        mPlanes[2].distance = -value[3][3] - value[3][0];
+
+        mPlanes[3].normal.x = -value[0][3] + value[0][0];
+        mPlanes[3].normal.y = -value[1][3] + value[1][0];
+        mPlanes[3].normal.z = -value[2][3] + value[2][0];
+        mPlanes[3].distance = -value[3][3] + value[3][0];
+
+        mPlanes[4].normal.x = -value[0][3] + value[0][1];
+        mPlanes[4].normal.y = -value[1][3] + value[1][1];
+        mPlanes[4].normal.z = -value[2][3] + value[2][1];
+        mPlanes[4].distance = -value[3][3] + value[3][1];
+
+        mPlanes[5].normal.x = -value[0][3] - value[0][1];
+        mPlanes[5].normal.y = -value[1][3] - value[1][1];
+        mPlanes[5].normal.z = -value[2][3] - value[2][1];
+        mPlanes[5].distance = -value[3][3] - value[3][1];
+
+        mPlanes[0].normal.x = -value[0][2];
+        mPlanes[0].normal.y = -value[1][2];
+        mPlanes[0].normal.z = -value[2][2];
+        mPlanes[0].distance = -value[3][2];
+
+        mPlanes[1].normal.x = -value[0][3] + value[0][2];
+        mPlanes[1].normal.y = -value[1][3] + value[1][2];
+        mPlanes[1].normal.z = -value[2][3] + value[2][2];
+        mPlanes[1].distance = -value[3][3] + value[3][2];
+
+        // Normalize all of the planes.
+        for (int index = 0; index < 6; ++index)
+        {
+            const float oneOverLength = 1.0f / mPlanes[index].normal.length();
+
+            mPlanes[index].normal *= oneOverLength;
+            mPlanes[index].distance *= oneOverLength;
+        }
+
+        for (int index = 0; index < PlaneSlots; ++index)
+        {
+            const bool padding = index >= NumPlanes;
+
+            mPlaneLanes[0][index] = padding ? 0.0f : mPlanes[index].normal.x;
+            mPlaneLanes[1][index] = padding ? 0.0f : mPlanes[index].normal.y;
+            mPlaneLanes[2][index] = padding ? 0.0f : mPlanes[index].normal.z;
+            mPlaneLanes[3][index] = padding ? -std::numeric_limits<float>::max() : mPlanes[index].distance;
+        }
+
+        Ray intersectionLine1 = Plane::computeIntersectionLine(mPlanes[0], mPlanes[2]);
+        mCornerArray[0] = intersectionLine1.computeIntersection(mPlanes[4]);
+        mCornerArray[3] = intersectionLine1.computeIntersection(mPlanes[5]);
+
+        Ray intersectionLine2 = Plane::computeIntersectionLine(mPlanes[3], mPlanes[0]);
+        mCornerArray[1] = intersectionLine2.computeIntersection(mPlanes[4]);
+        mCornerArray[2] = intersectionLine2.computeIntersection(mPlanes[5]);
+
+        intersectionLine2 = Plane::computeIntersectionLine(mPlanes[2], mPlanes[1]);
+        mCornerArray[4] = intersectionLine2.computeIntersection(mPlanes[4]);
+        mCornerArray[7] = intersectionLine2.computeIntersection(mPlanes[5]);
+
+        intersectionLine2 = Plane::computeIntersectionLine(mPlanes[1], mPlanes[3]);
+        mCornerArray[5] = intersectionLine2.computeIntersection(mPlanes[4]);
+        mCornerArray[6] = intersectionLine2.computeIntersection(mPlanes[5]);
+    }
+
+    vec3f Frustum::supportMapping(const vec3f vector) const
+    {
+        int searchIndex = 0;
+        float thetaA = vec3f::dot(mCornerArray[0], vector);
+
+        for (int index2 = 1; index2 < 8; ++index2)
+        {
+            float thetaB = vec3f::dot(mCornerArray[index2], vector);
+            if (thetaB > thetaA)
+            {
+                searchIndex = index2;
+                thetaA = thetaB;
+            }
+        }
+
+        return mCornerArray[searchIndex];
+    }
+
+    bool Frustum::intersects(const AABB& box) const
+    {
+        return contains(box) != ContainmentType::Disjoint;
+    }
+
+    bool Frustum::intersects(const OBB& box) const
+    {
+        return contains(box) != ContainmentType::Disjoint;
+    }
+
+    bool Frustum::intersects(const Frustum& frustum) const
+    {
+        // Each thread gets its own working set so const queries stay reentrant.
+        thread_local GJK gjk;
+        return intersects(frustum, gjk);
+    }
+
+    bool Frustum::intersects(const Frustum& frustum, GJK& gjk) const
+    {
+        gjk.reset();
+
+        const vec3f* otherCorners = frustum.getCorners();
+
+        vec3f result1 = mCornerArray[0] - otherCorners[0];
+
+        if ((double)result1.lengthSquared() < 9.99999974737875E-06)
+            result1 = mCornerArray[0] - otherCorners[1];
+
+        float num1 = std::numeric_limits<float>::max();
+        float num2;
+        do
+        {
+            vec3f v;
+
+            v.x = -result1.x;
+            v.y = -result1.y;
+            v.z = -result1.z;
+
+            vec3f result2 = supportMapping(v);
+            vec3f result3 = frustum.supportMapping(result1);
+            vec3f result4 = result2 - result3;
+
+            if (result1.x * result4.x + result1.y * result4.y + result1.z * result4.z > 0.0f)
+                return false;
+
+            gjk.addSupportPoint(result4);
+
+            result1 = gjk.closestPoint();
+
+            float num3 = num1;
+            num1 = result1.lengthSquared();
+            num2 = 4E-05f * gjk.maxLengthSquared();
+            if ((double) num3 - (double)num1 <= 9.99999974737875E-06 * (double) num3)
+                return false;
+        }
+        while (!gjk.fullSimplex() && num1 >= num2);
+        return true;
+    }
+
+    float Frustum::intersects(const Ray& ray) const
+    {
+        ContainmentType result1 = contains(ray.position);
+        if (result1 == ContainmentType::Contains)
+        {
+            return  0.0f;
+        }
+        else
+        {
+            float minDistance = std::numeric_limits<float>::min();//float.MinValue;
+            float maxDistance = std::numeric_limits<float>::max();//float.MaxValue;
+
+            for (auto plane : mPlanes)
+            {
+                float dotA = vec3f::dot(ray.direction, plane.normal);
+                float dotB = vec3f::dot(ray.position, plane.normal);
+
+                dotB += plane.distance;
+
+                if (std::abs(dotA) < 9.99999974737875E-06)
+                {
+                    if (dotB > 0.0f)
+                        return 0.0f;
+                }
+                else
+                {
+                    float num3 = -dotB / dotA;
+                    if (dotA < 0.0f)
+                    {
+                        if (num3 > maxDistance)
+                            return 0.0f;
+
+                        if (num3 > minDistance)
+                            minDistance = num3;
+                    }
+                    else
+                    {
+                        if (num3 < minDistance)
+                            return 0.0f;
+                        if (num3 < maxDistance)
+                            maxDistance = num3;
+                    }
+                }
+            }
+
+            float clampedResult = minDistance >= 0.0f ? minDistance : maxDistance;
+
+            if (clampedResult < 0.0f)
+                return 0.0f;
+
+            return clampedResult;
+        }
+    }
+
+    bool Frustum::intersects(const Sphere& sphere) const
+    {
+        return contains(sphere) != ContainmentType::Disjoint;
+    }
+
+    PlaneIntersectionType Frustum::intersects(const Plane& plane) const
+    {
+        int result = 0;
+        for (int index = 0; index < 8; ++index)
+        {
+            float dotResult = vec3f::dot(mCornerArray[index], plane.normal);
+
+            if (dotResult + plane.distance > 0.0f)
+                result |= 1;
+            else
+                result |= 2;
+
+            if (result == 3)
+                return PlaneIntersectionType::Intersecting;
+        }
+        return result != 1 ? PlaneIntersectionType::Back : PlaneIntersectionType::Front;
+    }
+
+    ContainmentType Frustum::contains(const vec3f& point) const
+    {
+        for (auto plane : mPlanes)
+        {
+            if (((plane.normal.x * point.x + plane.normal.y * point.y + plane.normal.z * point.z) + plane.distance) > 9.99999974737875E-06f)
+                return ContainmentType::Disjoint;
+        }
+        return ContainmentType::Contains;
+    }
+
+    ContainmentType Frustum::contains(const AABB& box) const
+    {
+        const vec3f center((box.min.x + box.max.x) * 0.5f, (box.min.y + box.max.y) * 0.5f, (box.min.z + box.max.z) * 0.5f);
+        const vec3f extent((box.max.x - box.min.x) * 0.5f, (box.max.y - box.min.y) * 0.5f, (box.max.z - box.min.z) * 0.5f);
+
+        return containsBox<WideLane>(mPlaneLanes, center, extent);
+    }
+
+    ContainmentType Frustum::contains(const OBB& box) const
+    {
+        return containsOrientedBox<WideLane>(mPlaneLanes, box);
+    }
+
+    ContainmentType Frustum::contains(const Frustum& frustum) const
+    {
+        ContainmentType containmentType = ContainmentType::Disjoint;
+        if (intersects(frustum))
+        {
+            containmentType = ContainmentType::Contains;
+            const vec3f* cornerPtr = frustum.getCorners();
+            for (int index = 0; index < 8; ++index)
+            {
+                if (contains(cornerPtr[index]) == ContainmentType::Disjoint)
+                {
+                    containmentType = ContainmentType::Intersects;
+                    break;
+                }
+            }
+        }
+        return containmentType;
+    }
+
+    ContainmentType Frustum::contains(const Sphere& sphere) const
+    {
+        return containsSphere<WideLane>(mPlaneLanes, sphere.center, sphere.radius);
+    }
+
+    void Frustum::cullBoxes(const float* minX, const float* minY, const float* minZ,
+                            const float* maxX, const float* maxY, const float* maxZ,
+                            std::size_t count, uint32* visibility, uint8* lastPlane) const
+    {
+        const float* const bounds[] = { minX, minY, minZ, maxX, maxY, maxZ };
+        cullBatch<BoxBlock>(0, mPlaneLanes, bounds, count, visibility, lastPlane);
+    }
+
+    void Frustum::cullBoxes(const float* minX, const float* minY, const float* minZ,
+                            const float* maxX, const float* maxY, const float* maxZ,
+                            std::size_t count, uint32* visibility, uint8* lastPlane, JobSystem& jobs) const
+    {
+        const float* const bounds[] = { minX, minY, minZ, maxX, maxY, maxZ };
+        cullBatch<BoxBlock>(&jobs, mPlaneLanes, bounds, count, visibility, lastPlane);
+    }
+
+    void Frustum::cullBoxes(const Vec3Array& min, const Vec3Array& max, uint32* visibility, uint8* lastPlane) const
+    {
+        cullBoxes(min.getX(), min.getY(), min.getZ(), max.getX(), max.getY(), max.getZ(), min.size(), visibility, lastPlane);
+    }
+
+    void Frustum::cullBoxes(const Vec3Array& min, const Vec3Array& max, uint32* visibility, uint8* lastPlane, JobSystem& jobs) const
+    {
+        cullBoxes(min.getX(), min.getY(), min.getZ(), max.getX(), max.getY(), max.getZ(), min.size(), visibility, lastPlane, jobs);
+    }
+
+    void Frustum::cullSpheres(const float* centerX, const float* centerY, const float* centerZ, const float* radius,
+                              std::size_t count, uint32* visibility, uint8* lastPlane) const
+    {
+        const float* const bounds[] = { centerX, centerY, centerZ, radius };
+        cullBatch<SphereBlock>(0, mPlaneLanes, bounds, count, visibility, lastPlane);
+    }
+
+    void Frustum::cullSpheres(const float* centerX, const float* centerY, const float* centerZ, const float* radius,
+                              std::size_t count, uint32* visibility, uint8* lastPlane, JobSystem& jobs) const
+    {
+        const float* const bounds[] = { centerX, centerY, centerZ, radius };
+        cullBatch<SphereBlock>(&jobs, mPlaneLanes, bounds, count, visibility, lastPlane);
+    }
+
+    void Frustum::cullSpheres(const Vec3Array& centers, const float* radius, uint32* visibility, uint8* lastPlane) const
+    {
+        cullSpheres(centers.getX(), centers.getY(), centers.getZ(), radius, centers.size(), visibility, lastPlane);
+    }
+
+    void Frustum::cullSpheres(const Vec3Array& centers, const float* radius, uint32* visibility, uint8* lastPlane, JobSystem& jobs) const
+    {
+        cullSpheres(centers.getX(), centers.getY(), centers.getZ(), radius, centers.size(), visibility, lastPlane, jobs);
+    }
+
+} //namespace nx
@@ -0,0 +1,264 @@
+#include <nex/math/loosequadtree.h>
+#include <nex/math/bounds2d.h>
+
+// Standard includes.
+#include <algorithm>
+
+namespace
+{
+    // Index of the first node of a level, the levels above hold (4^level - 1) / 3 nodes.
+    uint32 levelOffset(int32 level)
+    {
+        return ((1u << (2 * level)) - 1) / 3;
+    }
+
+    int32 levelOf(uint32 node)
+    {
+        int32 level = 0;
+        while (levelOffset(level + 1) <= node)
+            ++level;
+        return level;
+    }
+
+    // Half the cell size by which the loose bounds grow, with a little slack
+    // against the rounding of the cell an item was filed under.
+    const float LooseHalf = 0.5f + 1.0f / 1024.0f;
+
+    struct Cell
+    {
+        int32 level;
+        int32 x;
+        int32 y;
+    };
+}
+
+namespace nx
+{
+
+LooseQuadtree::LooseQuadtree(const rectf& world, int32 depth) :
+    mDepth(std::max(0, std::min(depth, LooseQuadtreeMaxDepth))),
+    mNodes(levelOffset(mDepth + 1)),
+    mFreeList(NullHandle),
+    mItemCount(0)
+{
+    const priv::Bounds2d bounds = priv::toBounds(world);
+    mWorldX = bounds.minX;
+    mWorldY = bounds.minY;
+    mWorldWidth = bounds.maxX - bounds.minX;
+    mWorldHeight = bounds.maxY - bounds.minY;
+
+    clear();
+}
+
+uint32 LooseQuadtree::locate(float minX, float minY, float maxX, float maxY) const
+{
+    const float centerX = (minX + maxX) * 0.5f;
+    const float centerY = (minY + maxY) * 0.5f;
+
+    if (!(centerX >= mWorldX && centerX < mWorldX + mWorldWidth &&
+          centerY >= mWorldY && centerY < mWorldY + mWorldHeight))
+        return 0;
+
+    // The deepest level whose cells are at least as large as the item, the
+    // loose bounds then hold it wherever its center falls in the cell.
+    const float width = maxX - minX;
+    const float height = maxY - minY;
+
+    int32 level = 0;
+    while (level < mDepth &&
+           width <= mWorldWidth / static_cast<float>(2 << level) &&
+           height <= mWorldHeight / static_cast<float>(2 << level))
+        ++level;
+
+    const int32 side = 1 << level;
+    const int32 x = std::min(side - 1, static_cast<int32>((centerX - mWorldX) / mWorldWidth * side));
+    const int32 y = std::min(side - 1, static_cast<int32>((centerY - mWorldY) / mWorldHeight * side));
+
+    return levelOffset(level) + static_cast<uint32>(y * side + x);
+}
+
+uint32 LooseQuadtree::insert(const rectf& bounds, void* userData)
+{
+    uint32 handle;
+    if (mFreeList != NullHandle)
+    {
+        handle = mFreeList;
+        mFreeList = mItems[handle].next;
+    }
+    else
+    {
+        handle = static_cast<uint32>(mItems.size());
+        mItems.push_back(Item());
+        mBoxes.resize(mBoxes.size() + 4);
+    }
+
+    mItems[handle].userData = userData;
+    mItems[handle].next = NullHandle;
+    ++mItemCount;
+
+    link(handle, store(handle, bounds));
+    return handle;
+}
+
+void LooseQuadtree::remove(uint32 handle)
+{
+    unlink(handle);
+
+    mItems[handle].userData = 0;
+    mItems[handle].next = mFreeList;
+    mFreeList = handle;
+    --mItemCount;
+}
+
+void LooseQuadtree::update(uint32 handle, const rectf& bounds)
+{
+    const uint32 node = store(handle, bounds);
+    if (node == mItems[handle].node)
+        return;
+
+    unlink(handle);
+    link(handle, node);
+}
+
+uint32 LooseQuadtree::store(uint32 handle, const rectf& bounds)
+{
+    const priv::Bounds2d box = priv::toBounds(bounds);
+
+    mItems[handle].bounds = bounds;
+
+    float* const stored = &mBoxes[handle * 4];
+    stored[0] = box.minX;
+    stored[1] = box.minY;
+    stored[2] = box.maxX;
+    stored[3] = box.maxY;
+
+    return locate(box.minX, box.minY, box.maxX, box.maxY);
+}
+
+void LooseQuadtree::link(uint32 handle, uint32 node)
+{
+    Item& item = mItems[handle];
+    item.node = node;
+    item.slot = static_cast<uint32>(mNodes[node].items.size());
+    mNodes[node].items.push_back(handle);
+
+    addCount(node, 1);
+}
+
+void LooseQuadtree::unlink(uint32 handle)
+{
+    const Item& item = mItems[handle];
+    std::vector<uint32>& items = mNodes[item.node].items;
+
+    // Swap with the last item of the node and fix its slot.
+    items[item.slot] = items.back();
+    mItems[items.back()].slot = item.slot;
+    items.pop_back();
+
+    addCount(item.node, -1);
+}
+
+void LooseQuadtree::addCount(uint32 node, int32 delta)
+{
+    int32 level = levelOf(node);
+    const uint32 local = node - levelOffset(level);
+    int32 x = static_cast<int32>(local) & ((1 << level) - 1);
+    int32 y = static_cast<int32>(local) >> level;
+
+    // The node and each of its parents up to the root.
+    for (; level >= 0; --level, x >>= 1, y >>= 1)
+        mNodes[levelOffset(level) + static_cast<uint32>((y << level) + x)].count += delta;
+}
+
+void LooseQuadtree::clear()
+{
+    for (std::size_t i = 0; i < mNodes.size(); ++i)
+    {
+        mNodes[i].items.clear();
+        mNodes[i].count = 0;
+    }
+
+    mItems.clear();
+    mBoxes.clear();
+    mFreeList = NullHandle;
+    mItemCount = 0;
+}
+
+template <typename Test>
+std::size_t LooseQuadtree::gather(float minX, float minY, float maxX, float maxY, const Test& test, uint32* results, std::size_t capacity) const
+{
+    std::size_t count = 0;
+
+    // Depth first, at most three siblings wait on every level.
+    Cell stack[4 * (LooseQuadtreeMaxDepth + 1)];
+    int32 stackSize = 0;
+
+    Cell root = { 0, 0, 0 };
+    stack[stackSize++] = root;
+
+    while (stackSize > 0)
+    {
+        const Cell cell = stack[--stackSize];
+        const Node& node = mNodes[levelOffset(cell.level) + static_cast<uint32>((cell.y << cell.level) + cell.x)];
+
+        for (std::size_t i = 0; i < node.items.size(); ++i)
+        {
+            const uint32 handle = node.items[i];
+            const float* const box = &mBoxes[handle * 4];
+
+            if (!test(box[0], box[1], box[2], box[3]))
+                continue;
+
+            if (count < capacity)
+                results[count] = handle;
+            ++count;
+        }
+
+        if (cell.level == mDepth)
+            continue;
+
+        const int32 level = cell.level + 1;
+        const float cellWidth = mWorldWidth / static_cast<float>(1 << level);
+        const float cellHeight = mWorldHeight / static_cast<float>(1 << level);
+
+        for (int32 child = 0; child < 4; ++child)
+        {
+            const Cell next = { level, cell.x * 2 + (child & 1), cell.y * 2 + (child >> 1) };
+            if (mNodes[levelOffset(level) + static_cast<uint32>((next.y << level) + next.x)].count == 0)
+                continue;
+
+            // The loose bounds reach half a cell past every side of the cell.
+            const float looseMinX = mWorldX + (static_cast<float>(next.x) - LooseHalf) * cellWidth;
+            const float looseMinY = mWorldY + (static_cast<float>(next.y) - LooseHalf) * cellHeight;
+            const float looseMaxX = mWorldX + (static_cast<float>(next.x + 1) + LooseHalf) * cellWidth;
+            const float looseMaxY = mWorldY + (static_cast<float>(next.y + 1) + LooseHalf) * cellHeight;
+
+            if (looseMinX > maxX || looseMaxX < minX || looseMinY > maxY || looseMaxY < minY)
+                continue;
+
+            stack[stackSize++] = next;
+        }
+    }
+
+    return count;
+}
+
+std::size_t LooseQuadtree::query(const rectf& region, uint32* results, std::size_t capacity) const
+{
+    const priv::Bounds2d box = priv::toBounds(region);
+    return gather(box.minX, box.minY, box.maxX, box.maxY, priv::RegionTest(box), results, capacity);
+}
+
+std::size_t LooseQuadtree::query(const vec2f& point, uint32* results, std::size_t capacity) const
+{
+    return gather(point.x, point.y, point.x, point.y, priv::PointTest(point), results, capacity);
+}
+
+std::size_t LooseQuadtree::query(const Circle& circle, uint32* results, std::size_t capacity) const
+{
+    return gather(circle.center.x - circle.radius, circle.center.y - circle.radius,
+                  circle.center.x + circle.radius, circle.center.y + circle.radius,
+                  priv::CircleTest(circle), results, capacity);
+}
+
+} // namespace nx
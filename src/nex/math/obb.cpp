@@ -0,0 +1,392 @@
+#include <nex/math/obb.h>
+#include <nex/math/sphere.h>
+#include <nex/math/pointcloud.h>
+#include <nex/math/simdlane.h>
+
+// Standard includes.
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    using nx::vec3f;
+
+#if defined(NEX_SIMD_SSE)
+    typedef nx::priv::SseLane QuadLane;
+#else
+    typedef nx::priv::ScalarLane QuadLane;
+#endif
+
+    // Added to the rotation terms so edge pairs that are almost parallel,
+    // whose cross product is close to zero, cannot report a false separation.
+    const float ParallelEpsilon = 1e-6f;
+
+    const int JacobiMaxSweeps = 16;
+
+    // The separating axis test of two boxes A and B in the frame of A, the
+    // axes grouped by three so a register tests a whole group. Slots 0 to 2
+    // hold the group, slot 3 is zero and never separates.
+    struct SatFrame
+    {
+        // Half extents of A and B, the extents of B also rotated by one slot each way.
+        float a[4];
+        float b[4];
+        float bNext[4];
+        float bPrevious[4];
+
+        // The center of B relative to A, on the axes of A.
+        float t[4];
+
+        // row[i][j] is the cosine between axis i of A and axis j of B.
+        float row[3][4];
+        float absRow[3][4];
+        float absRowNext[3][4];
+        float absRowPrevious[3][4];
+
+        // absColumn[j][i] is absRow[i][j].
+        float absColumn[3][4];
+    };
+
+    void buildFrame(const nx::OBB& boxA, const nx::OBB& boxB, SatFrame& frame)
+    {
+        const float extentA[3] = { boxA.halfExtents.x, boxA.halfExtents.y, boxA.halfExtents.z };
+        const float extentB[3] = { boxB.halfExtents.x, boxB.halfExtents.y, boxB.halfExtents.z };
+        const vec3f offset = boxB.center - boxA.center;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            frame.a[i] = extentA[i];
+            frame.b[i] = extentB[i];
+            frame.bNext[i] = extentB[(i + 1) % 3];
+            frame.bPrevious[i] = extentB[(i + 2) % 3];
+            frame.t[i] = vec3f::dot(offset, boxA.axes[i]);
+
+            float absolute[3];
+            for (int j = 0; j < 3; ++j)
+            {
+                frame.row[i][j] = vec3f::dot(boxA.axes[i], boxB.axes[j]);
+                absolute[j] = std::fabs(frame.row[i][j]) + ParallelEpsilon;
+            }
+
+            for (int j = 0; j < 3; ++j)
+            {
+                frame.absRow[i][j] = absolute[j];
+                frame.absRowNext[i][j] = absolute[(j + 1) % 3];
+                frame.absRowPrevious[i][j] = absolute[(j + 2) % 3];
+                frame.absColumn[j][i] = absolute[j];
+            }
+
+            frame.row[i][3] = frame.absRow[i][3] = frame.absRowNext[i][3] = frame.absRowPrevious[i][3] = 0.0f;
+        }
+
+        frame.a[3] = frame.b[3] = frame.bNext[3] = frame.bPrevious[3] = frame.t[3] = 0.0f;
+        for (int j = 0; j < 3; ++j)
+            frame.absColumn[j][3] = 0.0f;
+    }
+
+    // The face normals of A.
+    template <typename Lane>
+    bool separatedByA(const SatFrame& frame)
+    {
+        typedef typename Lane::Type Type;
+
+        for (std::size_t slot = 0; slot < 4; slot += Lane::Width)
+        {
+            const Type radiusA = Lane::loadUnaligned(frame.a + slot);
+            const Type radiusB = Lane::multiplyAdd(Lane::set(frame.b[2]), Lane::loadUnaligned(frame.absColumn[2] + slot),
+                                 Lane::multiplyAdd(Lane::set(frame.b[1]), Lane::loadUnaligned(frame.absColumn[1] + slot),
+                                 Lane::mul(Lane::set(frame.b[0]), Lane::loadUnaligned(frame.absColumn[0] + slot))));
+            const Type distance = Lane::abs(Lane::loadUnaligned(frame.t + slot));
+
+            if (Lane::moveMask(Lane::greater(distance, Lane::add(radiusA, radiusB))))
+                return true;
+        }
+        return false;
+    }
+
+    // The face normals of B.
+    template <typename Lane>
+    bool separatedByB(const SatFrame& frame)
+    {
+        typedef typename Lane::Type Type;
+
+        for (std::size_t slot = 0; slot < 4; slot += Lane::Width)
+        {
+            const Type radiusA = Lane::multiplyAdd(Lane::set(frame.a[2]), Lane::loadUnaligned(frame.absRow[2] + slot),
+                                 Lane::multiplyAdd(Lane::set(frame.a[1]), Lane::loadUnaligned(frame.absRow[1] + slot),
+                                 Lane::mul(Lane::set(frame.a[0]), Lane::loadUnaligned(frame.absRow[0] + slot))));
+            const Type radiusB = Lane::loadUnaligned(frame.b + slot);
+            const Type distance = Lane::abs(Lane::multiplyAdd(Lane::set(frame.t[2]), Lane::loadUnaligned(frame.row[2] + slot),
+                                            Lane::multiplyAdd(Lane::set(frame.t[1]), Lane::loadUnaligned(frame.row[1] + slot),
+                                            Lane::mul(Lane::set(frame.t[0]), Lane::loadUnaligned(frame.row[0] + slot)))));
+
+            if (Lane::moveMask(Lane::greater(distance, Lane::add(radiusA, radiusB))))
+                return true;
+        }
+        return false;
+    }
+
+    // The cross products of axis i of A with the three axes of B.
+    template <typename Lane>
+    bool separatedByEdges(const SatFrame& frame, int i)
+    {
+        typedef typename Lane::Type Type;
+
+        const int next = (i + 1) % 3;
+        const int previous = (i + 2) % 3;
+
+        for (std::size_t slot = 0; slot < 4; slot += Lane::Width)
+        {
+            const Type radiusA = Lane::multiplyAdd(Lane::set(frame.a[next]), Lane::loadUnaligned(frame.absRow[previous] + slot),
+                                 Lane::mul(Lane::set(frame.a[previous]), Lane::loadUnaligned(frame.absRow[next] + slot)));
+            const Type radiusB = Lane::multiplyAdd(Lane::loadUnaligned(frame.bNext + slot), Lane::loadUnaligned(frame.absRowPrevious[i] + slot),
+                                 Lane::mul(Lane::loadUnaligned(frame.bPrevious + slot), Lane::loadUnaligned(frame.absRowNext[i] + slot)));
+            const Type distance = Lane::abs(Lane::sub(Lane::mul(Lane::set(frame.t[previous]), Lane::loadUnaligned(frame.row[next] + slot)),
+                                                      Lane::mul(Lane::set(frame.t[next]), Lane::loadUnaligned(frame.row[previous] + slot))));
+
+            if (Lane::moveMask(Lane::greater(distance, Lane::add(radiusA, radiusB))))
+                return true;
+        }
+        return false;
+    }
+
+    // Eigenvectors of a symmetric 3x3 matrix given as xx, xy, xz, yy, yz and zz, by cyclic Jacobi rotations.
+    void eigenvectors(const float* covariance, vec3f* axes)
+    {
+        double a[3][3] = { { covariance[0], covariance[1], covariance[2] },
+                           { covariance[1], covariance[3], covariance[4] },
+                           { covariance[2], covariance[4], covariance[5] } };
+        double v[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+
+        const double scale = a[0][0] * a[0][0] + a[1][1] * a[1][1] + a[2][2] * a[2][2];
+
+        for (int sweep = 0; sweep < JacobiMaxSweeps; ++sweep)
+        {
+            const double offDiagonal = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+            if (offDiagonal <= 1e-24 * scale || offDiagonal == 0.0)
+                break;
+
+            for (int p = 0; p < 2; ++p)
+            {
+                for (int q = p + 1; q < 3; ++q)
+                {
+                    if (a[p][q] == 0.0)
+                        continue;
+
+                    const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                    const double t = (theta < 0.0 ? -1.0 : 1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                    const double c = 1.0 / std::sqrt(t * t + 1.0);
+                    const double s = t * c;
+
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        const double kp = a[k][p];
+                        const double kq = a[k][q];
+                        a[k][p] = c * kp - s * kq;
+                        a[k][q] = s * kp + c * kq;
+                    }
+
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        const double pk = a[p][k];
+                        const double qk = a[q][k];
+                        a[p][k] = c * pk - s * qk;
+                        a[q][k] = s * pk + c * qk;
+                    }
+
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        const double kp = v[k][p];
+                        const double kq = v[k][q];
+                        v[k][p] = c * kp - s * kq;
+                        v[k][q] = s * kp + c * kq;
+                    }
+                }
+            }
+        }
+
+        for (int i = 0; i < 2; ++i)
+            axes[i] = vec3f::normalize(vec3f(static_cast<float>(v[0][i]), static_cast<float>(v[1][i]), static_cast<float>(v[2][i])));
+
+        // Rebuilt from the other two so the frame stays orthonormal and right handed.
+        axes[2] = vec3f::normalize(vec3f::cross(axes[0], axes[1]));
+        axes[1] = vec3f::cross(axes[2], axes[0]);
+    }
+
+    // The box of createFromPoints, jobs is 0 to stay on the calling thread.
+    nx::OBB fitPoints(const nx::priv::PointSpan& span, nx::JobSystem* jobs)
+    {
+        if (span.count == 0)
+            return nx::OBB();
+
+        vec3f mean;
+        float covariance[6];
+        nx::priv::pointCovariance(span, mean, covariance, jobs);
+
+        nx::OBB result;
+        eigenvectors(covariance, result.axes);
+
+        vec3f min;
+        vec3f max;
+        nx::priv::pointExtents(span, result.axes, min, max, jobs);
+
+        const vec3f middle = (min + max) * 0.5f;
+        result.center = result.axes[0] * middle.x + result.axes[1] * middle.y + result.axes[2] * middle.z;
+        result.halfExtents = (max - min) * 0.5f;
+
+        return result;
+    }
+}
+
+namespace nx
+{
+
+OBB::OBB() :
+    center(vec3f()),
+    halfExtents(vec3f())
+{
+    axes[0] = vec3f(1.0f, 0.0f, 0.0f);
+    axes[1] = vec3f(0.0f, 1.0f, 0.0f);
+    axes[2] = vec3f(0.0f, 0.0f, 1.0f);
+}
+
+OBB::OBB(const vec3f& center, const vec3f& halfExtents, const quatf& rotation) :
+    center(center),
+    halfExtents(halfExtents)
+{
+    const float x = rotation.x;
+    const float y = rotation.y;
+    const float z = rotation.z;
+    const float w = rotation.w;
+
+    axes[0] = vec3f(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y));
+    axes[1] = vec3f(2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x));
+    axes[2] = vec3f(2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y));
+}
+
+OBB::OBB(const vec3f& center, const vec3f& halfExtents, const vec3f& axisX, const vec3f& axisY, const vec3f& axisZ) :
+    center(center),
+    halfExtents(halfExtents)
+{
+    axes[0] = axisX;
+    axes[1] = axisY;
+    axes[2] = axisZ;
+}
+
+OBB::OBB(const AABB& box) :
+    center(vec3f::lerp(box.min, box.max, 0.5f)),
+    halfExtents((box.max - box.min) * 0.5f)
+{
+    axes[0] = vec3f(1.0f, 0.0f, 0.0f);
+    axes[1] = vec3f(0.0f, 1.0f, 0.0f);
+    axes[2] = vec3f(0.0f, 0.0f, 1.0f);
+}
+
+void OBB::getCorners(vec3f* corners) const
+{
+    const vec3f x = axes[0] * halfExtents.x;
+    const vec3f y = axes[1] * halfExtents.y;
+    const vec3f z = axes[2] * halfExtents.z;
+
+    for (int i = 0; i < CornerCount; ++i)
+        corners[i] = center + ((i & 1) ? x : -x) + ((i & 2) ? y : -y) + ((i & 4) ? z : -z);
+}
+
+AABB OBB::getBounds() const
+{
+    const vec3f extent(halfExtents.x * std::fabs(axes[0].x) + halfExtents.y * std::fabs(axes[1].x) + halfExtents.z * std::fabs(axes[2].x),
+                       halfExtents.x * std::fabs(axes[0].y) + halfExtents.y * std::fabs(axes[1].y) + halfExtents.z * std::fabs(axes[2].y),
+                       halfExtents.x * std::fabs(axes[0].z) + halfExtents.y * std::fabs(axes[1].z) + halfExtents.z * std::fabs(axes[2].z));
+
+    return AABB(center - extent, center + extent);
+}
+
+vec3f OBB::closestPoint(const vec3f& point) const
+{
+    const vec3f offset = point - center;
+    const float extents[3] = { halfExtents.x, halfExtents.y, halfExtents.z };
+
+    vec3f result = center;
+    for (int i = 0; i < 3; ++i)
+    {
+        const float distance = vec3f::dot(offset, axes[i]);
+        result += axes[i] * std::max(-extents[i], std::min(distance, extents[i]));
+    }
+    return result;
+}
+
+bool OBB::intersects(const OBB& box) const
+{
+    SatFrame frame;
+    buildFrame(*this, box, frame);
+
+    if (separatedByA<QuadLane>(frame) || separatedByB<QuadLane>(frame))
+        return false;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        if (separatedByEdges<QuadLane>(frame, i))
+            return false;
+    }
+    return true;
+}
+
+bool OBB::intersects(const AABB& box) const
+{
+    return intersects(OBB(box));
+}
+
+bool OBB::intersects(const Sphere& sphere) const
+{
+    return vec3f::distanceSquared(closestPoint(sphere.center), sphere.center) <= sphere.radius * sphere.radius;
+}
+
+ContainmentType OBB::contains(const vec3f& point) const
+{
+    const vec3f offset = point - center;
+
+    return std::fabs(vec3f::dot(offset, axes[0])) > halfExtents.x ||
+           std::fabs(vec3f::dot(offset, axes[1])) > halfExtents.y ||
+           std::fabs(vec3f::dot(offset, axes[2])) > halfExtents.z ? ContainmentType::Disjoint : ContainmentType::Contains;
+}
+
+OBB OBB::transform(const OBB& box, const mat4f& matrix)
+{
+    OBB result;
+    result.center = mat4f::transform(box.center, matrix);
+
+    float extents[3] = { box.halfExtents.x, box.halfExtents.y, box.halfExtents.z };
+    for (int i = 0; i < 3; ++i)
+    {
+        const vec3f axis = mat4f::transformNormal(box.axes[i], matrix);
+        const float length = axis.length();
+
+        result.axes[i] = axis * (1.0f / length);
+        extents[i] *= length;
+    }
+
+    result.halfExtents = vec3f(extents[0], extents[1], extents[2]);
+    return result;
+}
+
+OBB OBB::createFromAABB(const AABB& box, const mat4f& matrix)
+{
+    return transform(OBB(box), matrix);
+}
+
+OBB OBB::createFromPoints(const std::vector<vec3f>& points)
+{
+    return createFromPoints(points.data(), points.size());
+}
+
+OBB OBB::createFromPoints(const vec3f* points, std::size_t count, std::size_t stride)
+{
+    return fitPoints(priv::PointSpan(points, count, stride), 0);
+}
+
+OBB OBB::createFromPoints(const vec3f* points, std::size_t count, std::size_t stride, JobSystem& jobs)
+{
+    return fitPoints(priv::PointSpan(points, count, stride), &jobs);
+}
+
+} // namespace nx
@@ -0,0 +1,68 @@
+#ifndef PARALLEL_H_INCLUDE
+#define PARALLEL_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/jobsystem.h>
+
+// Standard includes.
+#include <algorithm>
+#include <cstddef>
+
+namespace nx
+{
+namespace priv
+{
+
+/**
+ * @brief Splits the range [0, count) into contiguous batches and runs function(begin, end) on each.
+ *
+ * The batches run on the job system, a few per thread so they balance, and
+ * never smaller than minBatchSize except for the last one. Without a job
+ * system, or for inputs of one batch or less, the whole range runs on the
+ * calling thread. The math batch functions take the job system as an opt
+ * in overload, so nothing forks unless the caller asked for it.
+ *
+ * @param jobs = The job system to run on, 0 to stay on the calling thread.
+ * @param count = The number of elements to process.
+ * @param minBatchSize = The smallest number of elements worth handing to another thread.
+ * @param function = The callable invoked with the begin and end index of each batch.
+ */
+template <typename Function>
+void parallelRange(JobSystem* jobs, std::size_t count, std::size_t minBatchSize, Function function)
+{
+    if (count == 0)
+        return;
+
+    if (!jobs || count <= minBatchSize)
+    {
+        function(static_cast<std::size_t>(0), count);
+        return;
+    }
+
+    const std::size_t batchSize = std::max(std::max<std::size_t>(1, minBatchSize), count / (jobs->getThreadCount() * 4));
+    jobs->parallelFor(count, batchSize, function);
+}
+
+/**
+ * @brief Runs two independent callables and waits for both.
+ * @param jobs = The job system to run on, 0 to run both on the calling thread.
+ * @param first = Runs on the calling thread.
+ * @param second = Runs on a worker thread, or on the calling thread when every worker is busy.
+ */
+template <typename FunctionA, typename FunctionB>
+void parallelInvoke(JobSystem* jobs, FunctionA first, FunctionB second)
+{
+    if (!jobs)
+    {
+        first();
+        second();
+        return;
+    }
+
+    jobs->parallelInvoke(first, second);
+}
+
+} // namespace priv
+} // namespace nx
+
+#endif // PARALLEL_H_INCLUDE
@@ -1,5 +1,6 @@
 #include <nex/math/plane.h>
 #include <nex/math/ray.h>
+#include <nex/math/obb.h>
 
 #include <cmath>
 
@@ -98,6 +99,19 @@ PlaneIntersectionType Plane::intersects(const Sphere& sphere) const
     return  dist < - sphere.radius ? PlaneIntersectionType::Back : PlaneIntersectionType::Intersecting;
 }
 
+PlaneIntersectionType Plane::intersects(const OBB& box) const
+{
+    const float dist = (box.center.x * normal.x + box.center.y * normal.y + box.center.z * normal.z) + distance;
+    const float radius = box.halfExtents.x * std::fabs(vec3f::dot(normal, box.axes[0])) +
+                         box.halfExtents.y * std::fabs(vec3f::dot(normal, box.axes[1])) +
+                         box.halfExtents.z * std::fabs(vec3f::dot(normal, box.axes[2]));
+
+    if (dist > radius)
+        return PlaneIntersectionType::Front;
+
+    return dist < -radius ? PlaneIntersectionType::Back : PlaneIntersectionType::Intersecting;
+}
+
 Plane Plane::normalize(const Plane& plane)
 {
     const float normalLength = (plane.normal.x * plane.normal.x + plane.normal.y * plane. normal.y + plane.normal.z * plane.normal.z);
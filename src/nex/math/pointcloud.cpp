@@ -0,0 +1,673 @@
+#include <nex/math/pointcloud.h>
+#include <nex/math/sphere.h>
+#include <nex/math/soakernels.h>
+#include <nex/math/simdlane.h>
+#include <nex/math/parallel.h>
+
+// Standard includes.
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+namespace
+{
+    using nx::vec3f;
+    using nx::priv::PointSpan;
+    using nx::priv::ScalarLane;
+    using nx::priv::WideLane;
+
+    // Points are transposed a block at a time so the kernels read one
+    // component array at a time, whatever the stride of the input.
+    const std::size_t BlockSize = 256;
+
+    // Passes of the exact sphere, each one adds the furthest point to the support set.
+    const int MinimalSphereMaxPasses = 256;
+
+    // Relative slack before a point counts as outside of a sphere.
+    const float MinimalSphereTolerance = 1e-5f;
+    const float SupportTolerance = 1e-4f;
+
+    struct PointBlock
+    {
+        float x[BlockSize];
+        float y[BlockSize];
+        float z[BlockSize];
+        std::size_t count;
+    };
+
+    void gather(const PointSpan& points, std::size_t begin, std::size_t end, PointBlock& block)
+    {
+        block.count = end - begin;
+        for (std::size_t i = 0; i < block.count; ++i)
+        {
+            const vec3f& point = points[begin + i];
+            block.x[i] = point.x;
+            block.y[i] = point.y;
+            block.z[i] = point.z;
+        }
+    }
+
+    // Min and max of tightly packed points. Width points fill three registers
+    // and the component of a float only depends on its position modulo 3, so
+    // every register is reduced on its own and the lanes are sorted at the end.
+    template <typename Lane>
+    std::size_t packedBoundsKernel(const float* data, float* min, float* max, std::size_t index, std::size_t count)
+    {
+        typedef typename Lane::Type Type;
+
+        if (index + Lane::Width > count)
+            return index;
+
+        Type low[3];
+        Type high[3];
+        for (int i = 0; i < 3; ++i)
+            low[i] = high[i] = Lane::loadUnaligned(data + 3 * index + i * Lane::Width);
+
+        for (index += Lane::Width; index + Lane::Width <= count; index += Lane::Width)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                const Type value = Lane::loadUnaligned(data + 3 * index + i * Lane::Width);
+                low[i] = Lane::min(low[i], value);
+                high[i] = Lane::max(high[i], value);
+            }
+        }
+
+        float lanesLow[3 * Lane::Width];
+        float lanesHigh[3 * Lane::Width];
+        for (int i = 0; i < 3; ++i)
+        {
+            Lane::storeUnaligned(lanesLow + i * Lane::Width, low[i]);
+            Lane::storeUnaligned(lanesHigh + i * Lane::Width, high[i]);
+        }
+
+        for (std::size_t i = 0; i < 3 * Lane::Width; ++i)
+        {
+            min[i % 3] = std::min(min[i % 3], lanesLow[i]);
+            max[i % 3] = std::max(max[i % 3], lanesHigh[i]);
+        }
+        return index;
+    }
+
+    template <typename Lane>
+    std::size_t distanceKernel(const PointBlock& block, const vec3f& center, float* result, std::size_t index)
+    {
+        typedef typename Lane::Type Type;
+
+        const Type centerX = Lane::set(center.x);
+        const Type centerY = Lane::set(center.y);
+        const Type centerZ = Lane::set(center.z);
+
+        for (; index + Lane::Width <= block.count; index += Lane::Width)
+        {
+            const Type x = Lane::sub(Lane::loadUnaligned(block.x + index), centerX);
+            const Type y = Lane::sub(Lane::loadUnaligned(block.y + index), centerY);
+            const Type z = Lane::sub(Lane::loadUnaligned(block.z + index), centerZ);
+            Lane::storeUnaligned(result + index, Lane::multiplyAdd(z, z, Lane::multiplyAdd(y, y, Lane::mul(x, x))));
+        }
+        return index;
+    }
+
+    // Squared distances of a block of points to a center.
+    void distancesSquared(const PointBlock& block, const vec3f& center, float* result)
+    {
+        const std::size_t index = distanceKernel<WideLane>(block, center, result, 0);
+        distanceKernel<ScalarLane>(block, center, result, index);
+    }
+
+    // Sums of the coordinates and of their products, relative to an origin.
+    template <typename Lane>
+    std::size_t momentKernel(const PointBlock& block, const vec3f& origin, float* sums, std::size_t index)
+    {
+        typedef typename Lane::Type Type;
+
+        const Type originX = Lane::set(origin.x);
+        const Type originY = Lane::set(origin.y);
+        const Type originZ = Lane::set(origin.z);
+
+        Type moments[9];
+        for (int i = 0; i < 9; ++i)
+            moments[i] = Lane::set(0.0f);
+
+        for (; index + Lane::Width <= block.count; index += Lane::Width)
+        {
+            const Type x = Lane::sub(Lane::loadUnaligned(block.x + index), originX);
+            const Type y = Lane::sub(Lane::loadUnaligned(block.y + index), originY);
+            const Type z = Lane::sub(Lane::loadUnaligned(block.z + index), originZ);
+
+            moments[0] = Lane::add(moments[0], x);
+            moments[1] = Lane::add(moments[1], y);
+            moments[2] = Lane::add(moments[2], z);
+            moments[3] = Lane::multiplyAdd(x, x, moments[3]);
+            moments[4] = Lane::multiplyAdd(x, y, moments[4]);
+            moments[5] = Lane::multiplyAdd(x, z, moments[5]);
+            moments[6] = Lane::multiplyAdd(y, y, moments[6]);
+            moments[7] = Lane::multiplyAdd(y, z, moments[7]);
+            moments[8] = Lane::multiplyAdd(z, z, moments[8]);
+        }
+
+        for (int i = 0; i < 9; ++i)
+            sums[i] += Lane::reduceAdd(moments[i]);
+        return index;
+    }
+
+    template <typename Lane>
+    std::size_t projectKernel(const PointBlock& block, const vec3f& axis, float* result, std::size_t index)
+    {
+        typedef typename Lane::Type Type;
+
+        const Type axisX = Lane::set(axis.x);
+        const Type axisY = Lane::set(axis.y);
+        const Type axisZ = Lane::set(axis.z);
+
+        for (; index + Lane::Width <= block.count; index += Lane::Width)
+        {
+            const Type x = Lane::mul(Lane::loadUnaligned(block.x + index), axisX);
+            const Type y = Lane::loadUnaligned(block.y + index);
+            const Type z = Lane::loadUnaligned(block.z + index);
+            Lane::storeUnaligned(result + index, Lane::multiplyAdd(z, axisZ, Lane::multiplyAdd(y, axisY, x)));
+        }
+        return index;
+    }
+
+    std::size_t find(const float* data, std::size_t count, float value)
+    {
+        std::size_t index = 0;
+        while (index < count - 1 && data[index] != value)
+            ++index;
+        return index;
+    }
+
+    void rangeBounds(const PointSpan& points, std::size_t begin, std::size_t end, vec3f& min, vec3f& max)
+    {
+        float low[3] = { points[begin].x, points[begin].y, points[begin].z };
+        float high[3] = { low[0], low[1], low[2] };
+
+        if (points.stride == sizeof(vec3f) && sizeof(vec3f) == 3 * sizeof(float))
+        {
+            const float* data = &points[begin].x;
+            const std::size_t count = end - begin;
+            const std::size_t index = packedBoundsKernel<WideLane>(data, low, high, 0, count);
+            packedBoundsKernel<ScalarLane>(data, low, high, index, count);
+        }
+        else
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const vec3f& point = points[i];
+                low[0] = std::min(low[0], point.x);
+                low[1] = std::min(low[1], point.y);
+                low[2] = std::min(low[2], point.z);
+                high[0] = std::max(high[0], point.x);
+                high[1] = std::max(high[1], point.y);
+                high[2] = std::max(high[2], point.z);
+            }
+        }
+
+        min = vec3f(low[0], low[1], low[2]);
+        max = vec3f(high[0], high[1], high[2]);
+    }
+
+    // Indices of the points with the smallest and largest x, y and z, the first one on ties.
+    struct Extremes
+    {
+        float value[6];
+        std::size_t index[6];
+
+        void merge(const Extremes& other)
+        {
+            for (int i = 0; i < 6; ++i)
+            {
+                const bool better = (i % 2 == 0) ? other.value[i] < value[i] : other.value[i] > value[i];
+                if (better || (other.value[i] == value[i] && other.index[i] < index[i]))
+                {
+                    value[i] = other.value[i];
+                    index[i] = other.index[i];
+                }
+            }
+        }
+    };
+
+    Extremes rangeExtremes(const PointSpan& points, std::size_t begin, std::size_t end)
+    {
+        const vec3f& start = points[begin];
+        const float coordinates[3] = { start.x, start.y, start.z };
+
+        Extremes extremes;
+        for (int i = 0; i < 6; ++i)
+        {
+            extremes.value[i] = coordinates[i / 2];
+            extremes.index[i] = begin;
+        }
+
+        PointBlock block;
+        for (std::size_t first = begin; first < end; first += BlockSize)
+        {
+            gather(points, first, std::min(first + BlockSize, end), block);
+            const float* components[3] = { block.x, block.y, block.z };
+
+            // Only blocks that beat the current extremes are searched for the index.
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const float low = nx::priv::soaReduceMin(components[axis], block.count);
+                if (low < extremes.value[axis * 2])
+                {
+                    extremes.value[axis * 2] = low;
+                    extremes.index[axis * 2] = first + find(components[axis], block.count, low);
+                }
+
+                const float high = nx::priv::soaReduceMax(components[axis], block.count);
+                if (high > extremes.value[axis * 2 + 1])
+                {
+                    extremes.value[axis * 2 + 1] = high;
+                    extremes.index[axis * 2 + 1] = first + find(components[axis], block.count, high);
+                }
+            }
+        }
+        return extremes;
+    }
+
+    // Ritter's growth pass. A grown sphere holds the previous one, so points
+    // inside the sphere a block started with are skipped without a recheck.
+    void grow(const PointSpan& points, std::size_t begin, std::size_t end, vec3f& center, float& radius)
+    {
+        PointBlock block;
+        float distances[BlockSize];
+
+        for (std::size_t first = begin; first < end; first += BlockSize)
+        {
+            gather(points, first, std::min(first + BlockSize, end), block);
+            distancesSquared(block, center, distances);
+
+            const float radiusSquared = radius * radius;
+            if (nx::priv::soaReduceMax(distances, block.count) <= radiusSquared)
+                continue;
+
+            for (std::size_t i = 0; i < block.count; ++i)
+            {
+                if (distances[i] <= radiusSquared)
+                    continue;
+
+                const vec3f offset = vec3f(block.x[i], block.y[i], block.z[i]) - center;
+                const float length = offset.length();
+                if (length > radius)
+                {
+                    radius = (radius + length) * 0.5f;
+                    center += (1.0f - radius / length) * offset;
+                }
+            }
+        }
+    }
+
+    float rangeFurthest(const PointSpan& points, std::size_t begin, std::size_t end, const vec3f& center, std::size_t& index)
+    {
+        PointBlock block;
+        float distances[BlockSize];
+        float furthest = -1.0f;
+
+        for (std::size_t first = begin; first < end; first += BlockSize)
+        {
+            gather(points, first, std::min(first + BlockSize, end), block);
+            distancesSquared(block, center, distances);
+
+            const float distance = nx::priv::soaReduceMax(distances, block.count);
+            if (distance > furthest)
+            {
+                furthest = distance;
+                index = first + find(distances, block.count, distance);
+            }
+        }
+        return furthest;
+    }
+
+    // Squared distance of the point furthest from a center, first one on ties.
+    float furthest(nx::JobSystem* jobs, const PointSpan& points, const vec3f& center, std::size_t& index)
+    {
+        float result = -1.0f;
+        std::mutex mutex;
+
+        nx::priv::parallelRange(jobs, points.count, nx::priv::PointCloudParallelSize, [&](std::size_t begin, std::size_t end)
+        {
+            std::size_t rangeIndex = begin;
+            const float distance = rangeFurthest(points, begin, end, center, rangeIndex);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (distance > result || (distance == result && rangeIndex < index))
+            {
+                result = distance;
+                index = rangeIndex;
+            }
+        });
+        return result;
+    }
+
+    // Moments relative to the first point, which keeps the sums small for clouds far from the origin.
+    void rangeMoments(const PointSpan& points, std::size_t begin, std::size_t end, double* moments)
+    {
+        PointBlock block;
+        const vec3f& origin = points[0];
+
+        for (std::size_t first = begin; first < end; first += BlockSize)
+        {
+            gather(points, first, std::min(first + BlockSize, end), block);
+
+            float sums[9] = { 0.0f };
+            const std::size_t index = momentKernel<WideLane>(block, origin, sums, 0);
+            momentKernel<ScalarLane>(block, origin, sums, index);
+
+            for (int i = 0; i < 9; ++i)
+                moments[i] += sums[i];
+        }
+    }
+
+    void rangeExtents(const PointSpan& points, std::size_t begin, std::size_t end, const vec3f* axes, float* low, float* high)
+    {
+        PointBlock block;
+        float projections[BlockSize];
+
+        for (std::size_t first = begin; first < end; first += BlockSize)
+        {
+            gather(points, first, std::min(first + BlockSize, end), block);
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const std::size_t index = projectKernel<WideLane>(block, axes[axis], projections, 0);
+                projectKernel<ScalarLane>(block, axes[axis], projections, index);
+
+                low[axis] = std::min(low[axis], nx::priv::soaReduceMin(projections, block.count));
+                high[axis] = std::max(high[axis], nx::priv::soaReduceMax(projections, block.count));
+            }
+        }
+    }
+
+    // Sphere through 1 to 4 points, false when they are degenerate.
+    bool circumsphere(const vec3f* points, int count, vec3f& center, float& radius)
+    {
+        if (count == 1)
+        {
+            center = points[0];
+        }
+        else if (count == 2)
+        {
+            center = vec3f::lerp(points[0], points[1], 0.5f);
+        }
+        else if (count == 3)
+        {
+            const vec3f a = points[1] - points[0];
+            const vec3f b = points[2] - points[0];
+            const vec3f normal = vec3f::cross(a, b);
+            const float denominator = 2.0f * normal.lengthSquared();
+
+            if (denominator <= 1e-12f * a.lengthSquared() * b.lengthSquared())
+                return false;
+
+            center = points[0] + (vec3f::cross(normal, a) * b.lengthSquared() + vec3f::cross(b, normal) * a.lengthSquared()) * (1.0f / denominator);
+        }
+        else
+        {
+            const vec3f a = points[1] - points[0];
+            const vec3f b = points[2] - points[0];
+            const vec3f c = points[3] - points[0];
+            const float determinant = 2.0f * vec3f::dot(a, vec3f::cross(b, c));
+
+            if (std::fabs(determinant) <= 1e-6f * a.length() * b.length() * c.length())
+                return false;
+
+            center = points[0] + (vec3f::cross(b, c) * a.lengthSquared() +
+                                  vec3f::cross(c, a) * b.lengthSquared() +
+                                  vec3f::cross(a, b) * c.lengthSquared()) * (1.0f / determinant);
+        }
+
+        radius = 0.0f;
+        for (int i = 0; i < count; ++i)
+            radius = std::max(radius, vec3f::distance(center, points[i]));
+        return true;
+    }
+
+    // Smallest sphere holding at most 5 points, every subset of 4 or fewer is
+    // tried as its boundary. The support is rewritten with the winning subset.
+    bool solveSupport(vec3f* support, int& count, vec3f& center, float& radius)
+    {
+        vec3f subset[4];
+        vec3f best[4];
+        int bestCount = 0;
+        float bestRadius = std::numeric_limits<float>::max();
+
+        for (int mask = 1; mask < (1 << count); ++mask)
+        {
+            int subsetCount = 0;
+            for (int i = 0; i < count && subsetCount <= 4; ++i)
+            {
+                if (mask & (1 << i))
+                {
+                    if (subsetCount < 4)
+                        subset[subsetCount] = support[i];
+                    ++subsetCount;
+                }
+            }
+
+            vec3f subsetCenter;
+            float subsetRadius;
+            if (subsetCount > 4 || !circumsphere(subset, subsetCount, subsetCenter, subsetRadius) || subsetRadius >= bestRadius)
+                continue;
+
+            const float limit = subsetRadius * (1.0f + SupportTolerance);
+            bool holdsAll = true;
+            for (int i = 0; i < count && holdsAll; ++i)
+                holdsAll = vec3f::distance(subsetCenter, support[i]) <= limit;
+
+            if (holdsAll)
+            {
+                std::copy(subset, subset + subsetCount, best);
+                bestCount = subsetCount;
+                bestRadius = subsetRadius;
+                center = subsetCenter;
+            }
+        }
+
+        if (bestCount == 0)
+            return false;
+
+        std::copy(best, best + bestCount, support);
+        count = bestCount;
+        radius = bestRadius;
+        return true;
+    }
+}
+
+namespace nx
+{
+namespace priv
+{
+
+void pointBounds(const PointSpan& points, vec3f& min, vec3f& max, JobSystem* jobs)
+{
+    if (points.count == 0)
+    {
+        min = max = vec3f();
+        return;
+    }
+
+    min = max = points[0];
+    std::mutex mutex;
+
+    parallelRange(jobs, points.count, PointCloudParallelSize, [&](std::size_t begin, std::size_t end)
+    {
+        vec3f low;
+        vec3f high;
+        rangeBounds(points, begin, end, low, high);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        min = vec3f::min(min, low);
+        max = vec3f::max(max, high);
+    });
+}
+
+Sphere pointRitterSphere(const PointSpan& points, JobSystem* jobs)
+{
+    if (points.count == 0)
+        return Sphere();
+
+    Extremes extremes = rangeExtremes(points, 0, 1);
+    std::mutex mutex;
+
+    parallelRange(jobs, points.count, PointCloudParallelSize, [&](std::size_t begin, std::size_t end)
+    {
+        const Extremes range = rangeExtremes(points, begin, end);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        extremes.merge(range);
+    });
+
+    // Start from the most distant pair of opposite extremes.
+    int axis = 0;
+    float distances[3];
+    for (int i = 0; i < 3; ++i)
+        distances[i] = vec3f::distance(points[extremes.index[i * 2]], points[extremes.index[i * 2 + 1]]);
+
+    if (distances[0] > distances[1])
+        axis = distances[0] > distances[2] ? 0 : 2;
+    else
+        axis = distances[1] > distances[2] ? 1 : 2;
+
+    const vec3f center = vec3f::lerp(points[extremes.index[axis * 2]], points[extremes.index[axis * 2 + 1]], 0.5f);
+    const float radius = distances[axis] * 0.5f;
+
+    // Every range grows its own copy, the copies all hold the start sphere so merging them stays tight.
+    Sphere result(center, radius);
+
+    parallelRange(jobs, points.count, PointCloudParallelSize, [&](std::size_t begin, std::size_t end)
+    {
+        vec3f rangeCenter = center;
+        float rangeRadius = radius;
+        grow(points, begin, end, rangeCenter, rangeRadius);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        result = Sphere::createMerged(result, Sphere(rangeCenter, rangeRadius));
+    });
+
+    return result;
+}
+
+Sphere pointMinimalSphere(const PointSpan& points, JobSystem* jobs)
+{
+    if (points.count == 0)
+        return Sphere();
+
+    // Welzl's recursion only ever runs on the support set plus the furthest
+    // point (Gaertner's pivoting), the radius grows with every pass and the
+    // input is read in place instead of being shuffled.
+    vec3f support[5] = { points[0] };
+    int supportCount = 1;
+
+    vec3f center = points[0];
+    float radius = 0.0f;
+
+    for (int pass = 0; ; ++pass)
+    {
+        std::size_t index = 0;
+        const float distance = std::sqrt(furthest(jobs, points, center, index));
+
+        if (distance <= radius * (1.0f + MinimalSphereTolerance) || pass == MinimalSphereMaxPasses)
+        {
+            radius = std::max(radius, distance);
+            break;
+        }
+
+        vec3f nextSupport[5];
+        std::copy(support, support + supportCount, nextSupport);
+        nextSupport[supportCount] = points[index];
+
+        int nextCount = supportCount + 1;
+        vec3f nextCenter;
+        float nextRadius;
+
+        // Rounding can leave no progress to make, the current sphere is then grown to the furthest point.
+        if (!solveSupport(nextSupport, nextCount, nextCenter, nextRadius) || nextRadius <= radius)
+        {
+            radius = std::max(radius, distance);
+            break;
+        }
+
+        std::copy(nextSupport, nextSupport + nextCount, support);
+        supportCount = nextCount;
+        center = nextCenter;
+        radius = nextRadius;
+    }
+
+    return Sphere(center, radius);
+}
+
+void pointCovariance(const PointSpan& points, vec3f& mean, float* covariance, JobSystem* jobs)
+{
+    if (points.count == 0)
+    {
+        mean = vec3f();
+        std::fill(covariance, covariance + 6, 0.0f);
+        return;
+    }
+
+    double moments[9] = { 0.0 };
+    std::mutex mutex;
+
+    parallelRange(jobs, points.count, PointCloudParallelSize, [&](std::size_t begin, std::size_t end)
+    {
+        double range[9] = { 0.0 };
+        rangeMoments(points, begin, end, range);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < 9; ++i)
+            moments[i] += range[i];
+    });
+
+    const double count = static_cast<double>(points.count);
+    const double x = moments[0] / count;
+    const double y = moments[1] / count;
+    const double z = moments[2] / count;
+
+    mean = points[0] + vec3f(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z));
+
+    covariance[0] = static_cast<float>(moments[3] / count - x * x);
+    covariance[1] = static_cast<float>(moments[4] / count - x * y);
+    covariance[2] = static_cast<float>(moments[5] / count - x * z);
+    covariance[3] = static_cast<float>(moments[6] / count - y * y);
+    covariance[4] = static_cast<float>(moments[7] / count - y * z);
+    covariance[5] = static_cast<float>(moments[8] / count - z * z);
+}
+
+void pointExtents(const PointSpan& points, const vec3f* axes, vec3f& min, vec3f& max, JobSystem* jobs)
+{
+    if (points.count == 0)
+    {
+        min = max = vec3f();
+        return;
+    }
+
+    // Every range starts from the first point, low and high are only touched under the lock.
+    const float first[3] = { vec3f::dot(points[0], axes[0]), vec3f::dot(points[0], axes[1]), vec3f::dot(points[0], axes[2]) };
+
+    float low[3] = { first[0], first[1], first[2] };
+    float high[3] = { first[0], first[1], first[2] };
+    std::mutex mutex;
+
+    parallelRange(jobs, points.count, PointCloudParallelSize, [&](std::size_t begin, std::size_t end)
+    {
+        float rangeLow[3] = { first[0], first[1], first[2] };
+        float rangeHigh[3] = { first[0], first[1], first[2] };
+        rangeExtents(points, begin, end, axes, rangeLow, rangeHigh);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            low[axis] = std::min(low[axis], rangeLow[axis]);
+            high[axis] = std::max(high[axis], rangeHigh[axis]);
+        }
+    });
+
+    min = vec3f(low[0], low[1], low[2]);
+    max = vec3f(high[0], high[1], high[2]);
+}
+
+} // namespace priv
+} // namespace nx
@@ -0,0 +1,62 @@
+#ifndef POINTCLOUD_H_INCLUDE
+#define POINTCLOUD_H_INCLUDE
+
+// Nex includes.
+#include <nex/math/vec3.h>
+
+// Standard includes.
+#include <cstddef>
+
+/*
+ * Bounding volume builders over point clouds that are read in place. The
+ * points may be spread through larger vertices, they are addressed with a
+ * byte stride and never copied. Given a job system, clouds of
+ * PointCloudParallelSize points or more are split between its threads.
+ */
+
+namespace nx
+{
+class Sphere;
+class JobSystem;
+
+namespace priv
+{
+
+/**
+ * @brief The smallest cloud worth splitting between threads.
+ */
+const std::size_t PointCloudParallelSize = 1 << 18;
+
+/**
+ * @brief A non owning view of points separated by a byte stride.
+ */
+struct PointSpan
+{
+    PointSpan(const vec3f* points, std::size_t count, std::size_t stride) :
+        data(reinterpret_cast<const char*>(points)),
+        count(count),
+        stride(stride)
+    { }
+
+    const vec3f& operator[](std::size_t index) const { return *reinterpret_cast<const vec3f*>(data + index * stride); }
+
+    const char* data;
+    std::size_t count;
+    std::size_t stride;
+};
+
+// Every builder runs on the calling thread when jobs is 0.
+void pointBounds(const PointSpan& points, vec3f& min, vec3f& max, JobSystem* jobs);
+Sphere pointRitterSphere(const PointSpan& points, JobSystem* jobs);
+Sphere pointMinimalSphere(const PointSpan& points, JobSystem* jobs);
+
+// Mean and covariance matrix of the points, the covariance as xx, xy, xz, yy, yz and zz.
+void pointCovariance(const PointSpan& points, vec3f& mean, float* covariance, JobSystem* jobs);
+
+// Smallest and largest projection of the points on each of three axes.
+void pointExtents(const PointSpan& points, const vec3f* axes, vec3f& min, vec3f& max, JobSystem* jobs);
+
+} // namespace priv
+} // namespace nx
+
+#endif // POINTCLOUD_H_INCLUDE
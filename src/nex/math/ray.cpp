@@ -152,6 +152,16 @@ float Ray::intersects(const AABB& boundingBox) const
     return result;
 }
 
+float Ray::intersects(const OBB& box) const
+{
+    // Slab test in the frame of the box, where it is an AABB around the origin.
+    const vec3f offset = position - box.center;
+    const Ray local(vec3f(vec3f::dot(offset, box.axes[0]), vec3f::dot(offset, box.axes[1]), vec3f::dot(offset, box.axes[2])),
+                    vec3f(vec3f::dot(direction, box.axes[0]), vec3f::dot(direction, box.axes[1]), vec3f::dot(direction, box.axes[2])));
+
+    return local.intersects(AABB(-box.halfExtents, box.halfExtents));
+}
+
 vec3f Ray::computeIntersection(const Plane& plane) const
 {
     const float distance = (-plane.distance - vec3f::dot(plane.normal, position)) / vec3f::dot(plane.normal, direction);
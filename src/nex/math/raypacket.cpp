@@ -0,0 +1,295 @@
+#include <nex/math/raypacket.h>
+#include <nex/math/simdlane.h>
+#include <nex/math/trianglekernel.h>
+
+// Standard includes.
+#include <cmath>
+
+namespace
+{
+    // The register that holds a whole packet, or as much of it as fits.
+    template <std::size_t Size>
+    struct PacketLane
+    {
+        typedef nx::priv::WideLane Type;
+    };
+
+    template <>
+    struct PacketLane<4>
+    {
+#if defined(NEX_SIMD_SSE)
+        typedef nx::priv::SseLane Type;
+#else
+        typedef nx::priv::ScalarLane Type;
+#endif
+    };
+
+    const float Infinity = std::numeric_limits<float>::infinity();
+
+    // Rays closer to parallel than this miss a plane, as in Ray::intersects.
+    const float ParallelEpsilon = 1e-5f;
+
+    // Slab test of the lanes [lane, lane + Width), returns the miss mask and the entry distances.
+    template <typename Lane, std::size_t Size>
+    typename Lane::Type slab(const float (*origin)[Size], const float (*inverse)[Size], const float* maxDistance, std::size_t lane,
+                             const float* min, const float* max, typename Lane::Type& entry)
+    {
+        typedef typename Lane::Type Type;
+
+        Type near = Lane::set(0.0f);
+        Type far = Lane::loadUnaligned(maxDistance + lane);
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const Type rayOrigin = Lane::loadUnaligned(origin[axis] + lane);
+            const Type rayInverse = Lane::loadUnaligned(inverse[axis] + lane);
+
+            const Type t0 = Lane::mul(Lane::sub(Lane::set(min[axis]), rayOrigin), rayInverse);
+            const Type t1 = Lane::mul(Lane::sub(Lane::set(max[axis]), rayOrigin), rayInverse);
+
+            near = Lane::max(near, Lane::min(t0, t1));
+            far = Lane::min(far, Lane::max(t0, t1));
+        }
+
+        entry = near;
+        return Lane::greater(near, far);
+    }
+}
+
+namespace nx
+{
+
+template <std::size_t Size>
+RayPacket<Size>::RayPacket()
+{
+    for (std::size_t lane = 0; lane < Size; ++lane)
+        set(lane, Ray(vec3f(), vec3f(0.0f, 0.0f, 1.0f)), -1.0f);
+}
+
+template <std::size_t Size>
+RayPacket<Size>::RayPacket(const Ray* rays, std::size_t count, float maxDistance)
+{
+    for (std::size_t lane = 0; lane < Size; ++lane)
+    {
+        if (lane < count)
+            set(lane, rays[lane], maxDistance);
+        else
+            set(lane, Ray(vec3f(), vec3f(0.0f, 0.0f, 1.0f)), -1.0f);
+    }
+}
+
+template <std::size_t Size>
+void RayPacket<Size>::set(std::size_t lane, const Ray& ray, float maxDistance)
+{
+    const float origin[3] = { ray.position.x, ray.position.y, ray.position.z };
+    const float direction[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        mOrigin[axis][lane] = origin[axis];
+        mDirection[axis][lane] = direction[axis];
+
+        // Tiny directions keep a huge but finite inverse so an origin lying on
+        // a slab gives 0 instead of 0 * infinity.
+        const float clamped = std::fabs(direction[axis]) < 1e-20f ? (direction[axis] < 0.0f ? -1e-20f : 1e-20f) : direction[axis];
+        mInverseDirection[axis][lane] = 1.0f / clamped;
+    }
+
+    mMaxDistance[lane] = maxDistance;
+}
+
+template <std::size_t Size>
+Ray RayPacket<Size>::get(std::size_t lane) const
+{
+    return Ray(vec3f(mOrigin[0][lane], mOrigin[1][lane], mOrigin[2][lane]),
+               vec3f(mDirection[0][lane], mDirection[1][lane], mDirection[2][lane]));
+}
+
+template <std::size_t Size>
+uint32 RayPacket<Size>::getActiveMask() const
+{
+    uint32 mask = 0;
+    for (std::size_t lane = 0; lane < Size; ++lane)
+        mask |= (mMaxDistance[lane] >= 0.0f ? 1u : 0u) << lane;
+    return mask;
+}
+
+template <std::size_t Size>
+uint32 RayPacket<Size>::intersects(const float* min, const float* max, float* distances) const
+{
+    typedef typename PacketLane<Size>::Type Lane;
+    typedef typename Lane::Type Type;
+
+    uint32 miss = 0;
+    for (std::size_t lane = 0; lane < Size; lane += Lane::Width)
+    {
+        Type entry;
+        const Type laneMiss = slab<Lane, Size>(mOrigin, mInverseDirection, mMaxDistance, lane, min, max, entry);
+
+        Lane::storeUnaligned(distances + lane, Lane::select(laneMiss, entry, Lane::set(Infinity)));
+        miss |= static_cast<uint32>(Lane::moveMask(laneMiss)) << lane;
+    }
+
+    return ~miss & FullMask;
+}
+
+template <std::size_t Size>
+uint32 RayPacket<Size>::intersects(const AABB& box, float* distances) const
+{
+    const float min[3] = { box.min.x, box.min.y, box.min.z };
+    const float max[3] = { box.max.x, box.max.y, box.max.z };
+    return intersects(min, max, distances);
+}
+
+template <std::size_t Size>
+uint32 RayPacket<Size>::intersects(const AABB* boxes, std::size_t count, float* distances, uint32* indices) const
+{
+    typedef typename PacketLane<Size>::Type Lane;
+    typedef typename Lane::Type Type;
+
+    uint32 hits = 0;
+    for (std::size_t lane = 0; lane < Size; lane += Lane::Width)
+    {
+        Type closest = Lane::set(Infinity);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const float min[3] = { boxes[i].min.x, boxes[i].min.y, boxes[i].min.z };
+            const float max[3] = { boxes[i].max.x, boxes[i].max.y, boxes[i].max.z };
+
+            Type entry;
+            const Type miss = slab<Lane, Size>(mOrigin, mInverseDirection, mMaxDistance, lane, min, max, entry);
+            const Type closer = Lane::less(Lane::select(miss, entry, Lane::set(Infinity)), closest);
+
+            int mask = Lane::moveMask(closer);
+            if (mask == 0)
+                continue;
+
+            closest = Lane::select(closer, closest, entry);
+            for (std::size_t bit = lane; mask != 0; ++bit, mask >>= 1)
+            {
+                if (mask & 1)
+                    indices[bit] = static_cast<uint32>(i);
+            }
+        }
+
+        Lane::storeUnaligned(distances + lane, closest);
+        hits |= static_cast<uint32>(Lane::moveMask(Lane::less(closest, Lane::set(Infinity)))) << lane;
+    }
+
+    return hits;
+}
+
+template <std::size_t Size>
+uint32 RayPacket<Size>::intersects(const Sphere& sphere, float* distances) const
+{
+    typedef typename PacketLane<Size>::Type Lane;
+    typedef typename Lane::Type Type;
+
+    const Type radiusSquared = Lane::set(sphere.radius * sphere.radius);
+    const Type center[3] = { Lane::set(sphere.center.x), Lane::set(sphere.center.y), Lane::set(sphere.center.z) };
+
+    uint32 miss = 0;
+    for (std::size_t lane = 0; lane < Size; lane += Lane::Width)
+    {
+        Type distanceSquared = Lane::set(0.0f);
+        Type projection = Lane::set(0.0f);
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const Type delta = Lane::sub(center[axis], Lane::loadUnaligned(mOrigin[axis] + lane));
+            distanceSquared = Lane::multiplyAdd(delta, delta, distanceSquared);
+            projection = Lane::multiplyAdd(delta, Lane::loadUnaligned(mDirection[axis] + lane), projection);
+        }
+
+        // Origins inside the sphere hit at 0, the others need the sphere in
+        // front of them and the ray closer to the center than the radius.
+        const Type outside = Lane::greater(distanceSquared, radiusSquared);
+        const Type discriminant = Lane::sub(radiusSquared, Lane::sub(distanceSquared, Lane::mul(projection, projection)));
+
+        Type laneMiss = Lane::maskAnd(outside, Lane::maskOr(Lane::less(projection, Lane::set(0.0f)),
+                                                            Lane::less(discriminant, Lane::set(0.0f))));
+
+        const Type front = Lane::sub(projection, Lane::sqrt(Lane::max(discriminant, Lane::set(0.0f))));
+        const Type distance = Lane::select(outside, Lane::set(0.0f), front);
+
+        laneMiss = Lane::maskOr(laneMiss, Lane::greater(distance, Lane::loadUnaligned(mMaxDistance + lane)));
+
+        Lane::storeUnaligned(distances + lane, Lane::select(laneMiss, distance, Lane::set(Infinity)));
+        miss |= static_cast<uint32>(Lane::moveMask(laneMiss)) << lane;
+    }
+
+    return ~miss & FullMask;
+}
+
+template <std::size_t Size>
+uint32 RayPacket<Size>::intersects(const Plane& plane, float* distances) const
+{
+    typedef typename PacketLane<Size>::Type Lane;
+    typedef typename Lane::Type Type;
+
+    const Type normal[3] = { Lane::set(plane.normal.x), Lane::set(plane.normal.y), Lane::set(plane.normal.z) };
+
+    uint32 miss = 0;
+    for (std::size_t lane = 0; lane < Size; lane += Lane::Width)
+    {
+        Type denominator = Lane::set(0.0f);
+        Type numerator = Lane::set(-plane.distance);
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            denominator = Lane::multiplyAdd(normal[axis], Lane::loadUnaligned(mDirection[axis] + lane), denominator);
+            numerator = Lane::sub(numerator, Lane::mul(normal[axis], Lane::loadUnaligned(mOrigin[axis] + lane)));
+        }
+
+        const Type distance = Lane::div(numerator, denominator);
+
+        // Parallel rays, planes behind the origin and planes past the end miss.
+        Type laneMiss = Lane::less(Lane::abs(denominator), Lane::set(ParallelEpsilon));
+        laneMiss = Lane::maskOr(laneMiss, Lane::less(distance, Lane::set(-ParallelEpsilon)));
+        laneMiss = Lane::maskOr(laneMiss, Lane::greater(distance, Lane::loadUnaligned(mMaxDistance + lane)));
+
+        const Type clamped = Lane::max(distance, Lane::set(0.0f));
+
+        Lane::storeUnaligned(distances + lane, Lane::select(laneMiss, clamped, Lane::set(Infinity)));
+        miss |= static_cast<uint32>(Lane::moveMask(laneMiss)) << lane;
+    }
+
+    return ~miss & FullMask;
+}
+
+template <std::size_t Size>
+uint32 RayPacket<Size>::intersects(const vec3f& vertexA, const vec3f& vertexB, const vec3f& vertexC, float* distances, float* u, float* v) const
+{
+    typedef typename PacketLane<Size>::Type Lane;
+    typedef typename Lane::Type Type;
+
+    const Type a[3] = { Lane::set(vertexA.x), Lane::set(vertexA.y), Lane::set(vertexA.z) };
+    const Type b[3] = { Lane::set(vertexB.x), Lane::set(vertexB.y), Lane::set(vertexB.z) };
+    const Type c[3] = { Lane::set(vertexC.x), Lane::set(vertexC.y), Lane::set(vertexC.z) };
+
+    uint32 miss = 0;
+    for (std::size_t lane = 0; lane < Size; lane += Lane::Width)
+    {
+        const Type origin[3] = { Lane::loadUnaligned(mOrigin[0] + lane), Lane::loadUnaligned(mOrigin[1] + lane), Lane::loadUnaligned(mOrigin[2] + lane) };
+        const Type direction[3] = { Lane::loadUnaligned(mDirection[0] + lane), Lane::loadUnaligned(mDirection[1] + lane), Lane::loadUnaligned(mDirection[2] + lane) };
+
+        Type distance;
+        Type laneU;
+        Type laneV;
+        const Type laneMiss = priv::intersectTriangles<Lane>(origin, direction, a, b, c, Lane::loadUnaligned(mMaxDistance + lane),
+                                                             distance, laneU, laneV);
+
+        Lane::storeUnaligned(distances + lane, Lane::select(laneMiss, distance, Lane::set(Infinity)));
+        Lane::storeUnaligned(u + lane, laneU);
+        Lane::storeUnaligned(v + lane, laneV);
+        miss |= static_cast<uint32>(Lane::moveMask(laneMiss)) << lane;
+    }
+
+    return ~miss & FullMask;
+}
+
+template class RayPacket<4>;
+template class RayPacket<8>;
+
+} // namespace nx
@@ -0,0 +1,180 @@
+#ifndef SIMDLANE_H_INCLUDE
+#define SIMDLANE_H_INCLUDE
+
+// Nex includes.
+#include <nex/math/simd.h>
+
+// Standard includes.
+#include <cmath>
+#include <cstddef>
+
+/*
+ * Thin wrappers that give the scalar, SSE and AVX registers the same
+ * interface so a kernel is written once as a template over the lane type:
+ *
+ *     index = kernel<WideLane>(data, 0, count);
+ *     kernel<ScalarLane>(data, index, count);
+ *
+ * Comparisons return a mask in the same lane type; moveMask packs the sign
+ * bit of every element into an int, one bit per element.
+ */
+
+namespace nx
+{
+namespace priv
+{
+
+struct ScalarLane
+{
+    typedef float Type;
+    enum { Width = 1 };
+
+    static Type load(const float* data) { return *data; }
+    static Type loadUnaligned(const float* data) { return *data; }
+    static void store(float* data, Type value) { *data = value; }
+    static void storeUnaligned(float* data, Type value) { *data = value; }
+    static Type set(float value) { return value; }
+
+    static Type add(Type a, Type b) { return a + b; }
+    static Type sub(Type a, Type b) { return a - b; }
+    static Type mul(Type a, Type b) { return a * b; }
+    static Type div(Type a, Type b) { return a / b; }
+    static Type multiplyAdd(Type a, Type b, Type c) { return a * b + c; }
+    static Type min(Type a, Type b) { return a < b ? a : b; }
+    static Type max(Type a, Type b) { return a > b ? a : b; }
+    static Type abs(Type a) { return std::fabs(a); }
+    static Type sqrt(Type a) { return std::sqrt(a); }
+
+    static Type greater(Type a, Type b) { return a > b ? 1.0f : 0.0f; }
+    static Type less(Type a, Type b) { return a < b ? 1.0f : 0.0f; }
+    static Type maskOr(Type a, Type b) { return (a != 0.0f || b != 0.0f) ? 1.0f : 0.0f; }
+    static Type maskAnd(Type a, Type b) { return (a != 0.0f && b != 0.0f) ? 1.0f : 0.0f; }
+    static Type select(Type mask, Type a, Type b) { return mask != 0.0f ? b : a; }
+    static int moveMask(Type mask) { return mask != 0.0f ? 1 : 0; }
+
+    static float reduceAdd(Type a) { return a; }
+    static float reduceMin(Type a) { return a; }
+    static float reduceMax(Type a) { return a; }
+};
+
+#if defined(NEX_SIMD_SSE)
+struct SseLane
+{
+    typedef __m128 Type;
+    enum { Width = 4 };
+
+    static Type load(const float* data) { return _mm_load_ps(data); }
+    static Type loadUnaligned(const float* data) { return _mm_loadu_ps(data); }
+    static void store(float* data, Type value) { _mm_store_ps(data, value); }
+    static void storeUnaligned(float* data, Type value) { _mm_storeu_ps(data, value); }
+    static Type set(float value) { return _mm_set1_ps(value); }
+
+    static Type add(Type a, Type b) { return _mm_add_ps(a, b); }
+    static Type sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+    static Type mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+    static Type div(Type a, Type b) { return _mm_div_ps(a, b); }
+#if defined(NEX_SIMD_AVX2)
+    static Type multiplyAdd(Type a, Type b, Type c) { return _mm_fmadd_ps(a, b, c); }
+#else
+    static Type multiplyAdd(Type a, Type b, Type c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#endif
+    static Type min(Type a, Type b) { return _mm_min_ps(a, b); }
+    static Type max(Type a, Type b) { return _mm_max_ps(a, b); }
+    static Type abs(Type a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static Type sqrt(Type a) { return _mm_sqrt_ps(a); }
+
+    static Type greater(Type a, Type b) { return _mm_cmpgt_ps(a, b); }
+    static Type less(Type a, Type b) { return _mm_cmplt_ps(a, b); }
+    static Type maskOr(Type a, Type b) { return _mm_or_ps(a, b); }
+    static Type maskAnd(Type a, Type b) { return _mm_and_ps(a, b); }
+    static Type select(Type mask, Type a, Type b) { return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a)); }
+    static int moveMask(Type mask) { return _mm_movemask_ps(mask); }
+
+    static float reduceAdd(Type a)
+    {
+        a = _mm_add_ps(a, _mm_movehl_ps(a, a));
+        a = _mm_add_ss(a, _mm_shuffle_ps(a, a, 0x55));
+        return _mm_cvtss_f32(a);
+    }
+
+    static float reduceMin(Type a)
+    {
+        a = _mm_min_ps(a, _mm_movehl_ps(a, a));
+        a = _mm_min_ss(a, _mm_shuffle_ps(a, a, 0x55));
+        return _mm_cvtss_f32(a);
+    }
+
+    static float reduceMax(Type a)
+    {
+        a = _mm_max_ps(a, _mm_movehl_ps(a, a));
+        a = _mm_max_ss(a, _mm_shuffle_ps(a, a, 0x55));
+        return _mm_cvtss_f32(a);
+    }
+};
+#endif
+
+#if defined(NEX_SIMD_AVX)
+struct AvxLane
+{
+    typedef __m256 Type;
+    enum { Width = 8 };
+
+    static Type load(const float* data) { return _mm256_load_ps(data); }
+    static Type loadUnaligned(const float* data) { return _mm256_loadu_ps(data); }
+    static void store(float* data, Type value) { _mm256_store_ps(data, value); }
+    static void storeUnaligned(float* data, Type value) { _mm256_storeu_ps(data, value); }
+    static Type set(float value) { return _mm256_set1_ps(value); }
+
+    static Type add(Type a, Type b) { return _mm256_add_ps(a, b); }
+    static Type sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+    static Type mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+    static Type div(Type a, Type b) { return _mm256_div_ps(a, b); }
+#if defined(NEX_SIMD_AVX2)
+    static Type multiplyAdd(Type a, Type b, Type c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+    static Type multiplyAdd(Type a, Type b, Type c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+    static Type min(Type a, Type b) { return _mm256_min_ps(a, b); }
+    static Type max(Type a, Type b) { return _mm256_max_ps(a, b); }
+    static Type abs(Type a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static Type sqrt(Type a) { return _mm256_sqrt_ps(a); }
+
+    static Type greater(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Type less(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static Type maskOr(Type a, Type b) { return _mm256_or_ps(a, b); }
+    static Type maskAnd(Type a, Type b) { return _mm256_and_ps(a, b); }
+    static Type select(Type mask, Type a, Type b) { return _mm256_blendv_ps(a, b, mask); }
+    static int moveMask(Type mask) { return _mm256_movemask_ps(mask); }
+
+    static float reduceAdd(Type a)
+    {
+        return SseLane::reduceAdd(_mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1)));
+    }
+
+    static float reduceMin(Type a)
+    {
+        return SseLane::reduceMin(_mm_min_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1)));
+    }
+
+    static float reduceMax(Type a)
+    {
+        return SseLane::reduceMax(_mm_max_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1)));
+    }
+};
+#endif
+
+/**
+ * @brief The widest lane type available for this build.
+ */
+#if defined(NEX_SIMD_AVX)
+typedef AvxLane WideLane;
+#elif defined(NEX_SIMD_SSE)
+typedef SseLane WideLane;
+#else
+typedef ScalarLane WideLane;
+#endif
+
+} // namespace priv
+} // namespace nx
+
+#endif // SIMDLANE_H_INCLUDE
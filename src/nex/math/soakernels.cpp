@@ -0,0 +1,239 @@
+#include <nex/math/soakernels.h>
+#include <nex/math/simdlane.h>
+
+// Standard includes.
+#include <limits>
+
+namespace
+{
+    using nx::priv::ScalarLane;
+    using nx::priv::WideLane;
+
+    // Every kernel processes [index, count) in steps of Lane::Width and returns
+    // where it stopped, the scalar instantiation then finishes the tail.
+
+    template <typename Lane>
+    std::size_t minKernel(const float* a, const float* b, float* result, std::size_t index, std::size_t count)
+    {
+        for (; index + Lane::Width <= count; index += Lane::Width)
+            Lane::storeUnaligned(result + index, Lane::min(Lane::loadUnaligned(a + index), Lane::loadUnaligned(b + index)));
+        return index;
+    }
+
+    template <typename Lane>
+    std::size_t maxKernel(const float* a, const float* b, float* result, std::size_t index, std::size_t count)
+    {
+        for (; index + Lane::Width <= count; index += Lane::Width)
+            Lane::storeUnaligned(result + index, Lane::max(Lane::loadUnaligned(a + index), Lane::loadUnaligned(b + index)));
+        return index;
+    }
+
+    template <typename Lane>
+    std::size_t lerpKernel(const float* a, const float* b, float amount, float* result, std::size_t index, std::size_t count)
+    {
+        const typename Lane::Type factor = Lane::set(amount);
+
+        for (; index + Lane::Width <= count; index += Lane::Width)
+        {
+            const typename Lane::Type previous = Lane::loadUnaligned(a + index);
+            const typename Lane::Type current = Lane::loadUnaligned(b + index);
+            Lane::storeUnaligned(result + index, Lane::multiplyAdd(Lane::sub(current, previous), factor, previous));
+        }
+        return index;
+    }
+
+    template <typename Lane>
+    std::size_t dotKernel(const float* const* a, const float* const* b, std::size_t components,
+                          float* result, std::size_t index, std::size_t count)
+    {
+        for (; index + Lane::Width <= count; index += Lane::Width)
+        {
+            typename Lane::Type sum = Lane::mul(Lane::loadUnaligned(a[0] + index), Lane::loadUnaligned(b[0] + index));
+            for (std::size_t component = 1; component < components; ++component)
+                sum = Lane::multiplyAdd(Lane::loadUnaligned(a[component] + index), Lane::loadUnaligned(b[component] + index), sum);
+
+            Lane::storeUnaligned(result + index, sum);
+        }
+        return index;
+    }
+
+    template <typename Lane>
+    std::size_t lengthKernel(const float* const* data, std::size_t components, float* result, std::size_t index, std::size_t count)
+    {
+        for (; index + Lane::Width <= count; index += Lane::Width)
+        {
+            typename Lane::Type sum = Lane::set(0.0f);
+            for (std::size_t component = 0; component < components; ++component)
+            {
+                const typename Lane::Type value = Lane::loadUnaligned(data[component] + index);
+                sum = Lane::multiplyAdd(value, value, sum);
+            }
+
+            Lane::storeUnaligned(result + index, Lane::sqrt(sum));
+        }
+        return index;
+    }
+
+    template <typename Lane>
+    std::size_t normalizeKernel(float* const* data, std::size_t components, std::size_t index, std::size_t count)
+    {
+        const typename Lane::Type one = Lane::set(1.0f);
+
+        for (; index + Lane::Width <= count; index += Lane::Width)
+        {
+            typename Lane::Type sum = Lane::set(0.0f);
+            for (std::size_t component = 0; component < components; ++component)
+            {
+                const typename Lane::Type value = Lane::loadUnaligned(data[component] + index);
+                sum = Lane::multiplyAdd(value, value, sum);
+            }
+
+            // Same as Vec3::normalize, a zero vector is left to produce NaNs.
+            const typename Lane::Type scale = Lane::div(one, Lane::sqrt(sum));
+            for (std::size_t component = 0; component < components; ++component)
+                Lane::storeUnaligned(data[component] + index, Lane::mul(Lane::loadUnaligned(data[component] + index), scale));
+        }
+        return index;
+    }
+
+    template <typename Lane>
+    std::size_t crossKernel(const float* const* a, const float* const* b, float* const* result, std::size_t index, std::size_t count)
+    {
+        for (; index + Lane::Width <= count; index += Lane::Width)
+        {
+            const typename Lane::Type ax = Lane::loadUnaligned(a[0] + index);
+            const typename Lane::Type ay = Lane::loadUnaligned(a[1] + index);
+            const typename Lane::Type az = Lane::loadUnaligned(a[2] + index);
+            const typename Lane::Type bx = Lane::loadUnaligned(b[0] + index);
+            const typename Lane::Type by = Lane::loadUnaligned(b[1] + index);
+            const typename Lane::Type bz = Lane::loadUnaligned(b[2] + index);
+
+            // Everything is loaded before storing so result may alias a or b.
+            Lane::storeUnaligned(result[0] + index, Lane::sub(Lane::mul(ay, bz), Lane::mul(az, by)));
+            Lane::storeUnaligned(result[1] + index, Lane::sub(Lane::mul(az, bx), Lane::mul(ax, bz)));
+            Lane::storeUnaligned(result[2] + index, Lane::sub(Lane::mul(ax, by), Lane::mul(ay, bx)));
+        }
+        return index;
+    }
+
+    struct MinOperation
+    {
+        template <typename Lane>
+        static typename Lane::Type apply(typename Lane::Type a, typename Lane::Type b) { return Lane::min(a, b); }
+
+        template <typename Lane>
+        static float reduce(typename Lane::Type a) { return Lane::reduceMin(a); }
+    };
+
+    struct MaxOperation
+    {
+        template <typename Lane>
+        static typename Lane::Type apply(typename Lane::Type a, typename Lane::Type b) { return Lane::max(a, b); }
+
+        template <typename Lane>
+        static float reduce(typename Lane::Type a) { return Lane::reduceMax(a); }
+    };
+
+    struct AddOperation
+    {
+        template <typename Lane>
+        static typename Lane::Type apply(typename Lane::Type a, typename Lane::Type b) { return Lane::add(a, b); }
+
+        template <typename Lane>
+        static float reduce(typename Lane::Type a) { return Lane::reduceAdd(a); }
+    };
+
+    // Horizontal reduction, two accumulators hide the latency of the operation.
+    template <typename Operation>
+    float reduce(const float* data, std::size_t count, float identity)
+    {
+        typedef WideLane Lane;
+
+        std::size_t index = 0;
+        float result = identity;
+
+        if (count >= 2 * Lane::Width)
+        {
+            Lane::Type first = Lane::loadUnaligned(data);
+            Lane::Type second = Lane::loadUnaligned(data + Lane::Width);
+
+            for (index = 2 * Lane::Width; index + 2 * Lane::Width <= count; index += 2 * Lane::Width)
+            {
+                first = Operation::template apply<Lane>(first, Lane::loadUnaligned(data + index));
+                second = Operation::template apply<Lane>(second, Lane::loadUnaligned(data + index + Lane::Width));
+            }
+
+            result = Operation::template reduce<Lane>(Operation::template apply<Lane>(first, second));
+        }
+
+        for (; index < count; ++index)
+            result = Operation::template apply<ScalarLane>(result, data[index]);
+
+        return result;
+    }
+}
+
+namespace nx
+{
+namespace priv
+{
+
+void soaMin(const float* a, const float* b, float* result, std::size_t count)
+{
+    const std::size_t index = minKernel<WideLane>(a, b, result, 0, count);
+    minKernel<ScalarLane>(a, b, result, index, count);
+}
+
+void soaMax(const float* a, const float* b, float* result, std::size_t count)
+{
+    const std::size_t index = maxKernel<WideLane>(a, b, result, 0, count);
+    maxKernel<ScalarLane>(a, b, result, index, count);
+}
+
+void soaLerp(const float* a, const float* b, float amount, float* result, std::size_t count)
+{
+    const std::size_t index = lerpKernel<WideLane>(a, b, amount, result, 0, count);
+    lerpKernel<ScalarLane>(a, b, amount, result, index, count);
+}
+
+float soaReduceMin(const float* data, std::size_t count)
+{
+    return reduce<MinOperation>(data, count, std::numeric_limits<float>::max());
+}
+
+float soaReduceMax(const float* data, std::size_t count)
+{
+    return reduce<MaxOperation>(data, count, -std::numeric_limits<float>::max());
+}
+
+float soaReduceAdd(const float* data, std::size_t count)
+{
+    return reduce<AddOperation>(data, count, 0.0f);
+}
+
+void soaDot(const float* const* a, const float* const* b, std::size_t components, float* result, std::size_t count)
+{
+    const std::size_t index = dotKernel<WideLane>(a, b, components, result, 0, count);
+    dotKernel<ScalarLane>(a, b, components, result, index, count);
+}
+
+void soaLength(const float* const* data, std::size_t components, float* result, std::size_t count)
+{
+    const std::size_t index = lengthKernel<WideLane>(data, components, result, 0, count);
+    lengthKernel<ScalarLane>(data, components, result, index, count);
+}
+
+void soaNormalize(float* const* data, std::size_t components, std::size_t count)
+{
+    const std::size_t index = normalizeKernel<WideLane>(data, components, 0, count);
+    normalizeKernel<ScalarLane>(data, components, index, count);
+}
+
+void soaCross(const float* const* a, const float* const* b, float* const* result, std::size_t count)
+{
+    const std::size_t index = crossKernel<WideLane>(a, b, result, 0, count);
+    crossKernel<ScalarLane>(a, b, result, index, count);
+}
+
+} // namespace priv
+} // namespace nx
@@ -0,0 +1,36 @@
+#ifndef SOAKERNELS_H_INCLUDE
+#define SOAKERNELS_H_INCLUDE
+
+// Standard includes.
+#include <cstddef>
+
+/*
+ * Kernels shared by the structure of arrays containers. Component wise
+ * operations run on one float array at a time, dot and normalize take an
+ * array of component pointers so the same code serves 3d and 4d vectors.
+ * None of them require aligned pointers.
+ */
+
+namespace nx
+{
+namespace priv
+{
+
+void soaMin(const float* a, const float* b, float* result, std::size_t count);
+void soaMax(const float* a, const float* b, float* result, std::size_t count);
+void soaLerp(const float* a, const float* b, float amount, float* result, std::size_t count);
+
+float soaReduceMin(const float* data, std::size_t count);
+float soaReduceMax(const float* data, std::size_t count);
+float soaReduceAdd(const float* data, std::size_t count);
+
+void soaDot(const float* const* a, const float* const* b, std::size_t components, float* result, std::size_t count);
+void soaLength(const float* const* data, std::size_t components, float* result, std::size_t count);
+void soaNormalize(float* const* data, std::size_t components, std::size_t count);
+
+void soaCross(const float* const* a, const float* const* b, float* const* result, std::size_t count);
+
+} // namespace priv
+} // namespace nx
+
+#endif // SOAKERNELS_H_INCLUDE
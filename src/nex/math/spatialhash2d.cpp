@@ -0,0 +1,229 @@
+#include <nex/math/spatialhash2d.h>
+#include <nex/math/bounds2d.h>
+
+// Standard includes.
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    std::size_t nextPowerOfTwo(std::size_t value)
+    {
+        std::size_t result = 1;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+}
+
+namespace nx
+{
+
+SpatialHash2d::SpatialHash2d(float cellSize, std::size_t bucketCount) :
+    mInvCellSize(1.0f / cellSize),
+    mBuckets(nextPowerOfTwo(std::max<std::size_t>(1, bucketCount))),
+    mFreeList(NullHandle),
+    mItemCount(0)
+{
+    clear();
+}
+
+SpatialHash2d::CellRange SpatialHash2d::toCells(float minX, float minY, float maxX, float maxY) const
+{
+    CellRange range;
+    range.minX = static_cast<int32>(std::floor(minX * mInvCellSize));
+    range.minY = static_cast<int32>(std::floor(minY * mInvCellSize));
+    range.maxX = static_cast<int32>(std::floor(maxX * mInvCellSize));
+    range.maxY = static_cast<int32>(std::floor(maxY * mInvCellSize));
+    return range;
+}
+
+std::size_t SpatialHash2d::bucket(int32 x, int32 y) const
+{
+    const uint32 hash = (static_cast<uint32>(x) * 73856093u) ^ (static_cast<uint32>(y) * 19349663u);
+    return hash & (mBuckets.size() - 1);
+}
+
+uint32 SpatialHash2d::insert(const rectf& bounds, void* userData)
+{
+    uint32 handle;
+    if (mFreeList != NullHandle)
+    {
+        handle = mFreeList;
+        mFreeList = mItems[handle].next;
+    }
+    else
+    {
+        handle = static_cast<uint32>(mItems.size());
+        mItems.push_back(Item());
+        mBoxes.resize(mBoxes.size() + 4);
+    }
+
+    Item& item = mItems[handle];
+    item.userData = userData;
+    item.next = NullHandle;
+    item.cells = store(handle, bounds);
+    ++mItemCount;
+
+    link(handle);
+    return handle;
+}
+
+void SpatialHash2d::remove(uint32 handle)
+{
+    unlink(handle);
+
+    mItems[handle].userData = 0;
+    mItems[handle].next = mFreeList;
+    mFreeList = handle;
+    --mItemCount;
+}
+
+void SpatialHash2d::update(uint32 handle, const rectf& bounds)
+{
+    const CellRange cells = store(handle, bounds);
+    const CellRange& current = mItems[handle].cells;
+
+    if (cells.minX == current.minX && cells.minY == current.minY &&
+        cells.maxX == current.maxX && cells.maxY == current.maxY)
+        return;
+
+    unlink(handle);
+    mItems[handle].cells = cells;
+    link(handle);
+}
+
+SpatialHash2d::CellRange SpatialHash2d::store(uint32 handle, const rectf& bounds)
+{
+    const priv::Bounds2d box = priv::toBounds(bounds);
+
+    mItems[handle].bounds = bounds;
+
+    float* const stored = &mBoxes[handle * 4];
+    stored[0] = box.minX;
+    stored[1] = box.minY;
+    stored[2] = box.maxX;
+    stored[3] = box.maxY;
+
+    return toCells(box.minX, box.minY, box.maxX, box.maxY);
+}
+
+void SpatialHash2d::link(uint32 handle)
+{
+    const CellRange& cells = mItems[handle].cells;
+
+    for (int32 y = cells.minY; y <= cells.maxY; ++y)
+    {
+        for (int32 x = cells.minX; x <= cells.maxX; ++x)
+        {
+            // Cells of one item that share a bucket list it once.
+            std::vector<uint32>& items = mBuckets[bucket(x, y)];
+            if (items.empty() || items.back() != handle)
+                items.push_back(handle);
+        }
+    }
+
+    mUsed.minX = std::min(mUsed.minX, cells.minX);
+    mUsed.minY = std::min(mUsed.minY, cells.minY);
+    mUsed.maxX = std::max(mUsed.maxX, cells.maxX);
+    mUsed.maxY = std::max(mUsed.maxY, cells.maxY);
+}
+
+void SpatialHash2d::unlink(uint32 handle)
+{
+    const CellRange& cells = mItems[handle].cells;
+
+    for (int32 y = cells.minY; y <= cells.maxY; ++y)
+    {
+        for (int32 x = cells.minX; x <= cells.maxX; ++x)
+        {
+            std::vector<uint32>& items = mBuckets[bucket(x, y)];
+            std::vector<uint32>::iterator it = std::find(items.begin(), items.end(), handle);
+
+            // Already gone if an earlier cell of the item shares the bucket.
+            if (it != items.end())
+            {
+                *it = items.back();
+                items.pop_back();
+            }
+        }
+    }
+}
+
+void SpatialHash2d::clear()
+{
+    for (std::size_t i = 0; i < mBuckets.size(); ++i)
+        mBuckets[i].clear();
+
+    mItems.clear();
+    mBoxes.clear();
+    mFreeList = NullHandle;
+    mItemCount = 0;
+
+    mUsed.minX = std::numeric_limits<int32>::max();
+    mUsed.minY = std::numeric_limits<int32>::max();
+    mUsed.maxX = std::numeric_limits<int32>::min();
+    mUsed.maxY = std::numeric_limits<int32>::min();
+}
+
+template <typename Test>
+std::size_t SpatialHash2d::gather(const CellRange& range, const Test& test, uint32* results, std::size_t capacity) const
+{
+    const int32 minX = std::max(range.minX, mUsed.minX);
+    const int32 minY = std::max(range.minY, mUsed.minY);
+    const int32 maxX = std::min(range.maxX, mUsed.maxX);
+    const int32 maxY = std::min(range.maxY, mUsed.maxY);
+
+    std::size_t count = 0;
+
+    for (int32 y = minY; y <= maxY; ++y)
+    {
+        for (int32 x = minX; x <= maxX; ++x)
+        {
+            const std::vector<uint32>& items = mBuckets[bucket(x, y)];
+
+            for (std::size_t i = 0; i < items.size(); ++i)
+            {
+                const uint32 handle = items[i];
+                const CellRange& cells = mItems[handle].cells;
+
+                // An item is only reported from the first cell it shares with the
+                // query, which also skips items hashed here from other cells.
+                if (x != std::max(cells.minX, range.minX) || y != std::max(cells.minY, range.minY) ||
+                    x > cells.maxX || y > cells.maxY)
+                    continue;
+
+                const float* const box = &mBoxes[handle * 4];
+                if (!test(box[0], box[1], box[2], box[3]))
+                    continue;
+
+                if (count < capacity)
+                    results[count] = handle;
+                ++count;
+            }
+        }
+    }
+
+    return count;
+}
+
+std::size_t SpatialHash2d::query(const rectf& region, uint32* results, std::size_t capacity) const
+{
+    const priv::Bounds2d box = priv::toBounds(region);
+    return gather(toCells(box.minX, box.minY, box.maxX, box.maxY), priv::RegionTest(box), results, capacity);
+}
+
+std::size_t SpatialHash2d::query(const vec2f& point, uint32* results, std::size_t capacity) const
+{
+    return gather(toCells(point.x, point.y, point.x, point.y), priv::PointTest(point), results, capacity);
+}
+
+std::size_t SpatialHash2d::query(const Circle& circle, uint32* results, std::size_t capacity) const
+{
+    const CellRange cells = toCells(circle.center.x - circle.radius, circle.center.y - circle.radius,
+                                    circle.center.x + circle.radius, circle.center.y + circle.radius);
+    return gather(cells, priv::CircleTest(circle), results, capacity);
+}
+
+} // namespace nx
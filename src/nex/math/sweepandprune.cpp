@@ -0,0 +1,190 @@
+#include <nex/math/sweepandprune.h>
+#include <nex/math/simdlane.h>
+
+// Standard includes.
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    using nx::SweepAndPrunePair;
+
+    const uint32 NullProxy = 0xFFFFFFFF;
+
+    float component(const nx::vec3f& vector, int axis)
+    {
+        return axis == 0 ? vector.x : (axis == 1 ? vector.y : vector.z);
+    }
+
+    bool lessPair(const SweepAndPrunePair& a, const SweepAndPrunePair& b)
+    {
+        return a.proxyA != b.proxyA ? a.proxyA < b.proxyA : a.proxyB < b.proxyB;
+    }
+
+    // Bounds are [sweep min, sweep max, a min, a max, b min, b max] in sweep
+    // order, each array padded by one register so loads never run off the end.
+    template <typename Lane>
+    void sweep(const float* const* bounds, const uint32* proxies, std::size_t count, std::vector<SweepAndPrunePair>& pairs)
+    {
+        typedef typename Lane::Type Type;
+        const int width = Lane::Width;
+        const int allLanes = (1 << width) - 1;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const Type sweepMax = Lane::set(bounds[1][i]);
+            const Type minA = Lane::set(bounds[2][i]);
+            const Type maxA = Lane::set(bounds[3][i]);
+            const Type minB = Lane::set(bounds[4][i]);
+            const Type maxB = Lane::set(bounds[5][i]);
+
+            for (std::size_t j = i + 1; j < count; j += width)
+            {
+                // Sorted on the sweep minimum, once a box starts past the end of
+                // box i every following box does too.
+                const Type past = Lane::greater(Lane::loadUnaligned(bounds[0] + j), sweepMax);
+
+                Type separated = Lane::maskOr(past, Lane::greater(Lane::loadUnaligned(bounds[2] + j), maxA));
+                separated = Lane::maskOr(separated, Lane::less(Lane::loadUnaligned(bounds[3] + j), minA));
+                separated = Lane::maskOr(separated, Lane::greater(Lane::loadUnaligned(bounds[4] + j), maxB));
+                separated = Lane::maskOr(separated, Lane::less(Lane::loadUnaligned(bounds[5] + j), minB));
+
+                int overlap = ~Lane::moveMask(separated) & allLanes;
+                if (j + width > count)
+                    overlap &= (1 << (count - j)) - 1;
+
+                for (int lane = 0; overlap != 0; ++lane, overlap >>= 1)
+                {
+                    if (overlap & 1)
+                    {
+                        SweepAndPrunePair pair;
+                        pair.proxyA = std::min(proxies[i], proxies[j + lane]);
+                        pair.proxyB = std::max(proxies[i], proxies[j + lane]);
+                        pairs.push_back(pair);
+                    }
+                }
+
+                if (Lane::moveMask(past))
+                    break;
+            }
+        }
+    }
+}
+
+namespace nx
+{
+
+SweepAndPrune::SweepAndPrune(int axis) :
+    mAxis(axis),
+    mFreeList(NullProxy)
+{ }
+
+uint32 SweepAndPrune::insert(const AABB& box, void* userData)
+{
+    uint32 proxy;
+    if (mFreeList != NullProxy)
+    {
+        proxy = mFreeList;
+        mFreeList = mProxies[proxy].next;
+    }
+    else
+    {
+        proxy = static_cast<uint32>(mProxies.size());
+        mProxies.push_back(Proxy());
+    }
+
+    mProxies[proxy].box = box;
+    mProxies[proxy].userData = userData;
+    mProxies[proxy].next = NullProxy;
+
+    // The insertion sort moves it to its place on the next findPairs.
+    Endpoint endpoint;
+    endpoint.min = component(box.min, mAxis);
+    endpoint.proxy = proxy;
+    mSorted.push_back(endpoint);
+
+    return proxy;
+}
+
+void SweepAndPrune::remove(uint32 proxy)
+{
+    for (std::size_t i = 0; i < mSorted.size(); ++i)
+    {
+        if (mSorted[i].proxy == proxy)
+        {
+            mSorted.erase(mSorted.begin() + i);
+            break;
+        }
+    }
+
+    mProxies[proxy].userData = 0;
+    mProxies[proxy].next = mFreeList;
+    mFreeList = proxy;
+}
+
+void SweepAndPrune::sort()
+{
+    for (std::size_t i = 0; i < mSorted.size(); ++i)
+        mSorted[i].min = component(mProxies[mSorted[i].proxy].box.min, mAxis);
+
+    // Insertion sort, linear when the order barely changed since the last frame.
+    for (std::size_t i = 1; i < mSorted.size(); ++i)
+    {
+        const Endpoint endpoint = mSorted[i];
+
+        std::size_t j = i;
+        while (j > 0 && mSorted[j - 1].min > endpoint.min)
+        {
+            mSorted[j] = mSorted[j - 1];
+            --j;
+        }
+        mSorted[j] = endpoint;
+    }
+}
+
+void SweepAndPrune::gather()
+{
+    const std::size_t count = mSorted.size();
+    const int axisA = (mAxis + 1) % 3;
+    const int axisB = (mAxis + 2) % 3;
+
+    mOrder.resize(count);
+    for (int i = 0; i < 6; ++i)
+        mBounds[i].assign(count + priv::WideLane::Width, std::numeric_limits<float>::infinity());
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const AABB& box = mProxies[mSorted[i].proxy].box;
+
+        mOrder[i] = mSorted[i].proxy;
+
+        mBounds[0][i] = component(box.min, mAxis);
+        mBounds[1][i] = component(box.max, mAxis);
+        mBounds[2][i] = component(box.min, axisA);
+        mBounds[3][i] = component(box.max, axisA);
+        mBounds[4][i] = component(box.min, axisB);
+        mBounds[5][i] = component(box.max, axisB);
+    }
+}
+
+const std::vector<SweepAndPrunePair>& SweepAndPrune::findPairs()
+{
+    mPairs.clear();
+
+    const std::size_t count = mSorted.size();
+    if (count < 2)
+        return mPairs;
+
+    sort();
+    gather();
+
+    const float* const bounds[] = { &mBounds[0][0], &mBounds[1][0], &mBounds[2][0], &mBounds[3][0], &mBounds[4][0], &mBounds[5][0] };
+    sweep<priv::WideLane>(bounds, &mOrder[0], count, mPairs);
+
+    // Sort so the narrowphase sees the same order every frame.
+    std::sort(mPairs.begin(), mPairs.end(), lessPair);
+
+    return mPairs;
+}
+
+} // namespace nx
@@ -0,0 +1,425 @@
+#include <nex/math/sweptquery.h>
+#include <nex/math/parallel.h>
+
+// Standard includes.
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    using nx::vec3f;
+    using nx::AABB;
+    using nx::SweptResult;
+
+    const float Infinity = std::numeric_limits<float>::infinity();
+
+    void miss(SweptResult& result)
+    {
+        result.hit = false;
+        result.time = 1.0f;
+        result.normal = vec3f();
+        result.point = vec3f();
+    }
+
+    float component(const vec3f& vector, int axis)
+    {
+        return axis == 0 ? vector.x : (axis == 1 ? vector.y : vector.z);
+    }
+
+    void setComponent(vec3f& vector, int axis, float value)
+    {
+        if (axis == 0)
+            vector.x = value;
+        else if (axis == 1)
+            vector.y = value;
+        else
+            vector.z = value;
+    }
+
+    // First t in [0, 1] at which the point start + motion * t is within radius of
+    // a center, infinity if never. A point already within radius gives 0.
+    float sphereTime(const vec3f& start, const vec3f& motion, const vec3f& center, float radius)
+    {
+        const vec3f offset = start - center;
+        const float c = vec3f::dot(offset, offset) - radius * radius;
+        if (c <= 0.0f)
+            return 0.0f;
+
+        const float b = vec3f::dot(offset, motion);
+        const float a = vec3f::dot(motion, motion);
+        if (b >= 0.0f || a == 0.0f)
+            return Infinity;
+
+        const float discriminant = b * b - a * c;
+        if (discriminant < 0.0f)
+            return Infinity;
+
+        const float time = (-b - std::sqrt(discriminant)) / a;
+        return time <= 1.0f ? time : Infinity;
+    }
+
+    // First t at which the moving point is within radius of the box edge that
+    // starts at corner and runs along axis for length, the end caps included.
+    float edgeTime(const vec3f& start, const vec3f& motion, const vec3f& corner, int axis, float length, float radius)
+    {
+        const int i = (axis + 1) % 3;
+        const int j = (axis + 2) % 3;
+
+        // The side of the cylinder is a circle in the plane of the two other axes.
+        const float x = component(start, i) - component(corner, i);
+        const float y = component(start, j) - component(corner, j);
+        const float motionX = component(motion, i);
+        const float motionY = component(motion, j);
+
+        const float a = motionX * motionX + motionY * motionY;
+        const float b = x * motionX + y * motionY;
+        const float c = x * x + y * y - radius * radius;
+
+        float time = Infinity;
+        if (c <= 0.0f)
+        {
+            time = 0.0f;
+        }
+        else if (a > 0.0f && b < 0.0f)
+        {
+            const float discriminant = b * b - a * c;
+            if (discriminant >= 0.0f)
+                time = (-b - std::sqrt(discriminant)) / a;
+        }
+
+        if (time <= 1.0f)
+        {
+            const float along = component(start, axis) + component(motion, axis) * time - component(corner, axis);
+            if (along >= 0.0f && along <= length)
+                return time;
+        }
+
+        // Missing the side means entering through one of the caps, if at all.
+        vec3f end = corner;
+        setComponent(end, axis, component(corner, axis) + length);
+
+        return std::min(sphereTime(start, motion, corner, radius), sphereTime(start, motion, end, radius));
+    }
+
+    bool sweepSpheres(const nx::Sphere& sphereA, const vec3f& motionA, const nx::Sphere& sphereB, const vec3f& motionB, SweptResult& result)
+    {
+        // B stands still and A moves by the difference of the motions.
+        const float time = sphereTime(sphereA.center, motionA - motionB, sphereB.center, sphereA.radius + sphereB.radius);
+        if (time == Infinity)
+        {
+            miss(result);
+            return false;
+        }
+
+        const vec3f centerA = sphereA.center + motionA * time;
+        const vec3f centerB = sphereB.center + motionB * time;
+        const vec3f offset = centerB - centerA;
+        const float length = offset.length();
+
+        result.hit = true;
+        result.time = time;
+        result.normal = length > 0.0f ? offset * (1.0f / length) : vec3f();
+        result.point = centerA + result.normal * sphereA.radius;
+        return true;
+    }
+
+    bool sweepSphereBox(const nx::Sphere& sphere, const vec3f& sphereMotion, const AABB& box, const vec3f& boxMotion, SweptResult& result)
+    {
+        const vec3f start = sphere.center;
+        const vec3f motion = sphereMotion - boxMotion;
+        const float radius = sphere.radius;
+
+        // Slab test of the center against the box grown by the radius, the
+        // first contact can not come before the center enters it.
+        float enter = 0.0f;
+        float exit = 1.0f;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float origin = component(start, axis);
+            const float speed = component(motion, axis);
+            const float low = component(box.min, axis) - radius;
+            const float high = component(box.max, axis) + radius;
+
+            if (speed == 0.0f)
+            {
+                if (origin < low || origin > high)
+                {
+                    miss(result);
+                    return false;
+                }
+                continue;
+            }
+
+            float near = (low - origin) / speed;
+            float far = (high - origin) / speed;
+            if (near > far)
+                std::swap(near, far);
+
+            enter = std::max(enter, near);
+            exit = std::min(exit, far);
+            if (enter > exit)
+            {
+                miss(result);
+                return false;
+            }
+        }
+
+        // Where the center entered tells which feature of the box it can touch:
+        // a face when it is outside of at most one slab, else an edge or a corner.
+        const vec3f entry = start + motion * enter;
+        int below = 0;
+        int above = 0;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (component(entry, axis) < component(box.min, axis))
+                below |= 1 << axis;
+            if (component(entry, axis) > component(box.max, axis))
+                above |= 1 << axis;
+        }
+
+        const int outside = below | above;
+        const int outsideCount = (outside & 1) + ((outside >> 1) & 1) + ((outside >> 2) & 1);
+
+        float time = enter;
+        if (outsideCount >= 2)
+        {
+            vec3f corner;
+            for (int axis = 0; axis < 3; ++axis)
+                setComponent(corner, axis, (below & (1 << axis)) ? component(box.min, axis) : component(box.max, axis));
+
+            // The edges along the axes that are inside the slabs, every edge of the corner for a corner region.
+            time = Infinity;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (outsideCount == 2 && (outside & (1 << axis)))
+                    continue;
+
+                vec3f edge = corner;
+                setComponent(edge, axis, component(box.min, axis));
+                time = std::min(time, edgeTime(start, motion, edge, axis, component(box.max, axis) - component(box.min, axis), radius));
+            }
+
+            if (time == Infinity)
+            {
+                miss(result);
+                return false;
+            }
+        }
+
+        const vec3f center = start + motion * time;
+        const vec3f closest = vec3f::clamp(center, box.min, box.max);
+        const vec3f offset = closest - center;
+        const float length = offset.length();
+
+        result.hit = true;
+        result.time = time;
+        if (length > 0.0f)
+            result.normal = offset * (1.0f / length);
+        else
+            result.normal = motion.lengthSquared() > 0.0f ? vec3f::normalize(motion) : vec3f();
+        result.point = closest + boxMotion * time;
+        return true;
+    }
+
+    bool sweepBoxes(const AABB& boxA, const vec3f& motionA, const AABB& boxB, const vec3f& motionB, SweptResult& result)
+    {
+        // A stands still and B moves by the difference of the motions.
+        const vec3f motion = motionB - motionA;
+
+        float first = 0.0f;
+        float last = 1.0f;
+        int axisFirst = -1;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float minA = component(boxA.min, axis);
+            const float maxA = component(boxA.max, axis);
+            const float minB = component(boxB.min, axis);
+            const float maxB = component(boxB.max, axis);
+            const float speed = component(motion, axis);
+
+            if (speed < 0.0f)
+            {
+                if (maxB < minA)
+                {
+                    miss(result);
+                    return false;
+                }
+                if (maxA < minB && (maxA - minB) / speed > first)
+                {
+                    first = (maxA - minB) / speed;
+                    axisFirst = axis;
+                }
+                if (maxB > minA)
+                    last = std::min(last, (minA - maxB) / speed);
+            }
+            else if (speed > 0.0f)
+            {
+                if (minB > maxA)
+                {
+                    miss(result);
+                    return false;
+                }
+                if (maxB < minA && (minA - maxB) / speed > first)
+                {
+                    first = (minA - maxB) / speed;
+                    axisFirst = axis;
+                }
+                if (maxA > minB)
+                    last = std::min(last, (maxA - minB) / speed);
+            }
+            else if (maxB < minA || minB > maxA)
+            {
+                miss(result);
+                return false;
+            }
+
+            if (first > last)
+            {
+                miss(result);
+                return false;
+            }
+        }
+
+        result.hit = true;
+        result.time = first;
+        result.normal = vec3f();
+
+        // B closes in on A along the axis it entered last, the normal faces B.
+        if (axisFirst >= 0)
+            setComponent(result.normal, axisFirst, component(motion, axisFirst) < 0.0f ? 1.0f : -1.0f);
+
+        // The middle of the region the boxes share at the contact.
+        const vec3f offsetA = motionA * first;
+        const vec3f offsetB = motionB * first;
+        const vec3f low = vec3f::max(boxA.min + offsetA, boxB.min + offsetB);
+        const vec3f high = vec3f::min(boxA.max + offsetA, boxB.max + offsetB);
+        result.point = vec3f::lerp(low, high, 0.5f);
+        return true;
+    }
+
+    // Pairs of arrays swept side by side, a null motion array means the shapes are at rest
+    // and null jobs the calling thread.
+    template <typename ShapeA, typename ShapeB, typename Function>
+    void sweepBatch(nx::JobSystem* jobs, const ShapeA* shapesA, const vec3f* motionsA, const ShapeB* shapesB, const vec3f* motionsB,
+                    std::size_t count, SweptResult* results, Function function)
+    {
+        nx::priv::parallelRange(jobs, count, nx::SweptQueryParallelSize, [&](std::size_t begin, std::size_t end)
+        {
+            const vec3f rest;
+            for (std::size_t i = begin; i < end; ++i)
+                function(shapesA[i], motionsA ? motionsA[i] : rest, shapesB[i], motionsB ? motionsB[i] : rest, results[i]);
+        });
+    }
+
+    // A support function moved by an offset, the shape as it is partway through its motion.
+    struct MovedSupport
+    {
+        MovedSupport(const nx::priv::SupportFunction& shape, const vec3f& offset) : shape(&shape), offset(offset) { }
+
+        vec3f support(const vec3f& direction) const { return (*shape)(direction) + offset; }
+
+        const nx::priv::SupportFunction* shape;
+        vec3f offset;
+    };
+}
+
+namespace nx
+{
+
+namespace priv
+{
+
+bool conservativeAdvancement(const SupportFunction& shapeA, const vec3f& motionA,
+                             const SupportFunction& shapeB, const vec3f& motionB,
+                             SweptResult& result, ConvexCache* cache)
+{
+    const vec3f motion = motionB - motionA;
+    float time = 0.0f;
+
+    for (int32 iteration = 0; ; ++iteration)
+    {
+        const MovedSupport movedA(shapeA, motionA * time);
+        const MovedSupport movedB(shapeB, motionB * time);
+        const ConvexResult query = gjkQuery(SupportFunction(movedA), SupportFunction(movedB), cache);
+
+        // Running out of steps this close to the other shape is reported as a contact, the safe side for a sweep.
+        if (query.intersecting || query.distance <= SweptQueryTolerance || iteration == SweptQueryMaxIterations)
+        {
+            result.hit = true;
+            result.time = time;
+            result.normal = query.normal;
+            result.point = query.pointA;
+            return true;
+        }
+
+        // The normal points from A to B, B gets closer when it moves against it.
+        const float closing = -vec3f::dot(motion, query.normal);
+        if (closing <= 0.0f)
+            break;
+
+        // Aim short of contact so a slightly long GJK distance cannot step through the other shape.
+        time += (query.distance - SweptQueryTolerance * 0.5f) / closing;
+        if (time > 1.0f)
+            break;
+    }
+
+    miss(result);
+    return false;
+}
+
+} // namespace priv
+
+bool SweptQuery::sweep(const Sphere& sphereA, const vec3f& motionA, const Sphere& sphereB, const vec3f& motionB, SweptResult& result)
+{
+    return sweepSpheres(sphereA, motionA, sphereB, motionB, result);
+}
+
+bool SweptQuery::sweep(const Sphere& sphere, const vec3f& sphereMotion, const AABB& box, const vec3f& boxMotion, SweptResult& result)
+{
+    return sweepSphereBox(sphere, sphereMotion, box, boxMotion, result);
+}
+
+bool SweptQuery::sweep(const AABB& boxA, const vec3f& motionA, const AABB& boxB, const vec3f& motionB, SweptResult& result)
+{
+    return sweepBoxes(boxA, motionA, boxB, motionB, result);
+}
+
+void SweptQuery::sweep(const Sphere* spheresA, const vec3f* motionsA, const Sphere* spheresB, const vec3f* motionsB,
+                       std::size_t count, SweptResult* results)
+{
+    sweepBatch(0, spheresA, motionsA, spheresB, motionsB, count, results, sweepSpheres);
+}
+
+void SweptQuery::sweep(const Sphere* spheresA, const vec3f* motionsA, const Sphere* spheresB, const vec3f* motionsB,
+                       std::size_t count, SweptResult* results, JobSystem& jobs)
+{
+    sweepBatch(&jobs, spheresA, motionsA, spheresB, motionsB, count, results, sweepSpheres);
+}
+
+void SweptQuery::sweep(const Sphere* spheres, const vec3f* sphereMotions, const AABB* boxes, const vec3f* boxMotions,
+                       std::size_t count, SweptResult* results)
+{
+    sweepBatch(0, spheres, sphereMotions, boxes, boxMotions, count, results, sweepSphereBox);
+}
+
+void SweptQuery::sweep(const Sphere* spheres, const vec3f* sphereMotions, const AABB* boxes, const vec3f* boxMotions,
+                       std::size_t count, SweptResult* results, JobSystem& jobs)
+{
+    sweepBatch(&jobs, spheres, sphereMotions, boxes, boxMotions, count, results, sweepSphereBox);
+}
+
+void SweptQuery::sweep(const AABB* boxesA, const vec3f* motionsA, const AABB* boxesB, const vec3f* motionsB,
+                       std::size_t count, SweptResult* results)
+{
+    sweepBatch(0, boxesA, motionsA, boxesB, motionsB, count, results, sweepBoxes);
+}
+
+void SweptQuery::sweep(const AABB* boxesA, const vec3f* motionsA, const AABB* boxesB, const vec3f* motionsB,
+                       std::size_t count, SweptResult* results, JobSystem& jobs)
+{
+    sweepBatch(&jobs, boxesA, motionsA, boxesB, motionsB, count, results, sweepBoxes);
+}
+
+} // namespace nx
@@ -0,0 +1,508 @@
+#include <nex/math/trianglebvh.h>
+#include <nex/math/simdlane.h>
+#include <nex/math/trianglekernel.h>
+
+// Standard includes.
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    using nx::BVHNode;
+    using nx::priv::WideLane;
+
+    // Past the last triangle the streams hold this many empty triangles, so
+    // the widest lane can load a full register from the last leaf.
+    const std::size_t StreamPadding = 8;
+
+    // Lane numbers, compared to the size of a leaf to mask its tail.
+    const float LaneIndices[8] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f };
+
+    // "NXTB", followed by the version of the layout.
+    const uint32 FileMagic = 0x4254584E;
+    const uint32 FileVersion = 1;
+
+    struct FileHeader
+    {
+        uint32 magic;
+        uint32 version;
+        uint32 nodeCount;
+        uint32 triangleCount;
+    };
+
+    bool writeBytes(nx::OutStream& stream, const void* data, std::size_t size)
+    {
+        if (size == 0)
+            return true;
+
+        return stream.write(const_cast<void*>(data), static_cast<int64>(size)) == static_cast<int64>(size);
+    }
+
+    bool readBytes(nx::InStream& stream, void* data, std::size_t size)
+    {
+        if (size == 0)
+            return true;
+
+        return stream.read(data, static_cast<int64>(size)) == static_cast<int64>(size);
+    }
+
+    // Tests a ray against the triangles [first, first + count) of the streams
+    // and keeps the closest hit, slot is the position of the triangle.
+    template <typename Lane>
+    bool intersectLeaf(const typename Lane::Type* origin, const typename Lane::Type* direction, const float* const* streams,
+                       uint32 first, uint32 count, float& closest, uint32& slot, float& u, float& v)
+    {
+        typedef typename Lane::Type Type;
+
+        bool found = false;
+        for (uint32 offset = 0; offset < count; offset += Lane::Width)
+        {
+            const std::size_t index = first + offset;
+
+            const Type a[3] = { Lane::loadUnaligned(streams[0] + index), Lane::loadUnaligned(streams[1] + index), Lane::loadUnaligned(streams[2] + index) };
+            const Type b[3] = { Lane::loadUnaligned(streams[3] + index), Lane::loadUnaligned(streams[4] + index), Lane::loadUnaligned(streams[5] + index) };
+            const Type c[3] = { Lane::loadUnaligned(streams[6] + index), Lane::loadUnaligned(streams[7] + index), Lane::loadUnaligned(streams[8] + index) };
+
+            Type distance;
+            Type laneU;
+            Type laneV;
+            Type miss = nx::priv::intersectTriangles<Lane>(origin, direction, a, b, c, Lane::set(closest), distance, laneU, laneV);
+
+            // The lanes past the end of the leaf belong to the next one.
+            miss = Lane::maskOr(miss, Lane::greater(Lane::loadUnaligned(LaneIndices), Lane::set(static_cast<float>(count - offset) - 0.5f)));
+
+            int mask = ~Lane::moveMask(miss) & ((1 << Lane::Width) - 1);
+            if (mask == 0)
+                continue;
+
+            float distances[Lane::Width];
+            float weightsU[Lane::Width];
+            float weightsV[Lane::Width];
+            Lane::storeUnaligned(distances, distance);
+            Lane::storeUnaligned(weightsU, laneU);
+            Lane::storeUnaligned(weightsV, laneV);
+
+            for (int lane = 0; mask != 0; ++lane, mask >>= 1)
+            {
+                if ((mask & 1) && distances[lane] <= closest)
+                {
+                    closest = distances[lane];
+                    slot = static_cast<uint32>(index + lane);
+                    u = weightsU[lane];
+                    v = weightsV[lane];
+                    found = true;
+                }
+            }
+        }
+
+        return found;
+    }
+}
+
+namespace nx
+{
+
+TriangleBVH::TriangleBVH() :
+    mTriangleCount(0),
+    mStride(0)
+{ }
+
+void TriangleBVH::build(const Vec3View& positions, uint32 maxLeafSize)
+{
+    rebuild(positions, 0, positions.size() / 3, maxLeafSize, 0);
+}
+
+void TriangleBVH::build(const Vec3View& positions, uint32 maxLeafSize, JobSystem& jobs)
+{
+    rebuild(positions, 0, positions.size() / 3, maxLeafSize, &jobs);
+}
+
+void TriangleBVH::build(const Vec3View& positions, const uint32* indices, std::size_t triangleCount, uint32 maxLeafSize)
+{
+    rebuild(positions, indices, triangleCount, maxLeafSize, 0);
+}
+
+void TriangleBVH::build(const Vec3View& positions, const uint32* indices, std::size_t triangleCount, uint32 maxLeafSize, JobSystem& jobs)
+{
+    rebuild(positions, indices, triangleCount, maxLeafSize, &jobs);
+}
+
+void TriangleBVH::rebuild(const Vec3View& positions, const uint32* indices, std::size_t triangleCount, uint32 maxLeafSize, JobSystem* jobs)
+{
+    clear();
+
+    if (triangleCount == 0)
+        return;
+
+    std::vector<AABB> boxes(triangleCount);
+    for (std::size_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        const std::size_t corner = triangle * 3;
+        const vec3f& a = positions[indices ? indices[corner] : corner];
+        const vec3f& b = positions[indices ? indices[corner + 1] : corner + 1];
+        const vec3f& c = positions[indices ? indices[corner + 2] : corner + 2];
+
+        boxes[triangle] = AABB(vec3f::min(vec3f::min(a, b), c), vec3f::max(vec3f::max(a, b), c));
+    }
+
+    BVH tree;
+    if (jobs)
+        tree.build(boxes, maxLeafSize, *jobs);
+    else
+        tree.build(boxes, maxLeafSize);
+
+    // The leaves of the tree already index runs of its primitive order, which
+    // becomes the order of the triangle streams.
+    mNodes.assign(tree.getNodes(), tree.getNodes() + tree.getNodeCount());
+
+    // Node 1 only pads the sibling pairs to cache lines, it is cleared so the
+    // written hierarchy does not depend on leftover memory.
+    if (mNodes.size() > 1)
+        mNodes[1] = BVHNode();
+    mTriangles.assign(tree.getIndices(), tree.getIndices() + tree.size());
+
+    mTriangleCount = triangleCount;
+    mStride = triangleCount + StreamPadding;
+    mVertices.assign(9 * mStride, 0.0f);
+
+    for (std::size_t slot = 0; slot < triangleCount; ++slot)
+    {
+        const std::size_t corner = mTriangles[slot] * static_cast<std::size_t>(3);
+
+        for (int vertex = 0; vertex < 3; ++vertex)
+        {
+            const vec3f& position = positions[indices ? indices[corner + vertex] : corner + vertex];
+            mVertices[(vertex * 3 + 0) * mStride + slot] = position.x;
+            mVertices[(vertex * 3 + 1) * mStride + slot] = position.y;
+            mVertices[(vertex * 3 + 2) * mStride + slot] = position.z;
+        }
+    }
+}
+
+void TriangleBVH::clear()
+{
+    mNodes.clear();
+    mVertices.clear();
+    mTriangles.clear();
+    mTriangleCount = 0;
+    mStride = 0;
+}
+
+bool TriangleBVH::raycast(const Ray& ray, TriangleHit& hit, float maxDistance) const
+{
+    typedef WideLane::Type Type;
+
+    if (mNodes.empty())
+        return false;
+
+    struct Entry
+    {
+        uint32 node;
+        float distance;
+    };
+
+    const priv::BVHRay prepared(ray);
+
+    const Type origin[3] = { WideLane::set(ray.position.x), WideLane::set(ray.position.y), WideLane::set(ray.position.z) };
+    const Type direction[3] = { WideLane::set(ray.direction.x), WideLane::set(ray.direction.y), WideLane::set(ray.direction.z) };
+
+    const float* streams[9];
+    for (int stream = 0; stream < 9; ++stream)
+        streams[stream] = getStream(stream / 3, stream % 3);
+
+    float closest = maxDistance;
+    uint32 slot = 0;
+    float u = 0.0f;
+    float v = 0.0f;
+    bool found = false;
+
+    float entry;
+    if (!prepared.intersects(mNodes[0].min, mNodes[0].max, closest, entry))
+        return false;
+
+    Entry stack[BVHMaxDepth];
+    std::size_t top = 0;
+    stack[top].node = 0;
+    stack[top].distance = entry;
+    ++top;
+
+    while (top > 0)
+    {
+        const Entry current = stack[--top];
+
+        // A closer hit was found since this node was pushed.
+        if (current.distance > closest)
+            continue;
+
+        const BVHNode& node = mNodes[current.node];
+
+        if (node.isLeaf())
+        {
+            found |= intersectLeaf<WideLane>(origin, direction, streams, node.first, node.count, closest, slot, u, v);
+            continue;
+        }
+
+        const BVHNode& left = mNodes[node.first];
+        const BVHNode& right = mNodes[node.first + 1];
+
+        float leftDistance;
+        float rightDistance;
+        const bool hitLeft = prepared.intersects(left.min, left.max, closest, leftDistance);
+        const bool hitRight = prepared.intersects(right.min, right.max, closest, rightDistance);
+
+        // Push the far child first so the near one is visited next.
+        if (hitLeft && hitRight)
+        {
+            const bool leftFirst = leftDistance <= rightDistance;
+
+            stack[top].node = leftFirst ? node.first + 1 : node.first;
+            stack[top].distance = leftFirst ? rightDistance : leftDistance;
+            ++top;
+
+            stack[top].node = leftFirst ? node.first : node.first + 1;
+            stack[top].distance = leftFirst ? leftDistance : rightDistance;
+            ++top;
+        }
+        else if (hitLeft)
+        {
+            stack[top].node = node.first;
+            stack[top].distance = leftDistance;
+            ++top;
+        }
+        else if (hitRight)
+        {
+            stack[top].node = node.first + 1;
+            stack[top].distance = rightDistance;
+            ++top;
+        }
+    }
+
+    if (found)
+    {
+        hit.triangle = mTriangles[slot];
+        hit.distance = closest;
+        hit.u = u;
+        hit.v = v;
+    }
+
+    return found;
+}
+
+uint32 TriangleBVH::raycast(const RayPacket4& packet, TriangleHit* hits) const
+{
+    return raycastPacket(packet, hits);
+}
+
+uint32 TriangleBVH::raycast(const RayPacket8& packet, TriangleHit* hits) const
+{
+    return raycastPacket(packet, hits);
+}
+
+template <std::size_t Size>
+uint32 TriangleBVH::raycastPacket(const RayPacket<Size>& packet, TriangleHit* hits) const
+{
+    if (mNodes.empty())
+        return 0;
+
+    struct Entry
+    {
+        uint32 node;
+        float distance;
+    };
+
+    // The maximum distance of a ray shrinks to its closest hit so far.
+    RayPacket<Size> rays(packet);
+
+    float distances[Size];
+    float u[Size];
+    float v[Size];
+
+    if (rays.intersects(mNodes[0].min, mNodes[0].max, distances) == 0)
+        return 0;
+
+    Entry stack[BVHMaxDepth];
+    std::size_t top = 0;
+    stack[top].node = 0;
+    stack[top].distance = *std::min_element(distances, distances + Size);
+    ++top;
+
+    uint32 found = 0;
+
+    while (top > 0)
+    {
+        const Entry current = stack[--top];
+
+        // Every ray found something closer since this node was pushed.
+        float farthest = -1.0f;
+        for (std::size_t lane = 0; lane < Size; ++lane)
+            farthest = std::max(farthest, rays.getMaxDistance(lane));
+
+        if (current.distance > farthest)
+            continue;
+
+        const BVHNode& node = mNodes[current.node];
+
+        if (node.isLeaf())
+        {
+            for (uint32 slot = node.first; slot < node.first + node.count; ++slot)
+            {
+                const vec3f a(getStream(0, 0)[slot], getStream(0, 1)[slot], getStream(0, 2)[slot]);
+                const vec3f b(getStream(1, 0)[slot], getStream(1, 1)[slot], getStream(1, 2)[slot]);
+                const vec3f c(getStream(2, 0)[slot], getStream(2, 1)[slot], getStream(2, 2)[slot]);
+
+                uint32 mask = rays.intersects(a, b, c, distances, u, v);
+                for (std::size_t lane = 0; mask != 0; ++lane, mask >>= 1)
+                {
+                    if ((mask & 1) == 0)
+                        continue;
+
+                    hits[lane].triangle = mTriangles[slot];
+                    hits[lane].distance = distances[lane];
+                    hits[lane].u = u[lane];
+                    hits[lane].v = v[lane];
+                    rays.setMaxDistance(lane, distances[lane]);
+                    found |= 1u << lane;
+                }
+            }
+            continue;
+        }
+
+        float leftDistances[Size];
+        float rightDistances[Size];
+        const bool hitLeft = rays.intersects(mNodes[node.first].min, mNodes[node.first].max, leftDistances) != 0;
+        const bool hitRight = rays.intersects(mNodes[node.first + 1].min, mNodes[node.first + 1].max, rightDistances) != 0;
+
+        // The rays that miss a child report infinity, the nearest entry of the
+        // others decides which child is visited first.
+        const float leftDistance = *std::min_element(leftDistances, leftDistances + Size);
+        const float rightDistance = *std::min_element(rightDistances, rightDistances + Size);
+
+        if (hitLeft && hitRight)
+        {
+            const bool leftFirst = leftDistance <= rightDistance;
+
+            stack[top].node = leftFirst ? node.first + 1 : node.first;
+            stack[top].distance = leftFirst ? rightDistance : leftDistance;
+            ++top;
+
+            stack[top].node = leftFirst ? node.first : node.first + 1;
+            stack[top].distance = leftFirst ? leftDistance : rightDistance;
+            ++top;
+        }
+        else if (hitLeft)
+        {
+            stack[top].node = node.first;
+            stack[top].distance = leftDistance;
+            ++top;
+        }
+        else if (hitRight)
+        {
+            stack[top].node = node.first + 1;
+            stack[top].distance = rightDistance;
+            ++top;
+        }
+    }
+
+    return found;
+}
+
+bool TriangleBVH::write(OutStream& stream) const
+{
+    FileHeader header;
+    header.magic = FileMagic;
+    header.version = FileVersion;
+    header.nodeCount = static_cast<uint32>(mNodes.size());
+    header.triangleCount = static_cast<uint32>(mTriangleCount);
+
+    return writeBytes(stream, &header, sizeof(header)) &&
+           writeBytes(stream, getNodes(), mNodes.size() * sizeof(BVHNode)) &&
+           writeBytes(stream, mVertices.empty() ? 0 : &mVertices[0], mVertices.size() * sizeof(float)) &&
+           writeBytes(stream, mTriangles.empty() ? 0 : &mTriangles[0], mTriangles.size() * sizeof(uint32));
+}
+
+bool TriangleBVH::read(InStream& stream)
+{
+    clear();
+
+    FileHeader header;
+    if (!readBytes(stream, &header, sizeof(header)) || header.magic != FileMagic || header.version != FileVersion)
+        return false;
+
+    // An empty mesh has no nodes, any other one has a root.
+    if ((header.nodeCount == 0) != (header.triangleCount == 0))
+        return false;
+
+    // The counts come from the file, nothing is allocated for more than the
+    // rest of the stream could hold.
+    const uint64 stride = header.triangleCount == 0 ? 0 : static_cast<uint64>(header.triangleCount) + StreamPadding;
+    const uint64 needed = static_cast<uint64>(header.nodeCount) * sizeof(BVHNode) +
+                          9 * stride * sizeof(float) +
+                          static_cast<uint64>(header.triangleCount) * sizeof(uint32);
+
+    const int64 position = stream.tell();
+    const int64 size = stream.size();
+    if (position < 0 || size < position || needed > static_cast<uint64>(size - position))
+        return false;
+
+    mNodes.resize(header.nodeCount);
+    mTriangleCount = header.triangleCount;
+    mStride = static_cast<std::size_t>(stride);
+    mVertices.resize(9 * mStride);
+    mTriangles.resize(header.triangleCount);
+
+    bool valid = readBytes(stream, mNodes.empty() ? 0 : &mNodes[0], mNodes.size() * sizeof(BVHNode)) &&
+                 readBytes(stream, mVertices.empty() ? 0 : &mVertices[0], mVertices.size() * sizeof(float)) &&
+                 readBytes(stream, mTriangles.empty() ? 0 : &mTriangles[0], mTriangles.size() * sizeof(uint32));
+
+    // Traversals trust the node links and the depth, a damaged file must not
+    // send them out of bounds. Every node is claimed by exactly one parent,
+    // so shared children cannot turn the tree into a graph.
+    std::vector<bool> reached(mNodes.size(), false);
+    std::vector<std::pair<uint32, uint32> > pending;
+    if (valid && !mNodes.empty())
+    {
+        reached[0] = true;
+        pending.push_back(std::make_pair(0u, 1u));
+    }
+
+    while (valid && !pending.empty())
+    {
+        const uint32 index = pending.back().first;
+        const uint32 depth = pending.back().second;
+        pending.pop_back();
+
+        const BVHNode& node = mNodes[index];
+        if (node.isLeaf())
+        {
+            valid = node.first <= mTriangleCount && node.count <= mTriangleCount - node.first;
+        }
+        else
+        {
+            valid = depth < BVHMaxDepth && node.first > index && static_cast<std::size_t>(node.first) + 1 < mNodes.size() &&
+                    !reached[node.first] && !reached[node.first + 1];
+            if (!valid)
+                break;
+
+            reached[node.first] = true;
+            reached[node.first + 1] = true;
+            pending.push_back(std::make_pair(node.first, depth + 1));
+            pending.push_back(std::make_pair(node.first + 1, depth + 1));
+        }
+    }
+
+    if (!valid)
+        clear();
+
+    return valid;
+}
+
+AABB TriangleBVH::getBounds() const
+{
+    if (mNodes.empty())
+        return AABB();
+
+    return AABB(vec3f(mNodes[0].min[0], mNodes[0].min[1], mNodes[0].min[2]),
+                vec3f(mNodes[0].max[0], mNodes[0].max[1], mNodes[0].max[2]));
+}
+
+} // namespace nx
@@ -0,0 +1,84 @@
+#ifndef TRIANGLEKERNEL_H_INCLUDE
+#define TRIANGLEKERNEL_H_INCLUDE
+
+// Nex includes.
+#include <nex/math/simdlane.h>
+
+/*
+ * Moller-Trumbore ray triangle test written once over the lane types. The
+ * lanes either hold one ray against several triangles or several rays
+ * against one triangle, the caller broadcasts whichever side is shared.
+ * Both faces of a triangle are hit.
+ */
+
+namespace nx
+{
+namespace priv
+{
+
+/**
+ * @brief Determinants smaller than this belong to rays parallel to the triangle, which miss.
+ */
+const float TriangleParallelEpsilon = 1e-20f;
+
+/**
+ * @brief Tests rays against triangles, one pair per lane.
+ * @param origin = The x, y and z of the ray origins.
+ * @param direction = The x, y and z of the ray directions.
+ * @param vertexA = The x, y and z of the first vertices.
+ * @param vertexB = The x, y and z of the second vertices.
+ * @param vertexC = The x, y and z of the third vertices.
+ * @param maxDistance = Hits farther than this are misses.
+ * @param distance = Receives the distances along the rays.
+ * @param u = Receives the weights of vertexB, as for Vec3::barycentric.
+ * @param v = Receives the weights of vertexC.
+ * @return the mask of the lanes that miss.
+ */
+template <typename Lane>
+typename Lane::Type intersectTriangles(const typename Lane::Type* origin, const typename Lane::Type* direction,
+                                       const typename Lane::Type* vertexA, const typename Lane::Type* vertexB,
+                                       const typename Lane::Type* vertexC, typename Lane::Type maxDistance,
+                                       typename Lane::Type& distance, typename Lane::Type& u, typename Lane::Type& v)
+{
+    typedef typename Lane::Type Type;
+
+    const Type edgeB[3] = { Lane::sub(vertexB[0], vertexA[0]), Lane::sub(vertexB[1], vertexA[1]), Lane::sub(vertexB[2], vertexA[2]) };
+    const Type edgeC[3] = { Lane::sub(vertexC[0], vertexA[0]), Lane::sub(vertexC[1], vertexA[1]), Lane::sub(vertexC[2], vertexA[2]) };
+    const Type offset[3] = { Lane::sub(origin[0], vertexA[0]), Lane::sub(origin[1], vertexA[1]), Lane::sub(origin[2], vertexA[2]) };
+
+    // p = direction x edgeC, q = offset x edgeB.
+    const Type p[3] = {
+        Lane::sub(Lane::mul(direction[1], edgeC[2]), Lane::mul(direction[2], edgeC[1])),
+        Lane::sub(Lane::mul(direction[2], edgeC[0]), Lane::mul(direction[0], edgeC[2])),
+        Lane::sub(Lane::mul(direction[0], edgeC[1]), Lane::mul(direction[1], edgeC[0]))
+    };
+    const Type q[3] = {
+        Lane::sub(Lane::mul(offset[1], edgeB[2]), Lane::mul(offset[2], edgeB[1])),
+        Lane::sub(Lane::mul(offset[2], edgeB[0]), Lane::mul(offset[0], edgeB[2])),
+        Lane::sub(Lane::mul(offset[0], edgeB[1]), Lane::mul(offset[1], edgeB[0]))
+    };
+
+    const Type determinant = Lane::multiplyAdd(edgeB[2], p[2], Lane::multiplyAdd(edgeB[1], p[1], Lane::mul(edgeB[0], p[0])));
+    const Type inverse = Lane::div(Lane::set(1.0f), determinant);
+
+    u = Lane::mul(Lane::multiplyAdd(offset[2], p[2], Lane::multiplyAdd(offset[1], p[1], Lane::mul(offset[0], p[0]))), inverse);
+    v = Lane::mul(Lane::multiplyAdd(direction[2], q[2], Lane::multiplyAdd(direction[1], q[1], Lane::mul(direction[0], q[0]))), inverse);
+    distance = Lane::mul(Lane::multiplyAdd(edgeC[2], q[2], Lane::multiplyAdd(edgeC[1], q[1], Lane::mul(edgeC[0], q[0]))), inverse);
+
+    const Type zero = Lane::set(0.0f);
+
+    // A parallel ray divides by 0, the comparisons on the resulting NaNs are
+    // all false so the determinant has to be rejected on its own.
+    Type miss = Lane::less(Lane::abs(determinant), Lane::set(TriangleParallelEpsilon));
+    miss = Lane::maskOr(miss, Lane::less(u, zero));
+    miss = Lane::maskOr(miss, Lane::less(v, zero));
+    miss = Lane::maskOr(miss, Lane::greater(Lane::add(u, v), Lane::set(1.0f)));
+    miss = Lane::maskOr(miss, Lane::less(distance, zero));
+    miss = Lane::maskOr(miss, Lane::greater(distance, maxDistance));
+    return miss;
+}
+
+} // namespace priv
+} // namespace nx
+
+#endif // TRIANGLEKERNEL_H_INCLUDE
@@ -0,0 +1,268 @@
+#include <nex/math/vec3array.h>
+#include <nex/math/soakernels.h>
+#include <nex/system/memory.h>
+
+// Standard includes.
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace
+{
+    // Capacities are a multiple of the widest register and the arrays are
+    // aligned to it, so every array starts on a fresh 32 byte boundary.
+    const std::size_t Vec3ArrayAlignment = 32;
+    const std::size_t Vec3ArrayGranularity = Vec3ArrayAlignment / sizeof(float);
+
+    std::size_t roundCapacity(std::size_t capacity)
+    {
+        return (capacity + Vec3ArrayGranularity - 1) / Vec3ArrayGranularity * Vec3ArrayGranularity;
+    }
+}
+
+namespace nx
+{
+
+Vec3Array::Vec3Array() :
+mData(0),
+mX(0),
+mY(0),
+mZ(0),
+mSize(0),
+mCapacity(0)
+{ }
+
+Vec3Array::Vec3Array(std::size_t size) :
+mData(0),
+mX(0),
+mY(0),
+mZ(0),
+mSize(0),
+mCapacity(0)
+{
+    resize(size);
+}
+
+Vec3Array::Vec3Array(const Vec3View& view) :
+mData(0),
+mX(0),
+mY(0),
+mZ(0),
+mSize(0),
+mCapacity(0)
+{
+    assign(view);
+}
+
+Vec3Array::Vec3Array(const Vec3Array& other) :
+mData(0),
+mX(0),
+mY(0),
+mZ(0),
+mSize(0),
+mCapacity(0)
+{
+    *this = other;
+}
+
+Vec3Array& Vec3Array::operator=(const Vec3Array& other)
+{
+    if (this == &other)
+        return *this;
+
+    mSize = 0;
+    reserve(other.mSize);
+    mSize = other.mSize;
+
+    if (mSize > 0)
+    {
+        std::memcpy(mX, other.mX, mSize * sizeof(float));
+        std::memcpy(mY, other.mY, mSize * sizeof(float));
+        std::memcpy(mZ, other.mZ, mSize * sizeof(float));
+    }
+
+    return *this;
+}
+
+Vec3Array::~Vec3Array()
+{
+    alignedFree(mData);
+}
+
+void Vec3Array::reallocate(std::size_t capacity)
+{
+    float* data = static_cast<float*>(alignedMalloc(3 * capacity * sizeof(float), Vec3ArrayAlignment));
+    if (!data)
+        throw std::bad_alloc();
+
+    if (mSize > 0)
+    {
+        std::memcpy(data, mX, mSize * sizeof(float));
+        std::memcpy(data + capacity, mY, mSize * sizeof(float));
+        std::memcpy(data + 2 * capacity, mZ, mSize * sizeof(float));
+    }
+
+    alignedFree(mData);
+
+    mData = data;
+    mX = data;
+    mY = data + capacity;
+    mZ = data + 2 * capacity;
+    mCapacity = capacity;
+}
+
+void Vec3Array::reserve(std::size_t capacity)
+{
+    if (capacity > mCapacity)
+        reallocate(roundCapacity(capacity));
+}
+
+void Vec3Array::resize(std::size_t size)
+{
+    reserve(size);
+
+    if (size > mSize)
+    {
+        std::fill(mX + mSize, mX + size, 0.0f);
+        std::fill(mY + mSize, mY + size, 0.0f);
+        std::fill(mZ + mSize, mZ + size, 0.0f);
+    }
+
+    mSize = size;
+}
+
+void Vec3Array::append(const vec3f& vector)
+{
+    if (mSize == mCapacity)
+        reallocate(roundCapacity(std::max<std::size_t>(mCapacity * 2, Vec3ArrayGranularity)));
+
+    set(mSize++, vector);
+}
+
+void Vec3Array::assign(const Vec3View& view)
+{
+    mSize = 0;
+    reserve(view.size());
+    mSize = view.size();
+
+    for (std::size_t i = 0; i < mSize; ++i)
+        set(i, view[i]);
+}
+
+void Vec3Array::store(const Vec3View& view) const
+{
+    for (std::size_t i = 0; i < mSize; ++i)
+    {
+        vec3f& vector = view[i];
+        vector.x = mX[i];
+        vector.y = mY[i];
+        vector.z = mZ[i];
+    }
+}
+
+void Vec3Array::store(std::vector<vec3f>& vector) const
+{
+    vector.resize(mSize);
+    store(Vec3View(vector));
+}
+
+void Vec3Array::normalize()
+{
+    float* const components[] = { mX, mY, mZ };
+    priv::soaNormalize(components, 3, mSize);
+}
+
+void Vec3Array::length(float* result) const
+{
+    const float* const components[] = { mX, mY, mZ };
+    priv::soaLength(components, 3, result, mSize);
+}
+
+void Vec3Array::lengthSquared(float* result) const
+{
+    const float* const components[] = { mX, mY, mZ };
+    priv::soaDot(components, components, 3, result, mSize);
+}
+
+vec3f Vec3Array::reduceMin() const
+{
+    return vec3f(priv::soaReduceMin(mX, mSize),
+                 priv::soaReduceMin(mY, mSize),
+                 priv::soaReduceMin(mZ, mSize));
+}
+
+vec3f Vec3Array::reduceMax() const
+{
+    return vec3f(priv::soaReduceMax(mX, mSize),
+                 priv::soaReduceMax(mY, mSize),
+                 priv::soaReduceMax(mZ, mSize));
+}
+
+void Vec3Array::bounds(vec3f& min, vec3f& max) const
+{
+    min = reduceMin();
+    max = reduceMax();
+}
+
+vec3f Vec3Array::sum() const
+{
+    return vec3f(priv::soaReduceAdd(mX, mSize),
+                 priv::soaReduceAdd(mY, mSize),
+                 priv::soaReduceAdd(mZ, mSize));
+}
+
+vec3f Vec3Array::centroid() const
+{
+    if (mSize == 0)
+        return vec3f();
+
+    const vec3f total = sum();
+    const float scale = 1.0f / static_cast<float>(mSize);
+    return vec3f(total.x * scale, total.y * scale, total.z * scale);
+}
+
+void Vec3Array::dot(const Vec3Array& a, const Vec3Array& b, float* result)
+{
+    const float* const componentsA[] = { a.mX, a.mY, a.mZ };
+    const float* const componentsB[] = { b.mX, b.mY, b.mZ };
+    priv::soaDot(componentsA, componentsB, 3, result, a.mSize);
+}
+
+void Vec3Array::cross(const Vec3Array& a, const Vec3Array& b, Vec3Array& result)
+{
+    result.resize(a.mSize);
+
+    const float* const componentsA[] = { a.mX, a.mY, a.mZ };
+    const float* const componentsB[] = { b.mX, b.mY, b.mZ };
+    float* const componentsResult[] = { result.mX, result.mY, result.mZ };
+    priv::soaCross(componentsA, componentsB, componentsResult, a.mSize);
+}
+
+void Vec3Array::lerp(const Vec3Array& a, const Vec3Array& b, float amount, Vec3Array& result)
+{
+    result.resize(a.mSize);
+
+    priv::soaLerp(a.mX, b.mX, amount, result.mX, a.mSize);
+    priv::soaLerp(a.mY, b.mY, amount, result.mY, a.mSize);
+    priv::soaLerp(a.mZ, b.mZ, amount, result.mZ, a.mSize);
+}
+
+void Vec3Array::min(const Vec3Array& a, const Vec3Array& b, Vec3Array& result)
+{
+    result.resize(a.mSize);
+
+    priv::soaMin(a.mX, b.mX, result.mX, a.mSize);
+    priv::soaMin(a.mY, b.mY, result.mY, a.mSize);
+    priv::soaMin(a.mZ, b.mZ, result.mZ, a.mSize);
+}
+
+void Vec3Array::max(const Vec3Array& a, const Vec3Array& b, Vec3Array& result)
+{
+    result.resize(a.mSize);
+
+    priv::soaMax(a.mX, b.mX, result.mX, a.mSize);
+    priv::soaMax(a.mY, b.mY, result.mY, a.mSize);
+    priv::soaMax(a.mZ, b.mZ, result.mZ, a.mSize);
+}
+
+} // namespace nx
@@ -0,0 +1,273 @@
+#include <nex/math/vec4array.h>
+#include <nex/math/soakernels.h>
+#include <nex/system/memory.h>
+
+// Standard includes.
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace
+{
+    // Capacities are a multiple of the widest register and the arrays are
+    // aligned to it, so every array starts on a fresh 32 byte boundary.
+    const std::size_t Vec4ArrayAlignment = 32;
+    const std::size_t Vec4ArrayGranularity = Vec4ArrayAlignment / sizeof(float);
+
+    std::size_t roundCapacity(std::size_t capacity)
+    {
+        return (capacity + Vec4ArrayGranularity - 1) / Vec4ArrayGranularity * Vec4ArrayGranularity;
+    }
+}
+
+namespace nx
+{
+
+Vec4Array::Vec4Array() :
+mData(0),
+mX(0),
+mY(0),
+mZ(0),
+mW(0),
+mSize(0),
+mCapacity(0)
+{ }
+
+Vec4Array::Vec4Array(std::size_t size) :
+mData(0),
+mX(0),
+mY(0),
+mZ(0),
+mW(0),
+mSize(0),
+mCapacity(0)
+{
+    resize(size);
+}
+
+Vec4Array::Vec4Array(const Vec4View& view) :
+mData(0),
+mX(0),
+mY(0),
+mZ(0),
+mW(0),
+mSize(0),
+mCapacity(0)
+{
+    assign(view);
+}
+
+Vec4Array::Vec4Array(const Vec4Array& other) :
+mData(0),
+mX(0),
+mY(0),
+mZ(0),
+mW(0),
+mSize(0),
+mCapacity(0)
+{
+    *this = other;
+}
+
+Vec4Array& Vec4Array::operator=(const Vec4Array& other)
+{
+    if (this == &other)
+        return *this;
+
+    mSize = 0;
+    reserve(other.mSize);
+    mSize = other.mSize;
+
+    if (mSize > 0)
+    {
+        std::memcpy(mX, other.mX, mSize * sizeof(float));
+        std::memcpy(mY, other.mY, mSize * sizeof(float));
+        std::memcpy(mZ, other.mZ, mSize * sizeof(float));
+        std::memcpy(mW, other.mW, mSize * sizeof(float));
+    }
+
+    return *this;
+}
+
+Vec4Array::~Vec4Array()
+{
+    alignedFree(mData);
+}
+
+void Vec4Array::reallocate(std::size_t capacity)
+{
+    float* data = static_cast<float*>(alignedMalloc(4 * capacity * sizeof(float), Vec4ArrayAlignment));
+    if (!data)
+        throw std::bad_alloc();
+
+    if (mSize > 0)
+    {
+        std::memcpy(data, mX, mSize * sizeof(float));
+        std::memcpy(data + capacity, mY, mSize * sizeof(float));
+        std::memcpy(data + 2 * capacity, mZ, mSize * sizeof(float));
+        std::memcpy(data + 3 * capacity, mW, mSize * sizeof(float));
+    }
+
+    alignedFree(mData);
+
+    mData = data;
+    mX = data;
+    mY = data + capacity;
+    mZ = data + 2 * capacity;
+    mW = data + 3 * capacity;
+    mCapacity = capacity;
+}
+
+void Vec4Array::reserve(std::size_t capacity)
+{
+    if (capacity > mCapacity)
+        reallocate(roundCapacity(capacity));
+}
+
+void Vec4Array::resize(std::size_t size)
+{
+    reserve(size);
+
+    if (size > mSize)
+    {
+        std::fill(mX + mSize, mX + size, 0.0f);
+        std::fill(mY + mSize, mY + size, 0.0f);
+        std::fill(mZ + mSize, mZ + size, 0.0f);
+        std::fill(mW + mSize, mW + size, 0.0f);
+    }
+
+    mSize = size;
+}
+
+void Vec4Array::append(const vec4f& vector)
+{
+    if (mSize == mCapacity)
+        reallocate(roundCapacity(std::max<std::size_t>(mCapacity * 2, Vec4ArrayGranularity)));
+
+    set(mSize++, vector);
+}
+
+void Vec4Array::assign(const Vec4View& view)
+{
+    mSize = 0;
+    reserve(view.size());
+    mSize = view.size();
+
+    for (std::size_t i = 0; i < mSize; ++i)
+        set(i, view[i]);
+}
+
+void Vec4Array::store(const Vec4View& view) const
+{
+    for (std::size_t i = 0; i < mSize; ++i)
+    {
+        vec4f& vector = view[i];
+        vector.x = mX[i];
+        vector.y = mY[i];
+        vector.z = mZ[i];
+        vector.w = mW[i];
+    }
+}
+
+void Vec4Array::store(std::vector<vec4f>& vector) const
+{
+    vector.resize(mSize);
+    store(Vec4View(vector));
+}
+
+void Vec4Array::normalize()
+{
+    float* const components[] = { mX, mY, mZ, mW };
+    priv::soaNormalize(components, 4, mSize);
+}
+
+void Vec4Array::length(float* result) const
+{
+    const float* const components[] = { mX, mY, mZ, mW };
+    priv::soaLength(components, 4, result, mSize);
+}
+
+void Vec4Array::lengthSquared(float* result) const
+{
+    const float* const components[] = { mX, mY, mZ, mW };
+    priv::soaDot(components, components, 4, result, mSize);
+}
+
+vec4f Vec4Array::reduceMin() const
+{
+    return vec4f(priv::soaReduceMin(mX, mSize),
+                 priv::soaReduceMin(mY, mSize),
+                 priv::soaReduceMin(mZ, mSize),
+                 priv::soaReduceMin(mW, mSize));
+}
+
+vec4f Vec4Array::reduceMax() const
+{
+    return vec4f(priv::soaReduceMax(mX, mSize),
+                 priv::soaReduceMax(mY, mSize),
+                 priv::soaReduceMax(mZ, mSize),
+                 priv::soaReduceMax(mW, mSize));
+}
+
+void Vec4Array::bounds(vec4f& min, vec4f& max) const
+{
+    min = reduceMin();
+    max = reduceMax();
+}
+
+vec4f Vec4Array::sum() const
+{
+    return vec4f(priv::soaReduceAdd(mX, mSize),
+                 priv::soaReduceAdd(mY, mSize),
+                 priv::soaReduceAdd(mZ, mSize),
+                 priv::soaReduceAdd(mW, mSize));
+}
+
+vec4f Vec4Array::centroid() const
+{
+    if (mSize == 0)
+        return vec4f();
+
+    const vec4f total = sum();
+    const float scale = 1.0f / static_cast<float>(mSize);
+    return vec4f(total.x * scale, total.y * scale, total.z * scale, total.w * scale);
+}
+
+void Vec4Array::dot(const Vec4Array& a, const Vec4Array& b, float* result)
+{
+    const float* const componentsA[] = { a.mX, a.mY, a.mZ, a.mW };
+    const float* const componentsB[] = { b.mX, b.mY, b.mZ, b.mW };
+    priv::soaDot(componentsA, componentsB, 4, result, a.mSize);
+}
+
+void Vec4Array::lerp(const Vec4Array& a, const Vec4Array& b, float amount, Vec4Array& result)
+{
+    result.resize(a.mSize);
+
+    priv::soaLerp(a.mX, b.mX, amount, result.mX, a.mSize);
+    priv::soaLerp(a.mY, b.mY, amount, result.mY, a.mSize);
+    priv::soaLerp(a.mZ, b.mZ, amount, result.mZ, a.mSize);
+    priv::soaLerp(a.mW, b.mW, amount, result.mW, a.mSize);
+}
+
+void Vec4Array::min(const Vec4Array& a, const Vec4Array& b, Vec4Array& result)
+{
+    result.resize(a.mSize);
+
+    priv::soaMin(a.mX, b.mX, result.mX, a.mSize);
+    priv::soaMin(a.mY, b.mY, result.mY, a.mSize);
+    priv::soaMin(a.mZ, b.mZ, result.mZ, a.mSize);
+    priv::soaMin(a.mW, b.mW, result.mW, a.mSize);
+}
+
+void Vec4Array::max(const Vec4Array& a, const Vec4Array& b, Vec4Array& result)
+{
+    result.resize(a.mSize);
+
+    priv::soaMax(a.mX, b.mX, result.mX, a.mSize);
+    priv::soaMax(a.mY, b.mY, result.mY, a.mSize);
+    priv::soaMax(a.mZ, b.mZ, result.mZ, a.mSize);
+    priv::soaMax(a.mW, b.mW, result.mW, a.mSize);
+}
+
+} // namespace nx
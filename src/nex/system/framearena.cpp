@@ -0,0 +1,75 @@
+#include <nex/system/framearena.h>
+#include <nex/system/memory.h>
+
+// Standard includes.
+#include <cstdint>
+
+namespace nx
+{
+
+FrameArena::FrameArena(std::size_t capacity) :
+    mData(static_cast<char*>(alignedMalloc(capacity > 0 ? capacity : 1, CacheLineSize))),
+    mCapacity(mData ? capacity : 0),
+    mOffset(0),
+    mOverflowSize(0)
+{ }
+
+FrameArena::~FrameArena()
+{
+    for (std::size_t index = 0; index < mOverflow.size(); ++index)
+        alignedFree(mOverflow[index]);
+
+    alignedFree(mData);
+}
+
+void* FrameArena::allocate(std::size_t size, std::size_t alignment)
+{
+    // The block is only cache line aligned, larger alignments depend on where it landed.
+    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(mData);
+    const std::size_t begin = ((base + mOffset + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1)) - base;
+    if (begin <= mCapacity && size <= mCapacity - begin)
+    {
+        mOffset = begin + size;
+        return mData + begin;
+    }
+
+    void* memory = alignedMalloc(size > 0 ? size : 1, alignment < sizeof(void*) ? sizeof(void*) : alignment);
+    if (!memory)
+        return 0;
+
+    mOverflow.push_back(memory);
+    mOverflowSize += size + alignment;
+    return memory;
+}
+
+void FrameArena::deallocate(void* memory, std::size_t size)
+{
+    char* bytes = static_cast<char*>(memory);
+    if (bytes >= mData && bytes + size == mData + mOffset)
+        mOffset = bytes - mData;
+}
+
+void FrameArena::reset()
+{
+    if (!mOverflow.empty())
+    {
+        for (std::size_t index = 0; index < mOverflow.size(); ++index)
+            alignedFree(mOverflow[index]);
+
+        // Grow to the peak of the frame with some room, once.
+        const std::size_t capacity = mCapacity + mOverflowSize + (mCapacity + mOverflowSize) / 2;
+        if (char* data = static_cast<char*>(alignedMalloc(capacity, CacheLineSize)))
+        {
+            alignedFree(mData);
+            mData = data;
+            mCapacity = capacity;
+        }
+
+        mOverflow.clear();
+        mOverflowSize = 0;
+    }
+
+    mOffset = 0;
+}
+
+} // namespace nx
@@ -0,0 +1,317 @@
+#include <nex/system/jobsystem.h>
+#include <nex/system/workstealingdeque.h>
+#include <nex/system/memory.h>
+
+// Standard includes.
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <thread>
+
+namespace
+{
+    // Failed searches before an idle worker goes to sleep.
+    const int IdleSpinCount = 64;
+
+    // The first capacity of the queue of jobs submitted from outside the pool.
+    const std::size_t InjectedCapacity = 256;
+
+    thread_local std::size_t threadIndex = 0;
+    thread_local std::unique_ptr<nx::ScratchArena> threadScratch;
+
+    void runLoopJob(void* data)
+    {
+        nx::priv::ParallelLoop& loop = *static_cast<nx::priv::ParallelLoop*>(data);
+        loop.run(loop);
+    }
+}
+
+namespace nx
+{
+
+struct JobSystem::Worker
+{
+    Worker() :
+        deque(JobSystemQueueCapacity),
+        random(0)
+    { }
+
+    // Xorshift, picks the first victim of a steal.
+    uint32 nextRandom()
+    {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        return random;
+    }
+
+    WorkStealingDeque<Job*> deque;
+    std::thread thread;
+    uint32 random;
+};
+
+JobSystem& JobSystem::getInstance()
+{
+    static JobSystem instance;
+
+    return instance;
+}
+
+JobSystem::JobSystem() :
+    mThreadCount(0),
+    mScratchSize(JobSystemScratchSize),
+    mWorkers(0),
+    mInjected(new Job*[InjectedCapacity]),
+    mInjectedCapacity(InjectedCapacity),
+    mInjectedHead(0),
+    mInjectedCount(0),
+    mQueued(0),
+    mSleeping(0),
+    mRunning(false)
+{
+    start(0);
+}
+
+JobSystem::~JobSystem()
+{
+    stop();
+    delete[] mInjected;
+}
+
+void JobSystem::setThreadCount(std::size_t count)
+{
+    stop();
+    start(count);
+}
+
+std::size_t JobSystem::getThreadIndex()
+{
+    return threadIndex;
+}
+
+ScratchArena& JobSystem::getScratch()
+{
+    if (!threadScratch)
+        threadScratch.reset(new ScratchArena(mScratchSize));
+
+    return *threadScratch;
+}
+
+void JobSystem::start(std::size_t count)
+{
+    mThreadCount = count > 0 ? count : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    mRunning.store(true);
+
+    // Every deque exists before the first worker starts stealing.
+    mWorkers = new Worker*[mThreadCount];
+    mWorkers[0] = 0;
+    for (std::size_t index = 1; index < mThreadCount; ++index)
+    {
+        // operator new only honours the default alignment before C++17, the
+        // deque indices must keep their cache lines to themselves
+        void* memory = alignedMalloc(sizeof(Worker), alignof(Worker));
+        if (!memory)
+            throw std::bad_alloc();
+
+        mWorkers[index] = new (memory) Worker;
+        mWorkers[index]->random = static_cast<uint32>(index * 2654435761u) | 1u;
+    }
+
+    for (std::size_t index = 1; index < mThreadCount; ++index)
+        mWorkers[index]->thread = std::thread(&JobSystem::workerMain, this, index);
+}
+
+void JobSystem::stop()
+{
+    if (!mWorkers)
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(mSleepLock);
+        mRunning.store(false);
+        mWake.notify_all();
+    }
+
+    for (std::size_t index = 1; index < mThreadCount; ++index)
+    {
+        mWorkers[index]->thread.join();
+        mWorkers[index]->~Worker();
+        alignedFree(mWorkers[index]);
+    }
+
+    delete[] mWorkers;
+    mWorkers = 0;
+}
+
+void JobSystem::workerMain(std::size_t index)
+{
+    threadIndex = index;
+
+    int idle = 0;
+    while (mRunning.load(std::memory_order_acquire))
+    {
+        if (Job* job = findJob(index))
+        {
+            execute(*job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < IdleSpinCount)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Sleeping is announced before checking for jobs, submit reads it
+        // after queueing, so one of the two always sees the other.
+        std::unique_lock<std::mutex> lock(mSleepLock);
+        mSleeping.fetch_add(1);
+        while (mQueued.load() == 0 && mRunning.load())
+            mWake.wait(lock);
+        mSleeping.fetch_sub(1);
+        idle = 0;
+    }
+
+    threadIndex = 0;
+}
+
+void JobSystem::submit(Job& job, JobCounter& counter)
+{
+    // A job queued several times against one counter may already be running
+    // elsewhere, it is only written the first time.
+    if (job.counter != &counter)
+        job.counter = &counter;
+    counter.mPending.fetch_add(1);
+
+    if (mThreadCount <= 1)
+    {
+        execute(job);
+        return;
+    }
+
+    mQueued.fetch_add(1);
+
+    const std::size_t index = threadIndex;
+    if (index > 0)
+    {
+        // A full deque means plenty of queued work, run this one now.
+        if (!mWorkers[index]->deque.push(&job))
+        {
+            mQueued.fetch_sub(1);
+            execute(job);
+            return;
+        }
+    }
+    else
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+
+        if (mInjectedCount == mInjectedCapacity)
+        {
+            Job** jobs = new Job*[mInjectedCapacity * 2];
+            for (std::size_t i = 0; i < mInjectedCount; ++i)
+                jobs[i] = mInjected[(mInjectedHead + i) % mInjectedCapacity];
+
+            delete[] mInjected;
+            mInjected = jobs;
+            mInjectedHead = 0;
+            mInjectedCapacity *= 2;
+        }
+
+        mInjected[(mInjectedHead + mInjectedCount) % mInjectedCapacity] = &job;
+        ++mInjectedCount;
+    }
+
+    if (mSleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> guard(mSleepLock);
+        mWake.notify_one();
+    }
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+    const std::size_t index = threadIndex;
+
+    while (!counter.isDone())
+    {
+        if (Job* job = findJob(index))
+            execute(*job);
+        else
+            std::this_thread::yield();
+    }
+}
+
+Job* JobSystem::findJob(std::size_t index)
+{
+    Job* job = 0;
+
+    if (index > 0 && mWorkers[index]->deque.pop(job))
+    {
+        mQueued.fetch_sub(1);
+        return job;
+    }
+
+    // Steal from the other workers, starting at a random one.
+    const std::size_t workerCount = mThreadCount - 1;
+    if (workerCount > 0 && mQueued.load(std::memory_order_relaxed) > 0)
+    {
+        const std::size_t first = index > 0 ? mWorkers[index]->nextRandom() % workerCount : 0;
+        for (std::size_t i = 0; i < workerCount; ++i)
+        {
+            const std::size_t victim = (first + i) % workerCount + 1;
+            if (victim != index && mWorkers[victim]->deque.steal(job))
+            {
+                mQueued.fetch_sub(1);
+                return job;
+            }
+        }
+    }
+
+    if (mQueued.load(std::memory_order_relaxed) <= 0)
+        return 0;
+
+    std::lock_guard<std::mutex> guard(mLock);
+    if (mInjectedCount == 0)
+        return 0;
+
+    job = mInjected[mInjectedHead];
+    mInjectedHead = (mInjectedHead + 1) % mInjectedCapacity;
+    --mInjectedCount;
+    mQueued.fetch_sub(1);
+    return job;
+}
+
+void JobSystem::execute(Job& job)
+{
+    // The waiting thread may release the job as soon as the counter drops.
+    JobCounter* counter = job.counter;
+    job.function(job.data);
+    counter->mPending.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::runLoop(priv::ParallelLoop& loop)
+{
+    const std::size_t chunks = (loop.count + loop.grain - 1) / loop.grain;
+    const std::size_t helpers = std::min(chunks, mThreadCount) - 1;
+
+    // The same job is queued once per helper, each copy joins the loop.
+    Job job(&runLoopJob, &loop);
+    JobCounter counter;
+    for (std::size_t i = 0; i < helpers; ++i)
+        submit(job, counter);
+
+    loop.run(loop);
+    wait(counter);
+}
+
+std::size_t JobSystem::getGrainSize(std::size_t count, std::size_t grainSize) const
+{
+    if (grainSize > 0)
+        return grainSize;
+
+    return std::max<std::size_t>(1, count / (mThreadCount * 4));
+}
+
+} // namespace nx
@@ -0,0 +1,35 @@
+#include <nex/system/scratcharena.h>
+#include <nex/system/memory.h>
+
+namespace nx
+{
+
+ScratchArena::ScratchArena(std::size_t capacity) :
+    mData(static_cast<char*>(alignedMalloc(capacity > 0 ? capacity : 1, CacheLineSize))),
+    mCapacity(mData ? capacity : 0),
+    mOffset(0)
+{ }
+
+ScratchArena::~ScratchArena()
+{
+    alignedFree(mData);
+}
+
+void* ScratchArena::allocate(std::size_t size, std::size_t alignment)
+{
+    const std::size_t begin = (mOffset + alignment - 1) & ~(alignment - 1);
+    if (begin > mCapacity || size > mCapacity - begin)
+        return 0;
+
+    mOffset = begin + size;
+    return mData + begin;
+}
+
+void ScratchArena::deallocate(void* memory, std::size_t size)
+{
+    char* bytes = static_cast<char*>(memory);
+    if (bytes >= mData && bytes + size == mData + mOffset)
+        mOffset = bytes - mData;
+}
+
+} // namespace nx
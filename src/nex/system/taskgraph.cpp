@@ -0,0 +1,186 @@
+#include <nex/system/taskgraph.h>
+
+// Standard includes.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace
+{
+    int64 now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+namespace nx
+{
+
+struct TaskGraph::Task
+{
+    Task(TaskGraph& graph, const std::string& name, const std::function<void()>& function) :
+        graph(graph),
+        name(name),
+        function(function),
+        dependencyCount(0),
+        pending(0),
+        job(&TaskGraph::runTask, this)
+    {
+        timing.start = 0;
+        timing.duration = 0;
+        timing.thread = 0;
+    }
+
+    TaskGraph& graph;
+    std::string name;
+    std::function<void()> function;
+
+    // The tasks waiting for this one.
+    std::vector<uint32> successors;
+    uint32 dependencyCount;
+
+    // Dependencies left in the current run.
+    std::atomic<uint32> pending;
+
+    Job job;
+    TaskTiming timing;
+};
+
+TaskGraph::TaskGraph() :
+    mJobs(0),
+    mRunStart(0),
+    mRunTime(0)
+{ }
+
+TaskGraph::~TaskGraph()
+{ }
+
+uint32 TaskGraph::addTask(const std::string& name, const std::function<void()>& function)
+{
+    mTasks.push_back(std::unique_ptr<Task>(new Task(*this, name, function)));
+    return static_cast<uint32>(mTasks.size() - 1);
+}
+
+bool TaskGraph::addDependency(uint32 task, uint32 dependency)
+{
+    if (task >= mTasks.size() || dependency >= mTasks.size() || task == dependency)
+        return false;
+
+    // The dependency must not already wait for the task.
+    if (dependsOn(dependency, task))
+        return false;
+
+    std::vector<uint32>& successors = mTasks[dependency]->successors;
+    if (std::find(successors.begin(), successors.end(), task) == successors.end())
+    {
+        successors.push_back(task);
+        ++mTasks[task]->dependencyCount;
+    }
+
+    return true;
+}
+
+void TaskGraph::clear()
+{
+    mTasks.clear();
+    mRunTime = 0;
+}
+
+void TaskGraph::run(JobSystem& jobs)
+{
+    mJobs = &jobs;
+    mRunStart = now();
+
+    // Every counter is reset before the first task can release another.
+    for (std::size_t index = 0; index < mTasks.size(); ++index)
+        mTasks[index]->pending.store(mTasks[index]->dependencyCount, std::memory_order_relaxed);
+
+    for (std::size_t index = 0; index < mTasks.size(); ++index)
+    {
+        if (mTasks[index]->dependencyCount == 0)
+            jobs.submit(mTasks[index]->job, mCounter);
+    }
+
+    jobs.wait(mCounter);
+    mJobs = 0;
+
+    int64 end = 0;
+    for (std::size_t index = 0; index < mTasks.size(); ++index)
+        end = std::max(end, mTasks[index]->timing.start + mTasks[index]->timing.duration);
+    mRunTime = end;
+}
+
+void TaskGraph::run()
+{
+    run(JobSystem::getInstance());
+}
+
+const TaskTiming& TaskGraph::getTiming(uint32 task) const
+{
+    return mTasks[task]->timing;
+}
+
+const std::string& TaskGraph::getName(uint32 task) const
+{
+    return mTasks[task]->name;
+}
+
+void TaskGraph::runTask(void* data)
+{
+    Task* task = static_cast<Task*>(data);
+    TaskGraph& graph = task->graph;
+
+    // The first released successor runs right here instead of going
+    // through a queue, the others are submitted for idle threads.
+    while (task)
+    {
+        const int64 start = now();
+        task->function();
+        task->timing.start = start - graph.mRunStart;
+        task->timing.duration = now() - start;
+        task->timing.thread = JobSystem::getThreadIndex();
+
+        Task* next = 0;
+        for (std::size_t index = 0; index < task->successors.size(); ++index)
+        {
+            Task* successor = graph.mTasks[task->successors[index]].get();
+            if (successor->pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                continue;
+
+            if (next)
+                graph.mJobs->submit(successor->job, graph.mCounter);
+            else
+                next = successor;
+        }
+
+        task = next;
+    }
+}
+
+bool TaskGraph::dependsOn(uint32 task, uint32 dependency) const
+{
+    // Walks forward from the dependency, declaration time only.
+    std::vector<uint32> stack(1, dependency);
+    std::vector<bool> visited(mTasks.size(), false);
+
+    while (!stack.empty())
+    {
+        const uint32 current = stack.back();
+        stack.pop_back();
+
+        if (current == task)
+            return true;
+
+        if (visited[current])
+            continue;
+        visited[current] = true;
+
+        const std::vector<uint32>& successors = mTasks[current]->successors;
+        stack.insert(stack.end(), successors.begin(), successors.end());
+    }
+
+    return false;
+}
+
+} // namespace nx
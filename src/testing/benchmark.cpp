@@ -0,0 +1,74 @@
+#include "benchmark.h"
+
+// Standard includes.
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+    const void* volatile escapedPointer = nullptr;
+    volatile double consumedValue = 0.0;
+}
+
+namespace bench
+{
+
+uint32 getOption(const Options& options, const std::string& name, const uint32 fallback)
+{
+    Options::const_iterator it = options.find(name);
+
+    if (it == options.end())
+        return fallback;
+
+    return static_cast<uint32>(std::strtoul(it->second.c_str(), nullptr, 10));
+}
+
+std::string getOption(const Options& options, const std::string& name, const std::string& fallback)
+{
+    Options::const_iterator it = options.find(name);
+
+    if (it == options.end())
+        return fallback;
+
+    return it->second;
+}
+
+void escape(const void* data)
+{
+    escapedPointer = data;
+}
+
+void consume(const double value)
+{
+    consumedValue = consumedValue + value;
+}
+
+void section(const std::string& title)
+{
+    std::cout << std::endl << "== " << title << " ==" << std::endl;
+}
+
+void report(const std::string& label, const double milliseconds, const uint64 operations)
+{
+    const double nanoseconds = operations > 0 ? milliseconds * 1000000.0 / static_cast<double>(operations) : 0.0;
+
+    std::cout << "  " << std::left << std::setw(44) << label << std::right
+              << std::fixed << std::setprecision(3) << std::setw(10) << milliseconds << " ms"
+              << std::setprecision(2) << std::setw(12) << nanoseconds << " ns/op" << std::endl;
+}
+
+void reportSpeedup(const std::string& label, const double baseline, const double milliseconds)
+{
+    const double speedup = milliseconds > 0.0 ? baseline / milliseconds : 0.0;
+
+    std::cout << "  " << std::left << std::setw(44) << label << std::right
+              << std::fixed << std::setprecision(2) << std::setw(10) << speedup << " x" << std::endl;
+}
+
+void note(const std::string& note)
+{
+    std::cout << "  " << note << std::endl;
+}
+
+}
@@ -0,0 +1,130 @@
+#ifndef BENCHMARK_H_INCLUDE
+#define BENCHMARK_H_INCLUDE
+
+// Nex includes.
+#include <nex/system/typedefs.h>
+
+// Standard includes.
+#include <chrono>
+#include <map>
+#include <string>
+
+/*
+ * A small timing harness for nex-test.
+ *
+ * Every benchmark times the new code path against the one it replaced (or a plain
+ * reference implementation) on the same input, and prints both timings and the speedup.
+ * Build with CMAKE_BUILD_TYPE=Release, a Debug build times the unoptimized code.
+ */
+
+namespace bench
+{
+    /**
+     * @brief The name=value options given on the command line.
+     */
+    typedef std::map<std::string, std::string> Options;
+
+    /**
+     * @brief Reads an integer option.
+     * @param options = The command line options.
+     * @param name = The option name.
+     * @param fallback = The value used when the option was not given.
+     * @return the option value.
+     */
+    uint32 getOption(const Options& options, const std::string& name, const uint32 fallback);
+
+    /**
+     * @brief Reads a string option.
+     * @param options = The command line options.
+     * @param name = The option name.
+     * @param fallback = The value used when the option was not given.
+     * @return the option value.
+     */
+    std::string getOption(const Options& options, const std::string& name, const std::string& fallback);
+
+    /**
+     * @brief Hides a pointer from the optimizer so the memory it points to must be written.
+     * @param data = The results of the timed work.
+     */
+    void escape(const void* data);
+
+    /**
+     * @brief Hides a value from the optimizer so the work computing it must be done.
+     * @param value = A result of the timed work.
+     */
+    void consume(const double value);
+
+    /**
+     * @brief Runs a function several times and returns its fastest run.
+     * @param function = The work to time.
+     * @param runs = How many times to run it.
+     * @return the fastest run, in milliseconds.
+     */
+    template <typename Function>
+    double measure(Function function, const uint32 runs = 7)
+    {
+        double best = 0.0;
+
+        for (uint32 i = 0; i < runs; ++i)
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            function();
+            const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+            const double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+            if (i == 0 || milliseconds < best)
+                best = milliseconds;
+        }
+
+        return best;
+    }
+
+    /**
+     * @brief Prints a section header.
+     * @param title = The section title.
+     */
+    void section(const std::string& title);
+
+    /**
+     * @brief Prints a timing.
+     * @param label = What was timed.
+     * @param milliseconds = The fastest run.
+     * @param operations = The operations done by one run, used for the time per operation.
+     */
+    void report(const std::string& label, const double milliseconds, const uint64 operations);
+
+    /**
+     * @brief Prints how much faster a timing is than its baseline.
+     * @param label = What was compared.
+     * @param baseline = The fastest run of the old path.
+     * @param milliseconds = The fastest run of the new path.
+     */
+    void reportSpeedup(const std::string& label, const double baseline, const double milliseconds);
+
+    /**
+     * @brief Prints a note under the current section.
+     * @param note = The note.
+     */
+    void note(const std::string& note);
+
+    /**
+     * @brief Makes a headless OpenGL context current, for the benchmarks that upload textures.
+     * nex has no window module to create one, nex-test uses EGL when it was found at build time.
+     * @return true if a context is current.
+     */
+    bool createContext();
+
+    // The benchmarks, see the matching <name>benchmark.cpp.
+    void benchmarkMatrix(const Options& options);
+    void benchmarkFrustum(const Options& options);
+    void benchmarkBVH(const Options& options);
+    void benchmarkBroadphase2d(const Options& options);
+    void benchmarkPointCloud(const Options& options);
+    void benchmarkSwept(const Options& options);
+    void benchmarkTriangleBVH(const Options& options);
+    void benchmarkQueue(const Options& options);
+    void benchmarkFont(const Options& options);
+}
+
+#endif // BENCHMARK_H_INCLUDE
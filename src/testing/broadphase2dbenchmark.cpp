@@ -0,0 +1,146 @@
+#include "benchmark.h"
+
+// Nex includes.
+#include <nex/math/circle.h>
+#include <nex/math/loosequadtree.h>
+#include <nex/math/rect.h>
+#include <nex/math/spatialhash2d.h>
+
+// Standard includes.
+#include <random>
+#include <vector>
+
+using namespace nx;
+
+namespace
+{
+    const float WorldSize = 10000.0f;
+
+    /*
+     * Times moving every item and then running the rectangle and circle queries,
+     * with a structure that supports insert, update and query.
+     */
+    template <typename Structure>
+    void run(const std::string& name, Structure& structure, const std::vector<rectf>& items, const std::vector<rectf>& moved,
+             const std::vector<rectf>& regions, const std::vector<Circle>& circles,
+             uint64 expectedRegionHits, uint64 expectedCircleHits,
+             double bruteRegion, double bruteCircle)
+    {
+        std::vector<uint32> handles(items.size());
+        std::vector<uint32> results(items.size());
+
+        const double build = bench::measure([&]()
+        {
+            structure.clear();
+            for (std::size_t i = 0; i < items.size(); ++i)
+                handles[i] = structure.insert(items[i]);
+            bench::escape(handles.data());
+        });
+
+        // Every item moves a little, then moves back so each run starts from the same state.
+        const double update = bench::measure([&]()
+        {
+            for (std::size_t i = 0; i < items.size(); ++i)
+                structure.update(handles[i], moved[i]);
+            for (std::size_t i = 0; i < items.size(); ++i)
+                structure.update(handles[i], items[i]);
+        });
+
+        uint64 regionHits = 0;
+        const double region = bench::measure([&]()
+        {
+            regionHits = 0;
+            for (std::size_t i = 0; i < regions.size(); ++i)
+                regionHits += structure.query(regions[i], results.data(), results.size());
+            bench::escape(results.data());
+        });
+
+        uint64 circleHits = 0;
+        const double circle = bench::measure([&]()
+        {
+            circleHits = 0;
+            for (std::size_t i = 0; i < circles.size(); ++i)
+                circleHits += structure.query(circles[i], results.data(), results.size());
+            bench::escape(results.data());
+        });
+
+        bench::report(name + ", insert", build, items.size());
+        bench::report(name + ", update (two moves per item)", update, items.size() * 2);
+        bench::report(name + ", rect query", region, regions.size());
+        bench::reportSpeedup("  vs brute force", bruteRegion, region);
+        bench::report(name + ", circle query", circle, circles.size());
+        bench::reportSpeedup("  vs brute force", bruteCircle, circle);
+
+        if (regionHits != expectedRegionHits || circleHits != expectedCircleHits)
+            bench::note("error: " + name + " found other items than the brute force scan");
+    }
+}
+
+namespace bench
+{
+
+void benchmarkBroadphase2d(const Options& options)
+{
+    const uint32 count = getOption(options, "count", 50000);
+    const uint32 queryCount = getOption(options, "queries", 2000);
+
+    section("LooseQuadtree and SpatialHash2d vs brute force");
+    note("items: " + std::to_string(count) + ", queries: " + std::to_string(queryCount));
+
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(0.0f, WorldSize - 50.0f);
+    std::uniform_real_distribution<float> size(2.0f, 40.0f);
+    std::uniform_real_distribution<float> step(-4.0f, 4.0f);
+
+    std::vector<rectf> items(count), moved(count);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        items[i] = rectf(position(random), position(random), size(random), size(random));
+        moved[i] = rectf(items[i].x + step(random), items[i].y + step(random), items[i].width, items[i].height);
+    }
+
+    std::vector<rectf> regions(queryCount);
+    std::vector<Circle> circles(queryCount);
+
+    for (uint32 i = 0; i < queryCount; ++i)
+    {
+        regions[i] = rectf(position(random), position(random), 100.0f, 100.0f);
+        circles[i] = Circle(vec2f(position(random), position(random)), 50.0f);
+    }
+
+    uint64 regionHits = 0;
+    const double bruteRegion = measure([&]()
+    {
+        regionHits = 0;
+        for (uint32 i = 0; i < queryCount; ++i)
+        {
+            for (uint32 j = 0; j < count; ++j)
+                regionHits += items[j].intersects(regions[i]) ? 1 : 0;
+        }
+        consume(static_cast<double>(regionHits));
+    }, 3);
+
+    uint64 circleHits = 0;
+    const double bruteCircle = measure([&]()
+    {
+        circleHits = 0;
+        for (uint32 i = 0; i < queryCount; ++i)
+        {
+            for (uint32 j = 0; j < count; ++j)
+                circleHits += Circle::intersects(circles[i], items[j]) ? 1 : 0;
+        }
+        consume(static_cast<double>(circleHits));
+    }, 3);
+
+    report("brute force, rect query", bruteRegion, queryCount);
+    report("brute force, circle query", bruteCircle, queryCount);
+
+    LooseQuadtree quadtree(rectf(0.0f, 0.0f, WorldSize, WorldSize));
+    run("LooseQuadtree", quadtree, items, moved, regions, circles, regionHits, circleHits, bruteRegion, bruteCircle);
+
+    SpatialHash2d hash(64.0f);
+    run("SpatialHash2d", hash, items, moved, regions, circles, regionHits, circleHits, bruteRegion, bruteCircle);
+}
+
+}
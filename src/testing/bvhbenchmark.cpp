@@ -0,0 +1,228 @@
+#include "benchmark.h"
+
+// Nex includes.
+#include <nex/math/aabb.h>
+#include <nex/math/bvh.h>
+#include <nex/math/frustum.h>
+#include <nex/math/ray.h>
+#include <nex/math/sphere.h>
+
+// Standard includes.
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace nx;
+
+namespace bench
+{
+
+void benchmarkBVH(const Options& options)
+{
+    const uint32 count = getOption(options, "count", 100000);
+    const uint32 rayCount = getOption(options, "rays", 1000);
+    const uint32 queryCount = getOption(options, "queries", 200);
+
+    section("BVH: queries vs linear scans over the boxes");
+    note("boxes: " + std::to_string(count) + ", rays: " + std::to_string(rayCount) +
+         ", sphere/box queries: " + std::to_string(queryCount));
+
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> extent(0.5f, 5.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    std::vector<AABB> boxes(count);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        const vec3f center(position(random), position(random), position(random));
+        const vec3f half(extent(random), extent(random), extent(random));
+        boxes[i] = AABB(center - half, center + half);
+    }
+
+    // Rays start outside the scene, where Ray::intersects(AABB) does not report 0 for a hit.
+    std::vector<Ray> rays(rayCount);
+
+    for (uint32 i = 0; i < rayCount; ++i)
+    {
+        vec3f origin(unit(random), unit(random), unit(random));
+        origin = vec3f::normalize(origin) * 1000.0f;
+        const vec3f target(position(random) * 0.5f, position(random) * 0.5f, position(random) * 0.5f);
+        rays[i] = Ray(origin, vec3f::normalize(target - origin));
+    }
+
+    std::vector<Sphere> spheres(queryCount);
+    std::vector<AABB> regions(queryCount);
+
+    for (uint32 i = 0; i < queryCount; ++i)
+    {
+        const vec3f center(position(random), position(random), position(random));
+        spheres[i] = Sphere(center, 25.0f);
+        regions[i] = AABB(center - vec3f(25.0f, 25.0f, 25.0f), center + vec3f(25.0f, 25.0f, 25.0f));
+    }
+
+    Frustum frustum;
+    frustum.setMatrix(mat4f::perspective(1.0f, 16.0f / 9.0f, 0.1f, 300.0f) *
+                      mat4f::lookAt(vec3f(0.0f, 0.0f, 0.0f), vec3f(1.0f, 0.2f, 1.0f), vec3f(0.0f, 1.0f, 0.0f)));
+
+    BVH bvh;
+    const double build = measure([&]()
+    {
+        bvh.build(boxes);
+        escape(bvh.getNodes());
+    });
+
+    report("build", build, count);
+    note("nodes: " + std::to_string(bvh.getNodeCount()));
+
+    // Closest hit along every ray.
+    std::vector<uint32> linearHits(rayCount), bvhHits(rayCount);
+
+    const double linearRaycast = measure([&]()
+    {
+        for (uint32 i = 0; i < rayCount; ++i)
+        {
+            uint32 closest = ~0u;
+            float closestDistance = std::numeric_limits<float>::max();
+
+            for (uint32 j = 0; j < count; ++j)
+            {
+                const float distance = rays[i].intersects(boxes[j]);
+                if (distance > 0.0f && distance < closestDistance)
+                {
+                    closest = j;
+                    closestDistance = distance;
+                }
+            }
+
+            linearHits[i] = closest;
+        }
+        escape(linearHits.data());
+    }, 3);
+
+    const double bvhRaycast = measure([&]()
+    {
+        for (uint32 i = 0; i < rayCount; ++i)
+        {
+            BVHHit hit;
+            bvhHits[i] = bvh.raycast(rays[i], hit) ? hit.index : ~0u;
+        }
+        escape(bvhHits.data());
+    });
+
+    uint32 rayMismatches = 0;
+    for (uint32 i = 0; i < rayCount; ++i)
+        rayMismatches += linearHits[i] != bvhHits[i] ? 1 : 0;
+
+    report("raycast, linear scan", linearRaycast, rayCount);
+    report("raycast, bvh", bvhRaycast, rayCount);
+    reportSpeedup("raycast speedup", linearRaycast, bvhRaycast);
+
+    // Every box overlapping a sphere or box region.
+    std::vector<uint32> results;
+    results.reserve(count);
+    uint64 linearFound = 0;
+    uint64 bvhFound = 0;
+
+    const double linearSphere = measure([&]()
+    {
+        linearFound = 0;
+        for (uint32 i = 0; i < queryCount; ++i)
+        {
+            results.clear();
+            for (uint32 j = 0; j < count; ++j)
+            {
+                if (boxes[j].intersects(spheres[i]))
+                    results.push_back(j);
+            }
+            linearFound += results.size();
+        }
+        escape(results.data());
+    }, 3);
+
+    const double bvhSphere = measure([&]()
+    {
+        bvhFound = 0;
+        for (uint32 i = 0; i < queryCount; ++i)
+        {
+            results.clear();
+            bvh.query(spheres[i], results);
+            bvhFound += results.size();
+        }
+        escape(results.data());
+    });
+
+    const bool spheresAgree = linearFound == bvhFound;
+
+    report("sphere query, linear scan", linearSphere, queryCount);
+    report("sphere query, bvh", bvhSphere, queryCount);
+    reportSpeedup("sphere query speedup", linearSphere, bvhSphere);
+
+    const double linearBox = measure([&]()
+    {
+        linearFound = 0;
+        for (uint32 i = 0; i < queryCount; ++i)
+        {
+            results.clear();
+            for (uint32 j = 0; j < count; ++j)
+            {
+                if (boxes[j].intersects(regions[i]))
+                    results.push_back(j);
+            }
+            linearFound += results.size();
+        }
+        escape(results.data());
+    }, 3);
+
+    const double bvhBox = measure([&]()
+    {
+        bvhFound = 0;
+        for (uint32 i = 0; i < queryCount; ++i)
+        {
+            results.clear();
+            bvh.query(regions[i], results);
+            bvhFound += results.size();
+        }
+        escape(results.data());
+    });
+
+    const bool boxesAgree = linearFound == bvhFound;
+
+    report("box query, linear scan", linearBox, queryCount);
+    report("box query, bvh", bvhBox, queryCount);
+    reportSpeedup("box query speedup", linearBox, bvhBox);
+
+    const double linearFrustum = measure([&]()
+    {
+        results.clear();
+        for (uint32 j = 0; j < count; ++j)
+        {
+            if (frustum.intersects(boxes[j]))
+                results.push_back(j);
+        }
+        linearFound = results.size();
+        escape(results.data());
+    });
+
+    const double bvhFrustum = measure([&]()
+    {
+        results.clear();
+        bvh.query(frustum, results);
+        bvhFound = results.size();
+        escape(results.data());
+    });
+
+    const bool frustumAgrees = linearFound == bvhFound;
+
+    report("frustum query, linear scan", linearFrustum, 1);
+    report("frustum query, bvh", bvhFrustum, 1);
+    reportSpeedup("frustum query speedup", linearFrustum, bvhFrustum);
+
+    if (rayMismatches != 0)
+        note("error: " + std::to_string(rayMismatches) + " rays hit another box than the linear scan");
+    if (!spheresAgree || !boxesAgree || !frustumAgrees)
+        note("error: the bvh queries found other boxes than the linear scans");
+}
+
+}
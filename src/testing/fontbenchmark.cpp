@@ -0,0 +1,130 @@
+#include "benchmark.h"
+
+// Nex includes.
+#include <nex/gfx/font.h>
+
+// The engine leaves the stb implementations to the application.
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+// Standard includes.
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+using namespace nx;
+
+namespace
+{
+    // Asks for every printable ASCII glyph at every size, as a UI with many text sizes does.
+    void requestGlyphs(const Font& font, const std::vector<uint32>& sizes)
+    {
+        double advance = 0.0;
+
+        for (std::size_t i = 0; i < sizes.size(); ++i)
+        {
+            for (uint32 codePoint = 32; codePoint < 127; ++codePoint)
+                advance += font.getGlyph(codePoint, sizes[i], false).advance;
+        }
+
+        bench::consume(advance);
+    }
+
+    void reportStats(const std::string& name, const FontStats& stats)
+    {
+        std::ostringstream line;
+        line << name << ": pages " << stats.pageCount << ", atlases " << stats.atlasCount << ", atlas memory "
+             << stats.atlasBytes / 1024 << " KiB, glyphs rasterized " << stats.glyphsRasterized << ", cache misses "
+             << stats.cacheMisses;
+        bench::note(line.str());
+    }
+}
+
+namespace bench
+{
+
+void benchmarkFont(const Options& options)
+{
+    const std::string path = getOption(options, "font", std::string());
+    const uint32 sizeCount = std::max(1u, getOption(options, "sizes", 12));
+
+    section("Font: distance field glyphs vs glyphs rendered for each size");
+
+    if (path.empty())
+    {
+        note("skipped, pass font=<path to a .ttf or .otf file>");
+        return;
+    }
+
+    if (!createContext())
+    {
+        note("skipped, the glyph atlases need an OpenGL context and none could be created");
+        return;
+    }
+
+    std::vector<uint32> sizes;
+    for (uint32 i = 0; i < sizeCount; ++i)
+        sizes.push_back(12 + i * 4);
+
+    note("font: " + path + ", sizes 12 to " + std::to_string(sizes.back()) + ", 95 glyphs per size");
+
+    Font check;
+    if (!check.loadFromFile(path))
+    {
+        note("error: the font could not be loaded");
+        return;
+    }
+
+    FontStats bitmapStats, distanceFieldStats;
+
+    // Cold runs load the font and fill every cache, warm runs only look glyphs up.
+    const double bitmapCold = measure([&]()
+    {
+        Font font;
+        font.loadFromFile(path);
+        requestGlyphs(font, sizes);
+        bitmapStats = font.getStats();
+    }, 3);
+
+    const double distanceFieldCold = measure([&]()
+    {
+        Font font;
+        font.loadFromFile(path);
+        font.setDistanceField(true);
+        requestGlyphs(font, sizes);
+        distanceFieldStats = font.getStats();
+    }, 3);
+
+    Font bitmap;
+    bitmap.loadFromFile(path);
+    requestGlyphs(bitmap, sizes);
+    const double bitmapWarm = measure([&]()
+    {
+        requestGlyphs(bitmap, sizes);
+    });
+
+    Font distanceField;
+    distanceField.loadFromFile(path);
+    distanceField.setDistanceField(true);
+    requestGlyphs(distanceField, sizes);
+    const double distanceFieldWarm = measure([&]()
+    {
+        requestGlyphs(distanceField, sizes);
+    });
+
+    const uint64 glyphCount = static_cast<uint64>(sizes.size()) * 95;
+
+    report("per size, load and fill the caches", bitmapCold, glyphCount);
+    report("distance field, load and fill the caches", distanceFieldCold, glyphCount);
+    reportSpeedup("  distance field vs per size", bitmapCold, distanceFieldCold);
+    report("per size, cached lookups", bitmapWarm, glyphCount);
+    report("distance field, cached lookups", distanceFieldWarm, glyphCount);
+    reportSpeedup("  distance field vs per size", bitmapWarm, distanceFieldWarm);
+
+    reportStats("per size", bitmapStats);
+    reportStats("distance field", distanceFieldStats);
+}
+
+}
@@ -0,0 +1,161 @@
+#include "benchmark.h"
+
+// Nex includes.
+#include <nex/math/aabb.h>
+#include <nex/math/frustum.h>
+#include <nex/math/sphere.h>
+#include <nex/system/jobsystem.h>
+
+// Standard includes.
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace nx;
+
+namespace
+{
+    uint32 countVisible(const std::vector<uint32>& visibility)
+    {
+        uint32 visible = 0;
+
+        for (std::size_t i = 0; i < visibility.size(); ++i)
+        {
+            for (uint32 bits = visibility[i]; bits != 0; bits &= bits - 1)
+                ++visible;
+        }
+
+        return visible;
+    }
+}
+
+namespace bench
+{
+
+void benchmarkFrustum(const Options& options)
+{
+    const uint32 count = getOption(options, "count", 1u << 20);
+    const uint32 hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    const uint32 maxThreads = getOption(options, "threads", std::max(4u, hardwareThreads));
+
+    section("Frustum: batch culling across threads vs one object at a time");
+    note("objects: " + std::to_string(count) + ", hardware threads: " + std::to_string(hardwareThreads));
+
+    Frustum frustum;
+    frustum.setMatrix(mat4f::perspective(1.0f, 16.0f / 9.0f, 0.1f, 500.0f) *
+                      mat4f::lookAt(vec3f(0.0f, 10.0f, 0.0f), vec3f(100.0f, 0.0f, 100.0f), vec3f(0.0f, 1.0f, 0.0f)));
+
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> extent(0.5f, 5.0f);
+
+    std::vector<float> minX(count), minY(count), minZ(count), maxX(count), maxY(count), maxZ(count);
+    std::vector<float> centerX(count), centerY(count), centerZ(count), radius(count);
+    std::vector<AABB> boxes(count);
+    std::vector<Sphere> spheres(count);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        const vec3f center(position(random), position(random) * 0.05f, position(random));
+        const vec3f half(extent(random), extent(random), extent(random));
+
+        minX[i] = center.x - half.x;
+        minY[i] = center.y - half.y;
+        minZ[i] = center.z - half.z;
+        maxX[i] = center.x + half.x;
+        maxY[i] = center.y + half.y;
+        maxZ[i] = center.z + half.z;
+        centerX[i] = center.x;
+        centerY[i] = center.y;
+        centerZ[i] = center.z;
+        radius[i] = half.x;
+
+        boxes[i] = AABB(center - half, center + half);
+        spheres[i] = Sphere(center, half.x);
+    }
+
+    std::vector<uint32> visibility((count + 31) / 32);
+    std::vector<uint32> reference((count + 31) / 32);
+
+    // One object at a time through the single object queries, as callers culled before the batch API.
+    const double boxBaseline = measure([&]()
+    {
+        std::fill(reference.begin(), reference.end(), 0u);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            if (frustum.intersects(boxes[i]))
+                reference[i / 32] |= 1u << (i % 32);
+        }
+        escape(reference.data());
+    });
+    const uint32 boxesVisible = countVisible(reference);
+
+    const double sphereBaseline = measure([&]()
+    {
+        std::fill(reference.begin(), reference.end(), 0u);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            if (frustum.intersects(spheres[i]))
+                reference[i / 32] |= 1u << (i % 32);
+        }
+        escape(reference.data());
+    });
+    const uint32 spheresVisible = countVisible(reference);
+
+    report("boxes, intersects() per box", boxBaseline, count);
+    report("spheres, intersects() per sphere", sphereBaseline, count);
+
+    JobSystem& jobs = JobSystem::getInstance();
+    double boxSingle = 0.0;
+    double sphereSingle = 0.0;
+
+    for (uint32 threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        jobs.setThreadCount(threads);
+
+        const double boxTime = measure([&]()
+        {
+            frustum.cullBoxes(minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(),
+                              count, visibility.data(), 0, jobs);
+            escape(visibility.data());
+        });
+        const uint32 boxesCulled = countVisible(visibility);
+
+        const double sphereTime = measure([&]()
+        {
+            frustum.cullSpheres(centerX.data(), centerY.data(), centerZ.data(), radius.data(), count, visibility.data(), 0, jobs);
+            escape(visibility.data());
+        });
+        const uint32 spheresCulled = countVisible(visibility);
+
+        if (threads == 1)
+        {
+            boxSingle = boxTime;
+            sphereSingle = sphereTime;
+        }
+
+        const std::string suffix = ", " + std::to_string(threads) + " thread" + (threads > 1 ? "s" : "");
+
+        report("cullBoxes" + suffix, boxTime, count);
+        reportSpeedup("  vs one thread", boxSingle, boxTime);
+        reportSpeedup("  vs intersects() per box", boxBaseline, boxTime);
+        report("cullSpheres" + suffix, sphereTime, count);
+        reportSpeedup("  vs one thread", sphereSingle, sphereTime);
+        reportSpeedup("  vs intersects() per sphere", sphereBaseline, sphereTime);
+
+        if (boxesCulled != boxesVisible)
+            note("error: cullBoxes found " + std::to_string(boxesCulled) + " visible boxes, intersects() " + std::to_string(boxesVisible));
+        if (spheresCulled != spheresVisible)
+            note("error: cullSpheres found " + std::to_string(spheresCulled) + " visible spheres, intersects() " + std::to_string(spheresVisible));
+    }
+
+    note("visible boxes: " + std::to_string(boxesVisible) + ", visible spheres: " + std::to_string(spheresVisible));
+
+    if (maxThreads > hardwareThreads)
+        note("runs with more threads than the hardware has do not show scaling");
+
+    jobs.setThreadCount(0);
+}
+
+}
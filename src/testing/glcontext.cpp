@@ -0,0 +1,50 @@
+#include "benchmark.h"
+
+#include <GL/glew.h>
+
+#if defined(NEX_TEST_EGL)
+    #include <EGL/egl.h>
+    #include <EGL/eglext.h>
+#endif
+
+namespace bench
+{
+
+bool createContext()
+{
+#if defined(NEX_TEST_EGL)
+    static bool created = false;
+    if (created)
+        return true;
+
+    // A surfaceless display needs no window system, eglGetDisplay is the fallback.
+    EGLDisplay display = EGL_NO_DISPLAY;
+
+#if defined(EGL_PLATFORM_SURFACELESS_MESA)
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay)
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+#endif
+
+    if (display == EGL_NO_DISPLAY)
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr) || !eglBindAPI(EGL_OPENGL_API))
+        return false;
+
+    // The textures are never drawn, so the context needs neither a config nor a surface.
+    EGLContext context = eglCreateContext(display, static_cast<EGLConfig>(nullptr), EGL_NO_CONTEXT, nullptr);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+        return false;
+
+    glewExperimental = GL_TRUE;
+    created = glewInit() == GLEW_OK;
+
+    return created;
+#else
+    return false;
+#endif
+}
+
+}
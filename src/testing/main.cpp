@@ -1,11 +1,83 @@
 #include <iostream>
+#include <string>
+#include <vector>
 
-#include <nex/math/rect.h>
-#include <nex/math/circle.h>
+#include "benchmark.h"
 
-using namespace nx;
+namespace
+{
+    struct Benchmark
+    {
+        const char* name;
+        void (*run)(const bench::Options& options);
+    };
+
+    const Benchmark benchmarks[] =
+    {
+        { "matrix", &bench::benchmarkMatrix },
+        { "frustum", &bench::benchmarkFrustum },
+        { "bvh", &bench::benchmarkBVH },
+        { "broadphase2d", &bench::benchmarkBroadphase2d },
+        { "pointcloud", &bench::benchmarkPointCloud },
+        { "swept", &bench::benchmarkSwept },
+        { "trianglebvh", &bench::benchmarkTriangleBVH },
+        { "queue", &bench::benchmarkQueue },
+        { "font", &bench::benchmarkFont },
+    };
+
+    const uint32 benchmarkCount = sizeof(benchmarks) / sizeof(benchmarks[0]);
+
+    void printUsage()
+    {
+        std::cout << "usage: nex-test [benchmark...] [option=value...]" << std::endl;
+        std::cout << "runs every benchmark when none is named. benchmarks:" << std::endl;
+
+        for (uint32 i = 0; i < benchmarkCount; ++i)
+            std::cout << "  " << benchmarks[i].name << std::endl;
+    }
+}
 
 int main(int argc, char** args)
 {
+    bench::Options options;
+    std::vector<const Benchmark*> selected;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = args[i];
+        const std::string::size_type separator = argument.find('=');
+
+        if (separator != std::string::npos)
+        {
+            options[argument.substr(0, separator)] = argument.substr(separator + 1);
+            continue;
+        }
+
+        const Benchmark* benchmark = nullptr;
+
+        for (uint32 j = 0; j < benchmarkCount; ++j)
+        {
+            if (argument == benchmarks[j].name)
+                benchmark = &benchmarks[j];
+        }
+
+        if (!benchmark)
+        {
+            printUsage();
+            return argument == "help" ? 0 : 1;
+        }
+
+        selected.push_back(benchmark);
+    }
+
+    if (selected.empty())
+    {
+        for (uint32 i = 0; i < benchmarkCount; ++i)
+            selected.push_back(&benchmarks[i]);
+    }
+
+    for (std::vector<const Benchmark*>::const_iterator it = selected.begin(); it != selected.end(); ++it)
+        (*it)->run(options);
 
+    return 0;
 }
@@ -0,0 +1,240 @@
+#include "benchmark.h"
+
+// Nex includes.
+#include <nex/math/matrix.h>
+#include <nex/math/simd.h>
+
+// Standard includes.
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace nx;
+
+namespace
+{
+    /*
+     * A float the mat4f specializations do not match, so Matrix<ScalarFloat> runs the
+     * generic scalar templates with the same float arithmetic mat4f used before them.
+     */
+    struct ScalarFloat
+    {
+        ScalarFloat() : value(0.0f) {}
+        ScalarFloat(const double value) : value(static_cast<float>(value)) {}
+
+        float value;
+    };
+
+    inline ScalarFloat operator +(const ScalarFloat left, const ScalarFloat right) { return ScalarFloat(left.value + right.value); }
+    inline ScalarFloat operator -(const ScalarFloat left, const ScalarFloat right) { return ScalarFloat(left.value - right.value); }
+    inline ScalarFloat operator *(const ScalarFloat left, const ScalarFloat right) { return ScalarFloat(left.value * right.value); }
+    inline ScalarFloat operator /(const ScalarFloat left, const ScalarFloat right) { return ScalarFloat(left.value / right.value); }
+    inline ScalarFloat operator -(const ScalarFloat value) { return ScalarFloat(-value.value); }
+
+    typedef Matrix<ScalarFloat> ScalarMatrix;
+
+    ScalarMatrix toScalar(const mat4f& matrix)
+    {
+        ScalarMatrix result;
+
+        for (uint32 column = 0; column < 4; ++column)
+            for (uint32 row = 0; row < 4; ++row)
+                result[column][row] = matrix[column][row];
+
+        return result;
+    }
+
+    float difference(const mat4f& left, const ScalarMatrix& right)
+    {
+        float largest = 0.0f;
+
+        for (uint32 column = 0; column < 4; ++column)
+            for (uint32 row = 0; row < 4; ++row)
+                largest = std::max(largest, std::abs(left[column][row] - right[column][row].value));
+
+        return largest;
+    }
+
+    // A random rotation, scale and translation, so both inverses are well conditioned.
+    mat4f randomAffine(std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+        std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+        std::uniform_real_distribution<float> offset(-100.0f, 100.0f);
+
+        return mat4f::translate(vec3f(offset(random), offset(random), offset(random))) *
+               mat4f::rotateY(angle(random)) *
+               mat4f::rotateX(angle(random)) *
+               mat4f::scale(scale(random), scale(random), scale(random));
+    }
+
+    std::string simdName()
+    {
+#if defined(NEX_SIMD_AVX2)
+        return "AVX2/FMA";
+#elif defined(NEX_SIMD_AVX)
+        return "AVX";
+#elif defined(NEX_SIMD_SSE)
+        return "SSE2";
+#else
+        return "none, NEX_NO_SIMD or no SSE2";
+#endif
+    }
+}
+
+namespace bench
+{
+
+void benchmarkMatrix(const Options& options)
+{
+    const uint32 count = getOption(options, "count", 1u << 16);
+
+    section("mat4f: SIMD specializations vs the scalar templates");
+    note("simd: " + simdName() + ", matrices: " + std::to_string(count));
+
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+
+    std::vector<mat4f> left(count), right(count), result(count);
+    std::vector<ScalarMatrix> scalarLeft(count), scalarRight(count), scalarResult(count);
+    std::vector<vec4f> vectors(count), vectorResult(count);
+    std::vector<Vec4<ScalarFloat> > scalarVectors(count), scalarVectorResult(count);
+    std::vector<vec3f> positions(count), positionResult(count);
+    std::vector<Vec3<ScalarFloat> > scalarPositions(count), scalarPositionResult(count);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        left[i] = randomAffine(random);
+        right[i] = randomAffine(random);
+        scalarLeft[i] = toScalar(left[i]);
+        scalarRight[i] = toScalar(right[i]);
+
+        positions[i] = vec3f(coordinate(random), coordinate(random), coordinate(random));
+        vectors[i] = vec4f(positions[i].x, positions[i].y, positions[i].z, 1.0f);
+        scalarPositions[i] = Vec3<ScalarFloat>(positions[i].x, positions[i].y, positions[i].z);
+        scalarVectors[i] = Vec4<ScalarFloat>(vectors[i].x, vectors[i].y, vectors[i].z, vectors[i].w);
+    }
+
+    // Checks the two paths agree on the last results before comparing their speed.
+    float largestError = 0.0f;
+
+    const double scalarMultiply = measure([&]()
+    {
+        for (uint32 i = 0; i < count; ++i)
+            scalarResult[i] = scalarLeft[i] * scalarRight[i];
+        escape(scalarResult.data());
+    });
+    const double simdMultiply = measure([&]()
+    {
+        for (uint32 i = 0; i < count; ++i)
+            result[i] = left[i] * right[i];
+        escape(result.data());
+    });
+
+    for (uint32 i = 0; i < count; ++i)
+        largestError = std::max(largestError, difference(result[i], scalarResult[i]));
+
+    const double scalarInverse = measure([&]()
+    {
+        for (uint32 i = 0; i < count; ++i)
+            scalarResult[i] = ScalarMatrix::inverse(scalarLeft[i]);
+        escape(scalarResult.data());
+    });
+    const double simdInverse = measure([&]()
+    {
+        for (uint32 i = 0; i < count; ++i)
+            result[i] = mat4f::inverse(left[i]);
+        escape(result.data());
+    });
+
+    for (uint32 i = 0; i < count; ++i)
+        largestError = std::max(largestError, difference(result[i], scalarResult[i]));
+
+    const double scalarAffineInverse = measure([&]()
+    {
+        for (uint32 i = 0; i < count; ++i)
+            scalarResult[i] = ScalarMatrix::affineInverse(scalarLeft[i]);
+        escape(scalarResult.data());
+    });
+    const double simdAffineInverse = measure([&]()
+    {
+        for (uint32 i = 0; i < count; ++i)
+            result[i] = mat4f::affineInverse(left[i]);
+        escape(result.data());
+    });
+
+    for (uint32 i = 0; i < count; ++i)
+        largestError = std::max(largestError, difference(result[i], scalarResult[i]));
+
+    const double scalarTranspose = measure([&]()
+    {
+        for (uint32 i = 0; i < count; ++i)
+            scalarResult[i] = ScalarMatrix::transpose(scalarLeft[i]);
+        escape(scalarResult.data());
+    });
+    const double simdTranspose = measure([&]()
+    {
+        for (uint32 i = 0; i < count; ++i)
+            result[i] = mat4f::transpose(left[i]);
+        escape(result.data());
+    });
+
+    const double scalarTransform4 = measure([&]()
+    {
+        for (uint32 i = 0; i < count; ++i)
+            scalarVectorResult[i] = ScalarMatrix::transform(scalarVectors[i], scalarLeft[i]);
+        escape(scalarVectorResult.data());
+    });
+    const double simdTransform4 = measure([&]()
+    {
+        for (uint32 i = 0; i < count; ++i)
+            vectorResult[i] = mat4f::transform(vectors[i], left[i]);
+        escape(vectorResult.data());
+    });
+
+    const double scalarTransform3 = measure([&]()
+    {
+        for (uint32 i = 0; i < count; ++i)
+            scalarPositionResult[i] = ScalarMatrix::transform(scalarPositions[i], scalarLeft[i]);
+        escape(scalarPositionResult.data());
+    });
+    const double simdTransform3 = measure([&]()
+    {
+        for (uint32 i = 0; i < count; ++i)
+            positionResult[i] = mat4f::transform(positions[i], left[i]);
+        escape(positionResult.data());
+    });
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        largestError = std::max(largestError, std::abs(vectorResult[i].x - scalarVectorResult[i].x.value));
+        largestError = std::max(largestError, std::abs(positionResult[i].y - scalarPositionResult[i].y.value));
+    }
+
+    report("multiply, scalar", scalarMultiply, count);
+    report("multiply, simd", simdMultiply, count);
+    reportSpeedup("multiply speedup", scalarMultiply, simdMultiply);
+    report("inverse, scalar", scalarInverse, count);
+    report("inverse, simd", simdInverse, count);
+    reportSpeedup("inverse speedup", scalarInverse, simdInverse);
+    report("affineInverse, scalar", scalarAffineInverse, count);
+    report("affineInverse, simd", simdAffineInverse, count);
+    reportSpeedup("affineInverse speedup", scalarAffineInverse, simdAffineInverse);
+    report("transpose, scalar", scalarTranspose, count);
+    report("transpose, simd", simdTranspose, count);
+    reportSpeedup("transpose speedup", scalarTranspose, simdTranspose);
+    report("transform vec4, scalar", scalarTransform4, count);
+    report("transform vec4, simd", simdTransform4, count);
+    reportSpeedup("transform vec4 speedup", scalarTransform4, simdTransform4);
+    report("transform vec3, scalar", scalarTransform3, count);
+    report("transform vec3, simd", simdTransform3, count);
+    reportSpeedup("transform vec3 speedup", scalarTransform3, simdTransform3);
+
+    std::ostringstream error;
+    error << "largest difference between the paths: " << largestError;
+    note(error.str());
+}
+
+}
@@ -0,0 +1,196 @@
+#include "benchmark.h"
+
+// Nex includes.
+#include <nex/math/aabb.h>
+#include <nex/math/sphere.h>
+
+// Standard includes.
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace nx;
+
+namespace
+{
+    // A typical interleaved vertex, the strided overloads read its position in place.
+    struct Vertex
+    {
+        vec3f position;
+        vec3f normal;
+        float u;
+        float v;
+    };
+
+    // The scalar loop AABB::createFromPoints ran before, minus the copy and the origin seed.
+    AABB scalarBox(const std::vector<vec3f>& points)
+    {
+        vec3f min = points[0];
+        vec3f max = points[0];
+
+        for (std::size_t i = 1; i < points.size(); ++i)
+        {
+            min = vec3f::min(min, points[i]);
+            max = vec3f::max(max, points[i]);
+        }
+
+        return AABB(min, max);
+    }
+
+    // Ritter's method as Sphere::createFromPoints ran it before, the points taken by value.
+    Sphere scalarSphere(std::vector<vec3f> points)
+    {
+        vec3f minX = points[0], maxX = points[0];
+        vec3f minY = points[0], maxY = points[0];
+        vec3f minZ = points[0], maxZ = points[0];
+
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            const vec3f& point = points[i];
+
+            if (point.x < minX.x)
+                minX = point;
+            if (point.x > maxX.x)
+                maxX = point;
+            if (point.y < minY.y)
+                minY = point;
+            if (point.y > maxY.y)
+                maxY = point;
+            if (point.z < minZ.z)
+                minZ = point;
+            if (point.z > maxZ.z)
+                maxZ = point;
+        }
+
+        const float spanX = vec3f::distance(minX, maxX);
+        const float spanY = vec3f::distance(minY, maxY);
+        const float spanZ = vec3f::distance(minZ, maxZ);
+
+        vec3f center;
+        float radius;
+
+        if (spanX >= spanY && spanX >= spanZ)
+        {
+            center = vec3f::lerp(minX, maxX, 0.5f);
+            radius = spanX * 0.5f;
+        }
+        else if (spanY >= spanZ)
+        {
+            center = vec3f::lerp(minY, maxY, 0.5f);
+            radius = spanY * 0.5f;
+        }
+        else
+        {
+            center = vec3f::lerp(minZ, maxZ, 0.5f);
+            radius = spanZ * 0.5f;
+        }
+
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            const vec3f offset = points[i] - center;
+            const float length = offset.length();
+
+            if (length > radius)
+            {
+                radius = (radius + length) * 0.5f;
+                center += (1.0f - radius / length) * offset;
+            }
+        }
+
+        return Sphere(center, radius);
+    }
+
+    bool sameBox(const AABB& left, const AABB& right)
+    {
+        return left.min.x == right.min.x && left.min.y == right.min.y && left.min.z == right.min.z &&
+               left.max.x == right.max.x && left.max.y == right.max.y && left.max.z == right.max.z;
+    }
+
+    void run(const std::vector<vec3f>& points)
+    {
+        const uint32 count = static_cast<uint32>(points.size());
+        const std::string suffix = ", " + std::to_string(count) + " points";
+
+        std::vector<Vertex> vertices(count);
+        for (uint32 i = 0; i < count; ++i)
+            vertices[i].position = points[i];
+
+        AABB reference, packed, strided;
+
+        const double scalarBoxTime = bench::measure([&]()
+        {
+            reference = scalarBox(points);
+            bench::escape(&reference);
+        });
+        const double packedBoxTime = bench::measure([&]()
+        {
+            packed = AABB::createFromPoints(points);
+            bench::escape(&packed);
+        });
+        const double stridedBoxTime = bench::measure([&]()
+        {
+            strided = AABB::createFromPoints(&vertices[0].position, count, sizeof(Vertex));
+            bench::escape(&strided);
+        });
+
+        Sphere before, after, minimal;
+
+        const double scalarSphereTime = bench::measure([&]()
+        {
+            before = scalarSphere(points);
+            bench::escape(&before);
+        });
+        const double sphereTime = bench::measure([&]()
+        {
+            after = Sphere::createFromPoints(points);
+            bench::escape(&after);
+        });
+        const double minimalTime = bench::measure([&]()
+        {
+            minimal = Sphere::createMinimal(points);
+            bench::escape(&minimal);
+        }, 3);
+
+        bench::report("AABB, scalar loop" + suffix, scalarBoxTime, count);
+        bench::report("AABB, packed" + suffix, packedBoxTime, count);
+        bench::reportSpeedup("  vs scalar loop", scalarBoxTime, packedBoxTime);
+        bench::report("AABB, strided vertices" + suffix, stridedBoxTime, count);
+        bench::reportSpeedup("  vs scalar loop", scalarBoxTime, stridedBoxTime);
+        bench::report("Sphere, previous Ritter" + suffix, scalarSphereTime, count);
+        bench::report("Sphere, createFromPoints" + suffix, sphereTime, count);
+        bench::reportSpeedup("  vs previous Ritter", scalarSphereTime, sphereTime);
+        bench::report("Sphere, createMinimal" + suffix, minimalTime, count);
+
+        std::ostringstream radius;
+        radius << "radius: previous Ritter " << before.radius << ", createFromPoints " << after.radius
+               << ", createMinimal " << minimal.radius;
+        bench::note(radius.str());
+
+        if (!sameBox(reference, packed) || !sameBox(reference, strided))
+            bench::note("error: the boxes differ from the scalar loop");
+    }
+}
+
+namespace bench
+{
+
+void benchmarkPointCloud(const Options& options)
+{
+    const uint32 count = getOption(options, "count", 1u << 20);
+
+    section("Point cloud bounds: SIMD and in place vs the previous scalar loops");
+
+    std::mt19937 random(1234);
+    std::normal_distribution<float> coordinate(0.0f, 10.0f);
+
+    std::vector<vec3f> points(count);
+    for (uint32 i = 0; i < count; ++i)
+        points[i] = vec3f(coordinate(random) + 50.0f, coordinate(random) * 0.5f, coordinate(random) * 2.0f);
+
+    // A mesh sized cloud and a large one, both on the calling thread like the scalar loops.
+    run(std::vector<vec3f>(points.begin(), points.begin() + std::min<uint32>(count, 4096)));
+    run(points);
+}
+
+}
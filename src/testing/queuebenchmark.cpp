@@ -0,0 +1,230 @@
+#include "benchmark.h"
+
+// Nex includes.
+#include <nex/system/mpmcqueue.h>
+#include <nex/system/spscqueue.h>
+
+// Standard includes.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace nx;
+
+namespace
+{
+    // The queue the lock free ones replace, with the same push/pop interface.
+    template <typename T>
+    class LockedQueue
+    {
+    public:
+
+        explicit LockedQueue(std::size_t) { }
+
+        bool push(const T& item)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mItems.push_back(item);
+            return true;
+        }
+
+        bool pop(T& item)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mItems.empty())
+                return false;
+
+            item = mItems.front();
+            mItems.pop_front();
+            return true;
+        }
+
+    private:
+
+        std::mutex mMutex;
+        std::deque<T> mItems;
+    };
+
+    /*
+     * Moves items 1 to count from the producers to the consumers. Every consumer stops
+     * at the 0 pushed for it once the producers are done, and the sum of everything
+     * consumed tells whether an item was lost or duplicated.
+     */
+    template <typename Queue>
+    double throughput(uint32 producers, uint32 consumers, uint64 count, std::size_t capacity, bool& valid)
+    {
+        const uint64 perProducer = count / producers;
+        const uint64 total = perProducer * producers;
+
+        valid = true;
+
+        return bench::measure([&]()
+        {
+            Queue queue(capacity);
+            std::atomic<uint64> sum(0);
+            std::vector<std::thread> threads;
+
+            for (uint32 c = 0; c < consumers; ++c)
+            {
+                threads.push_back(std::thread([&]()
+                {
+                    uint64 localSum = 0;
+                    uint64 item;
+
+                    for (;;)
+                    {
+                        if (!queue.pop(item))
+                        {
+                            std::this_thread::yield();
+                            continue;
+                        }
+
+                        if (item == 0)
+                            break;
+
+                        localSum += item;
+                    }
+
+                    sum.fetch_add(localSum);
+                }));
+            }
+
+            std::vector<std::thread> producerThreads;
+
+            for (uint32 p = 0; p < producers; ++p)
+            {
+                producerThreads.push_back(std::thread([&, p]()
+                {
+                    const uint64 first = p * perProducer + 1;
+
+                    for (uint64 item = first; item < first + perProducer; ++item)
+                    {
+                        while (!queue.push(item))
+                            std::this_thread::yield();
+                    }
+                }));
+            }
+
+            for (std::size_t i = 0; i < producerThreads.size(); ++i)
+                producerThreads[i].join();
+
+            // The producers are done, so this thread may act as the single producer of an SpscQueue.
+            for (uint32 c = 0; c < consumers; ++c)
+            {
+                while (!queue.push(0))
+                    std::this_thread::yield();
+            }
+
+            for (std::size_t i = 0; i < threads.size(); ++i)
+                threads[i].join();
+
+            if (sum.load() != total * (total + 1) / 2)
+                valid = false;
+        }, 3);
+    }
+
+    /*
+     * Bounces one item between two threads through a pair of queues and
+     * records every round trip, in nanoseconds.
+     */
+    template <typename Queue>
+    void roundTrips(uint32 count, std::vector<int64>& times)
+    {
+        Queue request(64);
+        Queue reply(64);
+
+        times.resize(count);
+
+        std::thread echo([&]()
+        {
+            uint64 item;
+
+            for (uint32 i = 0; i < count; ++i)
+            {
+                while (!request.pop(item))
+                    std::this_thread::yield();
+                while (!reply.push(item))
+                    std::this_thread::yield();
+            }
+        });
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            uint64 item = i;
+
+            while (!request.push(item))
+                std::this_thread::yield();
+            while (!reply.pop(item))
+                std::this_thread::yield();
+
+            times[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        echo.join();
+        std::sort(times.begin(), times.end());
+    }
+
+    template <typename Queue>
+    void reportLatency(const std::string& name, uint32 count)
+    {
+        std::vector<int64> times;
+        roundTrips<Queue>(count, times);
+
+        std::ostringstream line;
+        line << name << " round trip: median " << times[times.size() / 2] << " ns, p99 "
+             << times[times.size() * 99 / 100] << " ns, max " << times.back() << " ns";
+        bench::note(line.str());
+    }
+}
+
+namespace bench
+{
+
+void benchmarkQueue(const Options& options)
+{
+    const uint32 count = getOption(options, "count", 1u << 20);
+    const uint32 capacity = getOption(options, "capacity", 1024);
+    const uint32 roundTripCount = getOption(options, "roundtrips", 10000);
+    const uint32 hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    section("SpscQueue and MpmcQueue vs a mutex guarded std::deque");
+    note("items: " + std::to_string(count) + ", capacity: " + std::to_string(capacity) +
+         ", hardware threads: " + std::to_string(hardwareThreads));
+
+    bool lockedValid, spscValid, mpmcValid, lockedManyValid, mpmcManyValid;
+
+    const double lockedOne = throughput<LockedQueue<uint64> >(1, 1, count, capacity, lockedValid);
+    const double spsc = throughput<SpscQueue<uint64> >(1, 1, count, capacity, spscValid);
+    const double mpmcOne = throughput<MpmcQueue<uint64> >(1, 1, count, capacity, mpmcValid);
+
+    report("1 producer, 1 consumer, mutex deque", lockedOne, count);
+    report("1 producer, 1 consumer, SpscQueue", spsc, count);
+    reportSpeedup("  vs mutex deque", lockedOne, spsc);
+    report("1 producer, 1 consumer, MpmcQueue", mpmcOne, count);
+    reportSpeedup("  vs mutex deque", lockedOne, mpmcOne);
+
+    const double lockedMany = throughput<LockedQueue<uint64> >(4, 4, count, capacity, lockedManyValid);
+    const double mpmcMany = throughput<MpmcQueue<uint64> >(4, 4, count, capacity, mpmcManyValid);
+
+    report("4 producers, 4 consumers, mutex deque", lockedMany, count);
+    report("4 producers, 4 consumers, MpmcQueue", mpmcMany, count);
+    reportSpeedup("  vs mutex deque", lockedMany, mpmcMany);
+
+    reportLatency<LockedQueue<uint64> >("mutex deque", roundTripCount);
+    reportLatency<SpscQueue<uint64> >("SpscQueue", roundTripCount);
+    reportLatency<MpmcQueue<uint64> >("MpmcQueue", roundTripCount);
+
+    if (!lockedValid || !spscValid || !mpmcValid || !lockedManyValid || !mpmcManyValid)
+        note("error: a queue lost or duplicated items");
+
+    if (hardwareThreads < 2)
+        note("with one hardware thread every hand over is a context switch, the numbers show scheduling more than the queues");
+}
+
+}
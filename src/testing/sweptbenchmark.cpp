@@ -0,0 +1,147 @@
+#include "benchmark.h"
+
+// Nex includes.
+#include <nex/math/aabb.h>
+#include <nex/math/convexquery.h>
+#include <nex/math/sphere.h>
+#include <nex/math/sweptquery.h>
+#include <nex/system/jobsystem.h>
+
+// Standard includes.
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace nx;
+
+namespace
+{
+    uint32 countHits(const std::vector<SweptResult>& results, std::size_t count)
+    {
+        uint32 hits = 0;
+
+        for (std::size_t i = 0; i < count; ++i)
+            hits += results[i].hit ? 1 : 0;
+
+        return hits;
+    }
+}
+
+namespace bench
+{
+
+void benchmarkSwept(const Options& options)
+{
+    const uint32 count = getOption(options, "count", 1u << 16);
+    const uint32 advanceCount = std::min(count, getOption(options, "advance", 4096));
+    const uint32 hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    const uint32 maxThreads = getOption(options, "threads", std::max(4u, hardwareThreads));
+
+    section("SweptQuery: batch sweeps across threads, closed form vs conservative advancement");
+    note("sphere/box pairs: " + std::to_string(count) + ", hardware threads: " + std::to_string(hardwareThreads));
+
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> extent(0.5f, 3.0f);
+    std::uniform_real_distribution<float> offset(-8.0f, 8.0f);
+
+    // Every sphere starts near its box and half of them move towards it.
+    std::vector<Sphere> spheres(count);
+    std::vector<AABB> boxes(count);
+    std::vector<vec3f> sphereMotions(count), boxMotions(count);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        const vec3f center(position(random), position(random), position(random));
+        const vec3f half(extent(random), extent(random), extent(random));
+        boxes[i] = AABB(center - half, center + half);
+
+        const vec3f start = center + vec3f(offset(random), offset(random), offset(random)) + vec3f(6.0f, 0.0f, 0.0f);
+        spheres[i] = Sphere(start, extent(random));
+
+        sphereMotions[i] = (i % 2 == 0 ? center - start : vec3f(offset(random), offset(random), offset(random))) * 1.5f;
+        boxMotions[i] = vec3f(offset(random), 0.0f, 0.0f) * 0.25f;
+    }
+
+    std::vector<SweptResult> serial(count), batch(count), advanced(count);
+
+    const double serialTime = measure([&]()
+    {
+        for (uint32 i = 0; i < count; ++i)
+            SweptQuery::sweep(spheres[i], sphereMotions[i], boxes[i], boxMotions[i], serial[i]);
+        escape(serial.data());
+    });
+
+    report("sweep one pair at a time", serialTime, count);
+
+    JobSystem& jobs = JobSystem::getInstance();
+    double singleThread = 0.0;
+    bool batchAgrees = true;
+
+    for (uint32 threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        jobs.setThreadCount(threads);
+
+        const double batchTime = measure([&]()
+        {
+            SweptQuery::sweep(spheres.data(), sphereMotions.data(), boxes.data(), boxMotions.data(), count, batch.data(), jobs);
+            escape(batch.data());
+        });
+
+        if (threads == 1)
+            singleThread = batchTime;
+
+        for (uint32 i = 0; i < count; ++i)
+            batchAgrees = batchAgrees && batch[i].hit == serial[i].hit && batch[i].time == serial[i].time;
+
+        report("batch sweep, " + std::to_string(threads) + " thread" + (threads > 1 ? "s" : ""), batchTime, count);
+        reportSpeedup("  vs one thread", singleThread, batchTime);
+        reportSpeedup("  vs one pair at a time", serialTime, batchTime);
+    }
+
+    jobs.setThreadCount(0);
+
+    // The same pairs through GJK based conservative advancement, the path for shapes without a closed form.
+    const double advanceTime = measure([&]()
+    {
+        for (uint32 i = 0; i < advanceCount; ++i)
+        {
+            const SphereSupport sphere(spheres[i]);
+            const AABBSupport box(boxes[i]);
+            SweptQuery::advance(sphere, sphereMotions[i], box, boxMotions[i], advanced[i]);
+        }
+        escape(advanced.data());
+    }, 3);
+
+    float largestTimeError = 0.0f;
+    uint32 hitMismatches = 0;
+
+    for (uint32 i = 0; i < advanceCount; ++i)
+    {
+        if (advanced[i].hit != serial[i].hit)
+            ++hitMismatches;
+        else if (serial[i].hit)
+            largestTimeError = std::max(largestTimeError, std::abs(advanced[i].time - serial[i].time));
+    }
+
+    const double closedFormTime = serialTime * advanceCount / count;
+
+    report("conservative advancement, " + std::to_string(advanceCount) + " pairs", advanceTime, advanceCount);
+    reportSpeedup("  closed form speedup", advanceTime, closedFormTime);
+
+    std::ostringstream summary;
+    summary << "hits: " << countHits(serial, count) << ", advancement disagrees on " << hitMismatches
+            << " pairs, largest time difference " << largestTimeError;
+    note(summary.str());
+
+    if (!batchAgrees)
+        note("error: the batch sweep differs from the single pair sweep");
+
+    if (maxThreads > hardwareThreads)
+        note("runs with more threads than the hardware has do not show scaling");
+}
+
+}
@@ -0,0 +1,231 @@
+#include "benchmark.h"
+
+// Nex includes.
+#include <nex/math/ray.h>
+#include <nex/math/raypacket.h>
+#include <nex/math/trianglebvh.h>
+#include <nex/math/vec3array.h>
+#include <nex/system/memoryinputstream.h>
+#include <nex/system/memoryoutputstream.h>
+
+// Standard includes.
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace nx;
+
+namespace
+{
+    // Moller-Trumbore, one ray against one triangle, as a mesh without a hierarchy is tested.
+    bool intersectTriangle(const Ray& ray, const vec3f& a, const vec3f& b, const vec3f& c, float& distance)
+    {
+        const vec3f edge1 = b - a;
+        const vec3f edge2 = c - a;
+        const vec3f p = vec3f::cross(ray.direction, edge2);
+        const float determinant = vec3f::dot(edge1, p);
+
+        if (std::abs(determinant) < 1e-8f)
+            return false;
+
+        const float oneOverDeterminant = 1.0f / determinant;
+        const vec3f t = ray.position - a;
+        const float u = vec3f::dot(t, p) * oneOverDeterminant;
+
+        if (u < 0.0f || u > 1.0f)
+            return false;
+
+        const vec3f q = vec3f::cross(t, edge1);
+        const float v = vec3f::dot(ray.direction, q) * oneOverDeterminant;
+
+        if (v < 0.0f || u + v > 1.0f)
+            return false;
+
+        distance = vec3f::dot(edge2, q) * oneOverDeterminant;
+        return distance >= 0.0f;
+    }
+
+    // A rolling height field, gridSize * gridSize quads of two triangles.
+    void createTerrain(uint32 gridSize, std::vector<vec3f>& positions, std::vector<uint32>& indices)
+    {
+        for (uint32 z = 0; z <= gridSize; ++z)
+        {
+            for (uint32 x = 0; x <= gridSize; ++x)
+            {
+                const float height = 4.0f * std::sin(x * 0.11f) * std::cos(z * 0.07f) + std::sin(x * 0.53f + z * 0.31f);
+                positions.push_back(vec3f(static_cast<float>(x), height, static_cast<float>(z)));
+            }
+        }
+
+        for (uint32 z = 0; z < gridSize; ++z)
+        {
+            for (uint32 x = 0; x < gridSize; ++x)
+            {
+                const uint32 corner = z * (gridSize + 1) + x;
+
+                indices.push_back(corner);
+                indices.push_back(corner + gridSize + 1);
+                indices.push_back(corner + 1);
+
+                indices.push_back(corner + 1);
+                indices.push_back(corner + gridSize + 1);
+                indices.push_back(corner + gridSize + 2);
+            }
+        }
+    }
+}
+
+namespace bench
+{
+
+void benchmarkTriangleBVH(const Options& options)
+{
+    const uint32 gridSize = std::max(32u, getOption(options, "grid", 256));
+    const uint32 rayCount = (getOption(options, "rays", 65536) + 7) / 8 * 8;
+    const uint32 bruteRayCount = std::min(rayCount, getOption(options, "bruterays", 256));
+
+    std::vector<vec3f> positions;
+    std::vector<uint32> indices;
+    createTerrain(gridSize, positions, indices);
+
+    const uint32 triangleCount = static_cast<uint32>(indices.size() / 3);
+
+    section("TriangleBVH: raycasts vs testing every triangle");
+    note("triangles: " + std::to_string(triangleCount) + ", rays: " + std::to_string(rayCount));
+
+    TriangleBVH bvh;
+    const double build = measure([&]()
+    {
+        bvh.build(Vec3View(positions), indices.data(), triangleCount);
+        escape(bvh.getNodes());
+    }, 3);
+
+    // Loading the serialized hierarchy is what the write/read pair is for, compare it with building.
+    std::vector<char> buffer(triangleCount * 128 + 1024);
+    MemoryOutputStream output;
+    output.open(buffer.data(), buffer.size());
+    const bool written = bvh.write(output);
+    const int64 writtenSize = output.tell();
+
+    TriangleBVH loaded;
+    bool read = false;
+    const double load = measure([&]()
+    {
+        MemoryInputStream input;
+        input.open(buffer.data(), writtenSize);
+        read = loaded.read(input);
+        escape(loaded.getNodes());
+    }, 3);
+
+    report("build", build, triangleCount);
+    report("read " + std::to_string(writtenSize / 1024) + " KiB from memory", load, triangleCount);
+    reportSpeedup("  vs build", build, load);
+
+    // Rays fall from above the terrain at a slant, in groups of 8 neighbours for the packets.
+    // They start far enough from the +x and +z edges to land on the terrain.
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> coordinate(1.0f, std::max(2.0f, static_cast<float>(gridSize) - 16.0f));
+    std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+
+    std::vector<Ray> rays(rayCount);
+
+    for (uint32 i = 0; i < rayCount; i += 8)
+    {
+        const float x = coordinate(random);
+        const float z = coordinate(random);
+
+        for (uint32 lane = 0; lane < 8; ++lane)
+        {
+            const vec3f origin(x + jitter(random), 20.0f, z + jitter(random));
+            rays[i + lane] = Ray(origin, vec3f::normalize(vec3f(0.3f, -1.0f, 0.2f)));
+        }
+    }
+
+    std::vector<float> bruteDistances(bruteRayCount);
+    const double brute = measure([&]()
+    {
+        for (uint32 i = 0; i < bruteRayCount; ++i)
+        {
+            float closest = std::numeric_limits<float>::max();
+
+            for (uint32 j = 0; j < triangleCount; ++j)
+            {
+                float distance;
+                if (intersectTriangle(rays[i], positions[indices[j * 3]], positions[indices[j * 3 + 1]],
+                                      positions[indices[j * 3 + 2]], distance) && distance < closest)
+                    closest = distance;
+            }
+
+            bruteDistances[i] = closest;
+        }
+        escape(bruteDistances.data());
+    }, 1);
+
+    std::vector<TriangleHit> singleHits(rayCount), packet4Hits(rayCount), packet8Hits(rayCount);
+    std::vector<uint8> singleHit(rayCount);
+    uint32 packet4Mask = 0, packet8Mask = 0;
+
+    const double single = measure([&]()
+    {
+        for (uint32 i = 0; i < rayCount; ++i)
+            singleHit[i] = bvh.raycast(rays[i], singleHits[i]) ? 1 : 0;
+        escape(singleHits.data());
+    });
+
+    const double packet4 = measure([&]()
+    {
+        packet4Mask = 0;
+        for (uint32 i = 0; i < rayCount; i += 4)
+        {
+            const RayPacket4 packet(&rays[i], 4);
+            packet4Mask |= bvh.raycast(packet, &packet4Hits[i]) ^ 0xF;
+        }
+        escape(packet4Hits.data());
+    });
+
+    const double packet8 = measure([&]()
+    {
+        packet8Mask = 0;
+        for (uint32 i = 0; i < rayCount; i += 8)
+        {
+            const RayPacket8 packet(&rays[i], 8);
+            packet8Mask |= bvh.raycast(packet, &packet8Hits[i]) ^ 0xFF;
+        }
+        escape(packet8Hits.data());
+    });
+
+    report("every triangle, " + std::to_string(bruteRayCount) + " rays", brute, bruteRayCount);
+    report("bvh, single rays", single, rayCount);
+    reportSpeedup("  vs every triangle", brute / bruteRayCount, single / rayCount);
+    report("bvh, RayPacket4", packet4, rayCount);
+    reportSpeedup("  vs single rays", single, packet4);
+    report("bvh, RayPacket8", packet8, rayCount);
+    reportSpeedup("  vs single rays", single, packet8);
+
+    // Every ray hits the terrain, so the hierarchy must find the brute force distance for all of them.
+    float largestError = 0.0f;
+    uint32 misses = 0;
+
+    for (uint32 i = 0; i < rayCount; ++i)
+    {
+        if (!singleHit[i])
+        {
+            ++misses;
+            continue;
+        }
+
+        if (i < bruteRayCount)
+            largestError = std::max(largestError, std::abs(singleHits[i].distance - bruteDistances[i]));
+        largestError = std::max(largestError, std::abs(singleHits[i].distance - packet4Hits[i].distance));
+        largestError = std::max(largestError, std::abs(singleHits[i].distance - packet8Hits[i].distance));
+    }
+
+    if (!written || !read || loaded.getNodeCount() != bvh.getNodeCount())
+        note("error: the hierarchy did not survive write and read");
+    if (misses != 0 || packet4Mask != 0 || packet8Mask != 0 || largestError > 1e-3f)
+        note("error: the bvh raycasts disagree with the brute force distances");
+}
+
+}
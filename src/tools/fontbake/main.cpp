@@ -0,0 +1,124 @@
+#include <nex/gfx/font.h>
+#include <nex/filesystem/fileoutputstream.h>
+#include <nex/system/string.h>
+
+// The engine leaves the stb implementations to the application.
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace nx;
+
+/**
+ * Bakes a font into the file format read by Font::loadFromBaked.
+ *
+ * usage: nex-fontbake <font> <output> <size,size,...> [--bold] [--charset <utf-8 file>]
+ *
+ * Printable ASCII is baked when no charset file is given.
+ */
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "usage: nex-fontbake <font> <output> <size,size,...> [--bold] [--charset <utf-8 file>]" << std::endl;
+    }
+
+    bool parseSizes(const std::string& list, std::vector<uint32>& sizes)
+    {
+        std::istringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ','))
+        {
+            const int size = std::atoi(item.c_str());
+            if (size <= 0)
+                return false;
+
+            sizes.push_back(static_cast<uint32>(size));
+        }
+
+        return !sizes.empty();
+    }
+
+    bool loadCharset(const std::string& filename, String& charset)
+    {
+        std::ifstream file(filename.c_str(), std::ios::binary);
+        if (!file)
+            return false;
+
+        const std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        charset = String::fromUtf8(bytes.begin(), bytes.end());
+        return true;
+    }
+}
+
+int main(int argc, char** args)
+{
+    if (argc < 4)
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::vector<uint32> sizes;
+    if (!parseSizes(args[3], sizes))
+    {
+        std::cout << "invalid character sizes: " << args[3] << std::endl;
+        return 1;
+    }
+
+    bool bold = false;
+    String charset;
+    for (uint32 codePoint = 32; codePoint < 127; ++codePoint)
+        charset += String(codePoint);
+
+    for (int i = 4; i < argc; ++i)
+    {
+        const std::string option = args[i];
+        if (option == "--bold")
+        {
+            bold = true;
+        }
+        else if (option == "--charset" && i + 1 < argc)
+        {
+            if (!loadCharset(args[++i], charset))
+            {
+                std::cout << "failed to read the charset file: " << args[i] << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    Font font;
+    if (!font.loadFromFile(args[1]))
+        return 1;
+
+    FileOutputStream stream;
+    if (!stream.open(args[2]))
+    {
+        std::cout << "failed to open the output file: " << args[2] << std::endl;
+        return 1;
+    }
+
+    if (!font.saveBaked(stream, sizes, charset, bold))
+    {
+        std::cout << "failed to bake the font" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}